@@ -0,0 +1,8 @@
+# FFT-based structure factors in compute xrd and saed need the FFT wrappers from KSPACE
+if(PKG_KSPACE)
+  target_compile_definitions(lammps PRIVATE -DLMP_DIFFRACTION_FFT)
+else()
+  get_target_property(LAMMPS_SOURCES lammps SOURCES)
+  list(REMOVE_ITEM LAMMPS_SOURCES ${LAMMPS_SOURCE_DIR}/DIFFRACTION/diffraction_fft.cpp)
+  set_property(TARGET lammps PROPERTY SOURCES "${LAMMPS_SOURCES}")
+endif()
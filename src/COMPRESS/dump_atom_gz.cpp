@@ -24,6 +24,7 @@ using namespace LAMMPS_NS;
 
 DumpAtomGZ::DumpAtomGZ(LAMMPS *lmp, int narg, char **arg) : DumpAtom(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump atom/gz only writes compressed files");
 }
 
@@ -30,6 +30,7 @@ using namespace LAMMPS_NS;
 
 DumpAtomZstd::DumpAtomZstd(LAMMPS *lmp, int narg, char **arg) : DumpAtom(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump atom/zstd only writes compressed files");
 }
 
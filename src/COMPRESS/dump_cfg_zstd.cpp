@@ -32,6 +32,7 @@ using namespace LAMMPS_NS;
 
 DumpCFGZstd::DumpCFGZstd(LAMMPS *lmp, int narg, char **arg) : DumpCFG(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump cfg/zstd only writes compressed files");
 }
 
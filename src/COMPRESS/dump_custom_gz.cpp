@@ -24,6 +24,7 @@ using namespace LAMMPS_NS;
 
 DumpCustomGZ::DumpCustomGZ(LAMMPS *lmp, int narg, char **arg) : DumpCustom(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump custom/gz only writes compressed files");
 }
 
@@ -33,6 +33,7 @@ using namespace LAMMPS_NS;
 DumpCustomZstd::DumpCustomZstd(LAMMPS *lmp, int narg, char **arg) :
   DumpCustom(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed)
     error->all(FLERR,"Dump custom/zstd only writes compressed files");
 }
@@ -24,6 +24,7 @@ using namespace LAMMPS_NS;
 
 DumpLocalGZ::DumpLocalGZ(LAMMPS *lmp, int narg, char **arg) : DumpLocal(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump local/gz only writes compressed files");
 }
 
@@ -30,6 +30,7 @@ using namespace LAMMPS_NS;
 
 DumpLocalZstd::DumpLocalZstd(LAMMPS *lmp, int narg, char **arg) : DumpLocal(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump local/zstd only writes compressed files");
 }
 
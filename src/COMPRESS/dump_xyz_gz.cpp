@@ -23,6 +23,7 @@ using namespace LAMMPS_NS;
 
 DumpXYZGZ::DumpXYZGZ(LAMMPS *lmp, int narg, char **arg) : DumpXYZ(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump xyz/gz only writes compressed files");
 }
 
@@ -29,6 +29,7 @@ using namespace LAMMPS_NS;
 
 DumpXYZZstd::DumpXYZZstd(LAMMPS *lmp, int narg, char **arg) : DumpXYZ(lmp, narg, arg)
 {
+  async_allow = 0;
   if (!compressed) error->all(FLERR, "Dump xyz/zstd only writes compressed files");
 }
 
@@ -0,0 +1,48 @@
+# Install/unInstall package files in LAMMPS
+# mode = 0/1/2 for uninstall/install/update
+
+mode=$1
+
+# enforce using portable C locale
+LC_ALL=C
+export LC_ALL
+
+# arg1 = file, arg2 = file it depends on
+
+action () {
+  if (test $mode = 0) then
+    rm -f ../$1
+  elif (! cmp -s $1 ../$1) then
+    if (test -z "$2" || test -e ../$2) then
+      cp $1 ..
+      if (test $mode = 2) then
+        echo "  updating src/$1"
+      fi
+    fi
+  elif (test -n "$2") then
+    if (test ! -e ../$2) then
+      rm -f ../$1
+    fi
+  fi
+}
+
+# all package files with no dependencies
+
+for file in compute_*.cpp compute_*.h fix_*.cpp fix_*.h; do
+  test -f ${file} && action $file
+done
+
+# list of files with optional dependencies
+
+action diffraction_fft.cpp fft3d_wrap.h
+action diffraction_fft.h fft3d_wrap.h
+
+# edit Makefile.package to enable FFT-based structure factors
+# only if the FFT wrappers from KSPACE are installed
+
+if (test -e ../Makefile.package) then
+  sed -i -e 's/[^ \t]*-DLMP_DIFFRACTION_FFT[^ \t]* //' ../Makefile.package
+  if (test $mode != 0 && test -e ../diffraction_fft.cpp) then
+    sed -i -e 's|^PKG_INC =[ \t]*|&-DLMP_DIFFRACTION_FFT |' ../Makefile.package
+  fi
+fi
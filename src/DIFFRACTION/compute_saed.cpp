@@ -31,6 +31,11 @@
 
 #include <cmath>
 #include <cstring>
+#include <vector>
+
+#if defined(LMP_DIFFRACTION_FFT)
+#include "diffraction_fft.h"
+#endif
 
 #include "omp_compat.h"
 using namespace LAMMPS_NS;
@@ -50,7 +55,7 @@ static const char cite_compute_saed_c[] =
 /* ---------------------------------------------------------------------- */
 
 ComputeSAED::ComputeSAED(LAMMPS *lmp, int narg, char **arg) :
-  Compute(lmp, narg, arg), ztype(nullptr), store_tmp(nullptr)
+  Compute(lmp, narg, arg), ztype(nullptr), dfft(nullptr), store_tmp(nullptr)
 {
   if (lmp->citeme) lmp->citeme->add(cite_compute_saed_c);
 
@@ -102,6 +107,7 @@ ComputeSAED::ComputeSAED(LAMMPS *lmp, int narg, char **arg) :
   manual = false;
   double manual_double=0;
   echo = false;
+  fftacc = 0.0;
 
   // Process optional args
   while (iarg < narg) {
@@ -145,6 +151,17 @@ ComputeSAED::ComputeSAED(LAMMPS *lmp, int narg, char **arg) :
       manual_double = 1;
       iarg += 1;
 
+    } else if (strcmp(arg[iarg],"fft") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal Compute SAED Command");
+      fftacc = utils::numeric(FLERR,arg[iarg+1],false,lmp);
+      if (fftacc < 0 || fftacc >= 1)
+        error->all(FLERR,"Compute SAED: fft accuracy must be between 0 and 1");
+#if !defined(LMP_DIFFRACTION_FFT)
+      if (fftacc > 0)
+        error->all(FLERR,"Compute SAED fft option requires the KSPACE package");
+#endif
+      iarg += 2;
+
     } else error->all(FLERR,"Illegal Compute SAED Command");
   }
 
@@ -255,6 +272,23 @@ ComputeSAED::ComputeSAED(LAMMPS *lmp, int narg, char **arg) :
                    "Reciprocal point spacing in k1,k2,k3 = {:.8} {:.8} {:.8}\n-----\n",
                    id,natoms,n,dK[0],dK[1],dK[2]);
 
+#if defined(LMP_DIFFRACTION_FFT)
+  // FFT grid covers all reciprocal points up to Kmax, oversampled 2x in
+  // each dimension, fine spacings c make it too large to allocate
+
+  if (fftacc > 0) {
+    int grid[3];
+    const double bytes = DiffractionFFT::memory_estimate(Knmax,fftacc,comm->nprocs,grid);
+    if (bytes > DiffractionFFT::MAXBYTES) {
+      if (me == 0)
+        error->warning(FLERR,"Compute SAED FFT grid {}x{}x{} needs about {:.1f} GB per MPI "
+                       "rank, using direct summation instead",grid[0],grid[1],grid[2],
+                       bytes/1024.0/1024.0/1024.0);
+      fftacc = 0.0;
+    }
+  }
+#endif
+
   nRows = n;
   size_vector = n;
   memory->create(vector,size_vector,"saed:vector");
@@ -281,6 +315,9 @@ ComputeSAED::~ComputeSAED()
   memory->destroy(vector);
   memory->destroy(store_tmp);
   delete[] ztype;
+#if defined(LMP_DIFFRACTION_FFT)
+  delete dfft;
+#endif
 }
 
 /* ---------------------------------------------------------------------- */
@@ -406,6 +443,43 @@ void ComputeSAED::compute_vector()
 
   if (me == 0 && echo) utils::logmesg(lmp,"\n");
 
+#if defined(LMP_DIFFRACTION_FFT)
+  if (fftacc > 0)
+    compute_fft(Fvec,xlocal,typelocal,offset);
+  else
+#endif
+    compute_direct(Fvec,xlocal,typelocal,offset);
+
+  auto scratch = new double[2*nRows];
+
+  // Sum intensity for each ang-hkl combination across processors
+  MPI_Allreduce(Fvec,scratch,2*nRows,MPI_DOUBLE,MPI_SUM,world);
+
+  for (int i = 0; i < nRows; i++) {
+    vector[i] = (scratch[2*i] * scratch[2*i] + scratch[2*i+1] * scratch[2*i+1]) / natoms;
+  }
+
+  double t2 = platform::walltime();
+
+  // compute memory usage per processor
+  double bytes = memory_usage();
+
+  if (me == 0 && echo)
+    utils::logmesg(lmp," 100% \nTime elapsed during compute_saed = {:.2f} sec "
+                   "using {:.2f} Mbytes/processor\n-----\n", t2-t0, bytes/1024.0/1024.0);
+
+  delete [] xlocal;
+  delete [] typelocal;
+  delete [] scratch;
+  delete [] Fvec;
+}
+
+/* ----------------------------------------------------------------------
+ structure factor as direct sum over atoms for each reciprocal point
+ ------------------------------------------------------------------------- */
+
+void ComputeSAED::compute_direct(double *Fvec, double *xlocal, int *typelocal, int offset)
+{
   int m = 0;
   double frac = 0.1;
 
@@ -480,29 +554,58 @@ void ComputeSAED::compute_vector()
     } // End of pragma omp for region
     delete [] f;
   }
+}
 
-  auto scratch = new double[2*nRows];
-
-  // Sum intensity for each ang-hkl combination across processors
-  MPI_Allreduce(Fvec,scratch,2*nRows,MPI_DOUBLE,MPI_SUM,world);
+/* ----------------------------------------------------------------------
+ structure factor from per-type structure factors of FFT on a grid
+ ------------------------------------------------------------------------- */
 
-  for (int i = 0; i < nRows; i++) {
-    vector[i] = (scratch[2*i] * scratch[2*i] + scratch[2*i+1] * scratch[2*i+1]) / natoms;
+void ComputeSAED::compute_fft(double *Fvec, double *xlocal, int *typelocal, int offset)
+{
+#if defined(LMP_DIFFRACTION_FFT)
+  if (dfft == nullptr) {
+    dfft = new DiffractionFFT(lmp,Knmax,dK,fftacc);
+    if (me == 0 && echo)
+      utils::logmesg(lmp," using FFT grid {}x{}x{}\n",dfft->grid[0],dfft->grid[1],dfft->grid[2]);
   }
 
-  double t2 = platform::walltime();
+  std::vector<double> sfac(2*ntypes*nRows);
+  dfft->compute(nlocalgroup,xlocal,typelocal,ntypes,nRows,store_tmp,sfac.data());
 
-  // compute memory usage per processor
-  double bytes = memory_usage();
+  // combine with atomic structure factor by type
+  // only rows with non-zero structure factors on this proc
 
-  if (me == 0 && echo)
-    utils::logmesg(lmp," 100% \nTime elapsed during compute_saed = {:.2f} sec "
-                   "using {:.2f} Mbytes/processor\n-----\n", t2-t0, bytes/1024.0/1024.0);
+  for (int n = 0; n < nRows; n++) {
+    const double *S = &sfac[2*ntypes*n];
+    int nonzero = 0;
+    for (int ii = 0; ii < 2*ntypes; ii++)
+      if (S[ii] != 0.0) nonzero = 1;
+    Fvec[2*n] = Fvec[2*n+1] = 0.0;
+    if (!nonzero) continue;
 
-  delete [] xlocal;
-  delete [] typelocal;
-  delete [] scratch;
-  delete [] Fvec;
+    double K[3];
+    K[0] = store_tmp[3*n+0] * dK[0];
+    K[1] = store_tmp[3*n+1] * dK[1];
+    K[2] = store_tmp[3*n+2] * dK[2];
+    double dinv2 = (K[0] * K[0] + K[1] * K[1] + K[2] * K[2]);
+    double SinTheta_lambda = 0.5*sqrt(dinv2);
+
+    for (int ii = 0; ii < ntypes; ii++) {
+      double f = 0;
+      for (int C = 0; C < 5; C++) {
+        int D = C + offset;
+        f += ASFSAED[ztype[ii]][D] * exp(-1*ASFSAED[ztype[ii]][5+D] * SinTheta_lambda * SinTheta_lambda);
+      }
+      Fvec[2*n] += f * S[2*ii];
+      Fvec[2*n+1] += f * S[2*ii+1];
+    }
+  }
+#else
+  (void) Fvec;
+  (void) xlocal;
+  (void) typelocal;
+  (void) offset;
+#endif
 }
 
 /* ----------------------------------------------------------------------
@@ -517,6 +620,9 @@ double ComputeSAED::memory_usage()
   bytes += (double)3.0 * nlocalgroup * sizeof(double); // xlocal
   bytes += (double)nlocalgroup * sizeof(int); // typelocal
   bytes += (double)3.0 * nRows * sizeof(int); // store_temp
+#if defined(LMP_DIFFRACTION_FFT)
+  if (dfft) bytes += dfft->memory_usage();
+#endif
 
   return bytes;
 }
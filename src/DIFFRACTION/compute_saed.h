@@ -42,6 +42,8 @@ class ComputeSAED : public Compute {
   double prd_inv[3];    // Inverse spacing of unit cell
   bool echo;            // echo compute_array progress
   bool manual;          // Turn on manual recpiprocal map
+  double fftacc;        // Accuracy of FFT-based structure factors, 0 = direct sum
+  class DiffractionFFT *dfft;
   int nRows;            // Number of relp explored
 
   double Zone[3];    // Zone axis to view SAED
@@ -54,6 +56,9 @@ class ComputeSAED : public Compute {
   int ntypes;
   int nlocalgroup;
   int *store_tmp;
+
+  void compute_direct(double *, double *, int *, int);
+  void compute_fft(double *, double *, int *, int);
 };
 
 }    // namespace LAMMPS_NS
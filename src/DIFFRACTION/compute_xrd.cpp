@@ -32,6 +32,11 @@
 
 #include <cmath>
 #include <cstring>
+#include <vector>
+
+#if defined(LMP_DIFFRACTION_FFT)
+#include "diffraction_fft.h"
+#endif
 
 #include "omp_compat.h"
 using namespace LAMMPS_NS;
@@ -51,7 +56,7 @@ static const char cite_compute_xrd_c[] =
 /* ---------------------------------------------------------------------- */
 
 ComputeXRD::ComputeXRD(LAMMPS *lmp, int narg, char **arg) :
-  Compute(lmp, narg, arg), ztype(nullptr), store_tmp(nullptr)
+  Compute(lmp, narg, arg), ztype(nullptr), dfft(nullptr), store_tmp(nullptr)
 {
   if (lmp->citeme) lmp->citeme->add(cite_compute_xrd_c);
 
@@ -102,6 +107,7 @@ ComputeXRD::ComputeXRD(LAMMPS *lmp, int narg, char **arg) :
   LP = 1;
   manual = false;
   echo = false;
+  fftacc = 0.0;
 
   // Process optional args
   while (iarg < narg) {
@@ -136,6 +142,17 @@ ComputeXRD::ComputeXRD(LAMMPS *lmp, int narg, char **arg) :
       manual = true;
       iarg += 1;
 
+    } else if (strcmp(arg[iarg],"fft") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal Compute XRD Command");
+      fftacc = utils::numeric(FLERR,arg[iarg+1],false,lmp);
+      if (fftacc < 0 || fftacc >= 1)
+        error->all(FLERR,"Compute XRD: fft accuracy must be between 0 and 1");
+#if !defined(LMP_DIFFRACTION_FFT)
+      if (fftacc > 0)
+        error->all(FLERR,"Compute XRD fft option requires the KSPACE package");
+#endif
+      iarg += 2;
+
     } else error->all(FLERR,"Illegal Compute XRD Command");
   }
 
@@ -237,6 +254,23 @@ ComputeXRD::ComputeXRD(LAMMPS *lmp, int narg, char **arg) :
                    "Reciprocal point spacing in k1,k2,k3 = {:.8} {:.8} {:.8}\n-----\n",
                    id,natoms,nRows,dK[0],dK[1],dK[2]);
 
+#if defined(LMP_DIFFRACTION_FFT)
+  // FFT grid covers all reciprocal points up to Kmax, oversampled 2x in
+  // each dimension, fine spacings c make it too large to allocate
+
+  if (fftacc > 0) {
+    int grid[3];
+    const double bytes = DiffractionFFT::memory_estimate(Knmax,fftacc,comm->nprocs,grid);
+    if (bytes > DiffractionFFT::MAXBYTES) {
+      if (me == 0)
+        error->warning(FLERR,"Compute XRD FFT grid {}x{}x{} needs about {:.1f} GB per MPI "
+                       "rank, using direct summation instead",grid[0],grid[1],grid[2],
+                       bytes/1024.0/1024.0/1024.0);
+      fftacc = 0.0;
+    }
+  }
+#endif
+
   memory->create(array,size_array_rows,size_array_cols,"xrd:array");
   memory->create(store_tmp,3*size_array_rows,"xrd:store_tmp");
 }
@@ -248,6 +282,9 @@ ComputeXRD::~ComputeXRD()
   memory->destroy(array);
   memory->destroy(store_tmp);
   delete[] ztype;
+#if defined(LMP_DIFFRACTION_FFT)
+  delete dfft;
+#endif
 }
 
 /* ---------------------------------------------------------------------- */
@@ -342,6 +379,43 @@ void ComputeXRD::compute_array()
         utils::logmesg(lmp,"Applying Lorentz-Polarization Factor During XRD Calculation 2\n");
   }
 
+#if defined(LMP_DIFFRACTION_FFT)
+  if (fftacc > 0)
+    compute_fft(Fvec,xlocal,typelocal);
+  else
+#endif
+    compute_direct(Fvec,xlocal,typelocal);
+
+  auto scratch = new double[2*size_array_rows];
+
+  // Sum intensity for each ang-hkl combination across processors
+  MPI_Allreduce(Fvec,scratch,2*size_array_rows,MPI_DOUBLE,MPI_SUM,world);
+
+  for (int i = 0; i < size_array_rows; i++) {
+    array[i][1] = (scratch[2*i] * scratch[2*i] + scratch[2*i+1] * scratch[2*i+1]) / natoms;
+  }
+
+  double t2 = platform::walltime();
+
+  // compute memory usage per processor
+  double bytes = memory_usage();
+
+  if (me == 0 && echo)
+    utils::logmesg(lmp," 100% \nTime elapsed during compute_xrd = {:.2f} sec "
+                   "using {:.2f} Mbytes/processor\n-----\n", t2-t0, bytes/1024.0/1024.0);
+
+  delete [] scratch;
+  delete [] Fvec;
+  delete [] xlocal;
+  delete [] typelocal;
+}
+
+/* ----------------------------------------------------------------------
+ structure factor as direct sum over atoms for each reciprocal point
+ ------------------------------------------------------------------------- */
+
+void ComputeXRD::compute_direct(double *Fvec, double *xlocal, int *typelocal)
+{
   int m = 0;
   double frac = 0.1;
 
@@ -484,29 +558,74 @@ void ComputeXRD::compute_array()
     } // End of if LP=1 check
     delete [] f;
   } // End of pragma omp parallel region
+}
 
-  auto scratch = new double[2*size_array_rows];
+/* ----------------------------------------------------------------------
+ structure factor from per-type structure factors of FFT on a grid
+ ------------------------------------------------------------------------- */
 
-  // Sum intensity for each ang-hkl combination across processors
-  MPI_Allreduce(Fvec,scratch,2*size_array_rows,MPI_DOUBLE,MPI_SUM,world);
+void ComputeXRD::compute_fft(double *Fvec, double *xlocal, int *typelocal)
+{
+#if defined(LMP_DIFFRACTION_FFT)
+  if (dfft == nullptr) {
+    dfft = new DiffractionFFT(lmp,Knmax,dK,fftacc);
+    if (me == 0 && echo)
+      utils::logmesg(lmp," using FFT grid {}x{}x{}\n",dfft->grid[0],dfft->grid[1],dfft->grid[2]);
+  }
 
-  for (int i = 0; i < size_array_rows; i++) {
-    array[i][1] = (scratch[2*i] * scratch[2*i] + scratch[2*i+1] * scratch[2*i+1]) / natoms;
+  std::vector<int> hkl(3*size_array_rows);
+  for (int n = 0; n < size_array_rows; n++) {
+    hkl[3*n] = store_tmp[3*n+2];
+    hkl[3*n+1] = store_tmp[3*n+1];
+    hkl[3*n+2] = store_tmp[3*n];
   }
+  std::vector<double> sfac(2*ntypes*size_array_rows);
+  dfft->compute(nlocalgroup,xlocal,typelocal,ntypes,size_array_rows,hkl.data(),sfac.data());
 
-  double t2 = platform::walltime();
+  // combine with atomic structure factor by type
+  // only rows with non-zero structure factors on this proc
 
-  // compute memory usage per processor
-  double bytes = memory_usage();
+  for (int n = 0; n < size_array_rows; n++) {
+    const double *S = &sfac[2*ntypes*n];
+    int nonzero = 0;
+    for (int ii = 0; ii < 2*ntypes; ii++)
+      if (S[ii] != 0.0) nonzero = 1;
+    Fvec[2*n] = Fvec[2*n+1] = 0.0;
+    if (!nonzero) continue;
 
-  if (me == 0 && echo)
-    utils::logmesg(lmp," 100% \nTime elapsed during compute_xrd = {:.2f} sec "
-                   "using {:.2f} Mbytes/processor\n-----\n", t2-t0, bytes/1024.0/1024.0);
+    double K[3];
+    K[0] = hkl[3*n] * dK[0];
+    K[1] = hkl[3*n+1] * dK[1];
+    K[2] = hkl[3*n+2] * dK[2];
+    double dinv2 = (K[0] * K[0] + K[1] * K[1] + K[2] * K[2]);
+    double SinTheta_lambda = 0.5*sqrt(dinv2);
+
+    for (int ii = 0; ii < ntypes; ii++) {
+      double f = 0;
+      for (int C = 0; C < 8 ; C+=2) {
+        f += ASFXRD[ztype[ii]][C] * exp(-1 * ASFXRD[ztype[ii]][C+1] * SinTheta_lambda * SinTheta_lambda );
+      }
+      f += ASFXRD[ztype[ii]][8];
+      Fvec[2*n] += f * S[2*ii];
+      Fvec[2*n+1] += f * S[2*ii+1];
+    }
 
-  delete [] scratch;
-  delete [] Fvec;
-  delete [] xlocal;
-  delete [] typelocal;
+    if (LP == 1) {
+      double SinTheta = SinTheta_lambda * lambda;
+      double ang = asin( SinTheta );
+      double Cos2Theta = cos( 2 * ang);
+      double CosTheta = cos( ang );
+      double sqrt_lp = sqrt( (1 + Cos2Theta * Cos2Theta) /
+                             ( CosTheta * SinTheta * SinTheta) );
+      Fvec[2*n] *= sqrt_lp;
+      Fvec[2*n+1] *= sqrt_lp;
+    }
+  }
+#else
+  (void) Fvec;
+  (void) xlocal;
+  (void) typelocal;
+#endif
 }
 
 /* ----------------------------------------------------------------------
@@ -521,6 +640,9 @@ double ComputeXRD::memory_usage()
   bytes += (double)nlocalgroup * sizeof(int); // typelocal
   bytes += (double)ntypes * sizeof(double); // f
   bytes += (double)3.0 * size_array_rows * sizeof(int); // store_temp
+#if defined(LMP_DIFFRACTION_FFT)
+  if (dfft) bytes += dfft->memory_usage();
+#endif
 
   return bytes;
 }
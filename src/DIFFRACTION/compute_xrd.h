@@ -45,12 +45,17 @@ class ComputeXRD : public Compute {
   int LP;               // Switch to turn on Lorentz-Polarization factor 1=on
   bool echo;            // echo compute_array progress
   bool manual;          // Turn on manual recpiprocal map
+  double fftacc;        // Accuracy of FFT-based structure factors, 0 = direct sum
+  class DiffractionFFT *dfft;
 
   int ntypes;
   int nlocalgroup;
   double lambda;    // Radiation wavelenght (distance units)
   int radflag;
   int *store_tmp;
+
+  void compute_direct(double *, double *, int *);
+  void compute_fft(double *, double *, int *);
 };
 
 }    // namespace LAMMPS_NS
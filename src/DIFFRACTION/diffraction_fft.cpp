@@ -0,0 +1,306 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "diffraction_fft.h"
+
+#include "error.h"
+#include "fft3d_wrap.h"
+#include "math_const.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace LAMMPS_NS;
+using MathConst::MY_PI;
+
+/* ----------------------------------------------------------------------
+   setup grid and kernel for requested accuracy of structure factors
+   relative to the sum of scattering factors of all atoms
+------------------------------------------------------------------------- */
+
+DiffractionFFT::DiffractionFFT(LAMMPS *lmp, const int *nmax_in, const double *dK_in,
+                               double accuracy) :
+    Pointers(lmp), work(nullptr), fft(nullptr)
+{
+  MPI_Comm_rank(world, &me);
+  MPI_Comm_size(world, &nprocs);
+
+  lnacc = -log(accuracy);
+  for (int d = 0; d < 3; d++) {
+    nmax[d] = nmax_in[d];
+    dK[d] = dK_in[d];
+  }
+  setup_grid(nmax, lnacc, grid, tau, nspread);
+
+  // distribute planes of grid in slow dimension evenly across procs
+
+  klo = me * grid[2] / nprocs;
+  khi = (me + 1) * grid[2] / nprocs - 1;
+  nplane = (bigint) grid[0] * grid[1];
+
+  plane2proc.resize(grid[2]);
+  for (int p = 0; p < nprocs; p++)
+    for (int k = p * grid[2] / nprocs; k < (p + 1) * grid[2] / nprocs; k++) plane2proc[k] = p;
+
+  const bigint nlocal = nplane * (khi - klo + 1);
+  if (2 * nlocal > MAXSMALLINT)
+    error->all(FLERR, "Too many FFT grid points per MPI rank for diffraction grid {}x{}x{}",
+               grid[0], grid[1], grid[2]);
+  slab.resize(nlocal);
+  memory->create(work, 2 * (int) MAX(nlocal, 1), "diffraction:work");
+
+  fft = new FFT3d(lmp, world, grid[0], grid[1], grid[2], 0, grid[0] - 1, 0, grid[1] - 1, klo, khi,
+                  0, grid[0] - 1, 0, grid[1] - 1, klo, khi, 0, 0, &nbuf, 0);
+}
+
+/* ----------------------------------------------------------------------
+   grid size, kernel width and spread of kernel for NMAX reciprocal points
+   and -ln of accuracy LNACC
+------------------------------------------------------------------------- */
+
+void DiffractionFFT::setup_grid(const int *nmax, double lnacc, int *grid, double *tau,
+                                int *nspread)
+{
+  // grid is oversampled by at least 2x, so a narrow kernel is sufficient
+  // kernel width balances the aliasing error of sampling it on the grid
+  // against the error of truncating it after nspread grid points
+
+  for (int d = 0; d < 3; d++) {
+    const int m = 2 * nmax[d] + 1;
+    grid[d] = 2 * m;
+    while (true) {
+      while (!factorable(grid[d])) grid[d]++;
+      tau[d] = lnacc / (4.0 * MY_PI * MY_PI * grid[d] * ((double) grid[d] - m));
+      nspread[d] = 2 * static_cast<int>(ceil(grid[d] * sqrt(4.0 * tau[d] * lnacc)));
+      if (nspread[d] <= grid[d]) break;
+      grid[d]++;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   estimate of memory per proc in bytes for NMAX reciprocal points,
+     requested ACCURACY and NPROCS procs, also return GRID size
+   slab, complex FFT data and FFT buffers of my planes, plus send and
+     receive buffers of spread(), which hold the entire grid if the atoms
+     of a proc touch every plane
+   used by callers to fall back to a direct sum when the grid is too large
+------------------------------------------------------------------------- */
+
+double DiffractionFFT::memory_estimate(const int *nmax, double accuracy, int nprocs, int *grid)
+{
+  double tau[3];
+  int nspread[3];
+  setup_grid(nmax, -log(accuracy), grid, tau, nspread);
+
+  const double ngrid = (double) grid[0] * grid[1] * grid[2];
+  const double nmine = (double) grid[0] * grid[1] * ((grid[2] + nprocs - 1) / nprocs);
+  return nmine * (sizeof(double) + 4 * sizeof(FFT_SCALAR)) + 2.0 * ngrid * sizeof(double);
+}
+
+/* ---------------------------------------------------------------------- */
+
+DiffractionFFT::~DiffractionFFT()
+{
+  delete fft;
+  memory->destroy(work);
+}
+
+/* ----------------------------------------------------------------------
+   N = # of my atoms with positions X and types TYPE (1 to NTYPES)
+   HKL = integer indices of NROWS reciprocal points
+   return structure factor of atoms of each type for each reciprocal point
+     SFAC[2*ntypes*row + 2*(type-1)] = real part, +1 = imaginary part
+     SFAC is only set for rows in my planes and zero otherwise,
+     so summing SFAC across procs gives the structure factor of all atoms
+------------------------------------------------------------------------- */
+
+void DiffractionFFT::compute(int n, const double *x, const int *type, int ntypes, int nrows,
+                             const int *hkl, double *sfac)
+{
+  for (int i = 0; i < 2 * ntypes * nrows; i++) sfac[i] = 0.0;
+
+  // A(h) = conj(FFT(h)) / # of grid points is the Fourier transform of
+  // the spread atoms, divide by transform of kernel to get structure factor
+
+  const double norm = 1.0 /
+      ((double) grid[0] * grid[1] * grid[2] * sqrt(4.0 * MY_PI * tau[0]) *
+       sqrt(4.0 * MY_PI * tau[1]) * sqrt(4.0 * MY_PI * tau[2]));
+  const bigint nlocal = nplane * (khi - klo + 1);
+
+  for (int itype = 1; itype <= ntypes; itype++) {
+    int count = 0, countall;
+    for (int i = 0; i < n; i++)
+      if (type[i] == itype) count++;
+    MPI_Allreduce(&count, &countall, 1, MPI_INT, MPI_SUM, world);
+    if (countall == 0) continue;
+
+    spread(n, x, type, itype);
+
+    for (bigint i = 0; i < nlocal; i++) {
+      work[2 * i] = slab[i];
+      work[2 * i + 1] = 0.0;
+    }
+    fft->compute(work, work, FFT3d::FORWARD);
+
+    for (int r = 0; r < nrows; r++) {
+      const int *index = &hkl[3 * r];
+      int q[3];
+      for (int d = 0; d < 3; d++) q[d] = ((index[d] % grid[d]) + grid[d]) % grid[d];
+      if (q[2] < klo || q[2] > khi) continue;
+
+      const double scale = norm *
+          exp(4.0 * MY_PI * MY_PI *
+              (tau[0] * index[0] * index[0] + tau[1] * index[1] * index[1] +
+               tau[2] * index[2] * index[2]));
+      const bigint m = ((bigint) (q[2] - klo) * grid[1] + q[1]) * grid[0] + q[0];
+      sfac[2 * ntypes * r + 2 * (itype - 1)] = work[2 * m] * scale;
+      sfac[2 * ntypes * r + 2 * (itype - 1) + 1] = -work[2 * m + 1] * scale;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   spread my atoms of type ITYPE to grid and sum values of my planes
+   each proc accumulates the planes its atoms touch and sends them to
+   their owners, so no proc needs to store the entire grid
+------------------------------------------------------------------------- */
+
+void DiffractionFFT::spread(int n, const double *x, const int *type, int itype)
+{
+  std::vector<int> base(3 * n);
+  std::vector<double> frac(3 * n);
+  int half[3];
+  for (int d = 0; d < 3; d++) half[d] = nspread[d] / 2;
+
+  // reduced coordinate of atom in grid units and first grid point it is spread to
+  // reciprocal points have integer indices, so only the coordinate modulo
+  // one period of the grid matters
+
+  for (int i = 0; i < n; i++) {
+    if (type[i] != itype) continue;
+    for (int d = 0; d < 3; d++) {
+      double u = x[3 * i + d] * dK[d];
+      u -= floor(u);
+      const double s = u * grid[d];
+      int g = static_cast<int>(s);
+      if (g >= grid[d]) g -= grid[d];
+      base[3 * i + d] = g - half[d] + 1;
+      frac[3 * i + d] = s;
+    }
+  }
+
+  // planes touched by my atoms in ascending order, grouped by owner
+
+  std::vector<int> planeindex(grid[2], -1);
+  for (int i = 0; i < n; i++) {
+    if (type[i] != itype) continue;
+    for (int o = 0; o < nspread[2]; o++)
+      planeindex[((base[3 * i + 2] + o) % grid[2] + grid[2]) % grid[2]] = 0;
+  }
+
+  std::vector<int> sendcounts(nprocs, 0), recvcounts(nprocs), sdispls(nprocs), rdispls(nprocs);
+  int ntouch = 0;
+  for (int k = 0; k < grid[2]; k++) {
+    if (planeindex[k] < 0) continue;
+    planeindex[k] = ntouch++;
+    sendcounts[plane2proc[k]] += (int) nplane + 1;
+  }
+
+  // each plane is sent with its index as header
+
+  const bigint stride = nplane + 1;
+  std::vector<double> sendbuf(ntouch * stride, 0.0);
+  for (int k = 0; k < grid[2]; k++)
+    if (planeindex[k] >= 0) sendbuf[(bigint) planeindex[k] * stride] = k;
+
+  std::vector<double> w0(nspread[0]), w1(nspread[1]), w2(nspread[2]);
+  std::vector<int> i0(nspread[0]), i1(nspread[1]), i2(nspread[2]);
+
+  for (int i = 0; i < n; i++) {
+    if (type[i] != itype) continue;
+    for (int o = 0; o < nspread[0]; o++) {
+      const int m = base[3 * i] + o;
+      const double dist = (m - frac[3 * i]) / grid[0];
+      w0[o] = exp(-dist * dist / (4.0 * tau[0]));
+      i0[o] = (m % grid[0] + grid[0]) % grid[0];
+    }
+    for (int o = 0; o < nspread[1]; o++) {
+      const int m = base[3 * i + 1] + o;
+      const double dist = (m - frac[3 * i + 1]) / grid[1];
+      w1[o] = exp(-dist * dist / (4.0 * tau[1]));
+      i1[o] = (m % grid[1] + grid[1]) % grid[1];
+    }
+    for (int o = 0; o < nspread[2]; o++) {
+      const int m = base[3 * i + 2] + o;
+      const double dist = (m - frac[3 * i + 2]) / grid[2];
+      w2[o] = exp(-dist * dist / (4.0 * tau[2]));
+      i2[o] = (m % grid[2] + grid[2]) % grid[2];
+    }
+
+    for (int o2 = 0; o2 < nspread[2]; o2++) {
+      double *plane = &sendbuf[(bigint) planeindex[i2[o2]] * stride + 1];
+      for (int o1 = 0; o1 < nspread[1]; o1++) {
+        double *row = plane + i1[o1] * grid[0];
+        const double w12 = w2[o2] * w1[o1];
+        for (int o0 = 0; o0 < nspread[0]; o0++) row[i0[o0]] += w12 * w0[o0];
+      }
+    }
+  }
+
+  // send planes to their owners and sum them into my slab
+
+  MPI_Alltoall(sendcounts.data(), 1, MPI_INT, recvcounts.data(), 1, MPI_INT, world);
+  int nrecv = 0;
+  for (int p = 0; p < nprocs; p++) {
+    sdispls[p] = (p > 0) ? sdispls[p - 1] + sendcounts[p - 1] : 0;
+    rdispls[p] = nrecv;
+    nrecv += recvcounts[p];
+  }
+
+  std::vector<double> recvbuf(nrecv);
+  MPI_Alltoallv(sendbuf.data(), sendcounts.data(), sdispls.data(), MPI_DOUBLE, recvbuf.data(),
+                recvcounts.data(), rdispls.data(), MPI_DOUBLE, world);
+
+  std::fill(slab.begin(), slab.end(), 0.0);
+  for (bigint m = 0; m < nrecv; m += stride) {
+    const int k = static_cast<int>(recvbuf[m]);
+    double *dest = &slab[(k - klo) * nplane];
+    const double *src = &recvbuf[m + 1];
+    for (bigint j = 0; j < nplane; j++) dest[j] += src[j];
+  }
+}
+
+/* ----------------------------------------------------------------------
+   check if n is a product of small primes only
+------------------------------------------------------------------------- */
+
+int DiffractionFFT::factorable(int n)
+{
+  const int factors[3] = {2, 3, 5};
+  for (int f : factors)
+    while (n % f == 0) n /= f;
+  return n == 1;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double DiffractionFFT::memory_usage()
+{
+  double bytes = (double) slab.capacity() * sizeof(double);
+  bytes += 2.0 * nplane * (khi - klo + 1) * sizeof(FFT_SCALAR);
+  bytes += (double) nbuf * sizeof(FFT_SCALAR);
+  bytes += (double) plane2proc.capacity() * sizeof(int);
+  return bytes;
+}
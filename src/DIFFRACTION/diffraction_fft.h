@@ -0,0 +1,66 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_DIFFRACTION_FFT_H
+#define LMP_DIFFRACTION_FFT_H
+
+#include "pointers.h"
+
+#include "lmpfftsettings.h"
+
+#include <vector>
+
+namespace LAMMPS_NS {
+
+// structure factors of all atoms of each type on a lattice of
+// reciprocal points K = (h*dK[0], k*dK[1], l*dK[2]) with |h| <= nmax[0] etc
+// computed as non-uniform FFT: atoms are spread to a periodic grid with
+// a Gaussian kernel, the grid is transformed with the KSPACE FFTs, and
+// the result is divided by the Fourier transform of the kernel
+
+class DiffractionFFT : protected Pointers {
+ public:
+  DiffractionFFT(class LAMMPS *, const int *, const double *, double);
+  ~DiffractionFFT() override;
+  void compute(int, const double *, const int *, int, int, const int *, double *);
+  double memory_usage();
+
+  static double memory_estimate(const int *, double, int, int *);
+  static constexpr double MAXBYTES = 2.0 * 1024 * 1024 * 1024;    // max estimate per proc
+
+  int grid[3];    // FFT grid size in each dimension
+
+ private:
+  int me, nprocs;
+  int nmax[3];        // max index of reciprocal points in each dimension
+  double dK[3];       // spacing of reciprocal points
+  double tau[3];      // variance/2 of Gaussian kernel in units of grid period
+  int nspread[3];     // # of grid points each atom is spread to per dimension
+  double lnacc;       // -ln of requested accuracy
+  int klo, khi;       // my planes of the grid in slow dimension
+  bigint nplane;      // # of grid values in one plane
+  int nbuf;
+
+  std::vector<int> plane2proc;    // owner of each plane
+  std::vector<double> slab;       // summed grid values of my planes
+  FFT_SCALAR *work;               // complex FFT data of my planes
+  class FFT3d *fft;
+
+  void spread(int, const double *, const int *, int);
+  static void setup_grid(const int *, double, int *, double *, int *);
+  static int factorable(int);
+};
+
+}    // namespace LAMMPS_NS
+
+#endif
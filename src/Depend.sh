@@ -114,6 +114,7 @@ if (test $1 = "KSPACE") then
   depend CG-SPICA
   depend CORESHELL
   depend DIELECTRIC
+  depend DIFFRACTION
   depend GPU
   depend KOKKOS
   depend OPT
@@ -115,6 +115,9 @@ void PPPMElectrode::init()
   // error check
   if (slabflag == 3)
     error->all(FLERR, "Cannot (yet) use PPPM/electrode with 'kspace_modify slab ew2d'");
+  if (fft_procs || fft_pipeline || fft_tune)
+    error->all(FLERR, "Cannot (yet) use PPPM/electrode with 'kspace_modify fft/procs', "
+               "'fft/pipeline', or 'fft/tune'");
 
   triclinic_check();
   triclinic = domain->triclinic;
@@ -32,6 +32,7 @@ ComputeTempKokkos<DeviceType>::ComputeTempKokkos(LAMMPS *lmp, int narg, char **a
   ComputeTemp(lmp, narg, arg)
 {
   kokkosable = 1;
+  size_scalar_partial = size_vector_partial = 0;
   atomKK = (AtomKokkos *) atom;
   execution_space = ExecutionSpaceFromDevice<DeviceType>::space;
 
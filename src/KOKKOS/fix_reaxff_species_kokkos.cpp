@@ -64,13 +64,7 @@ void FixReaxFFSpeciesKokkos::init()
 
 void FixReaxFFSpeciesKokkos::FindMolecule()
 {
-  int i,j,ii,jj,inum,itype,jtype,loop,looptot;
-  int change,done,anychange;
-  int *mask = atom->mask;
-  double bo_tmp,bo_cut;
-  double **spec_atom = f_SPECBOND->array_atom;
-
-  inum = reaxff->list->inum;
+  int inum = reaxff->list->inum;
   typename ArrayTypes<LMPHostType>::t_int_1d ilist;
   if (reaxff->execution_space == Host) {
     NeighListKokkos<LMPHostType>* k_list = static_cast<NeighListKokkos<LMPHostType>*>(reaxff->list);
@@ -82,60 +76,5 @@ void FixReaxFFSpeciesKokkos::FindMolecule()
     ilist = k_list->k_ilist.h_view;
   }
 
-  for (ii = 0; ii < inum; ii++) {
-    i = ilist[ii];
-    if (mask[i] & groupbit) {
-      clusterID[i] = atom->tag[i];
-      x0[i].x = spec_atom[i][1];
-      x0[i].y = spec_atom[i][2];
-      x0[i].z = spec_atom[i][3];
-    }
-    else clusterID[i] = 0.0;
-  }
-
-  loop = 0;
-  while (true) {
-    comm->forward_comm(this);
-    loop ++;
-
-    change = 0;
-    while (true) {
-      done = 1;
-
-      for (ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
-
-        itype = atom->type[i];
-
-        for (jj = 0; jj < MAXSPECBOND; jj++) {
-          j = reaxff->tmpid[i][jj];
-
-          if ((j == 0) && (j < i)) continue;
-          if (!(mask[j] & groupbit)) continue;
-
-          if (clusterID[i] == clusterID[j]
-            && x0[i].x == x0[j].x && x0[i].y == x0[j].y && x0[i].z == x0[j].z) continue;
-
-          jtype = atom->type[j];
-          bo_cut = BOCut[itype][jtype];
-          bo_tmp = spec_atom[i][jj+7];
-
-          if (bo_tmp > bo_cut) {
-            clusterID[i] = clusterID[j] = MIN(clusterID[i], clusterID[j]);
-            x0[i] = x0[j] = chAnchor(x0[i], x0[j]);
-            done = 0;
-          }
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
-    }
-    MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
-    if (!anychange) break;
-
-    MPI_Allreduce(&loop,&looptot,1,MPI_INT,MPI_SUM,world);
-    if (looptot >= 400*comm->nprocs) break;
-
-  }
+  MergeMolecules(inum, ilist.data());
 }
@@ -40,6 +40,8 @@ MLIAPDescriptorSO3Kokkos<DeviceType>::MLIAPDescriptorSO3Kokkos(LAMMPS *lmp, char
  // TODO: why take self as param, shouldn't be needed
   :  Pointers(lmp), MLIAPDescriptorSO3(lmp, paramfilename), MLIAPDescriptorKokkos<DeviceType>(lmp, this)
 {
+  if (ntable > 0) error->all(FLERR, "SO3 ntable keyword is not supported by the KOKKOS package");
+
   // TODO: the MLIAP_SO3 object likely needs a kokkos-ified version
   so3ptr_kokkos = new MLIAP_SO3Kokkos<DeviceType>(lmp, rcutfac, lmax, nmax, alpha);
 }
@@ -432,6 +432,9 @@ void PairPACEExtrapolationKokkos<DeviceType>::init_style()
     return;
   }
 
+  if (uncertain_flag)
+    error->all(FLERR, "Pair style pace/extrapolation/kk uncertain keyword requires running on the host");
+
   if (atom->tag_enable == 0) error->all(FLERR, "Pair style PACE requires atom IDs");
   if (force->newton_pair == 0) error->all(FLERR, "Pair style PACE requires newton pair on");
 
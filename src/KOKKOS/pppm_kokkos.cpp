@@ -144,6 +144,9 @@ void PPPMKokkos<DeviceType>::init()
 
   if (differentiation_flag == 1)
     error->all(FLERR,"Cannot (yet) use PPPM Kokkos with 'kspace_modify diff ad'");
+  if (fft_procs || fft_pipeline || fft_tune)
+    error->all(FLERR,"Cannot (yet) use PPPM Kokkos with 'kspace_modify fft/procs', "
+               "'fft/pipeline', or 'fft/tune'");
 
   triclinic_check();
 
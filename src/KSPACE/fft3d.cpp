@@ -24,8 +24,9 @@
 
 #include "remap.h"
 
-#include <cstdlib>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 
 #if defined(_OPENMP)
 #include <omp.h>
@@ -39,6 +40,10 @@
 #define MIN(A,B) ((A) < (B) ? (A) : (B))
 #define MAX(A,B) ((A) > (B) ? (A) : (B))
 
+static void fft_1d_range(FFT_DATA *, int, int, int, int, struct fft_plan_3d *);
+static void fft_1d_remap(FFT_DATA *, FFT_DATA *, int, int, struct remap_plan_3d *,
+                         struct fft_plan_3d *);
+
 /* ----------------------------------------------------------------------
    Data layout for 3d FFTs:
 
@@ -77,14 +82,6 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
 #endif
   FFT_DATA *data,*copy;
 
-  // system specific constants
-
-#if defined(FFT_FFTW3)
-  FFTW_API(plan) theplan;
-#else
-  // nothing to do for other FFTs
-#endif
-
   // pre-remap to prepare for 1st FFTs if needed
   // copy = loc for remap result
 
@@ -99,104 +96,31 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
     data = in;
 
   // 1d FFTs along fast axis
-
-#if defined(FFT_MKL)
-  if (flag == 1)
-    DftiComputeForward(plan->handle_fast,data);
-  else
-    DftiComputeBackward(plan->handle_fast,data);
-#elif defined(FFT_FFTW3)
-  if (flag == 1)
-    theplan=plan->plan_fast_forward;
-  else
-    theplan=plan->plan_fast_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
-#else
-  int total = plan->total1;
-  int length = plan->length1;
-
-  if (flag == 1)
-    for (int offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_fast_forward,&data[offset],&data[offset]);
-  else
-    for (int offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_fast_backward,&data[offset],&data[offset]);
-#endif
-
   // 1st mid-remap to prepare for 2nd FFTs
   // copy = loc for remap result
 
   if (plan->mid1_target == 0) copy = out;
   else copy = plan->copy;
-  remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) copy,
-           (FFT_SCALAR *) plan->scratch, plan->mid1_plan);
+  fft_1d_remap(data,copy,0,flag,plan->mid1_plan,plan);
   data = copy;
 
   // 1d FFTs along mid axis
-
-#if defined(FFT_MKL)
-  if (flag == 1)
-    DftiComputeForward(plan->handle_mid,data);
-  else
-    DftiComputeBackward(plan->handle_mid,data);
-#elif defined(FFT_FFTW3)
-  if (flag == 1)
-    theplan=plan->plan_mid_forward;
-  else
-    theplan=plan->plan_mid_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
-#else
-  total = plan->total2;
-  length = plan->length2;
-
-  if (flag == 1)
-    for (int offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_mid_forward,&data[offset],&data[offset]);
-  else
-    for (int offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_mid_backward,&data[offset],&data[offset]);
-#endif
-
   // 2nd mid-remap to prepare for 3rd FFTs
   // copy = loc for remap result
 
   if (plan->mid2_target == 0) copy = out;
   else copy = plan->copy;
-  remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) copy,
-           (FFT_SCALAR *) plan->scratch, plan->mid2_plan);
+  fft_1d_remap(data,copy,1,flag,plan->mid2_plan,plan);
   data = copy;
 
   // 1d FFTs along slow axis
-
-#if defined(FFT_MKL)
-  if (flag == 1)
-    DftiComputeForward(plan->handle_slow,data);
-  else
-    DftiComputeBackward(plan->handle_slow,data);
-#elif defined(FFT_FFTW3)
-  if (flag == 1)
-    theplan=plan->plan_slow_forward;
-  else
-    theplan=plan->plan_slow_backward;
-  FFTW_API(execute_dft)(theplan,data,data);
-#else
-  total = plan->total3;
-  length = plan->length3;
-
-  if (flag == 1)
-    for (int offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_slow_forward,&data[offset],&data[offset]);
-  else
-    for (int offset = 0; offset < total; offset += length)
-      kiss_fft(plan->cfg_slow_backward,&data[offset],&data[offset]);
-#endif
-
   // post-remap to put data in output format if needed
   // destination is always out
 
   if (plan->post_plan)
-    remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) out,
-             (FFT_SCALAR *) plan->scratch, plan->post_plan);
+    fft_1d_remap(data,out,2,flag,plan->post_plan,plan);
+  else
+    fft_1d_range(data,2,flag,0,plan->total3/plan->length3,plan);
 
   // scaling if required
 
@@ -221,6 +145,111 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
   }
 }
 
+/* ----------------------------------------------------------------------
+   perform 1d FFTs first to last-1 of one set of 1d FFTs of a 3d FFT
+   stage = 0,1,2 for 1d FFTs along fast,mid,slow axis
+------------------------------------------------------------------------- */
+
+static void fft_1d_range(FFT_DATA *data, int stage, int flag, int first, int last,
+                         struct fft_plan_3d *plan)
+{
+  if (first >= last) return;
+
+  int length;
+  if (stage == 0) length = plan->length1;
+  else if (stage == 1) length = plan->length2;
+  else length = plan->length3;
+
+#if defined(FFT_MKL)
+  // the descriptors encode the # of transforms, so do all of them at once
+
+  if (first > 0) return;
+
+  DFTI_DESCRIPTOR *handle;
+  if (stage == 0) handle = plan->handle_fast;
+  else if (stage == 1) handle = plan->handle_mid;
+  else handle = plan->handle_slow;
+
+  if (flag == 1)
+    DftiComputeForward(handle,data);
+  else
+    DftiComputeBackward(handle,data);
+#elif defined(FFT_FFTW3)
+  FFTW_API(plan) theplan;
+  int total;
+  if (stage == 0) total = plan->total1;
+  else if (stage == 1) total = plan->total2;
+  else total = plan->total3;
+
+  if (first == 0 && last*length == total) {
+    if (stage == 0)
+      theplan = (flag == 1) ? plan->plan_fast_forward : plan->plan_fast_backward;
+    else if (stage == 1)
+      theplan = (flag == 1) ? plan->plan_mid_forward : plan->plan_mid_backward;
+    else
+      theplan = (flag == 1) ? plan->plan_slow_forward : plan->plan_slow_backward;
+    FFTW_API(execute_dft)(theplan,data,data);
+  } else {
+    theplan = plan->plan_single[2*stage + ((flag == 1) ? 0 : 1)];
+    for (int offset = first*length; offset < last*length; offset += length)
+      FFTW_API(execute_dft)(theplan,&data[offset],&data[offset]);
+  }
+#else
+  kiss_fft_cfg cfg;
+  if (stage == 0)
+    cfg = (flag == 1) ? plan->cfg_fast_forward : plan->cfg_fast_backward;
+  else if (stage == 1)
+    cfg = (flag == 1) ? plan->cfg_mid_forward : plan->cfg_mid_backward;
+  else
+    cfg = (flag == 1) ? plan->cfg_slow_forward : plan->cfg_slow_backward;
+
+  for (int offset = first*length; offset < last*length; offset += length)
+    kiss_fft(cfg,&data[offset],&data[offset]);
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   perform one set of 1d FFTs and the remap that follows it
+   if pipelined, each message of the remap is sent as soon as the
+     1d FFTs it depends on are done, so communication overlaps with
+     the remaining 1d FFTs
+------------------------------------------------------------------------- */
+
+static void fft_1d_remap(FFT_DATA *data, FFT_DATA *copy, int stage, int flag,
+                         struct remap_plan_3d *remap, struct fft_plan_3d *plan)
+{
+  int nfft;
+  if (stage == 0) nfft = plan->total1/plan->length1;
+  else if (stage == 1) nfft = plan->total2/plan->length2;
+  else nfft = plan->total3/plan->length3;
+
+  if (!plan->pipeline || !plan->send_order[stage]) {
+    fft_1d_range(data,stage,flag,0,nfft,plan);
+    remap_3d((FFT_SCALAR *) data, (FFT_SCALAR *) copy,
+             (FFT_SCALAR *) plan->scratch, remap);
+    return;
+  }
+
+  int *order = plan->send_order[stage];
+  int *need = plan->send_need[stage];
+  int done = 0;
+
+  remap_3d_begin((FFT_SCALAR *) plan->scratch, remap);
+
+  for (int m = 0; m < remap->nsend; m++) {
+    int isend = order[m];
+    if (need[isend] > done) {
+      fft_1d_range(data,stage,flag,done,need[isend],plan);
+      done = need[isend];
+    }
+    remap_3d_isend((FFT_SCALAR *) data, isend, remap);
+  }
+
+  fft_1d_range(data,stage,flag,done,nfft,plan);
+  remap_3d_end((FFT_SCALAR *) data, (FFT_SCALAR *) copy,
+               (FFT_SCALAR *) plan->scratch, remap);
+}
+
 /* ----------------------------------------------------------------------
    Create plan for performing a 3d FFT
 
@@ -240,6 +269,8 @@ void fft_3d(FFT_DATA *in, FFT_DATA *out, int flag, struct fft_plan_3d *plan)
                           2 = permute twice = slow->fast, fast->mid, mid->slow
    nbuf                 returns size of internal storage buffers used by FFT
    usecollective        use collective MPI operations for remapping data
+   nprocs_fft           # of procs that own data between the 1st and last
+                          remap, see fft_3d_subset_rank(), 0 = all procs
 ------------------------------------------------------------------------- */
 
 struct fft_plan_3d *fft_3d_create_plan(
@@ -248,10 +279,10 @@ struct fft_plan_3d *fft_3d_create_plan(
        int in_klo, int in_khi,
        int out_ilo, int out_ihi, int out_jlo, int out_jhi,
        int out_klo, int out_khi,
-       int scaled, int permute, int *nbuf, int usecollective)
+       int scaled, int permute, int *nbuf, int usecollective, int nprocs_fft)
 {
   struct fft_plan_3d *plan;
-  int me,nprocs,nthreads;
+  int me,nprocs,nthreads,me_fft;
   int flag,remapflag;
   int first_ilo,first_ihi,first_jlo,first_jhi,first_klo,first_khi;
   int second_ilo,second_ihi,second_jlo,second_jhi,second_klo,second_khi;
@@ -273,16 +304,30 @@ struct fft_plan_3d *fft_3d_create_plan(
 #endif
 
   // compute division of procs in 2 dimensions not on-processor
+  // only the subset of nprocs_fft procs takes part in it,
+  //   the other procs own no data in the intermediate decompositions
 
-  bifactor(nprocs,&np1,&np2);
-  ip1 = me % np1;
-  ip2 = me/np1;
+  if (nprocs_fft <= 0 || nprocs_fft > nprocs) nprocs_fft = nprocs;
+  me_fft = fft_3d_subset_rank(me,nprocs,nprocs_fft);
+
+  bifactor(nprocs_fft,&np1,&np2);
+  ip1 = me_fft % np1;
+  ip2 = me_fft/np1;
 
   // allocate memory for plan data struct
 
   plan = (struct fft_plan_3d *) malloc(sizeof(struct fft_plan_3d));
   if (plan == nullptr) return nullptr;
 
+  plan->pipeline = 0;
+  for (int i = 0; i < 3; i++) {
+    plan->send_order[i] = nullptr;
+    plan->send_need[i] = nullptr;
+  }
+#if defined(FFT_FFTW3)
+  for (int i = 0; i < 6; i++) plan->plan_single[i] = nullptr;
+#endif
+
   // remap from initial distribution to layout needed for 1st set of 1d FFTs
   // not needed if all procs own entire fast axis initially
   // first indices = distribution after 1st set of FFTs
@@ -309,6 +354,7 @@ struct fft_plan_3d *fft_3d_create_plan(
     first_jhi = (ip1+1)*nmid/np1 - 1;
     first_klo = ip2*nslow/np2;
     first_khi = (ip2+1)*nslow/np2 - 1;
+    if (me_fft < 0) first_khi = first_klo - 1;
     plan->pre_plan = remap_3d_create_plan(comm,in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
                                           first_ilo,first_ihi,first_jlo,first_jhi,
                                           first_klo,first_khi,2,0,0,FFT_PRECISION,0);
@@ -330,6 +376,7 @@ struct fft_plan_3d *fft_3d_create_plan(
   second_jhi = nmid - 1;
   second_klo = ip2*nslow/np2;
   second_khi = (ip2+1)*nslow/np2 - 1;
+  if (me_fft < 0) second_khi = second_klo - 1;
   plan->mid1_plan = remap_3d_create_plan(comm, first_ilo,first_ihi,first_jlo,first_jhi,
                                          first_klo,first_khi,second_ilo,second_ihi,
                                          second_jlo,second_jhi,second_klo,second_khi,
@@ -367,6 +414,7 @@ struct fft_plan_3d *fft_3d_create_plan(
     third_jhi = (ip2+1)*nmid/np2 - 1;
     third_klo = 0;
     third_khi = nslow - 1;
+    if (me_fft < 0) third_jhi = third_jlo - 1;
   }
 
   plan->mid2_plan =
@@ -620,6 +668,8 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   FFTW_API(destroy_plan)(plan->plan_mid_backward);
   FFTW_API(destroy_plan)(plan->plan_fast_forward);
   FFTW_API(destroy_plan)(plan->plan_fast_backward);
+  for (int i = 0; i < 6; i++)
+    if (plan->plan_single[i]) FFTW_API(destroy_plan)(plan->plan_single[i]);
 #if defined(FFT_FFTW_THREADS)
   FFTW_API(cleanup_threads)();
 #endif
@@ -637,9 +687,100 @@ void fft_3d_destroy_plan(struct fft_plan_3d *plan)
   free(plan->cfg_fast_backward);
 #endif
 
+  for (int i = 0; i < 3; i++) {
+    if (plan->send_order[i]) free(plan->send_order[i]);
+    if (plan->send_need[i]) free(plan->send_need[i]);
+  }
+
   free(plan);
 }
 
+/* ----------------------------------------------------------------------
+   Enable or disable overlap of 1d FFTs with the remaps that follow them
+
+   Arguments:
+   plan         plan returned by previous call to fft_3d_create_plan
+   flag         1 to enable, 0 to disable
+
+   remaps that use collectives are not affected
+   return 1 on success, 0 if memory could not be allocated
+------------------------------------------------------------------------- */
+
+int fft_3d_pipeline(struct fft_plan_3d *plan, int flag)
+{
+  plan->pipeline = 0;
+  if (flag == 0) return 1;
+
+  struct remap_plan_3d *remaps[3] = {plan->mid1_plan, plan->mid2_plan, plan->post_plan};
+  int lengths[3] = {plan->length1, plan->length2, plan->length3};
+
+  for (int stage = 0; stage < 3; stage++) {
+    struct remap_plan_3d *remap = remaps[stage];
+    if (remap == nullptr || plan->send_order[stage]) continue;
+    if (remap->usecollective) continue;
+    if (remap_3d_nonblocking(remap) == 0) return 0;
+
+    // # of 1d FFTs each message depends on, 2 datums per complex value
+    // messages are sent in order of increasing dependency
+
+    int nsend = remap->nsend;
+    int *order = (int *) malloc((nsend+1)*sizeof(int));
+    int *need = (int *) malloc((nsend+1)*sizeof(int));
+    if (order == nullptr || need == nullptr) return 0;
+
+    for (int isend = 0; isend < nsend; isend++) {
+      need[isend] = remap_3d_send_last(remap,isend)/(2*lengths[stage]) + 1;
+
+      int m = isend;
+      while (m > 0 && need[order[m-1]] > need[isend]) {
+        order[m] = order[m-1];
+        m--;
+      }
+      order[m] = isend;
+    }
+
+    plan->send_order[stage] = order;
+    plan->send_need[stage] = need;
+  }
+
+#if defined(FFT_FFTW3)
+  for (int stage = 0; stage < 3; stage++) {
+    if (plan->plan_single[2*stage]) continue;
+    plan->plan_single[2*stage] =
+      FFTW_API(plan_dft_1d)(lengths[stage],nullptr,nullptr,FFTW_FORWARD,
+                            FFTW_ESTIMATE | FFTW_UNALIGNED);
+    plan->plan_single[2*stage+1] =
+      FFTW_API(plan_dft_1d)(lengths[stage],nullptr,nullptr,FFTW_BACKWARD,
+                            FFTW_ESTIMATE | FFTW_UNALIGNED);
+  }
+#endif
+
+  plan->pipeline = 1;
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   Map a proc to its rank within a subset of nsubset procs
+   the subset is spread evenly over all procs, so that the procs doing
+     the FFTs are not all on the same nodes
+
+   Arguments:
+   me           rank of proc in communicator
+   nprocs       # of procs in communicator
+   nsubset      # of procs in subset
+
+   return rank within subset, -1 if proc is not part of it
+------------------------------------------------------------------------- */
+
+int fft_3d_subset_rank(int me, int nprocs, int nsubset)
+{
+  if (nsubset <= 0 || nsubset >= nprocs) return me;
+
+  int64_t k = ((int64_t) me*nsubset + nprocs - 1) / nprocs;
+  if (k < nsubset && k*nprocs/nsubset == me) return (int) k;
+  return -1;
+}
+
 /* ----------------------------------------------------------------------
    recursively divide n into small factors, return them in list
 ------------------------------------------------------------------------- */
@@ -102,6 +102,11 @@ struct fft_plan_3d {
   int scaled;     // whether to scale FFT results
   int normnum;    // # of values to rescale
   double norm;    // normalization factor for rescaling
+  int pipeline;   // 1 if 1d FFTs are overlapped with the following remap
+
+  // pipelined remaps after 1st,2nd,3rd FFTs
+  int *send_order[3];    // order in which messages are sent
+  int *send_need[3];     // # of 1d FFTs that must be done before each send
 
   // system specific 1d FFT info
 #if defined(FFT_MKL)
@@ -115,6 +120,7 @@ struct fft_plan_3d {
   FFTW_API(plan) plan_mid_backward;
   FFTW_API(plan) plan_slow_forward;
   FFTW_API(plan) plan_slow_backward;
+  FFTW_API(plan) plan_single[6];    // single 1d FFTs for pipelining
 #elif defined(FFT_KISS)
   kiss_fft_cfg cfg_fast_forward;
   kiss_fft_cfg cfg_fast_backward;
@@ -130,8 +136,10 @@ struct fft_plan_3d {
 extern "C" {
 void fft_3d(FFT_DATA *, FFT_DATA *, int, struct fft_plan_3d *);
 struct fft_plan_3d *fft_3d_create_plan(MPI_Comm, int, int, int, int, int, int, int, int, int, int,
-                                       int, int, int, int, int, int, int, int *, int);
+                                       int, int, int, int, int, int, int, int *, int, int);
 void fft_3d_destroy_plan(struct fft_plan_3d *);
+int fft_3d_pipeline(struct fft_plan_3d *, int);
+int fft_3d_subset_rank(int, int, int);
 void factor(int, int *, int *);
 void bifactor(int, int *, int *);
 void fft_1d_only(FFT_DATA *, int, int, struct fft_plan_3d *);
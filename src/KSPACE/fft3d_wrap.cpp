@@ -25,12 +25,13 @@ FFT3d::FFT3d(LAMMPS *lmp, MPI_Comm comm, int nfast, int nmid, int nslow,
              int in_klo, int in_khi,
              int out_ilo, int out_ihi, int out_jlo, int out_jhi,
              int out_klo, int out_khi,
-             int scaled, int permute, int *nbuf, int usecollective) : Pointers(lmp)
+             int scaled, int permute, int *nbuf, int usecollective,
+             int nprocs_fft) : Pointers(lmp)
 {
   plan = fft_3d_create_plan(comm,nfast,nmid,nslow,
                             in_ilo,in_ihi,in_jlo,in_jhi,in_klo,in_khi,
                             out_ilo,out_ihi,out_jlo,out_jhi,out_klo,out_khi,
-                            scaled,permute,nbuf,usecollective);
+                            scaled,permute,nbuf,usecollective,nprocs_fft);
   if (plan == nullptr) error->one(FLERR,"Could not create 3d FFT plan");
 }
 
@@ -54,3 +55,12 @@ void FFT3d::timing1d(FFT_SCALAR *in, int nsize, int flag)
 {
   fft_1d_only((FFT_DATA *) in,nsize,flag,plan);
 }
+
+/* ----------------------------------------------------------------------
+   overlap 1d FFTs with the point-to-point remaps that follow them
+------------------------------------------------------------------------- */
+
+void FFT3d::set_pipeline(int flag)
+{
+  if (fft_3d_pipeline(plan,flag) == 0) error->one(FLERR,"Could not create pipelined 3d FFT plan");
+}
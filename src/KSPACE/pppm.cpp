@@ -50,6 +50,7 @@ using namespace MathSpecial;
 #define LARGE 10000.0
 #define SMALL 0.00001
 #define EPS_HOC 1.0e-7
+#define NTUNE 5
 
 enum{REVERSE_RHO};
 enum{FORWARD_IK,FORWARD_AD,FORWARD_IK_PERATOM,FORWARD_AD_PERATOM};
@@ -73,6 +74,7 @@ PPPM::PPPM(LAMMPS *lmp) : KSpace(lmp),
   sf_precoeff1(nullptr), sf_precoeff2(nullptr), sf_precoeff3(nullptr),
   sf_precoeff4(nullptr), sf_precoeff5(nullptr), sf_precoeff6(nullptr),
   acons(nullptr), fft1(nullptr), fft2(nullptr), remap(nullptr), gc(nullptr),
+  fft1_save(nullptr), fft2_save(nullptr), remap_save(nullptr), greensfn_save(nullptr),
   gc_buf1(nullptr), gc_buf2(nullptr), density_A_brick(nullptr), density_B_brick(nullptr), density_A_fft(nullptr),
   density_B_fft(nullptr), part2grid(nullptr), boxlo(nullptr)
 {
@@ -93,6 +95,7 @@ PPPM::PPPM(LAMMPS *lmp) : KSpace(lmp),
   MPI_Comm_size(world,&nprocs);
 
   nfft_both = 0;
+  tuned_grid[0] = tuned_grid[1] = tuned_grid[2] = 0;
   nxhi_in = nxlo_in = nxhi_out = nxlo_out = 0;
   nyhi_in = nylo_in = nyhi_out = nylo_out = 0;
   nzhi_in = nzlo_in = nzhi_out = nzlo_out = 0;
@@ -120,6 +123,11 @@ PPPM::PPPM(LAMMPS *lmp) : KSpace(lmp),
   gc = nullptr;
   gc_buf1 = gc_buf2 = nullptr;
 
+  fft1_save = fft2_save = nullptr;
+  remap_save = nullptr;
+  greensfn_save = nullptr;
+  gf_valid = 0;
+
   nmax = 0;
   part2grid = nullptr;
 
@@ -180,6 +188,7 @@ PPPM::~PPPM()
 
   delete [] factors;
   PPPM::deallocate();
+  free_saved();
   if (peratom_allocate_flag) PPPM::deallocate_peratom();
   if (group_allocate_flag) PPPM::deallocate_groups();
   memory->destroy(part2grid);
@@ -340,6 +349,12 @@ void PPPM::init()
 
   double estimated_accuracy = final_accuracy();
 
+  // choose FFT procs and pipelining by timing the candidates
+  // only once per grid, later runs with the same grid keep the choice
+
+  if (fft_tune && (nx_pppm != tuned_grid[0] || ny_pppm != tuned_grid[1] ||
+                   nz_pppm != tuned_grid[2])) tune_fft();
+
   // allocate K-space dependent memory
   // don't invoke allocate peratom() or group(), will be allocated when needed
 
@@ -369,6 +384,9 @@ void PPPM::init()
     mesg += "  using " LMP_FFT_PREC " precision " LMP_FFT_LIB "\n";
     mesg += fmt::format("  3d grid and FFT values/proc = {} {}\n",
                        ngrid_max,nfft_both_max);
+    if (fft_procs || fft_pipeline || fft_tune)
+      mesg += fmt::format("  FFT procs = {}, pipelined FFT remaps = {}\n",
+                          fft_procs ? fft_procs : nprocs,fft_pipeline ? "yes" : "no");
     utils::logmesg(lmp,mesg);
   }
 }
@@ -469,8 +487,18 @@ void PPPM::setup()
     }
   }
 
+  // Green's function only depends on box, G-ewald and order
+  // skip recomputing it, if they are unchanged, e.g. in a new run
+
+  const double info[NGFINFO] = {xprd, yprd, zprd_slab, g_ewald, (double) order,
+                                (double) differentiation_flag};
+  if (gf_valid && (memcmp(info,gfinfo,sizeof(info)) == 0)) return;
+
   if (differentiation_flag == 1) compute_gf_ad();
   else compute_gf_ik();
+
+  memcpy(gfinfo,info,sizeof(info));
+  gf_valid = 1;
 }
 
 /* ----------------------------------------------------------------------
@@ -551,7 +579,11 @@ void PPPM::setup_triclinic()
     }
   }
 
+  // always recompute the Green's function for a triclinic box
+  // gfinfo does not store the tilt, so a later orthogonal setup() must not reuse it
+
   compute_gf_ik_triclinic();
+  gf_valid = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -793,7 +825,6 @@ void PPPM::allocate()
                           nxlo_out,nxhi_out,"pppm:density_brick");
 
   memory->create(density_fft,nfft_both,"pppm:density_fft");
-  memory->create(greensfn,nfft_both,"pppm:greensfn");
   memory->create(work1,2*nfft_both,"pppm:work1");
   memory->create(work2,2*nfft_both,"pppm:work2");
   memory->create(vg,nfft_both,6,"pppm:vg");
@@ -838,6 +869,31 @@ void PPPM::allocate()
   memory->create2d_offset(drho_coeff,order,(1-order)/2,order/2,
                           "pppm:drho_coeff");
 
+  // reuse FFTs, remap and Green's function kept by deallocate()
+  //   if grid and FFT decomposition are unchanged on all procs
+
+  int info[NPLANINFO];
+  set_plan_info(info);
+
+  int reuse = 0, reuse_all;
+  if (fft1_save) reuse = (memcmp(info,planinfo,sizeof(info)) == 0);
+  MPI_Allreduce(&reuse,&reuse_all,1,MPI_INT,MPI_MIN,world);
+
+  if (reuse_all) {
+    fft1 = fft1_save;
+    fft2 = fft2_save;
+    remap = remap_save;
+    greensfn = greensfn_save;
+    fft1_save = fft2_save = nullptr;
+    remap_save = nullptr;
+    greensfn_save = nullptr;
+    return;
+  }
+
+  free_saved();
+  memory->create(greensfn,nfft_both,"pppm:greensfn");
+  gf_valid = 0;
+
   // create 2 FFTs and a Remap
   // 1st FFT keeps data in FFT decomposition
   // 2nd FFT returns data in 3d brick decomposition
@@ -848,12 +904,15 @@ void PPPM::allocate()
   fft1 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
-                   0,0,&tmp,collective_flag);
+                   0,0,&tmp,collective_flag,fft_procs);
 
   fft2 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
                    nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
                    nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
-                   0,0,&tmp,collective_flag);
+                   0,0,&tmp,collective_flag,fft_procs);
+
+  fft1->set_pipeline(fft_pipeline);
+  fft2->set_pipeline(fft_pipeline);
 
   remap = new Remap(lmp,world,
                     nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
@@ -888,7 +947,6 @@ void PPPM::deallocate()
   }
 
   memory->destroy(density_fft);
-  memory->destroy(greensfn);
   memory->destroy(work1);
   memory->destroy(work2);
   memory->destroy(vg);
@@ -910,9 +968,67 @@ void PPPM::deallocate()
   memory->destroy2d_offset(rho_coeff,(1-order_allocated)/2);
   memory->destroy2d_offset(drho_coeff,(1-order_allocated)/2);
 
-  delete fft1;
-  delete fft2;
-  delete remap;
+  // keep FFTs, remap and Green's function for reuse by the next allocate()
+  // FFT plans only depend on the grid, so this avoids re-planning in every run
+
+  free_saved();
+  if (fft1 && fft2 && remap && greensfn) {
+    set_plan_info(planinfo);
+    fft1_save = fft1;
+    fft2_save = fft2;
+    remap_save = remap;
+    greensfn_save = greensfn;
+  } else {
+    delete fft1;
+    delete fft2;
+    delete remap;
+    memory->destroy(greensfn);
+  }
+  fft1 = fft2 = nullptr;
+  remap = nullptr;
+  greensfn = nullptr;
+}
+
+/* ----------------------------------------------------------------------
+   store grid bounds and settings that FFTs, remap and Green's function
+     allocated for the current grid depend on
+------------------------------------------------------------------------- */
+
+void PPPM::set_plan_info(int *info)
+{
+  info[0] = nx_pppm;
+  info[1] = ny_pppm;
+  info[2] = nz_pppm;
+  info[3] = nxlo_fft;
+  info[4] = nxhi_fft;
+  info[5] = nylo_fft;
+  info[6] = nyhi_fft;
+  info[7] = nzlo_fft;
+  info[8] = nzhi_fft;
+  info[9] = nxlo_in;
+  info[10] = nxhi_in;
+  info[11] = nylo_in;
+  info[12] = nyhi_in;
+  info[13] = nzlo_in;
+  info[14] = nzhi_in;
+  info[15] = nfft_both;
+  info[16] = collective_flag;
+  info[17] = fft_procs;
+  info[18] = fft_pipeline;
+}
+
+/* ----------------------------------------------------------------------
+   free FFTs, remap and Green's function kept by deallocate()
+------------------------------------------------------------------------- */
+
+void PPPM::free_saved()
+{
+  delete fft1_save;
+  delete fft2_save;
+  delete remap_save;
+  memory->destroy(greensfn_save);
+  fft1_save = fft2_save = nullptr;
+  remap_save = nullptr;
 }
 
 /* ----------------------------------------------------------------------
@@ -1396,15 +1512,20 @@ void PPPM::set_grid_local()
   // me_y,me_z = which proc (0-npe_fft-1) I am in y,z dimensions
   // nlo_fft,nhi_fft = lower/upper limit of the section
   //   of the global FFT mesh that I own in x-pencil decomposition
+  // if fft_procs is set, only that subset of procs owns FFT mesh points
+
+  int nprocs_fft = nprocs;
+  if (fft_procs > 0 && fft_procs < nprocs) nprocs_fft = fft_procs;
+  int me_fft = fft_3d_subset_rank(me,nprocs,nprocs_fft);
 
   int npey_fft,npez_fft;
-  if (nz_pppm >= nprocs) {
+  if (nz_pppm >= nprocs_fft) {
     npey_fft = 1;
-    npez_fft = nprocs;
-  } else procs2grid2d(nprocs,ny_pppm,nz_pppm,&npey_fft,&npez_fft);
+    npez_fft = nprocs_fft;
+  } else procs2grid2d(nprocs_fft,ny_pppm,nz_pppm,&npey_fft,&npez_fft);
 
-  int me_y = me % npey_fft;
-  int me_z = me / npey_fft;
+  int me_y = me_fft % npey_fft;
+  int me_z = me_fft / npey_fft;
 
   nxlo_fft = 0;
   nxhi_fft = nx_pppm - 1;
@@ -1412,6 +1533,101 @@ void PPPM::set_grid_local()
   nyhi_fft = (me_y+1)*ny_pppm/npey_fft - 1;
   nzlo_fft = me_z*nz_pppm/npez_fft;
   nzhi_fft = (me_z+1)*nz_pppm/npez_fft - 1;
+
+  if (me_fft < 0) {
+    nylo_fft = nzlo_fft = 0;
+    nyhi_fft = nzhi_fft = -1;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   choose # of FFT procs and pipelining of FFT remaps by timing
+     the brick -> FFT remap and the 3d FFTs of one timestep
+   candidates are all procs and successive halves of them down to 1/8,
+     each with and without pipelining
+------------------------------------------------------------------------- */
+
+void PPPM::tune_fft()
+{
+  int tmp;
+  double time1,time,timeall;
+  FFT_SCALAR *density,*work;
+
+  int nbrick = (nxhi_in-nxlo_in+1) * (nyhi_in-nylo_in+1) * (nzhi_in-nzlo_in+1);
+  int nback = (differentiation_flag == 1) ? 1 : 3;
+  int best_procs = 0;
+  int best_pipeline = 0;
+  double best_time = 0.0;
+
+  std::string mesg = "  FFT tuning (procs, pipeline, time):";
+
+  for (int n = nprocs; n > 0 && n >= nprocs/8; n /= 2) {
+    fft_procs = (n == nprocs) ? 0 : n;
+    set_grid_local();
+
+    int nfft_trial = (nxhi_fft-nxlo_fft+1) * (nyhi_fft-nylo_fft+1) * (nzhi_fft-nzlo_fft+1);
+    int nwork = MAX(nfft_trial,nbrick);
+    memory->create(density,nwork,"pppm:tune_density");
+    memory->create(work,2*nwork,"pppm:tune_work");
+
+    auto fft_trial1 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
+                                nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
+                                nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
+                                0,0,&tmp,collective_flag,fft_procs);
+    auto fft_trial2 = new FFT3d(lmp,world,nx_pppm,ny_pppm,nz_pppm,
+                                nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
+                                nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
+                                0,0,&tmp,collective_flag,fft_procs);
+    auto remap_trial = new Remap(lmp,world,
+                                 nxlo_in,nxhi_in,nylo_in,nyhi_in,nzlo_in,nzhi_in,
+                                 nxlo_fft,nxhi_fft,nylo_fft,nyhi_fft,nzlo_fft,nzhi_fft,
+                                 1,0,0,FFT_PRECISION,collective_flag);
+
+    for (int pipeline = 0; pipeline <= 1; pipeline++) {
+      fft_trial1->set_pipeline(pipeline);
+      fft_trial2->set_pipeline(pipeline);
+      for (int i = 0; i < nwork; i++) density[i] = ZEROF;
+      for (int i = 0; i < 2*nwork; i++) work[i] = ZEROF;
+
+      // 1st iteration is not timed
+
+      time1 = 0.0;
+      for (int iter = -1; iter < NTUNE; iter++) {
+        if (iter == 0) {
+          MPI_Barrier(world);
+          time1 = platform::walltime();
+        }
+        remap_trial->perform(density,density,work);
+        fft_trial1->compute(work,work,FFT3d::FORWARD);
+        for (int k = 0; k < nback; k++)
+          fft_trial2->compute(work,work,FFT3d::BACKWARD);
+      }
+      time = platform::walltime() - time1;
+      MPI_Allreduce(&time,&timeall,1,MPI_DOUBLE,MPI_MAX,world);
+
+      mesg += fmt::format(" ({}, {}, {:.4g})",n,pipeline ? "yes" : "no",timeall);
+      if (best_time == 0.0 || timeall < best_time) {
+        best_time = timeall;
+        best_procs = fft_procs;
+        best_pipeline = pipeline;
+      }
+    }
+
+    delete fft_trial1;
+    delete fft_trial2;
+    delete remap_trial;
+    memory->destroy(density);
+    memory->destroy(work);
+  }
+
+  fft_procs = best_procs;
+  fft_pipeline = best_pipeline;
+  tuned_grid[0] = nx_pppm;
+  tuned_grid[1] = ny_pppm;
+  tuned_grid[2] = nz_pppm;
+  set_grid_local();
+
+  if (me == 0) utils::logmesg(lmp,mesg + "\n");
 }
 
 /* ----------------------------------------------------------------------
@@ -1454,12 +1670,12 @@ void PPPM::compute_gf_ik()
   const double unitkz = (MY_2PI/zprd_slab);
 
   double snx,sny,snz;
-  double argx,argy,argz,wx,wy,wz,sx,sy,sz,qx,qy,qz;
+  double wx,wy,wz,sx,sy,sz,qx,qy,qz;
   double sum1,dot1,dot2;
   double numerator,denominator;
   double sqk;
 
-  int k,l,m,n,nx,ny,nz,kper,lper,mper;
+  int i,k,l,m,n,nx,ny,nz,kper,lper,mper;
 
   const int nbx = static_cast<int> ((g_ewald*xprd/(MY_PI*nx_pppm)) *
                                     pow(-log(EPS_HOC),0.25));
@@ -1469,18 +1685,54 @@ void PPPM::compute_gf_ik()
                                     pow(-log(EPS_HOC),0.25));
   const int twoorder = 2*order;
 
+  // tabulate wavevector, Gaussian and assignment function factors of all
+  //   aliased images for my FFT grid pts in each dimension,
+  //   so the sum over images below needs no exp() or powsinxx() calls
+
+  const int nlo[3] = {nxlo_fft, nylo_fft, nzlo_fft};
+  const int nhi[3] = {nxhi_fft, nyhi_fft, nzhi_fft};
+  const int nb[3] = {nbx, nby, nbz};
+  const int npppm[3] = {nx_pppm, ny_pppm, nz_pppm};
+  const double unitk[3] = {unitkx, unitky, unitkz};
+  const double len[3] = {xprd, yprd, zprd_slab};
+
+  int ntab = 1;
+  for (i = 0; i < 3; i++) ntab = MAX(ntab,(nhi[i]-nlo[i]+1)*(2*nb[i]+1));
+
+  double **qtab,**stab,**wtab;
+  memory->create(qtab,3,ntab,"pppm:qtab");
+  memory->create(stab,3,ntab,"pppm:stab");
+  memory->create(wtab,3,ntab,"pppm:wtab");
+
+  for (i = 0; i < 3; i++) {
+    n = 0;
+    for (k = nlo[i]; k <= nhi[i]; k++) {
+      kper = k - npppm[i]*(2*k/npppm[i]);
+      for (nx = -nb[i]; nx <= nb[i]; nx++) {
+        qx = unitk[i]*(kper+npppm[i]*nx);
+        qtab[i][n] = qx;
+        stab[i][n] = exp(-0.25*square(qx/g_ewald));
+        wtab[i][n] = powsinxx(0.5*qx*len[i]/npppm[i],twoorder);
+        n++;
+      }
+    }
+  }
+
   n = 0;
   for (m = nzlo_fft; m <= nzhi_fft; m++) {
     mper = m - nz_pppm*(2*m/nz_pppm);
     snz = square(sin(0.5*unitkz*mper*zprd_slab/nz_pppm));
+    const int iz = (m-nzlo_fft)*(2*nbz+1) + nbz;
 
     for (l = nylo_fft; l <= nyhi_fft; l++) {
       lper = l - ny_pppm*(2*l/ny_pppm);
       sny = square(sin(0.5*unitky*lper*yprd/ny_pppm));
+      const int iy = (l-nylo_fft)*(2*nby+1) + nby;
 
       for (k = nxlo_fft; k <= nxhi_fft; k++) {
         kper = k - nx_pppm*(2*k/nx_pppm);
         snx = square(sin(0.5*unitkx*kper*xprd/nx_pppm));
+        const int ix = (k-nxlo_fft)*(2*nbx+1) + nbx;
 
         sqk = square(unitkx*kper) + square(unitky*lper) + square(unitkz*mper);
 
@@ -1490,22 +1742,19 @@ void PPPM::compute_gf_ik()
           sum1 = 0.0;
 
           for (nx = -nbx; nx <= nbx; nx++) {
-            qx = unitkx*(kper+nx_pppm*nx);
-            sx = exp(-0.25*square(qx/g_ewald));
-            argx = 0.5*qx*xprd/nx_pppm;
-            wx = powsinxx(argx,twoorder);
+            qx = qtab[0][ix+nx];
+            sx = stab[0][ix+nx];
+            wx = wtab[0][ix+nx];
 
             for (ny = -nby; ny <= nby; ny++) {
-              qy = unitky*(lper+ny_pppm*ny);
-              sy = exp(-0.25*square(qy/g_ewald));
-              argy = 0.5*qy*yprd/ny_pppm;
-              wy = powsinxx(argy,twoorder);
+              qy = qtab[1][iy+ny];
+              sy = stab[1][iy+ny];
+              wy = wtab[1][iy+ny];
 
               for (nz = -nbz; nz <= nbz; nz++) {
-                qz = unitkz*(mper+nz_pppm*nz);
-                sz = exp(-0.25*square(qz/g_ewald));
-                argz = 0.5*qz*zprd_slab/nz_pppm;
-                wz = powsinxx(argz,twoorder);
+                qz = qtab[2][iz+nz];
+                sz = stab[2][iz+nz];
+                wz = wtab[2][iz+nz];
 
                 dot1 = unitkx*kper*qx + unitky*lper*qy + unitkz*mper*qz;
                 dot2 = qx*qx+qy*qy+qz*qz;
@@ -1518,6 +1767,10 @@ void PPPM::compute_gf_ik()
       }
     }
   }
+
+  memory->destroy(qtab);
+  memory->destroy(stab);
+  memory->destroy(wtab);
 }
 
 /* ----------------------------------------------------------------------
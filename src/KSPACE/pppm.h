@@ -82,6 +82,18 @@ class PPPM : public KSpace {
   class Remap *remap;
   class Grid3d *gc;
 
+  // FFTs, remap and Green's function kept by deallocate() for reuse in allocate()
+
+  static constexpr int NPLANINFO = 19;
+  static constexpr int NGFINFO = 6;
+  class FFT3d *fft1_save, *fft2_save;
+  class Remap *remap_save;
+  double *greensfn_save;
+  int planinfo[NPLANINFO];    // grid and FFT settings of saved FFTs and remap
+  double gfinfo[NGFINFO];     // box and settings greensfn was computed for
+  int gf_valid;               // 1 if greensfn is consistent with gfinfo
+  int tuned_grid[3];          // PPPM grid that fft_procs and fft_pipeline were tuned for
+
   FFT_SCALAR *gc_buf1, *gc_buf2;
   int ngc_buf1, ngc_buf2, npergrid;
 
@@ -102,6 +114,7 @@ class PPPM : public KSpace {
 
   virtual void set_grid_global();
   virtual void set_grid_local();
+  void tune_fft();
   void adjust_gewald();
   virtual double newton_raphson_f();
   double derivf();
@@ -110,6 +123,8 @@ class PPPM : public KSpace {
   virtual void allocate();
   virtual void allocate_peratom();
   virtual void deallocate();
+  void set_plan_info(int *);
+  void free_saved();
   virtual void deallocate_peratom();
   int factorable(int);
   virtual double compute_df_kspace();
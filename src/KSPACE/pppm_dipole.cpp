@@ -103,6 +103,10 @@ void PPPMDipole::init()
 
   // error check
 
+  if (fft_procs || fft_pipeline || fft_tune)
+    error->all(FLERR,"Cannot (yet) use kspace_modify fft/procs, fft/pipeline, or fft/tune "
+               "with PPPMDipole");
+
   dipoleflag = atom->mu?1:0;
   qsum_qsq(0); // q[i] might not be declared ?
 
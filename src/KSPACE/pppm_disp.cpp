@@ -267,6 +267,10 @@ void PPPMDisp::init()
 
   // error check
 
+  if (fft_procs || fft_pipeline || fft_tune)
+    error->all(FLERR,"Cannot (yet) use kspace_modify fft/procs, fft/pipeline, or fft/tune "
+               "with PPPMDisp");
+
   triclinic_check();
 
   if (triclinic != domain->triclinic)
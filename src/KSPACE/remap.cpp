@@ -202,6 +202,121 @@ void remap_3d(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
   }
 }
 
+/* ----------------------------------------------------------------------
+   Split-phase point-to-point 3d remap, used to overlap the remap with
+   computation that produces the input data one chunk at a time
+
+   remap_3d_nonblocking() must be called once to enable it for a plan
+   remap_3d_begin() posts all recvs into scratch space
+   remap_3d_isend() packs and sends message isend, all of its input data
+     must be final at this point
+   remap_3d_end() copies self data, unpacks all recvs into out and waits
+     for all sends to complete, all input data must be final at this point
+
+   every send must be issued exactly once between begin and end
+   arguments are the same as for remap_3d()
+   only available for plans that do not use collectives
+------------------------------------------------------------------------- */
+
+int remap_3d_nonblocking(struct remap_plan_3d *plan)
+{
+  if (plan->usecollective) return 0;
+  if (plan->isend_bufloc) return 1;
+
+  int size = 0;
+  plan->isend_bufloc = (int *) malloc((plan->nsend+1)*sizeof(int));
+  plan->send_request = (MPI_Request *) malloc((plan->nsend+1)*sizeof(MPI_Request));
+  if (plan->isend_bufloc == nullptr || plan->send_request == nullptr) return 0;
+
+  for (int isend = 0; isend < plan->nsend; isend++) {
+    plan->isend_bufloc[isend] = size;
+    size += plan->send_size[isend];
+  }
+
+  if (size) {
+    plan->isendbuf = (FFT_SCALAR *) malloc((size_t)size*sizeof(FFT_SCALAR));
+    if (plan->isendbuf == nullptr) return 0;
+  }
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   return offset of the last input datum that message isend is packed from
+------------------------------------------------------------------------- */
+
+int remap_3d_send_last(struct remap_plan_3d *plan, int isend)
+{
+  struct pack_plan_3d *packplan = &plan->packplan[isend];
+
+  return plan->send_offset[isend] + (packplan->nslow-1)*packplan->nstride_plane +
+    (packplan->nmid-1)*packplan->nstride_line + packplan->nfast - 1;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void remap_3d_begin(FFT_SCALAR *buf, struct remap_plan_3d *plan)
+{
+  FFT_SCALAR *scratch;
+
+  if (plan->memory == 0)
+    scratch = buf;
+  else
+    scratch = plan->scratch;
+
+  for (int irecv = 0; irecv < plan->nrecv; irecv++)
+    MPI_Irecv(&scratch[plan->recv_bufloc[irecv]],plan->recv_size[irecv],
+              MPI_FFT_SCALAR,plan->recv_proc[irecv],0,
+              plan->comm,&plan->request[irecv]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void remap_3d_isend(FFT_SCALAR *in, int isend, struct remap_plan_3d *plan)
+{
+  FFT_SCALAR *sendbuf = &plan->isendbuf[plan->isend_bufloc[isend]];
+
+  plan->pack(&in[plan->send_offset[isend]],sendbuf,&plan->packplan[isend]);
+  MPI_Isend(sendbuf,plan->send_size[isend],MPI_FFT_SCALAR,
+            plan->send_proc[isend],0,plan->comm,&plan->send_request[isend]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void remap_3d_end(FFT_SCALAR *in, FFT_SCALAR *out, FFT_SCALAR *buf,
+                  struct remap_plan_3d *plan)
+{
+  int i,isend,irecv;
+  FFT_SCALAR *scratch;
+
+  if (plan->memory == 0)
+    scratch = buf;
+  else
+    scratch = plan->scratch;
+
+  // copy in -> scratch -> out for self data
+  // all sends were packed already, so out may be the same as in
+
+  if (plan->self) {
+    isend = plan->nsend;
+    irecv = plan->nrecv;
+    plan->pack(&in[plan->send_offset[isend]],
+               &scratch[plan->recv_bufloc[irecv]],
+               &plan->packplan[isend]);
+    plan->unpack(&scratch[plan->recv_bufloc[irecv]],
+                 &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+  }
+
+  // unpack all messages from scratch -> out
+
+  for (i = 0; i < plan->nrecv; i++) {
+    MPI_Waitany(plan->nrecv,plan->request,&irecv,MPI_STATUS_IGNORE);
+    plan->unpack(&scratch[plan->recv_bufloc[irecv]],
+                 &out[plan->recv_offset[irecv]],&plan->unpackplan[irecv]);
+  }
+
+  MPI_Waitall(plan->nsend,plan->send_request,MPI_STATUSES_IGNORE);
+}
+
 /* ----------------------------------------------------------------------
    Create plan for performing a 3d remap
 
@@ -252,6 +367,9 @@ struct remap_plan_3d *remap_3d_create_plan(
   plan = (struct remap_plan_3d *) malloc(sizeof(struct remap_plan_3d));
   if (plan == nullptr) return nullptr;
   plan->usecollective = usecollective;
+  plan->isendbuf = nullptr;
+  plan->isend_bufloc = nullptr;
+  plan->send_request = nullptr;
 
   // store parameters in local data structs
 
@@ -665,6 +783,10 @@ void remap_3d_destroy_plan(struct remap_plan_3d *plan)
     if (plan->scratch) free(plan->scratch);
   }
 
+  if (plan->isendbuf) free(plan->isendbuf);
+  if (plan->isend_bufloc) free(plan->isend_bufloc);
+  if (plan->send_request) free(plan->send_request);
+
   // free plan itself
 
   free(plan);
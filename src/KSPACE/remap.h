@@ -42,6 +42,9 @@ struct remap_plan_3d {
   int usecollective;                  // use collective or point-to-point MPI
   int commringlen;                    // length of commringlist
   int *commringlist;                  // ranks on communication ring of this plan
+  FFT_SCALAR *isendbuf;               // buffer for all non-blocking sends
+  int *isend_bufloc;                  // offset in isendbuf for each send
+  MPI_Request *send_request;          // MPI request for each non-blocking send
 };
 
 // collision between 2 regions
@@ -55,6 +58,11 @@ struct extent_3d {
 // function prototypes
 
 void remap_3d(FFT_SCALAR *, FFT_SCALAR *, FFT_SCALAR *, struct remap_plan_3d *);
+int remap_3d_nonblocking(struct remap_plan_3d *);
+int remap_3d_send_last(struct remap_plan_3d *, int);
+void remap_3d_begin(FFT_SCALAR *, struct remap_plan_3d *);
+void remap_3d_isend(FFT_SCALAR *, int, struct remap_plan_3d *);
+void remap_3d_end(FFT_SCALAR *, FFT_SCALAR *, FFT_SCALAR *, struct remap_plan_3d *);
 struct remap_plan_3d *remap_3d_create_plan(MPI_Comm, int, int, int, int, int, int, int, int, int,
                                            int, int, int, int, int, int, int, int);
 void remap_3d_destroy_plan(struct remap_plan_3d *);
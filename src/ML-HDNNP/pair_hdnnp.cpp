@@ -289,6 +289,34 @@ void PairHDNNP::transferNeighborList()
   }
 }
 
+/* ----------------------------------------------------------------------
+   estimate cost of each owned atom for balance weight pair
+   radial symmetry functions scale with the # of neighbors in the cutoff,
+   angular symmetry functions with the # of neighbor pairs
+------------------------------------------------------------------------- */
+
+int PairHDNNP::cost_atom(double *cost)
+{
+  if (!list) return 0;
+
+  double rc2 = maxCutoffRadius * maxCutoffRadius;
+  for (int ii = 0; ii < list->inum; ++ii) {
+    int i = list->ilist[ii];
+    if (i >= atom->nlocal) continue;
+    double n = 0.0;
+    for (int jj = 0; jj < list->numneigh[i]; ++jj) {
+      int j = list->firstneigh[i][jj];
+      j &= NEIGHMASK;
+      double dx = atom->x[i][0] - atom->x[j][0];
+      double dy = atom->x[i][1] - atom->x[j][1];
+      double dz = atom->x[i][2] - atom->x[j][2];
+      if (dx * dx + dy * dy + dz * dz <= rc2) n += 1.0;
+    }
+    cost[i] += n + 0.5 * n * (n - 1.0);
+  }
+  return 1;
+}
+
 void PairHDNNP::handleExtrapolationWarnings()
 {
   // Get number of extrapolation warnings for local atoms.
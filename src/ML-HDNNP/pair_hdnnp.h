@@ -45,6 +45,7 @@ class PairHDNNP : public Pair {
   void coeff(int, char **) override;
   void init_style() override;
   double init_one(int, int) override;
+  int cost_atom(double *) override;
 
  protected:
   virtual void allocate();
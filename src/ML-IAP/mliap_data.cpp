@@ -40,6 +40,7 @@ MLIAPData::MLIAPData(LAMMPS *lmp, int gradgradflag_in, int *map_in, class MLIAPM
   model = model_in;
   descriptor = descriptor_in;
   pairmliap = pairmliap_in;
+  graddescflag = 0;
 
   ndescriptors = descriptor->ndescriptors;
   nelements = descriptor->nelements;
@@ -64,6 +65,7 @@ MLIAPData::MLIAPData(LAMMPS *lmp, int gradgradflag_in, int *map_in, class MLIAPM
   nlistatoms_max = 0;
   natomneigh_max = 0;
   nneigh_max = 0;
+  ngraddesc_max = 0;
   nmax = 0;
   natomgamma_max = 0;
 }
@@ -266,9 +268,16 @@ void MLIAPData::grow_neigharrays()
     memory->grow(jatoms, nneigh, "MLIAPData:jatoms");
     memory->grow(jelems, nneigh, "MLIAPData:jelems");
     memory->grow(rij, nneigh, 3, "MLIAPData:rij");
-    if (gradgradflag == 0) memory->grow(graddesc, nneigh, ndescriptors, 3, "MLIAPData:graddesc");
     nneigh_max = nneigh;
   }
+
+  // the pair style only needs graddesc on some steps, allocate on first use
+
+  if (((gradgradflag == 0) || graddescflag) && (ngraddesc_max < nneigh)) {
+    memory->destroy(graddesc);
+    memory->create(graddesc, nneigh, ndescriptors, 3, "MLIAPData:graddesc");
+    ngraddesc_max = nneigh;
+  }
 }
 
 double MLIAPData::memory_usage()
@@ -298,8 +307,7 @@ double MLIAPData::memory_usage()
   bytes += (double) nneigh_max * sizeof(int);           // jelems
   bytes += (double) nneigh_max * 3 * sizeof(double);    // rij"
 
-  if (gradgradflag == 0)
-    bytes += (double) nneigh_max * ndescriptors * 3 * sizeof(double);    // graddesc
+  bytes += (double) ngraddesc_max * ndescriptors * 3 * sizeof(double);    // graddesc
 
   return bytes;
 }
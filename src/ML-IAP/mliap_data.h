@@ -45,6 +45,7 @@ class MLIAPData : protected Pointers {
   int nparams;             // number of model parameters per element
   int nelements;           // number of elements
   int gradgradflag;        // 1 for graddesc, 0 for gamma, -1 for pair style
+  int graddescflag;        // 1 if graddesc is needed by pair style on this step
 
   // data structures for grad-grad list (gamma)
 
@@ -73,6 +74,7 @@ class MLIAPData : protected Pointers {
   int *jelems;                   // element of each neighbor
   int *elems;                    // element of each atom in or not in the neighborlist
   double **rij;                  // distance vector of each neighbor
+  int ngraddesc_max;             // number of ij neighbors allocated in graddesc
   double ***graddesc;            // descriptor gradient w.r.t. each neighbor
   int eflag;                     // indicates if energy is needed
   int vflag;                     // indicates if virial is needed
@@ -42,7 +42,7 @@ MLIAPDescriptorSO3::MLIAPDescriptorSO3(LAMMPS *lmp, char *paramfilename) : Point
   so3ptr = nullptr;
   read_paramfile(paramfilename);
 
-  so3ptr = new MLIAP_SO3(lmp, rcutfac, lmax, nmax, alpha);
+  so3ptr = new MLIAP_SO3(lmp, rcutfac, lmax, nmax, alpha, ntable);
 
   ndescriptors = so3ptr->ncoeff;
 }
@@ -73,6 +73,7 @@ void MLIAPDescriptorSO3::read_paramfile(char *paramfilename)
 
   rfac0 = 0.99363;
   rmin0 = 0.0;
+  ntable = 0;
 
   for (int i = 0; i < nelements; i++) delete[] elements[i];
   delete[] elements;
@@ -176,6 +177,10 @@ void MLIAPDescriptorSO3::read_paramfile(char *paramfilename)
       } else if (skeywd == "alpha") {
         alpha = utils::numeric(FLERR, skeyval, false, lmp);
         alphaflag = 1;
+      } else if (skeywd == "ntable") {
+        ntable = utils::inumeric(FLERR, skeyval, false, lmp);
+        if ((ntable != 0) && (ntable < 4))
+          error->all(FLERR, "SO3 ntable must be 0 or at least 4: {}", ntable);
       } else
         error->all(FLERR, "Incorrect SO3 parameter file");
     }
@@ -41,6 +41,7 @@ class MLIAPDescriptorSO3 : public MLIAPDescriptor, virtual protected Pointers {
 
   int nmax, lmax;
   double alpha;
+  int ntable;    // # of intervals of radial integral tables, 0 = analytic
 
   int twojmax, switchflag, bzeroflag;
   int chemflag, bnormflag, wselfallflag;
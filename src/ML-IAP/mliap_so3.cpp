@@ -35,12 +35,14 @@ using namespace MathSpecial;
 
 /* ---------------------------------------------------------------------- */
 
-MLIAP_SO3::MLIAP_SO3(LAMMPS *lmp, double vrcut, int vlmax, int vnmax, double valpha) : Pointers(lmp)
+MLIAP_SO3::MLIAP_SO3(LAMMPS *lmp, double vrcut, int vlmax, int vnmax, double valpha,
+                     int vntable) : Pointers(lmp)
 {
   m_rcut = vrcut;
   m_alpha = valpha;
   m_lmax = vlmax;
   m_nmax = vnmax;
+  m_ntable = vntable;
   compute_ncoeff();
 
   m_Nmax = (m_nmax + m_lmax + 1) * 10;
@@ -93,6 +95,14 @@ MLIAP_SO3::MLIAP_SO3(LAMMPS *lmp, double vrcut, int vlmax, int vnmax, double val
   m_clisttot_r = nullptr;
   m_clisttot_i = nullptr;
 
+  m_rip_table = nullptr;
+  m_rip_dtable = nullptr;
+  m_ylm_cache_r = nullptr;
+  m_ylm_cache_i = nullptr;
+  m_rij_cache = nullptr;
+  m_dtable = 0.0;
+  m_cache_npairs = m_cache_max = 0;
+
   m_init_arrays = 0;
   m_dfac_l1 = m_dfac_l2 = 0;
   m_pfac_l1 = m_pfac_l2 = 0;
@@ -152,6 +162,12 @@ MLIAP_SO3::~MLIAP_SO3()
 
   memory->destroy(m_clisttot_r);
   memory->destroy(m_clisttot_i);
+
+  memory->destroy(m_rip_table);
+  memory->destroy(m_rip_dtable);
+  memory->destroy(m_ylm_cache_r);
+  memory->destroy(m_ylm_cache_i);
+  memory->destroy(m_rij_cache);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -281,6 +297,214 @@ void MLIAP_SO3::init()
         m_idxu_count += 1;
       }
   }
+
+  if (m_ntable > 0) init_table();
+}
+
+/* ----------------------------------------------------------------------
+   tabulate radial integrals and their derivatives for r = 0 to rcut
+   knot values use the same quadrature as get_sbes_array() and get_rip_array()
+------------------------------------------------------------------------- */
+
+void MLIAP_SO3::init_table()
+{
+  const int lmax1 = m_lmax + 1;
+  const int nl = m_nmax * lmax1;
+  const bigint totali = (bigint) 4 * (m_ntable + 1) * nl;
+
+  memory->destroy(m_rip_table);
+  memory->create(m_rip_table, totali, "MLIAP_SO3:m_rip_table");
+  memory->destroy(m_rip_dtable);
+  memory->create(m_rip_dtable, totali, "MLIAP_SO3:m_rip_dtable");
+  alloc_init += 2.0 * totali * sizeof(double);
+  for (bigint ti = 0; ti < totali; ti++) m_rip_table[ti] = m_rip_dtable[ti] = 0.0;
+
+  m_dtable = m_rcut / m_ntable;
+
+  const double pfac1 = m_alpha * m_rcut;
+  const double pfac3 = MY_PI / 2.0 / m_Nmax;
+  const double pfac4 = m_rcut / 2.0;
+  auto sbes = new double[lmax1 + 1];
+  auto sbesd = new double[lmax1];
+
+  for (int k = 0; k <= m_ntable; k++) {
+    const double ri = k * m_dtable;
+    const double expfac = 4 * MY_PI * exp(-m_alpha * ri * ri);
+    double *rip = m_rip_table + (bigint) 4 * k * nl;
+    double *ripd = m_rip_dtable + (bigint) 4 * k * nl;
+
+    for (int i = 1; i < m_Nmax + 1; i++) {
+      const double x = cos((2 * i - 1) * pfac3);
+      const double xi = pfac4 * (x + 1);
+      const double rb = pfac1 * ri * (x + 1);
+
+      // modified spherical Bessel functions, use their limit at r = 0
+
+      if (ri < SMALL) {
+        sbes[0] = 1.0;
+        for (int j = 1; j < lmax1 + 1; j++) sbes[j] = 0.0;
+      } else {
+        sbes[0] = sinh(rb) / rb;
+        sbes[1] = (cosh(rb) - sbes[0]) / rb;
+        for (int j = 2; j < lmax1 + 1; j++) sbes[j] = sbes[j - 2] - (2 * j - 1) / rb * sbes[j - 1];
+      }
+      sbesd[0] = xi * sbes[1];
+      for (int j = 1; j < lmax1; j++)
+        sbesd[j] = xi * (j * sbes[j - 1] + (j + 1) * sbes[j + 1]) / (2 * j + 1);
+
+      for (int n = 0; n < m_nmax; n++) {
+        const double g = m_g_array[n * m_Nmax + i - 1];
+        for (int l = 0; l < lmax1; l++) {
+          rip[4 * (n * lmax1 + l)] += g * sbes[l];
+          ripd[4 * (n * lmax1 + l)] += g * sbesd[l];
+        }
+      }
+    }
+
+    for (int j = 0; j < nl; j++) {
+      rip[4 * j] *= expfac;
+      ripd[4 * j] *= expfac;
+    }
+  }
+  delete[] sbes;
+  delete[] sbesd;
+
+  spline_table(m_rip_table);
+  spline_table(m_rip_dtable);
+}
+
+/* ----------------------------------------------------------------------
+   convert knot values of a table into cubic spline coefficients,
+   using the same derivative estimates as pair style eam
+   table[(knot*nl + j)*4 + c], value = ((c3*p + c2)*p + c1)*p + c0
+------------------------------------------------------------------------- */
+
+void MLIAP_SO3::spline_table(double *table)
+{
+  const int nl = m_nmax * (m_lmax + 1);
+  const int n = m_ntable;
+  const bigint stride = (bigint) 4 * nl;
+
+  for (int j = 0; j < nl; j++) {
+    double *s = table + 4 * j;
+    s[1] = s[stride] - s[0];
+    s[stride + 1] = 0.5 * (s[2 * stride] - s[0]);
+    s[(n - 1) * stride + 1] = 0.5 * (s[n * stride] - s[(n - 2) * stride]);
+    s[n * stride + 1] = s[n * stride] - s[(n - 1) * stride];
+    for (int k = 2; k < n - 1; k++)
+      s[k * stride + 1] = ((s[(k - 2) * stride] - s[(k + 2) * stride]) +
+                           8.0 * (s[(k + 1) * stride] - s[(k - 1) * stride])) /
+          12.0;
+    for (int k = 0; k < n; k++) {
+      const double df = s[(k + 1) * stride] - s[k * stride];
+      s[k * stride + 2] = 3.0 * df - 2.0 * s[k * stride + 1] - s[(k + 1) * stride + 1];
+      s[k * stride + 3] = s[k * stride + 1] + s[(k + 1) * stride + 1] - 2.0 * df;
+    }
+    s[n * stride + 2] = s[n * stride + 3] = 0.0;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   real and imaginary parts of spherical harmonics up to lmax+1
+   from the current content of ulist
+------------------------------------------------------------------------- */
+
+void MLIAP_SO3::compute_ylms(double *ylms_r, double *ylms_i)
+{
+  int i = 0;
+  for (int l = 0; l < m_lmax + 2; l++)
+    for (int m = -l; m < l + 1; m++) {
+      ylms_r[i] = (m_ulist_r[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
+      ylms_i[i] = (m_ulist_i[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
+      i += 1;
+    }
+}
+
+/* ----------------------------------------------------------------------
+   interpolate radial integrals from tables and store spherical harmonics
+   for all pairs, so they are computed only once per step
+------------------------------------------------------------------------- */
+
+void MLIAP_SO3::fill_pair_cache(int nlocal, int *numneighs, double **rij, bigint npairs)
+{
+  const int nl = m_nmax * (m_lmax + 1);
+  const int nylm = (m_lmax + 2) * (m_lmax + 2);
+  const int twolmax = 2 * (m_lmax + 1);
+
+  if (npairs > m_cache_max) {
+    m_cache_max = npairs;
+    memory->destroy(m_ylm_cache_r);
+    memory->create(m_ylm_cache_r, m_cache_max * nylm, "MLIAP_SO3:m_ylm_cache_r");
+    memory->destroy(m_ylm_cache_i);
+    memory->create(m_ylm_cache_i, m_cache_max * nylm, "MLIAP_SO3:m_ylm_cache_i");
+    memory->destroy(m_rij_cache);
+    memory->create(m_rij_cache, m_cache_max * 3, "MLIAP_SO3:m_rij_cache");
+  }
+
+  const bigint totali = npairs * nl;
+  memory->destroy(m_rip_array);
+  memory->create(m_rip_array, totali, "MLIAP_SO3:m_rip_array");
+  memory->destroy(m_rip_darray);
+  memory->create(m_rip_darray, totali, "MLIAP_SO3:m_rip_darray");
+
+  bigint ipair = 0;
+  for (int ii = 0; ii < nlocal; ii++) {
+    for (int neighbor = 0; neighbor < numneighs[ii]; neighbor++, ipair++) {
+      const double x = rij[ipair][0];
+      const double y = rij[ipair][1];
+      const double z = rij[ipair][2];
+      m_rij_cache[3 * ipair] = x;
+      m_rij_cache[3 * ipair + 1] = y;
+      m_rij_cache[3 * ipair + 2] = z;
+
+      const double r = sqrt(x * x + y * y + z * z);
+      if (r < SMALL) continue;
+
+      // radial integrals vanish together with the cutoff function beyond rcut
+
+      double *rip = m_rip_array + ipair * nl;
+      double *ripd = m_rip_darray + ipair * nl;
+      double p = r / m_dtable;
+      const int k = static_cast<int>(p);
+      if (k >= m_ntable) {
+        for (int j = 0; j < nl; j++) rip[j] = ripd[j] = 0.0;
+      } else {
+        p -= k;
+        const double *s = m_rip_table + (bigint) 4 * k * nl;
+        const double *sd = m_rip_dtable + (bigint) 4 * k * nl;
+        for (int j = 0; j < nl; j++) {
+          rip[j] = ((s[4 * j + 3] * p + s[4 * j + 2]) * p + s[4 * j + 1]) * p + s[4 * j];
+          ripd[j] = ((sd[4 * j + 3] * p + sd[4 * j + 2]) * p + sd[4 * j + 1]) * p + sd[4 * j];
+        }
+      }
+
+      for (int ti = 0; ti < m_idxu_count; ti++) {
+        m_ulist_r[ti] = 0.0;
+        m_ulist_i[ti] = 0.0;
+      }
+      compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
+      compute_ylms(m_ylm_cache_r + ipair * nylm, m_ylm_cache_i + ipair * nylm);
+    }
+  }
+  m_cache_npairs = npairs;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if the pair cache was filled for the same pair distances
+------------------------------------------------------------------------- */
+
+int MLIAP_SO3::pair_cache_valid(int nlocal, int *numneighs, double **rij, bigint npairs)
+{
+  if (npairs != m_cache_npairs) return 0;
+
+  bigint ipair = 0;
+  for (int ii = 0; ii < nlocal; ii++)
+    for (int neighbor = 0; neighbor < numneighs[ii]; neighbor++, ipair++)
+      if ((rij[ipair][0] != m_rij_cache[3 * ipair]) ||
+          (rij[ipair][1] != m_rij_cache[3 * ipair + 1]) ||
+          (rij[ipair][2] != m_rij_cache[3 * ipair + 2]))
+        return 0;
+  return 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -347,7 +571,12 @@ void MLIAP_SO3::init_arrays(int nlocal, int ncoefs)
 
 double MLIAP_SO3::memory_usage()
 {
-  return alloc_init + alloc_arrays;
+  double bytes = alloc_init + alloc_arrays;
+  if (m_ntable > 0) {
+    bytes += (double) m_cache_max * 2 * (m_lmax + 2) * (m_lmax + 2) * sizeof(double);
+    bytes += (double) m_cache_max * 3 * sizeof(double);
+  }
+  return bytes;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -813,7 +1042,8 @@ void MLIAP_SO3::spectrum(int nlocal, int *numneighs, int *jelems, double *wjelem
 
   bigint totaln = 0;
   bigint totali;
-  double Ylm_r, Ylm_i;
+  const double *ylm_r, *ylm_i;
+  const int nylm = (m_lmax + 2) * (m_lmax + 2);
   int weight, neighbor;
   double x, y, z, r;
   double r_int;
@@ -827,18 +1057,23 @@ void MLIAP_SO3::spectrum(int nlocal, int *numneighs, int *jelems, double *wjelem
 
   for (int i = 0; i < nlocal; i++) totaln += numneighs[i];
 
-  totali = totaln * m_Nmax * (m_lmax + 1);
-  memory->destroy(m_sbes_array);
-  memory->create(m_sbes_array, totali, "MLIAP_SO3:m_sbes_array");
-  memory->destroy(m_sbes_darray);
-  memory->create(m_sbes_darray, totali, "MLIAP_SO3:m_sbes_darray");
-  alloc_arrays += 2.0 * totali * sizeof(double);
-
+  if (m_ntable > 0) {
+    fill_pair_cache(nlocal, numneighs, rij, totaln);
+  } else {
+    totali = totaln * m_Nmax * (m_lmax + 1);
+    memory->destroy(m_sbes_array);
+    memory->create(m_sbes_array, totali, "MLIAP_SO3:m_sbes_array");
+    memory->destroy(m_sbes_darray);
+    memory->create(m_sbes_darray, totali, "MLIAP_SO3:m_sbes_darray");
+    alloc_arrays += 2.0 * totali * sizeof(double);
+
+    totali = totaln * m_nmax * (m_lmax + 1);
+    memory->destroy(m_rip_array);
+    memory->create(m_rip_array, totali, "MLIAP_SO3:m_rip_array");
+    memory->destroy(m_rip_darray);
+    memory->create(m_rip_darray, totali, "MLIAP_SO3:m_rip_darray");
+  }
   totali = totaln * m_nmax * (m_lmax + 1);
-  memory->destroy(m_rip_array);
-  memory->create(m_rip_array, totali, "MLIAP_SO3:m_rip_array");
-  memory->destroy(m_rip_darray);
-  memory->create(m_rip_darray, totali, "MLIAP_SO3:m_rip_darray");
   alloc_arrays += 2.0 * totali * sizeof(double);
 
   totali = totaln * ncoefs * 3;
@@ -846,9 +1081,10 @@ void MLIAP_SO3::spectrum(int nlocal, int *numneighs, int *jelems, double *wjelem
   memory->create(m_dplist_r, totali, "MLIAP_SO3:m_dplist_r");
   alloc_arrays += 2.0 * totali * sizeof(double);
 
-  get_sbes_array(nlocal, numneighs, rij, lmax, rcut, alpha);
-
-  get_rip_array(nlocal, numneighs, rij, nmax, lmax, alpha);
+  if (m_ntable == 0) {
+    get_sbes_array(nlocal, numneighs, rij, lmax, rcut, alpha);
+    get_rip_array(nlocal, numneighs, rij, nmax, lmax, alpha);
+  }
 
   totali = (bigint) nlocal * ncoefs;
   for (int i = 0; i < totali; i++) {
@@ -881,13 +1117,20 @@ void MLIAP_SO3::spectrum(int nlocal, int *numneighs, int *jelems, double *wjelem
         m_clist_r[ti] = 0.0;
         m_clist_i[ti] = 0.0;
       }
-      for (bigint ti = 0; ti < m_idxu_count; ti++) {
-        m_ulist_r[ti] = 0.0;
-        m_ulist_i[ti] = 0.0;
+      if (m_ntable > 0) {
+        ylm_r = m_ylm_cache_r + (ipair - 1) * nylm;
+        ylm_i = m_ylm_cache_i + (ipair - 1) * nylm;
+      } else {
+        for (bigint ti = 0; ti < m_idxu_count; ti++) {
+          m_ulist_r[ti] = 0.0;
+          m_ulist_i[ti] = 0.0;
+        }
+        compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
+        compute_ylms(m_Ylms_r, m_Ylms_i);
+        ylm_r = m_Ylms_r;
+        ylm_i = m_Ylms_i;
       }
 
-      compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
-
       sfac = compute_sfac(r, rcut);
 
       gindex = (ipair - 1) * findex;
@@ -898,10 +1141,8 @@ void MLIAP_SO3::spectrum(int nlocal, int *numneighs, int *jelems, double *wjelem
 
           for (int m = -l; m < l + 1; m++) {
 
-            Ylm_r = (m_ulist_r[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
-            m_clist_r[(n - 1) * m_numYlms + i] += r_int * Ylm_r * sfac;
-            Ylm_i = (m_ulist_i[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
-            m_clist_i[(n - 1) * m_numYlms + i] += r_int * Ylm_i * sfac;
+            m_clist_r[(n - 1) * m_numYlms + i] += r_int * ylm_r[i] * sfac;
+            m_clist_i[(n - 1) * m_numYlms + i] += r_int * ylm_i[i] * sfac;
             i += 1;
           }
         }
@@ -931,7 +1172,8 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
   bigint totaln = 0;
   bigint totali;
   double dr_int[3];
-  double Ylm_r, Ylm_i;
+  const double *ylm_r, *ylm_i;
+  const int nylm = (m_lmax + 2) * (m_lmax + 2);
 
   double rvec[3];
   double dexpfac[3];
@@ -958,17 +1200,26 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
 
   for (int i = 0; i < nlocal; i++) totaln += numneighs[i];
 
-  totali = totaln * m_Nmax * (m_lmax + 1);
-  memory->destroy(m_sbes_array);
-  memory->create(m_sbes_array, totali, "MLIAP_SO3:m_sbes_array");
-  memory->destroy(m_sbes_darray);
-  memory->create(m_sbes_darray, totali, "MLIAP_SO3:m_sbes_darray");
-
-  totali = totaln * m_nmax * (m_lmax + 1);
-  memory->destroy(m_rip_array);
-  memory->create(m_rip_array, totali, "MLIAP_SO3:m_rip_array");
-  memory->destroy(m_rip_darray);
-  memory->create(m_rip_darray, totali, "MLIAP_SO3:m_rip_darray");
+  if (!m_init_arrays) init_arrays(nlocal, ncoefs);
+
+  // with tables, reuse radial and angular terms of the preceding spectrum() call
+
+  if (m_ntable > 0) {
+    if (!pair_cache_valid(nlocal, numneighs, rij, totaln))
+      fill_pair_cache(nlocal, numneighs, rij, totaln);
+  } else {
+    totali = totaln * m_Nmax * (m_lmax + 1);
+    memory->destroy(m_sbes_array);
+    memory->create(m_sbes_array, totali, "MLIAP_SO3:m_sbes_array");
+    memory->destroy(m_sbes_darray);
+    memory->create(m_sbes_darray, totali, "MLIAP_SO3:m_sbes_darray");
+
+    totali = totaln * m_nmax * (m_lmax + 1);
+    memory->destroy(m_rip_array);
+    memory->create(m_rip_array, totali, "MLIAP_SO3:m_rip_array");
+    memory->destroy(m_rip_darray);
+    memory->create(m_rip_darray, totali, "MLIAP_SO3:m_rip_darray");
+  }
 
   totali = totaln * ncoefs * 3;
   memory->destroy(m_dplist_r);
@@ -982,9 +1233,10 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
 
   numps = nmax * (nmax + 1) * (lmax + 1) / 2;
 
-  get_sbes_array(nlocal, numneighs, rij, lmax, rcut, alpha);
-
-  get_rip_array(nlocal, numneighs, rij, nmax, lmax, alpha);
+  if (m_ntable == 0) {
+    get_sbes_array(nlocal, numneighs, rij, lmax, rcut, alpha);
+    get_rip_array(nlocal, numneighs, rij, nmax, lmax, alpha);
+  }
 
   int twolmax = 2 * (lmax + 1);
 
@@ -1016,13 +1268,20 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
         m_clist_i[ti] = 0.0;
       }
 
-      for (bigint ti = 0; ti < m_idxu_count; ti++) {
-        m_ulist_r[ti] = 0.0;
-        m_ulist_i[ti] = 0.0;
+      if (m_ntable > 0) {
+        ylm_r = m_ylm_cache_r + (ipair - 1) * nylm;
+        ylm_i = m_ylm_cache_i + (ipair - 1) * nylm;
+      } else {
+        for (bigint ti = 0; ti < m_idxu_count; ti++) {
+          m_ulist_r[ti] = 0.0;
+          m_ulist_i[ti] = 0.0;
+        }
+        compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
+        compute_ylms(m_Ylms_r, m_Ylms_i);
+        ylm_r = m_Ylms_r;
+        ylm_i = m_Ylms_i;
       }
 
-      compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
-
       sfac = compute_sfac(r, rcut);
 
       gindex = (ipair - 1) * findex;
@@ -1033,10 +1292,8 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
 
           for (int m = -l; m < l + 1; m++) {
 
-            Ylm_r = (m_ulist_r[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
-            m_clist_r[(n - 1) * m_numYlms + i] += r_int * Ylm_r * sfac;
-            Ylm_i = (m_ulist_i[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
-            m_clist_i[(n - 1) * m_numYlms + i] += r_int * Ylm_i * sfac;
+            m_clist_r[(n - 1) * m_numYlms + i] += r_int * ylm_r[i] * sfac;
+            m_clist_i[(n - 1) * m_numYlms + i] += r_int * ylm_i[i] * sfac;
             i += 1;
           }
         }
@@ -1073,32 +1330,25 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
         m_dclist_i[tn] = 0.0;
       }
 
-      for (int ti = 0; ti < m_idxu_count; ti++) {
-        m_ulist_r[ti] = 0.0;
-        m_ulist_i[ti] = 0.0;
+      if (m_ntable > 0) {
+        ylm_r = m_ylm_cache_r + (idpair - 1) * nylm;
+        ylm_i = m_ylm_cache_i + (idpair - 1) * nylm;
+      } else {
+        for (int ti = 0; ti < m_idxu_count; ti++) {
+          m_ulist_r[ti] = 0.0;
+          m_ulist_i[ti] = 0.0;
+        }
+        compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
+        compute_ylms(m_Ylms_r, m_Ylms_i);
+        ylm_r = m_Ylms_r;
+        ylm_i = m_Ylms_i;
       }
 
-      compute_uarray_recursive(x, y, z, r, twolmax, m_ulist_r, m_ulist_i, m_idxu_block, m_rootpq);
-
       /////////  compute_carray_wD  ////////
       {
         rvec[0] = x;
         rvec[1] = y;
         rvec[2] = z;
-        totali = ((bigint) lmax + 2) * (lmax + 2);
-        for (bigint tn = 0; tn < totali; tn++) {
-          m_Ylms_r[tn] = 0.0;
-          m_Ylms_i[tn] = 0.0;
-        }
-
-        int i = 0;
-        for (int l = 0; l < lmax + 2; l++) {
-          for (int m = -l; m < l + 1; m++) {
-            m_Ylms_r[i] = (m_ulist_r[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
-            m_Ylms_i[i] = (m_ulist_i[m_idxylm[i]]) * m_pfac[l * m_pfac_l2 + m];
-            i += 1;
-          }
-        }
 
         totali = ((bigint) lmax + 1) * (lmax + 1) * 3;
         for (bigint tn = 0; tn < totali; tn++) {
@@ -1109,7 +1359,7 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
         comj_i = 1.0 / sqrt(2.0);
         oneofr = 1.0 / r;
 
-        i = 1;
+        int i = 1;
         for (int l = 1; l < lmax + 1; l++) {
           for (int m = -l; m < l + 1; m++) {
 
@@ -1120,23 +1370,23 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
             dfact[4] = m_dfac4[l * m_dfac_l2 + m] * oneofr;
             dfact[5] = m_dfac5[l * m_dfac_l2 + m] * oneofr;
 
-            xcov0_r = dfact[0] * m_Ylms_r[m_ellpl1[l] + m];
-            xcov0_i = dfact[0] * m_Ylms_i[m_ellpl1[l] + m];
+            xcov0_r = dfact[0] * ylm_r[m_ellpl1[l] + m];
+            xcov0_i = dfact[0] * ylm_i[m_ellpl1[l] + m];
             if (abs(m) <= l - 1.0) {
-              xcov0_r += dfact[1] * m_Ylms_r[m_ellm1[l] + m];
-              xcov0_i += dfact[1] * m_Ylms_i[m_ellm1[l] + m];
+              xcov0_r += dfact[1] * ylm_r[m_ellm1[l] + m];
+              xcov0_i += dfact[1] * ylm_i[m_ellm1[l] + m];
             }
-            xcovpl1_r = dfact[2] * m_Ylms_r[m_ellpl1[l] + m + 1];
-            xcovpl1_i = dfact[2] * m_Ylms_i[m_ellpl1[l] + m + 1];
+            xcovpl1_r = dfact[2] * ylm_r[m_ellpl1[l] + m + 1];
+            xcovpl1_i = dfact[2] * ylm_i[m_ellpl1[l] + m + 1];
             if (abs(m + 1) <= l - 1.0) {
-              xcovpl1_r -= dfact[3] * m_Ylms_r[m_ellm1[l] + m + 1];
-              xcovpl1_i -= dfact[3] * m_Ylms_i[m_ellm1[l] + m + 1];
+              xcovpl1_r -= dfact[3] * ylm_r[m_ellm1[l] + m + 1];
+              xcovpl1_i -= dfact[3] * ylm_i[m_ellm1[l] + m + 1];
             }
-            xcovm1_r = dfact[4] * m_Ylms_r[m_ellpl1[l] + m - 1];
-            xcovm1_i = dfact[4] * m_Ylms_i[m_ellpl1[l] + m - 1];
+            xcovm1_r = dfact[4] * ylm_r[m_ellpl1[l] + m - 1];
+            xcovm1_i = dfact[4] * ylm_i[m_ellpl1[l] + m - 1];
             if (fabs(m - 1.0) <= l - 1.0) {
-              xcovm1_r -= dfact[5] * m_Ylms_r[m_ellm1[l] + m - 1];
-              xcovm1_i -= dfact[5] * m_Ylms_i[m_ellm1[l] + m - 1];
+              xcovm1_r -= dfact[5] * ylm_r[m_ellm1[l] + m - 1];
+              xcovm1_i -= dfact[5] * ylm_i[m_ellm1[l] + m - 1];
             }
             m_dYlm_r[i * 3 + 0] = 1.0 / sqrt(2.0) * (xcovm1_r - xcovpl1_r);
             m_dYlm_r[i * 3 + 1] = -comj_i * (xcovm1_i + xcovpl1_i);
@@ -1169,38 +1419,38 @@ void MLIAP_SO3::spectrum_dxdr(int nlocal, int *numneighs, int *jelems, double *w
             for (int m = -l; m < l + 1; m++) {
 
               m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 0] +=
-                  (r_int * m_Ylms_r[i] * dexpfac[0] + dr_int[0] * m_Ylms_r[i] +
+                  (r_int * ylm_r[i] * dexpfac[0] + dr_int[0] * ylm_r[i] +
                    r_int * m_dYlm_r[i * 3 + 0]) *
                   sfac;
               m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 1] +=
-                  (r_int * m_Ylms_r[i] * dexpfac[1] + dr_int[1] * m_Ylms_r[i] +
+                  (r_int * ylm_r[i] * dexpfac[1] + dr_int[1] * ylm_r[i] +
                    r_int * m_dYlm_r[i * 3 + 1]) *
                   sfac;
               m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 2] +=
-                  (r_int * m_Ylms_r[i] * dexpfac[2] + dr_int[2] * m_Ylms_r[i] +
+                  (r_int * ylm_r[i] * dexpfac[2] + dr_int[2] * ylm_r[i] +
                    r_int * m_dYlm_r[i * 3 + 2]) *
                   sfac;
 
               m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 0] +=
-                  (r_int * m_Ylms_i[i] * dexpfac[0] + dr_int[0] * m_Ylms_i[i] +
+                  (r_int * ylm_i[i] * dexpfac[0] + dr_int[0] * ylm_i[i] +
                    r_int * m_dYlm_i[i * 3 + 0]) *
                   sfac;
               m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 1] +=
-                  (r_int * m_Ylms_i[i] * dexpfac[1] + dr_int[1] * m_Ylms_i[i] +
+                  (r_int * ylm_i[i] * dexpfac[1] + dr_int[1] * ylm_i[i] +
                    r_int * m_dYlm_i[i * 3 + 1]) *
                   sfac;
               m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 2] +=
-                  (r_int * m_Ylms_i[i] * dexpfac[2] + dr_int[2] * m_Ylms_i[i] +
+                  (r_int * ylm_i[i] * dexpfac[2] + dr_int[2] * ylm_i[i] +
                    r_int * m_dYlm_i[i * 3 + 2]) *
                   sfac;
 
-              m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 0] += (r_int * m_Ylms_r[i]) * dsfac_arr[0];
-              m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 1] += (r_int * m_Ylms_r[i]) * dsfac_arr[1];
-              m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 2] += (r_int * m_Ylms_r[i]) * dsfac_arr[2];
+              m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 0] += (r_int * ylm_r[i]) * dsfac_arr[0];
+              m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 1] += (r_int * ylm_r[i]) * dsfac_arr[1];
+              m_dclist_r[((n - 1) * m_numYlms + i) * 3 + 2] += (r_int * ylm_r[i]) * dsfac_arr[2];
 
-              m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 0] += (r_int * m_Ylms_i[i]) * dsfac_arr[0];
-              m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 1] += (r_int * m_Ylms_i[i]) * dsfac_arr[1];
-              m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 2] += (r_int * m_Ylms_i[i]) * dsfac_arr[2];
+              m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 0] += (r_int * ylm_i[i]) * dsfac_arr[0];
+              m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 1] += (r_int * ylm_i[i]) * dsfac_arr[1];
+              m_dclist_i[((n - 1) * m_numYlms + i) * 3 + 2] += (r_int * ylm_i[i]) * dsfac_arr[2];
 
               i += 1;
             }
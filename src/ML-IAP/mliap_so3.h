@@ -8,7 +8,7 @@ namespace LAMMPS_NS {
 class MLIAP_SO3 : protected Pointers {
 
  public:
-  MLIAP_SO3(LAMMPS *, double vrcut, int vlmax, int vnmax, double valpha);
+  MLIAP_SO3(LAMMPS *, double vrcut, int vlmax, int vnmax, double valpha, int vntable = 0);
   MLIAP_SO3(LAMMPS *lmp) : Pointers(lmp){};
 
   ~MLIAP_SO3() override;
@@ -47,6 +47,16 @@ class MLIAP_SO3 : protected Pointers {
   double *m_Ylms_r, *m_Ylms_i, *m_dYlm_r, *m_dYlm_i;
   double *m_dclist_r, *m_dclist_i, *m_tempdp_r;
 
+  // optional cubic spline tables of the radial integrals with m_ntable intervals
+  // and per-pair cache of tabulated radial and angular terms, which is shared
+  // by spectrum() and spectrum_dxdr() as long as the pair distances are unchanged
+
+  int m_ntable;
+  double m_dtable;
+  double *m_rip_table, *m_rip_dtable;
+  double *m_ylm_cache_r, *m_ylm_cache_i, *m_rij_cache;
+  bigint m_cache_npairs, m_cache_max;
+
  public:
   void spectrum(int nlocal, int *numneighs, int *jelems, double *wjelem, double **rij, int nmax,
                 int lmax, double rcut, double alpha, int ncoefs);
@@ -61,6 +71,11 @@ class MLIAP_SO3 : protected Pointers {
   void get_sbes_array(int nlocal, int *numneighs, double **rij, int lmax, double rcut,
                       double alpha);
   void get_rip_array(int nlocal, int *numneighs, double **rij, int nmax, int lmax, double alpha);
+  void init_table();
+  void spline_table(double *table);
+  void fill_pair_cache(int nlocal, int *numneighs, double **rij, bigint npairs);
+  int pair_cache_valid(int nlocal, int *numneighs, double **rij, bigint npairs);
+  void compute_ylms(double *ylms_r, double *ylms_i);
   void init_arrays(int nlocal, int ncoefs);
   void init_garray(int nmax, int lmax, double rcut, double alpha, double *w, int lw1,
                    double *g_array, int lg2);
@@ -30,6 +30,7 @@
 #endif
 
 #include "atom.h"
+#include "comm.h"
 #include "error.h"
 #include "force.h"
 #include "memory.h"
@@ -43,7 +44,8 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 PairMLIAP::PairMLIAP(LAMMPS *lmp) :
-    Pair(lmp), map(nullptr), model(nullptr), descriptor(nullptr), data(nullptr)
+    Pair(lmp), map(nullptr), model(nullptr), descriptor(nullptr), data(nullptr),
+    betasum(nullptr), esum(nullptr), fcommittee(nullptr), variance(nullptr)
 {
   single_enable = 0;
   restartinfo = 0;
@@ -53,6 +55,9 @@ PairMLIAP::PairMLIAP(LAMMPS *lmp) :
   centroidstressflag = CENTROID_NOTAVAIL;
   model=nullptr;
   descriptor=nullptr;
+  variance_flag = 0;
+  nmax = 0;
+  nlistmax = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -62,8 +67,13 @@ PairMLIAP::~PairMLIAP()
   if (copymode) return;
 
   delete model;
+  for (auto &member : committee) delete member;
   delete descriptor;
   delete data;
+  memory->destroy(betasum);
+  memory->destroy(esum);
+  memory->destroy(fcommittee);
+  memory->destroy(variance);
   model=nullptr;
   descriptor=nullptr;
   data=nullptr;
@@ -91,7 +101,22 @@ void PairMLIAP::compute(int eflag, int vflag)
     error->all(FLERR, "Inconsistent model and descriptor element count: {} vs {}",
                model->nelements, data->nelements);
 
+  for (auto &member : committee)
+    if ((member->ndescriptors != data->ndescriptors) || (member->nelements != data->nelements))
+      error->all(FLERR, "Inconsistent committee model and descriptor descriptor or element count");
+
   ev_init(eflag, vflag);
+
+  // committee needs per-atom energies of all members for the variance
+
+  if (!committee.empty()) {
+    data->graddescflag = variance_flag;
+    data->generate_neighdata(list, eflag || variance_flag, vflag);
+    compute_committee();
+    if (vflag_fdotr) virial_fdotr_compute();
+    return;
+  }
+
   data->generate_neighdata(list, eflag, vflag);
 
   // compute descriptors, if needed
@@ -112,6 +137,143 @@ void PairMLIAP::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   committee force calculation
+   descriptors are computed once and all members are evaluated on them
+   the force is linear in the betas, so the mean force of the committee
+   is computed in a single pass with the mean betas of all members
+------------------------------------------------------------------------- */
+
+void PairMLIAP::compute_committee()
+{
+  const int nmembers = committee.size() + 1;
+  const int ndescriptors = data->ndescriptors;
+  const int nlist = data->nlistatoms;
+
+  descriptor->compute_descriptors(data);
+
+  if (nlist > nlistmax) {
+    nlistmax = nlist;
+    memory->grow(betasum, nlistmax, ndescriptors, "pair:betasum");
+    memory->grow(esum, nlistmax, nmembers, "pair:esum");
+  }
+
+  // per-member forces need the gradient of each descriptor w.r.t. each neighbor
+
+  if (variance_flag) {
+    if (atom->nmax > nmax) {
+      nmax = atom->nmax;
+      memory->grow(fcommittee, nmax, 3 * nmembers, "pair:fcommittee");
+      memory->grow(variance, nmax, 2, "pair:variance");
+    }
+    const int nall = atom->nlocal + atom->nghost;
+    for (int i = 0; i < nall; i++)
+      for (int k = 0; k < 3 * nmembers; k++) fcommittee[i][k] = 0.0;
+    descriptor->compute_descriptor_gradients(data);
+  }
+
+  for (int ii = 0; ii < nlist; ii++)
+    for (int k = 0; k < ndescriptors; k++) betasum[ii][k] = 0.0;
+
+  double energy = 0.0;
+
+  for (int m = 0; m < nmembers; m++) {
+    MLIAPModel *member = (m == 0) ? model : committee[m - 1];
+    member->compute_gradients(data);
+    energy += data->energy;
+
+    for (int ii = 0; ii < nlist; ii++) {
+      for (int k = 0; k < ndescriptors; k++) betasum[ii][k] += data->betas[ii][k];
+      if (data->eflag) esum[ii][m] = data->eatoms[ii];
+    }
+
+    // force of this member: add beta_i.dB_i/dR_j to Fi, subtract from Fj
+
+    if (variance_flag) {
+      int ij = 0;
+      for (int ii = 0; ii < nlist; ii++) {
+        const int i = data->iatoms[ii];
+        const double *beta = data->betas[ii];
+        for (int jj = 0; jj < data->numneighs[ii]; jj++) {
+          const int j = data->jatoms[ij];
+          double fij[3] = {0.0, 0.0, 0.0};
+          for (int k = 0; k < ndescriptors; k++) {
+            fij[0] += beta[k] * data->graddesc[ij][k][0];
+            fij[1] += beta[k] * data->graddesc[ij][k][1];
+            fij[2] += beta[k] * data->graddesc[ij][k][2];
+          }
+          for (int d = 0; d < 3; d++) {
+            fcommittee[i][3 * m + d] += fij[d];
+            fcommittee[j][3 * m + d] -= fij[d];
+          }
+          ij++;
+        }
+      }
+    }
+  }
+
+  // dynamics follows the committee mean
+
+  const double inv = 1.0 / nmembers;
+  for (int ii = 0; ii < nlist; ii++) {
+    for (int k = 0; k < ndescriptors; k++) data->betas[ii][k] = betasum[ii][k] * inv;
+    if (data->eflag) {
+      double etmp = 0.0;
+      for (int m = 0; m < nmembers; m++) etmp += esum[ii][m];
+      data->eatoms[ii] = etmp * inv;
+    }
+  }
+  data->energy = energy * inv;
+
+  descriptor->compute_forces(data);
+  e_tally(data);
+
+  if (variance_flag) committee_variance();
+}
+
+/* ----------------------------------------------------------------------
+   variance of per-atom energy and force of committee members
+   variance[i][0] = energy variance, variance[i][1] = sum of the
+   variances of the three force components
+------------------------------------------------------------------------- */
+
+void PairMLIAP::committee_variance()
+{
+  const int nmembers = committee.size() + 1;
+  const double inv = 1.0 / nmembers;
+  const int nlocal = atom->nlocal;
+
+  comm->reverse_comm(this);
+
+  for (int i = 0; i < nlocal; i++) {
+    double fvar = 0.0;
+    for (int d = 0; d < 3; d++) {
+      double fmean = 0.0;
+      for (int m = 0; m < nmembers; m++) fmean += fcommittee[i][3 * m + d];
+      fmean *= inv;
+      for (int m = 0; m < nmembers; m++) {
+        const double delta = fcommittee[i][3 * m + d] - fmean;
+        fvar += delta * delta;
+      }
+    }
+    variance[i][0] = 0.0;
+    variance[i][1] = fvar * inv;
+  }
+
+  for (int ii = 0; ii < data->nlistatoms; ii++) {
+    const int i = data->iatoms[ii];
+    double emean = 0.0;
+    for (int m = 0; m < nmembers; m++) emean += esum[ii][m];
+    emean *= inv;
+    double evar = 0.0;
+    for (int m = 0; m < nmembers; m++) {
+      const double delta = esum[ii][m] - emean;
+      evar += delta * delta;
+    }
+    variance[i][0] = evar * inv;
+  }
+}
+
 /* ----------------------------------------------------------------------
    allocate all arrays
 ------------------------------------------------------------------------- */
@@ -141,6 +303,8 @@ void PairMLIAP::settings(int narg, char ** arg)
     model = nullptr;
     delete descriptor;
     descriptor = nullptr;
+    for (auto &member : committee) delete member;
+    committee.clear();
   }
 
   // process keywords
@@ -149,27 +313,19 @@ void PairMLIAP::settings(int narg, char ** arg)
     if (strcmp(arg[iarg],"model") == 0) {
       if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap model", error);
       if (model != nullptr) error->all(FLERR,"Illegal multiple pair_style mliap model definition");
-      if (strcmp(arg[iarg+1],"linear") == 0) {
-        if (iarg+3 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap model linear", error);
-        model = new MLIAPModelLinear(lmp,arg[iarg+2]);
-        iarg += 3;
-      } else if (strcmp(arg[iarg+1],"quadratic") == 0) {
-        if (iarg+3 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap model quadratic", error);
-        model = new MLIAPModelQuadratic(lmp,arg[iarg+2]);
-        iarg += 3;
-      } else if (strcmp(arg[iarg+1],"nn") == 0) {
-        if (iarg+3 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap model nn", error);
-        model = new MLIAPModelNN(lmp,arg[iarg+2]);
-        iarg += 3;
-      } else if (strcmp(arg[iarg+1],"mliappy") == 0) {
-#ifdef MLIAP_PYTHON
-        if (iarg+3 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap mliappy", error);
-        model = new MLIAPModelPython(lmp,arg[iarg+2]);
-        iarg += 3;
-#else
-        error->all(FLERR,"Using pair_style mliap model mliappy requires ML-IAP with python support");
-#endif
-      } else error->all(FLERR,"Unknown pair_style mliap model keyword: {}", arg[iarg]);
+      if (iarg+3 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap model", error);
+      model = create_model(arg[iarg+1],arg[iarg+2]);
+      iarg += 3;
+    } else if (strcmp(arg[iarg],"committee") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap committee", error);
+      int nextra = utils::inumeric(FLERR,arg[iarg+1],false,lmp);
+      if (nextra < 1) error->all(FLERR,"Illegal pair_style mliap committee size: {}", nextra);
+      if (iarg+2+2*nextra > narg) utils::missing_cmd_args(FLERR, "pair_style mliap committee", error);
+      iarg += 2;
+      for (int m = 0; m < nextra; m++) {
+        committee.push_back(create_model(arg[iarg],arg[iarg+1]));
+        iarg += 2;
+      }
     } else if (strcmp(arg[iarg],"descriptor") == 0) {
       if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "pair_style mliap descriptor", error);
       if (descriptor != nullptr) error->all(FLERR,"Illegal multiple pair_style mliap descriptor definition");
@@ -207,6 +363,31 @@ void PairMLIAP::settings(int narg, char ** arg)
 
   if (model == nullptr || descriptor == nullptr)
     error->all(FLERR,"Incomplete pair_style mliap setup: need model and descriptor, or unified");
+  if (!committee.empty() && is_child)
+    error->all(FLERR,"Pair style mliap committee is not supported by accelerated variants");
+
+  // reverse communication of the force of each committee member
+
+  comm_reverse = 3 * (committee.size() + 1);
+}
+
+/* ----------------------------------------------------------------------
+   create model of given style from coefficient file
+------------------------------------------------------------------------- */
+
+MLIAPModel *PairMLIAP::create_model(const char *style, char *file)
+{
+  if (strcmp(style,"linear") == 0) return new MLIAPModelLinear(lmp,file);
+  else if (strcmp(style,"quadratic") == 0) return new MLIAPModelQuadratic(lmp,file);
+  else if (strcmp(style,"nn") == 0) return new MLIAPModelNN(lmp,file);
+  else if (strcmp(style,"mliappy") == 0) {
+#ifdef MLIAP_PYTHON
+    return new MLIAPModelPython(lmp,file);
+#else
+    error->all(FLERR,"Using pair_style mliap model mliappy requires ML-IAP with python support");
+#endif
+  } else error->all(FLERR,"Unknown pair_style mliap model keyword: {}", style);
+  return nullptr;
 }
 
 /* ----------------------------------------------------------------------
@@ -259,6 +440,7 @@ void PairMLIAP::coeff(int narg, char **arg)
   // set up model, descriptor, and mliap data structures
 
   model->init();
+  for (auto &member : committee) member->init();
   descriptor->init();
   constexpr int gradgradflag = -1;
   delete data;
@@ -352,6 +534,50 @@ double PairMLIAP::init_one(int i, int j)
   return cutmax;
 }
 
+/* ----------------------------------------------------------------------
+   trigger for per-atom variance of committee, set by fix pair
+------------------------------------------------------------------------- */
+
+void *PairMLIAP::extract(const char *str, int &dim)
+{
+  dim = 0;
+  if (!committee.empty() && (strcmp(str,"variance_flag") == 0)) return (void *) &variance_flag;
+  return nullptr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void *PairMLIAP::extract_peratom(const char *str, int &ncol)
+{
+  if (!committee.empty() && (strcmp(str,"variance") == 0)) {
+    ncol = 2;
+    return (void *) variance;
+  }
+  return nullptr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+int PairMLIAP::pack_reverse_comm(int n, int first, double *buf)
+{
+  int m = 0;
+  const int last = first + n;
+  for (int i = first; i < last; i++)
+    for (int k = 0; k < comm_reverse; k++) buf[m++] = fcommittee[i][k];
+  return m;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void PairMLIAP::unpack_reverse_comm(int n, int *list, double *buf)
+{
+  int m = 0;
+  for (int i = 0; i < n; i++) {
+    const int j = list[i];
+    for (int k = 0; k < comm_reverse; k++) fcommittee[j][k] += buf[m++];
+  }
+}
+
 /* ----------------------------------------------------------------------
    memory usage
 ------------------------------------------------------------------------- */
@@ -367,6 +593,11 @@ double PairMLIAP::memory_usage()
   bytes += (double)n*sizeof(int);              // map
   bytes += descriptor->memory_usage(); // Descriptor object
   bytes += model->memory_usage();      // Model object
+  for (auto &member : committee) bytes += member->memory_usage();
+  bytes += (double)nlistmax*data->ndescriptors*sizeof(double);    // betasum
+  bytes += (double)nlistmax*(committee.size()+1)*sizeof(double);  // esum
+  bytes += (double)nmax*3*(committee.size()+1)*sizeof(double);    // fcommittee
+  bytes += (double)nmax*2*sizeof(double);                         // variance
   bytes += data->memory_usage();       // Data object
 
   return bytes;
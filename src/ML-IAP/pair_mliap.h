@@ -22,6 +22,8 @@ PairStyle(mliap,PairMLIAP);
 
 #include "pair.h"
 
+#include <vector>
+
 namespace LAMMPS_NS {
 
 class PairMLIAP : public Pair {
@@ -35,16 +37,35 @@ class PairMLIAP : public Pair {
   void v_tally(int, int, double *, double *);
   void init_style() override;
   double init_one(int, int) override;
+  void *extract(const char *, int &) override;
+  void *extract_peratom(const char *, int &) override;
+  int pack_reverse_comm(int, int, double *) override;
+  void unpack_reverse_comm(int, int *, double *) override;
   double memory_usage() override;
   int *map;    // mapping from atom types to elements
 
  protected:
   virtual void allocate();
+  class MLIAPModel *create_model(const char *, char *);
+  void compute_committee();
+  void committee_variance();
 
   class MLIAPModel *model;
   class MLIAPDescriptor *descriptor;
   class MLIAPData *data;
   bool is_child;
+
+  // committee mode: model and committee[] are evaluated on the same descriptors,
+  // forces and energies are the committee mean
+
+  std::vector<class MLIAPModel *> committee;    // committee members besides model
+  int variance_flag;      // 1 if per-atom variance is computed on this step
+  int nmax;               // allocated size of per-atom committee arrays
+  int nlistmax;           // allocated size of committee arrays for atoms in list
+  double **betasum;       // sum of betas of all members for each atom in list
+  double **esum;          // energy of each member for each atom in list
+  double **fcommittee;    // force of each member on each owned and ghost atom
+  double **variance;      // variance of energy and force of each owned atom
 };
 
 }    // namespace LAMMPS_NS
@@ -23,9 +23,11 @@ Copyright 2022 Yury Lysogorskiy^1, Anton Bochkarev^1, Matous Mrovec^1, Ralf Drau
 
 #include "pair_pace_extrapolation.h"
 
+#include "async_writer.h"
 #include "atom.h"
 #include "comm.h"
 #include "error.h"
+#include "file_writer.h"
 #include "force.h"
 #include "math_const.h"
 #include "memory.h"
@@ -100,6 +102,12 @@ PairPACEExtrapolation::PairPACEExtrapolation(LAMMPS *lmp) : Pair(lmp)
   extrapolation_grade_gamma = nullptr;
 
   chunksize = 4096;
+
+  uncertain_flag = 0;
+  uncertain_binary = 0;
+  gamma_lo = gamma_hi = 0.0;
+  uncertain_fp = nullptr;
+  uncertain_writer = nullptr;
 }
 
 /* ----------------------------------------------------------------------
@@ -112,6 +120,11 @@ PairPACEExtrapolation::~PairPACEExtrapolation()
 
   delete aceimpl;
 
+  // finish pending output before closing file
+
+  delete uncertain_writer;
+  if (uncertain_fp) fclose(uncertain_fp);
+
   if (allocated) {
     memory->destroy(setflag);
     memory->destroy(cutsq);
@@ -260,6 +273,143 @@ void PairPACEExtrapolation::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 
   // end modifications YL
+
+  if (flag_compute_extrapolation_grade && uncertain_flag) {
+    pack_uncertain();
+    write_uncertain();
+  }
+}
+
+/* ----------------------------------------------------------------------
+   pack local environment of each of my atoms with gamma_lo <= gamma < gamma_hi
+   record = timestep, atom ID, gamma, # of atoms N, N x (atomic number, x, y, z)
+   the uncertain atom comes first and positions are relative to it,
+   followed by all its neighbors within the cutoff of the potential
+------------------------------------------------------------------------- */
+
+void PairPACEExtrapolation::pack_uncertain()
+{
+  double **x = atom->x;
+  int *type = atom->type;
+  tagint *tag = atom->tag;
+  const double ntimestep = update->ntimestep;
+
+  uncertain_buf.clear();
+
+  for (int ii = 0; ii < list->inum; ii++) {
+    const int i = list->ilist[ii];
+    const double gamma = extrapolation_grade_gamma[i];
+    if ((gamma < gamma_lo) || (gamma >= gamma_hi)) continue;
+
+    const int itype = type[i];
+    const int *jlist = list->firstneigh[i];
+    const int jnum = list->numneigh[i];
+
+    uncertain_buf.push_back(ntimestep);
+    uncertain_buf.push_back(tag[i]);
+    uncertain_buf.push_back(gamma);
+    const size_t ncount = uncertain_buf.size();
+    uncertain_buf.push_back(1.0);
+    uncertain_buf.push_back(type2number[itype]);
+    uncertain_buf.push_back(0.0);
+    uncertain_buf.push_back(0.0);
+    uncertain_buf.push_back(0.0);
+
+    int count = 1;
+    for (int jj = 0; jj < jnum; jj++) {
+      const int j = jlist[jj] & NEIGHMASK;
+      const int jtype = type[j];
+      if (map[jtype] < 0) continue;
+      const double delx = x[j][0] - x[i][0];
+      const double dely = x[j][1] - x[i][1];
+      const double delz = x[j][2] - x[i][2];
+      if (delx * delx + dely * dely + delz * delz >= cutsq[itype][jtype]) continue;
+      uncertain_buf.push_back(type2number[jtype]);
+      uncertain_buf.push_back(delx);
+      uncertain_buf.push_back(dely);
+      uncertain_buf.push_back(delz);
+      count++;
+    }
+    uncertain_buf[ncount] = count;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   gather packed environments of all procs on proc 0 and write them there
+   as extended XYZ or binary records on a background thread, so that
+   formatting and file I/O overlap with the next MD steps
+------------------------------------------------------------------------- */
+
+void PairPACEExtrapolation::write_uncertain()
+{
+  const int me = comm->me;
+  const int nprocs = comm->nprocs;
+  int nmine = uncertain_buf.size();
+
+  std::vector<int> counts(nprocs), displs(nprocs);
+  MPI_Gather(&nmine, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, world);
+
+  std::vector<double> all;
+  if (me == 0) {
+    int ntotal = 0;
+    for (int p = 0; p < nprocs; p++) {
+      displs[p] = ntotal;
+      ntotal += counts[p];
+    }
+    all.resize(ntotal);
+  }
+  MPI_Gatherv(uncertain_buf.data(), nmine, MPI_DOUBLE, all.data(), counts.data(), displs.data(),
+              MPI_DOUBLE, 0, world);
+  if ((me != 0) || all.empty()) return;
+
+  FILE *out = uncertain_fp;
+  const int binary = uncertain_binary;
+
+  auto task = [out, binary, all]() {
+    if (binary) {
+      if (fwrite(all.data(), sizeof(double), all.size(), out) != all.size())
+        throw FileWriterException("Error writing pace/extrapolation uncertain file");
+      return;
+    }
+    std::string text;
+    for (size_t m = 0; m < all.size();) {
+      const int n = static_cast<int>(all[m + 3]);
+      text += fmt::format("{}\nProperties=species:S:1:pos:R:3 timestep={} id={} gamma={:.8g} "
+                          "pbc=\"F F F\"\n",
+                          n, static_cast<bigint>(all[m]), static_cast<tagint>(all[m + 1]),
+                          all[m + 2]);
+      m += 4;
+      for (int k = 0; k < n; k++, m += 4)
+        text += fmt::format("{} {:.8f} {:.8f} {:.8f}\n",
+                            elements_pace_al[static_cast<int>(all[m])], all[m + 1], all[m + 2],
+                            all[m + 3]);
+    }
+    if (fputs(text.c_str(), out) < 0)
+      throw FileWriterException("Error writing pace/extrapolation uncertain file");
+  };
+
+  if (!uncertain_writer) uncertain_writer = new AsyncWriter();
+  try {
+    uncertain_writer->submit(task);
+  } catch (FileWriterException &e) {
+    error->one(FLERR, e.what());
+  }
+}
+
+/* ----------------------------------------------------------------------
+   uncertain file is complete at the end of a run
+------------------------------------------------------------------------- */
+
+void PairPACEExtrapolation::finish()
+{
+  if (!uncertain_writer) return;
+
+  try {
+    uncertain_writer->wait();
+  } catch (FileWriterException &e) {
+    error->one(FLERR, e.what());
+  }
+  fflush(uncertain_fp);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -281,17 +431,47 @@ void PairPACEExtrapolation::allocate()
 
 void PairPACEExtrapolation::settings(int narg, char **arg)
 {
-//  if (narg > 2) error->all(FLERR, "Pair style pace/extrapolation supports no keywords");
-  if (narg > 2) utils::missing_cmd_args(FLERR, "pair_style pace/extrapolation", error);
   // ACE potentials are parameterized in metal units
   if (strcmp("metal", update->unit_style) != 0)
     error->all(FLERR, "ACE potentials require 'metal' units");
 
+  // output of uncertain environments is off unless requested again,
+  // finish pending output of a previous pair_style command and close its file
+
+  uncertain_flag = 0;
+  uncertain_binary = 0;
+  gamma_lo = gamma_hi = 0.0;
+  delete uncertain_writer;
+  uncertain_writer = nullptr;
+  if (uncertain_fp) fclose(uncertain_fp);
+  uncertain_fp = nullptr;
+
   int iarg = 0;
   while (iarg < narg) {
       if (strcmp(arg[iarg], "chunksize") == 0) {
+          if (iarg + 2 > narg)
+            utils::missing_cmd_args(FLERR, "pair_style pace/extrapolation chunksize", error);
           chunksize = utils::inumeric(FLERR, arg[iarg + 1], false, lmp);
           iarg += 2;
+      } else if (strcmp(arg[iarg], "uncertain") == 0) {
+          if (iarg + 4 > narg)
+            utils::missing_cmd_args(FLERR, "pair_style pace/extrapolation uncertain", error);
+          gamma_lo = utils::numeric(FLERR, arg[iarg + 1], false, lmp);
+          gamma_hi = utils::numeric(FLERR, arg[iarg + 2], false, lmp);
+          if ((gamma_lo < 0.0) || (gamma_hi <= gamma_lo))
+            error->all(FLERR, "Illegal pair_style pace/extrapolation uncertain range: {} {}",
+                       arg[iarg + 1], arg[iarg + 2]);
+          uncertain_binary = (utils::strmatch(arg[iarg + 3], "\\.bin$") ||
+                              utils::strmatch(arg[iarg + 3], "\\.lammpsbin$")) ? 1 : 0;
+          if (comm->me == 0) {
+            if (uncertain_fp) fclose(uncertain_fp);
+            uncertain_fp = fopen(arg[iarg + 3], uncertain_binary ? "wb" : "w");
+            if (!uncertain_fp)
+              error->one(FLERR, "Cannot open pace/extrapolation uncertain file {}: {}",
+                         arg[iarg + 3], utils::getsyserror());
+          }
+          uncertain_flag = 1;
+          iarg += 4;
       } else
           error->all(FLERR, "Unknown pair_style pace keyword: {}", arg[iarg]);
   }
@@ -357,6 +537,7 @@ void PairPACEExtrapolation::coeff(int narg, char **arg)
 
   const int n = atom->ntypes;
   element_names.resize(n);
+  type2number.assign(n + 1, 0);
   for (int i = 1; i <= n; i++) {
     char *elemname = elemtypes[i - 1];
     element_names[i - 1] = elemname;
@@ -370,6 +551,7 @@ void PairPACEExtrapolation::coeff(int narg, char **arg)
       // dump species types for reconstruction of atomic configurations
       int atomic_number = AtomicNumberByName_pace_al(elemname);
       if (atomic_number == -1) error->all(FLERR, "'{}' is not a valid element\n", elemname);
+      type2number[i] = atomic_number;
       SPECIES_TYPE mu = aceimpl->basis_set->get_species_index_by_name(elemname);
       if (mu != -1) {
         if (comm->me == 0)
@@ -28,6 +28,7 @@ PairStyle(pace/extrapolation,PairPACEExtrapolation)
 #define LMP_PAIR_PACE_AL_H
 
 #include "pair.h"
+#include <cstdio>
 #include <vector>
 
 namespace LAMMPS_NS {
@@ -44,6 +45,7 @@ class PairPACEExtrapolation : public Pair {
   double init_one(int, int) override;
   void *extract(const char *, int &) override;
   void *extract_peratom(const char *, int &) override;
+  void finish() override;
 
  protected:
   struct ACEALImpl *aceimpl;
@@ -58,6 +60,20 @@ class PairPACEExtrapolation : public Pair {
   double **scale;
 
   int chunksize;
+
+  // local environments of atoms with gamma_lo <= gamma < gamma_hi are buffered
+  // on gamma evaluation steps and written by proc 0 on a background thread
+
+  int uncertain_flag;
+  int uncertain_binary;                  // 1 for binary output, 0 for extxyz
+  double gamma_lo, gamma_hi;
+  FILE *uncertain_fp;
+  class AsyncWriter *uncertain_writer;
+  std::vector<int> type2number;          // atomic number of each atom type, 0 if NULL
+  std::vector<double> uncertain_buf;     // packed environments of my uncertain atoms
+
+  void pack_uncertain();
+  void write_uncertain();
 };
 
 }    // namespace LAMMPS_NS
@@ -43,6 +43,7 @@ using namespace LAMMPS_NS;
 
 DumpCustomMPIIO::DumpCustomMPIIO(LAMMPS *lmp, int narg, char **arg) : DumpCustom(lmp, narg, arg)
 {
+  async_allow = 0;
   if (me == 0)
     error->warning(FLERR, "MPI-IO output is unmaintained and unreliable. Use with caution.");
 }
@@ -0,0 +1,152 @@
+// clang-format off
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "compute_rdf_omp.h"
+
+#include "atom.h"
+#include "comm.h"
+#include "force.h"
+#include "neigh_list.h"
+#include "neighbor.h"
+
+#include <cmath>
+
+#include "omp_compat.h"
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+ComputeRDFOMP::ComputeRDFOMP(LAMMPS *lmp, int narg, char **arg) :
+  ComputeRDF(lmp, narg, arg) { }
+
+/* ----------------------------------------------------------------------
+   same as ComputeRDF::tally() with the loop over my atoms split across
+   threads, each thread counts into its own copy of hist and coord
+   counts are integers, so the result does not depend on the # of threads
+------------------------------------------------------------------------- */
+
+void ComputeRDFOMP::tally()
+{
+  const int nthreads = comm->nthreads;
+  const int nhist = npairs*nbin;
+  const int stride = nhist + npairs;
+  thrhist.assign((size_t) nthreads*stride, 0.0);
+  double *thrbuf = thrhist.data();
+
+#if defined(_OPENMP)
+#pragma omp parallel LMP_DEFAULT_NONE LMP_SHARED(thrbuf)
+#endif
+  {
+#if defined(_OPENMP)
+    const int tid = omp_get_thread_num();
+#else
+    const int tid = 0;
+#endif
+    double *thist = thrbuf + (size_t) tid*stride;
+    double *tcoord = thist + nhist;
+
+    int i,j,m,ii,jj,jnum,itype,jtype,ipair,jpair,ibin,ihisto,incoord;
+    double xtmp,ytmp,ztmp,delx,dely,delz,rsq,r,factor_lj,factor_coul;
+    int *jlist;
+
+    const int inum = list->inum;
+    const int * const ilist = list->ilist;
+    const int * const numneigh = list->numneigh;
+    int ** const firstneigh = list->firstneigh;
+
+    const double * const * const x = atom->x;
+    const int * const type = atom->type;
+    const int * const mask = atom->mask;
+    const int nlocal = atom->nlocal;
+
+    const double * const special_coul = force->special_coul;
+    const double * const special_lj = force->special_lj;
+    const int newton_pair = force->newton_pair;
+    const double cutcoordsq = cutcoord*cutcoord;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (ii = 0; ii < inum; ii++) {
+      i = ilist[ii];
+      if (!(mask[i] & groupbit)) continue;
+      xtmp = x[i][0];
+      ytmp = x[i][1];
+      ztmp = x[i][2];
+      itype = type[i];
+      jlist = firstneigh[i];
+      jnum = numneigh[i];
+
+      for (jj = 0; jj < jnum; jj++) {
+        j = jlist[jj];
+        factor_lj = special_lj[sbmask(j)];
+        factor_coul = special_coul[sbmask(j)];
+        j &= NEIGHMASK;
+
+        if (factor_lj == 0.0 && factor_coul == 0.0) continue;
+
+        if (!(mask[j] & groupbit)) continue;
+        jtype = type[j];
+        ipair = nrdfpair[itype][jtype];
+        jpair = nrdfpair[jtype][itype];
+        if (!ipair && !jpair) continue;
+
+        delx = xtmp - x[j][0];
+        dely = ytmp - x[j][1];
+        delz = ztmp - x[j][2];
+        rsq = delx*delx + dely*dely + delz*delz;
+        r = sqrt(rsq);
+        ibin = static_cast<int> (r*delrinv);
+        if (ibin >= nbin) continue;
+        incoord = (rsq < cutcoordsq);
+
+        for (ihisto = 0; ihisto < ipair; ihisto++) {
+          m = rdfpair[ihisto][itype][jtype];
+          thist[m*nbin+ibin] += 1.0;
+          if (incoord) tcoord[m] += 1.0;
+        }
+        if (newton_pair || j < nlocal) {
+          for (ihisto = 0; ihisto < jpair; ihisto++) {
+            m = rdfpair[ihisto][jtype][itype];
+            thist[m*nbin+ibin] += 1.0;
+            if (incoord) tcoord[m] += 1.0;
+          }
+        }
+      }
+    }
+
+    // sum per-thread counts, each thread reduces a chunk of the bins
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (int k = 0; k < stride; k++) {
+      double sum = 0.0;
+      for (int t = 0; t < nthreads; t++) sum += thrbuf[(size_t) t*stride+k];
+      if (k < nhist) hist[k/nbin][k%nbin] = sum;
+      else if (coord) coord[k-nhist] = sum;
+    }
+  }
+}
+
+/* ---------------------------------------------------------------------- */
+
+double ComputeRDFOMP::memory_usage()
+{
+  return ComputeRDF::memory_usage() + (double) thrhist.capacity() * sizeof(double);
+}
@@ -0,0 +1,44 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifdef COMPUTE_CLASS
+// clang-format off
+ComputeStyle(rdf/omp,ComputeRDFOMP);
+// clang-format on
+#else
+
+#ifndef LMP_COMPUTE_RDF_OMP_H
+#define LMP_COMPUTE_RDF_OMP_H
+
+#include "compute_rdf.h"
+
+#include <vector>
+
+namespace LAMMPS_NS {
+
+class ComputeRDFOMP : public ComputeRDF {
+ public:
+  ComputeRDFOMP(class LAMMPS *, int, char **);
+  double memory_usage() override;
+
+ protected:
+  void tally() override;
+
+ private:
+  std::vector<double> thrhist;    // per-thread histograms and coord counts
+};
+
+}    // namespace LAMMPS_NS
+
+#endif
+#endif
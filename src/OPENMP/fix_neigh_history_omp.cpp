@@ -528,11 +528,12 @@ void FixNeighHistoryOMP::post_neighbor()
     const int tid = 0;
 #endif
 
-    int i, j, ii, jj, m, nn, np, inum, jnum, rflag;
+    int i, j, ii, jj, m, nn, np, inum, jnum, rflag, usehash;
     tagint jtag;
     int *ilist, *jlist, *numneigh, **firstneigh;
     int *allflags;
     double *allvalues;
+    PartnerHash thrhash;
 
     MyPage<int> &ipg = ipage_neigh[tid];
     MyPage<double> &dpg = dpage_neigh[tid];
@@ -564,6 +565,8 @@ void FixNeighHistoryOMP::post_neighbor()
       firstvalue[i] = allvalues = dpg.get(jnum * dnum);
       np = npartner[i];
       nn = 0;
+      usehash = (np > NPARTNER_LINEAR);
+      if (usehash) thrhash.build(partner[i], np);
 
       for (jj = 0; jj < jnum; jj++) {
         j = jlist[jj];
@@ -577,8 +580,13 @@ void FixNeighHistoryOMP::post_neighbor()
 
         if (rflag) {
           jtag = tag[j];
-          for (m = 0; m < np; m++)
-            if (partner[i][m] == jtag) break;
+          if (usehash) {
+            m = thrhash.find(jtag);
+            if (m < 0) m = np;
+          } else {
+            for (m = 0; m < np; m++)
+              if (partner[i][m] == jtag) break;
+          }
           if (m < np) {
             allflags[jj] = 1;
             memcpy(&allvalues[nn], &valuepartner[i][dnum * m], dnumbytes);
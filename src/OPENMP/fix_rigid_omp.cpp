@@ -20,7 +20,6 @@
 #include "fix_rigid_omp.h"
 
 #include <cmath>
-#include <cstring>
 #include "atom.h"
 #include "atom_vec_ellipsoid.h"
 #include "atom_vec_line.h"
@@ -152,18 +151,19 @@ void FixRigidOMP::compute_forces_and_torques()
 
   } else if (rstyle == GROUP) {
 
-     // we likely have only a rather number of groups so we loops
-     // over bodies and thread over all atoms for each of them.
+     // we likely have only a rather small number of groups so we loop
+     // over bodies and thread over the atoms of each of them.
 
      for (int ib = 0; ib < nbody; ++ib) {
+       const int kfirst = bodyfirst[ib];
+       const int klast = bodyfirst[ib+1];
        double s0=0.0,s1=0.0,s2=0.0,s3=0.0,s4=0.0,s5=0.0;
 
 #if defined(_OPENMP)
 #pragma omp parallel for LMP_DEFAULT_NONE LMP_SHARED(ib) reduction(+:s0,s1,s2,s3,s4,s5)
 #endif
-       for (int i = 0; i < nlocal; i++) {
-         const int ibody = body[i];
-         if (ibody != ib) continue;
+       for (int k = kfirst; k < klast; k++) {
+         const int i = bodyatom[k];
 
          s0 += f[i].x;
          s1 += f[i].y;
@@ -171,9 +171,9 @@ void FixRigidOMP::compute_forces_and_torques()
 
          double unwrap[3];
          domain->unmap(x[i],xcmimage[i],unwrap);
-         const double dx = unwrap[0] - xcm[ibody][0];
-         const double dy = unwrap[1] - xcm[ibody][1];
-         const double dz = unwrap[2] - xcm[ibody][2];
+         const double dx = unwrap[0] - xcm[ib][0];
+         const double dy = unwrap[1] - xcm[ib][1];
+         const double dz = unwrap[2] - xcm[ib][2];
 
          s3 += dy*f[i].z - dz*f[i].y;
          s4 += dz*f[i].x - dx*f[i].z;
@@ -193,25 +193,17 @@ void FixRigidOMP::compute_forces_and_torques()
   } else if (rstyle == MOLECULE) {
 
      // we likely have a large number of rigid objects with only a
-     // a few atoms each. so we loop over all atoms for all threads
-     // and then each thread only processes some bodies.
-
-     const int nthreads=comm->nthreads;
-     memset(&sum[0][0],0,6*nbody*sizeof(double));
+     // few atoms each. atoms are grouped by body in bodyfirst/bodyatom,
+     // so we thread over bodies and each thread only sums its own bodies.
 
 #if defined(_OPENMP)
-#pragma omp parallel LMP_DEFAULT_NONE
-#endif
-     {
-#if defined(_OPENMP)
-       const int tid = omp_get_thread_num();
-#else
-       const int tid = 0;
+#pragma omp parallel for LMP_DEFAULT_NONE schedule(static)
 #endif
+     for (int ibody = 0; ibody < nbody; ibody++) {
+       double s0=0.0,s1=0.0,s2=0.0,s3=0.0,s4=0.0,s5=0.0;
 
-       for (int i = 0; i < nlocal; i++) {
-         const int ibody = body[i];
-         if ((ibody < 0) || (ibody % nthreads != tid)) continue;
+       for (int k = bodyfirst[ibody]; k < bodyfirst[ibody+1]; k++) {
+         const int i = bodyatom[k];
 
          double unwrap[3];
          domain->unmap(x[i],xcmimage[i],unwrap);
@@ -219,23 +211,23 @@ void FixRigidOMP::compute_forces_and_torques()
          const double dy = unwrap[1] - xcm[ibody][1];
          const double dz = unwrap[2] - xcm[ibody][2];
 
-         const double s0 = f[i].x;
-         const double s1 = f[i].y;
-         const double s2 = f[i].z;
+         s0 += f[i].x;
+         s1 += f[i].y;
+         s2 += f[i].z;
 
-         double s3 = dy*s2 - dz*s1;
-         double s4 = dz*s0 - dx*s2;
-         double s5 = dx*s1 - dy*s0;
+         s3 += dy*f[i].z - dz*f[i].y;
+         s4 += dz*f[i].x - dx*f[i].z;
+         s5 += dx*f[i].y - dy*f[i].x;
 
          if (extended && (eflags[i] & TORQUE)) {
            s3 += torque_one[i][0];
            s4 += torque_one[i][1];
            s5 += torque_one[i][2];
          }
-
-         sum[ibody][0] += s0; sum[ibody][1] += s1; sum[ibody][2] += s2;
-         sum[ibody][3] += s3; sum[ibody][4] += s4; sum[ibody][5] += s5;
        }
+
+       sum[ibody][0]=s0; sum[ibody][1]=s1; sum[ibody][2]=s2;
+       sum[ibody][3]=s3; sum[ibody][4]=s4; sum[ibody][5]=s5;
      }
    } else
      error->all(FLERR,"rigid style is unsupported by fix rigid/omp");
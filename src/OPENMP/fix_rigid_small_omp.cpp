@@ -113,66 +113,50 @@ void FixRigidSmallOMP::compute_forces_and_torques()
   double * const * _noalias const x = atom->x;
   const auto * _noalias const f = (dbl3_t *) atom->f[0];
   const double * const * const torque_one = atom->torque;
-  const int nlocal = atom->nlocal;
-  const int nthreads=comm->nthreads;
-
-#if defined(_OPENMP)
-#pragma omp parallel for LMP_DEFAULT_NONE schedule(static)
-#endif
-  for (int ibody = 0; ibody < nlocal_body+nghost_body; ibody++) {
-    double * _noalias const fcm = body[ibody].fcm;
-    fcm[0] = fcm[1] = fcm[2] = 0.0;
-    double * _noalias const tcm = body[ibody].torque;
-    tcm[0] = tcm[1] = tcm[2] = 0.0;
-  }
+  const int nall_body = nlocal_body+nghost_body;
 
   // sum over atoms to get force and torque on rigid body
-  // we likely have a large number of rigid objects with only a
-  // a few atoms each. so we loop over all atoms for all threads
-  // and then each thread only processes some bodies.
+  // atoms are grouped by body in bodyfirst/bodyatom, so we can
+  // thread over bodies and each thread only touches its own bodies
 
 #if defined(_OPENMP)
-#pragma omp parallel LMP_DEFAULT_NONE
-#endif
-  {
-#if defined(_OPENMP)
-    const int tid = omp_get_thread_num();
-#else
-    const int tid = 0;
+#pragma omp parallel for LMP_DEFAULT_NONE schedule(static)
 #endif
+  for (int ibody = 0; ibody < nall_body; ibody++) {
+    Body &b = body[ibody];
+    const double * _noalias const xcm = b.xcm;
+    double s0=0.0,s1=0.0,s2=0.0,s3=0.0,s4=0.0,s5=0.0;
 
-    for (int i = 0; i < nlocal; i++) {
-      int ibody = atom2body[i];
-      if ((ibody < 0) || (ibody % nthreads != tid)) continue;
-
-      Body &b = body[ibody];
+    for (int k = bodyfirst[ibody]; k < bodyfirst[ibody+1]; k++) {
+      const int i = bodyatom[k];
 
       double unwrap[3];
       domain->unmap(x[i],xcmimage[i],unwrap);
 
-      double * _noalias const fcm = b.fcm;
-      double * _noalias const xcm = b.xcm;
-      double * _noalias const tcm = b.torque;
-
       const double dx = unwrap[0] - xcm[0];
       const double dy = unwrap[1] - xcm[1];
       const double dz = unwrap[2] - xcm[2];
 
-      fcm[0] += f[i].x;
-      fcm[1] += f[i].y;
-      fcm[2] += f[i].z;
+      s0 += f[i].x;
+      s1 += f[i].y;
+      s2 += f[i].z;
 
-      tcm[0] += dy*f[i].z - dz*f[i].y;
-      tcm[1] += dz*f[i].x - dx*f[i].z;
-      tcm[2] += dx*f[i].y - dy*f[i].x;
+      s3 += dy*f[i].z - dz*f[i].y;
+      s4 += dz*f[i].x - dx*f[i].z;
+      s5 += dx*f[i].y - dy*f[i].x;
 
       if (extended && (eflags[i] & TORQUE)) {
-        tcm[0] += torque_one[i][0];
-        tcm[1] += torque_one[i][1];
-        tcm[2] += torque_one[i][2];
+        s3 += torque_one[i][0];
+        s4 += torque_one[i][1];
+        s5 += torque_one[i][2];
       }
     }
-  } // end of omp parallel region
+
+    double * _noalias const fcm = b.fcm;
+    fcm[0] = s0; fcm[1] = s1; fcm[2] = s2;
+    double * _noalias const tcm = b.torque;
+    tcm[0] = s3; tcm[1] = s4; tcm[2] = s5;
+  } // end of omp parallel for
 
   // reverse communicate fcm, torque of all bodies
 
@@ -291,90 +275,94 @@ void FixRigidSmallOMP::set_xv_thr()
 
   // set x and v of each atom
 
+  // loop over bodies and their atoms, so data of each body is loaded once
+
   const int nlocal = atom->nlocal;
+  const int nall_body = nlocal_body+nghost_body;
 
 #if defined(_OPENMP)
-#pragma omp parallel for LMP_DEFAULT_NONE reduction(+:v0,v1,v2,v3,v4,v5)
+#pragma omp parallel for LMP_DEFAULT_NONE schedule(static) reduction(+:v0,v1,v2,v3,v4,v5)
 #endif
-  for (int i = 0; i < nlocal; i++) {
-    const int ibody = atom2body[i];
-    if (ibody  < 0) continue;
-
+  for (int ibody = 0; ibody < nall_body; ibody++) {
     Body &b = body[ibody];
 
-    const int xbox = (xcmimage[i] & IMGMASK) - IMGMAX;
-    const int ybox = (xcmimage[i] >> IMGBITS & IMGMASK) - IMGMAX;
-    const int zbox = (xcmimage[i] >> IMG2BITS) - IMGMAX;
-    const double deltax = xbox*xprd + (TRICLINIC ? ybox*xy + zbox*xz : 0.0);
-    const double deltay = ybox*yprd + (TRICLINIC ? zbox*yz : 0.0);
-    const double deltaz = zbox*zprd;
-
-    // save old positions and velocities for virial
-    double x0,x1,x2,vx,vy,vz;
-    if (EVFLAG) {
-      x0 = x[i].x + deltax;
-      x1 = x[i].y + deltay;
-      x2 = x[i].z + deltaz;
-      vx = v[i].x;
-      vy = v[i].y;
-      vz = v[i].z;
-    }
-
-    // x = displacement from center-of-mass, based on body orientation
-    // v = vcm + omega around center-of-mass
-
-    MathExtra::matvec(b.ex_space,b.ey_space,b.ez_space,displace[i],&x[i].x);
-
-    v[i].x = b.omega[1]*x[i].z - b.omega[2]*x[i].y + b.vcm[0];
-    v[i].y = b.omega[2]*x[i].x - b.omega[0]*x[i].z + b.vcm[1];
-    v[i].z = b.omega[0]*x[i].y - b.omega[1]*x[i].x + b.vcm[2];
-
-    // add center of mass to displacement
-    // map back into periodic box via xbox,ybox,zbox
-    // for triclinic, add in box tilt factors as well
-
-    x[i].x += b.xcm[0] - deltax;
-    x[i].y += b.xcm[1] - deltay;
-    x[i].z += b.xcm[2] - deltaz;
-
-    // virial = unwrapped coords dotted into body constraint force
-    // body constraint force = implied force due to v change minus f external
-    // assume f does not include forces internal to body
-    // 1/2 factor b/c final_integrate contributes other half
-    // assume per-atom contribution is due to constraint force on that atom
+    for (int k = bodyfirst[ibody]; k < bodyfirst[ibody+1]; k++) {
+      const int i = bodyatom[k];
 
-    if (EVFLAG) {
-      double massone,vr[6];
-
-      if (rmass) massone = rmass[i];
-      else massone = mass[type[i]];
-
-      const double fc0 = 0.5*(massone*(v[i].x - vx)/dtf - f[i].x);
-      const double fc1 = 0.5*(massone*(v[i].y - vy)/dtf - f[i].y);
-      const double fc2 = 0.5*(massone*(v[i].z - vz)/dtf - f[i].z);
-
-      vr[0] = x0*fc0; vr[1] = x1*fc1; vr[2] = x2*fc2;
-      vr[3] = x0*fc1; vr[4] = x0*fc2; vr[5] = x1*fc2;
+      const int xbox = (xcmimage[i] & IMGMASK) - IMGMAX;
+      const int ybox = (xcmimage[i] >> IMGBITS & IMGMASK) - IMGMAX;
+      const int zbox = (xcmimage[i] >> IMG2BITS) - IMGMAX;
+      const double deltax = xbox*xprd + (TRICLINIC ? ybox*xy + zbox*xz : 0.0);
+      const double deltay = ybox*yprd + (TRICLINIC ? zbox*yz : 0.0);
+      const double deltaz = zbox*zprd;
 
-      // Fix::v_tally() is not thread safe, so we do this manually here
-      // accumulate global virial into thread-local variables for reduction
-      if (vflag_global) {
-        v0 += vr[0];
-        v1 += vr[1];
-        v2 += vr[2];
-        v3 += vr[3];
-        v4 += vr[4];
-        v5 += vr[5];
+      // save old positions and velocities for virial
+      double x0,x1,x2,vx,vy,vz;
+      if (EVFLAG) {
+        x0 = x[i].x + deltax;
+        x1 = x[i].y + deltay;
+        x2 = x[i].z + deltaz;
+        vx = v[i].x;
+        vy = v[i].y;
+        vz = v[i].z;
       }
 
-      // accumulate per atom virial directly since we parallelize over atoms.
-      if (vflag_atom) {
-        vatom[i][0] += vr[0];
-        vatom[i][1] += vr[1];
-        vatom[i][2] += vr[2];
-        vatom[i][3] += vr[3];
-        vatom[i][4] += vr[4];
-        vatom[i][5] += vr[5];
+      // x = displacement from center-of-mass, based on body orientation
+      // v = vcm + omega around center-of-mass
+
+      MathExtra::matvec(b.ex_space,b.ey_space,b.ez_space,displace[i],&x[i].x);
+
+      v[i].x = b.omega[1]*x[i].z - b.omega[2]*x[i].y + b.vcm[0];
+      v[i].y = b.omega[2]*x[i].x - b.omega[0]*x[i].z + b.vcm[1];
+      v[i].z = b.omega[0]*x[i].y - b.omega[1]*x[i].x + b.vcm[2];
+
+      // add center of mass to displacement
+      // map back into periodic box via xbox,ybox,zbox
+      // for triclinic, add in box tilt factors as well
+
+      x[i].x += b.xcm[0] - deltax;
+      x[i].y += b.xcm[1] - deltay;
+      x[i].z += b.xcm[2] - deltaz;
+
+      // virial = unwrapped coords dotted into body constraint force
+      // body constraint force = implied force due to v change minus f external
+      // assume f does not include forces internal to body
+      // 1/2 factor b/c final_integrate contributes other half
+      // assume per-atom contribution is due to constraint force on that atom
+
+      if (EVFLAG) {
+        double massone,vr[6];
+
+        if (rmass) massone = rmass[i];
+        else massone = mass[type[i]];
+
+        const double fc0 = 0.5*(massone*(v[i].x - vx)/dtf - f[i].x);
+        const double fc1 = 0.5*(massone*(v[i].y - vy)/dtf - f[i].y);
+        const double fc2 = 0.5*(massone*(v[i].z - vz)/dtf - f[i].z);
+
+        vr[0] = x0*fc0; vr[1] = x1*fc1; vr[2] = x2*fc2;
+        vr[3] = x0*fc1; vr[4] = x0*fc2; vr[5] = x1*fc2;
+
+        // Fix::v_tally() is not thread safe, so we do this manually here
+        // accumulate global virial into thread-local variables for reduction
+        if (vflag_global) {
+          v0 += vr[0];
+          v1 += vr[1];
+          v2 += vr[2];
+          v3 += vr[3];
+          v4 += vr[4];
+          v5 += vr[5];
+        }
+
+        // accumulate per atom virial directly since we parallelize over atoms.
+        if (vflag_atom) {
+          vatom[i][0] += vr[0];
+          vatom[i][1] += vr[1];
+          vatom[i][2] += vr[2];
+          vatom[i][3] += vr[3];
+          vatom[i][4] += vr[4];
+          vatom[i][5] += vr[5];
+        }
       }
     }
   }
@@ -486,80 +474,84 @@ void FixRigidSmallOMP::set_v_thr()
 
   // set v of each atom
 
+  // loop over bodies and their atoms, so data of each body is loaded once
+
   const int nlocal = atom->nlocal;
+  const int nall_body = nlocal_body+nghost_body;
 
 #if defined(_OPENMP)
-#pragma omp parallel for LMP_DEFAULT_NONE reduction(+:v0,v1,v2,v3,v4,v5)
+#pragma omp parallel for LMP_DEFAULT_NONE schedule(static) reduction(+:v0,v1,v2,v3,v4,v5)
 #endif
-  for (int i = 0; i < nlocal; i++) {
-    const int ibody = atom2body[i];
-    if (ibody < 0) continue;
-
-    Body &b = body[atom2body[i]];
-    double delta[3],vx,vy,vz;
-
-    MathExtra::matvec(b.ex_space,b.ey_space,b.ez_space,displace[i],delta);
-
-    // save old velocities for virial
-
-    if (EVFLAG) {
-      vx = v[i].x;
-      vy = v[i].y;
-      vz = v[i].z;
-    }
-
-    v[i].x = b.omega[1]*delta[2] - b.omega[2]*delta[1] + b.vcm[0];
-    v[i].y = b.omega[2]*delta[0] - b.omega[0]*delta[2] + b.vcm[1];
-    v[i].z = b.omega[0]*delta[1] - b.omega[1]*delta[0] + b.vcm[2];
+  for (int ibody = 0; ibody < nall_body; ibody++) {
+    Body &b = body[ibody];
 
-    // virial = unwrapped coords dotted into body constraint force
-    // body constraint force = implied force due to v change minus f external
-    // assume f does not include forces internal to body
-    // 1/2 factor b/c initial_integrate contributes other half
-    // assume per-atom contribution is due to constraint force on that atom
+    for (int k = bodyfirst[ibody]; k < bodyfirst[ibody+1]; k++) {
+      const int i = bodyatom[k];
+      double delta[3],vx,vy,vz;
 
-    if (EVFLAG) {
-      double massone, vr[6];
-      if (rmass) massone = rmass[i];
-      else massone = mass[type[i]];
+      MathExtra::matvec(b.ex_space,b.ey_space,b.ez_space,displace[i],delta);
 
-      const int xbox = (xcmimage[i] & IMGMASK) - IMGMAX;
-      const int ybox = (xcmimage[i] >> IMGBITS & IMGMASK) - IMGMAX;
-      const int zbox = (xcmimage[i] >> IMG2BITS) - IMGMAX;
-      const double deltax = xbox*xprd + (TRICLINIC ? ybox*xy + zbox*xz : 0.0);
-      const double deltay = ybox*yprd + (TRICLINIC ? zbox*yz : 0.0);
-      const double deltaz = zbox*zprd;
+      // save old velocities for virial
 
-      const double fc0 = 0.5*(massone*(v[i].x - vx)/dtf - f[i].x);
-      const double fc1 = 0.5*(massone*(v[i].y - vy)/dtf - f[i].y);
-      const double fc2 = 0.5*(massone*(v[i].z - vz)/dtf - f[i].z);
-
-      const double x0 = x[i].x + deltax;
-      const double x1 = x[i].y + deltay;
-      const double x2 = x[i].z + deltaz;
-
-      vr[0] = x0*fc0; vr[1] = x1*fc1; vr[2] = x2*fc2;
-      vr[3] = x0*fc1; vr[4] = x0*fc2; vr[5] = x1*fc2;
-
-      // Fix::v_tally() is not thread safe, so we do this manually here
-      // accumulate global virial into thread-local variables and reduce them later
-      if (vflag_global) {
-        v0 += vr[0];
-        v1 += vr[1];
-        v2 += vr[2];
-        v3 += vr[3];
-        v4 += vr[4];
-        v5 += vr[5];
+      if (EVFLAG) {
+        vx = v[i].x;
+        vy = v[i].y;
+        vz = v[i].z;
       }
 
-      // accumulate per atom virial directly since we parallelize over atoms.
-      if (vflag_atom) {
-        vatom[i][0] += vr[0];
-        vatom[i][1] += vr[1];
-        vatom[i][2] += vr[2];
-        vatom[i][3] += vr[3];
-        vatom[i][4] += vr[4];
-        vatom[i][5] += vr[5];
+      v[i].x = b.omega[1]*delta[2] - b.omega[2]*delta[1] + b.vcm[0];
+      v[i].y = b.omega[2]*delta[0] - b.omega[0]*delta[2] + b.vcm[1];
+      v[i].z = b.omega[0]*delta[1] - b.omega[1]*delta[0] + b.vcm[2];
+
+      // virial = unwrapped coords dotted into body constraint force
+      // body constraint force = implied force due to v change minus f external
+      // assume f does not include forces internal to body
+      // 1/2 factor b/c initial_integrate contributes other half
+      // assume per-atom contribution is due to constraint force on that atom
+
+      if (EVFLAG) {
+        double massone, vr[6];
+        if (rmass) massone = rmass[i];
+        else massone = mass[type[i]];
+
+        const int xbox = (xcmimage[i] & IMGMASK) - IMGMAX;
+        const int ybox = (xcmimage[i] >> IMGBITS & IMGMASK) - IMGMAX;
+        const int zbox = (xcmimage[i] >> IMG2BITS) - IMGMAX;
+        const double deltax = xbox*xprd + (TRICLINIC ? ybox*xy + zbox*xz : 0.0);
+        const double deltay = ybox*yprd + (TRICLINIC ? zbox*yz : 0.0);
+        const double deltaz = zbox*zprd;
+
+        const double fc0 = 0.5*(massone*(v[i].x - vx)/dtf - f[i].x);
+        const double fc1 = 0.5*(massone*(v[i].y - vy)/dtf - f[i].y);
+        const double fc2 = 0.5*(massone*(v[i].z - vz)/dtf - f[i].z);
+
+        const double x0 = x[i].x + deltax;
+        const double x1 = x[i].y + deltay;
+        const double x2 = x[i].z + deltaz;
+
+        vr[0] = x0*fc0; vr[1] = x1*fc1; vr[2] = x2*fc2;
+        vr[3] = x0*fc1; vr[4] = x0*fc2; vr[5] = x1*fc2;
+
+        // Fix::v_tally() is not thread safe, so we do this manually here
+        // accumulate global virial into thread-local variables and reduce them later
+        if (vflag_global) {
+          v0 += vr[0];
+          v1 += vr[1];
+          v2 += vr[2];
+          v3 += vr[3];
+          v4 += vr[4];
+          v5 += vr[5];
+        }
+
+        // accumulate per atom virial directly since we parallelize over atoms.
+        if (vflag_atom) {
+          vatom[i][0] += vr[0];
+          vatom[i][1] += vr[1];
+          vatom[i][2] += vr[2];
+          vatom[i][3] += vr[3];
+          vatom[i][4] += vr[4];
+          vatom[i][5] += vr[5];
+        }
       }
     }
   } // end of parallel for
@@ -24,6 +24,7 @@
 #include "force.h"
 #include "math_const.h"
 #include "math_special.h"
+#include "memory.h"
 
 #include <cmath>
 #include <cstring>
@@ -48,7 +49,8 @@ using namespace MathSpecial;
 
 /* ---------------------------------------------------------------------- */
 
-PPPMOMP::PPPMOMP(LAMMPS *lmp) : PPPM(lmp), ThrOMP(lmp, THR_KSPACE)
+PPPMOMP::PPPMOMP(LAMMPS *lmp) : PPPM(lmp), ThrOMP(lmp, THR_KSPACE),
+  nmax_omp(0), maxzbin(0), rho1d_atom(nullptr), zbin_start(nullptr), zbin_atom(nullptr)
 {
   triclinic_support = 1;
   suffix_flag |= Suffix::OMP;
@@ -74,6 +76,12 @@ void PPPMOMP::allocate()
     ThrData *thr = fix->get_thr(tid);
     thr->init_pppm(order,memory);
   }
+
+  // stencil weights depend on order, so force reallocation in make_rho()
+
+  memory->destroy(rho1d_atom);
+  memory->destroy(zbin_atom);
+  nmax_omp = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -94,6 +102,10 @@ PPPMOMP::~PPPMOMP()
     ThrData *thr = fix->get_thr(tid);
     thr->init_pppm(-order,memory);
   }
+
+  memory->destroy(rho1d_atom);
+  memory->destroy(zbin_start);
+  memory->destroy(zbin_atom);
 }
 
 /* ----------------------------------------------------------------------
@@ -330,11 +342,28 @@ void PPPMOMP::compute(int eflag, int vflag)
   } // end of omp parallel region
 }
 
+/* ----------------------------------------------------------------------
+   memory usage of PPPM plus the stored stencil weights and z-plane bins
+------------------------------------------------------------------------- */
+
+double PPPMOMP::memory_usage()
+{
+  double bytes = PPPM::memory_usage();
+  bytes += (double)nmax_omp*3*order * sizeof(FFT_SCALAR);
+  bytes += (double)nmax_omp * sizeof(int);
+  bytes += (double)maxzbin * sizeof(int);
+  return bytes;
+}
+
 /* ----------------------------------------------------------------------
    create discretized "density" on section of global grid due to my particles
    density(x,y,z) = charge "density" at grid points of my 3d brick
    (nxlo:nxhi,nylo:nyhi,nzlo:nzhi) is extent of my brick (including ghosts)
    in global grid
+   the stencil weights of each atom are computed once and stored,
+     so fieldforce_ik() and fieldforce_peratom() can reuse them
+   each thread owns a slab of z-planes of the brick and only visits
+     the atoms whose stencil overlaps it, using atoms binned by z-plane
 ------------------------------------------------------------------------- */
 
 void PPPMOMP::make_rho()
@@ -352,6 +381,32 @@ void PPPMOMP::make_rho()
 
   const int ix = nxhi_out - nxlo_out + 1;
   const int iy = nyhi_out - nylo_out + 1;
+  const int nzbin = nzhi_out - nzlo_out + 1;
+
+  if (atom->nmax > nmax_omp) {
+    memory->destroy(rho1d_atom);
+    memory->destroy(zbin_atom);
+    nmax_omp = atom->nmax;
+    memory->create(rho1d_atom,nmax_omp,3*order,"pppm/omp:rho1d_atom");
+    memory->create(zbin_atom,nmax_omp,"pppm/omp:zbin_atom");
+  }
+  if (nzbin+1 > maxzbin) {
+    memory->destroy(zbin_start);
+    maxzbin = nzbin+1;
+    memory->create(zbin_start,maxzbin,"pppm/omp:zbin_start");
+  }
+
+  // bin atoms by z-plane of grid pt to "lower left" of charge
+
+  const auto * _noalias const p2g = (int3_t *) part2grid[0];
+  int i,ibin;
+
+  for (ibin = 0; ibin <= nzbin; ibin++) zbin_start[ibin] = 0;
+  for (i = 0; i < nlocal; i++) zbin_start[p2g[i].t-nzlo_out+1]++;
+  for (ibin = 0; ibin < nzbin; ibin++) zbin_start[ibin+1] += zbin_start[ibin];
+  for (i = 0; i < nlocal; i++) zbin_atom[zbin_start[p2g[i].t-nzlo_out]++] = i;
+  for (ibin = nzbin; ibin > 0; ibin--) zbin_start[ibin] = zbin_start[ibin-1];
+  zbin_start[0] = 0;
 
 #if defined(_OPENMP)
 #pragma omp parallel LMP_DEFAULT_NONE
@@ -359,61 +414,64 @@ void PPPMOMP::make_rho()
   {
     const double * _noalias const q = atom->q;
     const auto * _noalias const x = (dbl3_t *) atom->x[0];
-    const auto * _noalias const p2g = (int3_t *) part2grid[0];
 
     const double boxlox = boxlo[0];
     const double boxloy = boxlo[1];
     const double boxloz = boxlo[2];
 
-    // determine range of grid points handled by this thread
-    int i,jfrom,jto,tid;
-    loop_setup_thr(jfrom,jto,tid,ngrid,comm->nthreads);
+    int ifrom,ito,zfrom,zto,tid;
+    FFT_SCALAR *r1d[3];
 
     // get per thread data
+    loop_setup_thr(ifrom,ito,tid,nlocal,comm->nthreads);
     ThrData *thr = fix->get_thr(tid);
     thr->timer(Timer::START);
-    FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
 
-    // loop over my charges, add their contribution to nearby grid points
+    // compute and store stencil weights of my share of the atoms
     // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
     // (dx,dy,dz) = distance to "lower left" grid pt
 
-    // loop over all local atoms for all threads
-    for (i = 0; i < nlocal; i++) {
+    for (int i = ifrom; i < ito; i++) {
+      const FFT_SCALAR dx = p2g[i].a+shiftone - (x[i].x-boxlox)*delxinv;
+      const FFT_SCALAR dy = p2g[i].b+shiftone - (x[i].y-boxloy)*delyinv;
+      const FFT_SCALAR dz = p2g[i].t+shiftone - (x[i].z-boxloz)*delzinv;
 
-      const int nx = p2g[i].a;
-      const int ny = p2g[i].b;
-      const int nz = p2g[i].t;
+      r1d[0] = rho1d_atom[i] - nlower;
+      r1d[1] = r1d[0] + order;
+      r1d[2] = r1d[1] + order;
+      compute_rho1d_thr(r1d,dx,dy,dz);
+    }
 
-      // pre-screen whether this atom will ever come within
-      // reach of the data segement this thread is updating.
-      if ( ((nz+nlower-nzlo_out)*ix*iy >= jto)
-           || ((nz+nupper-nzlo_out+1)*ix*iy < jfrom) ) continue;
+    sync_threads();
 
-      const FFT_SCALAR dx = nx+shiftone - (x[i].x-boxlox)*delxinv;
-      const FFT_SCALAR dy = ny+shiftone - (x[i].y-boxloy)*delyinv;
-      const FFT_SCALAR dz = nz+shiftone - (x[i].z-boxloz)*delzinv;
+    // loop over charges whose stencil overlaps my z-planes
+    //   and add their contribution to grid points in those planes
 
-      compute_rho1d_thr(r1d,dx,dy,dz);
+    loop_setup_thr(zfrom,zto,tid,nzbin,comm->nthreads);
+    const int binlo = MAX(0,zfrom-nupper);
+    const int binhi = MIN(nzbin,zto-nlower);
 
-      const FFT_SCALAR z0 = delvolinv * q[i];
+    for (int ibin = binlo; ibin < binhi; ibin++) {
+      const int nlo = MAX(nlower,zfrom-ibin);
+      const int nhi = MIN(nupper,zto-1-ibin);
 
-      for (int n = nlower; n <= nupper; ++n) {
-        const int jn = (nz+n-nzlo_out)*ix*iy;
-        const FFT_SCALAR y0 = z0*r1d[2][n];
+      for (int k = zbin_start[ibin]; k < zbin_start[ibin+1]; k++) {
+        const int i = zbin_atom[k];
+        const int nx = p2g[i].a;
+        const int ny = p2g[i].b;
+        const FFT_SCALAR * const w1d = rho1d_atom[i] - nlower;
+        const FFT_SCALAR z0 = delvolinv * q[i];
 
-        for (int m = nlower; m <= nupper; ++m) {
-          const int jm = jn+(ny+m-nylo_out)*ix;
-          const FFT_SCALAR x0 = y0*r1d[1][m];
+        for (int n = nlo; n <= nhi; ++n) {
+          const int jn = (ibin+n)*ix*iy;
+          const FFT_SCALAR y0 = z0*w1d[2*order+n];
 
-          for (int l = nlower; l <= nupper; ++l) {
-            const int jl = jm+nx+l-nxlo_out;
-            // make sure each thread only updates
-            // "his" elements of the density grid
-            if (jl >= jto) break;
-            if (jl < jfrom) continue;
+          for (int m = nlower; m <= nupper; ++m) {
+            const int jm = jn+(ny+m-nylo_out)*ix;
+            const FFT_SCALAR x0 = y0*w1d[order+m];
 
-            d[jl] += x0*r1d[0][l];
+            for (int l = nlower; l <= nupper; ++l)
+              d[jm+nx+l-nxlo_out] += x0*w1d[l];
           }
         }
       }
@@ -430,7 +488,6 @@ void PPPMOMP::fieldforce_ik()
 {
   // loop over my charges, interpolate electric field from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
-  // (dx,dy,dz) = distance to "lower left" grid pt
   // (mx,my,mz) = global coords of moving stencil pt
   // ek = 3 components of E-field on particle
 
@@ -441,14 +498,10 @@ void PPPMOMP::fieldforce_ik()
 
   if (nlocal == 0) return;
 
-  const auto * _noalias const x = (dbl3_t *) atom->x[0];
   const double * _noalias const q = atom->q;
   const auto * _noalias const p2g = (int3_t *) part2grid[0];
 
   const double qqrd2e = force->qqrd2e;
-  const double boxlox = boxlo[0];
-  const double boxloy = boxlo[1];
-  const double boxloz = boxlo[2];
 
 #if defined(_OPENMP)
 #pragma omp parallel LMP_DEFAULT_NONE
@@ -463,28 +516,25 @@ void PPPMOMP::fieldforce_ik()
     ThrData *thr = fix->get_thr(tid);
     thr->timer(Timer::START);
     auto * _noalias const f = (dbl3_t *) thr->get_f()[0];
-    FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
+
+    // stencil weights were stored by make_rho() for the current positions
 
     for (i = ifrom; i < ito; ++i) {
       const int nx = p2g[i].a;
       const int ny = p2g[i].b;
       const int nz = p2g[i].t;
-      const FFT_SCALAR dx = nx+shiftone - (x[i].x-boxlox)*delxinv;
-      const FFT_SCALAR dy = ny+shiftone - (x[i].y-boxloy)*delyinv;
-      const FFT_SCALAR dz = nz+shiftone - (x[i].z-boxloz)*delzinv;
-
-      compute_rho1d_thr(r1d,dx,dy,dz);
+      const FFT_SCALAR * const w1d = rho1d_atom[i] - nlower;
 
       ekx = eky = ekz = ZEROF;
       for (n = nlower; n <= nupper; n++) {
         mz = n+nz;
-        z0 = r1d[2][n];
+        z0 = w1d[2*order+n];
         for (m = nlower; m <= nupper; m++) {
           my = m+ny;
-          y0 = z0*r1d[1][m];
+          y0 = z0*w1d[order+m];
           for (l = nlower; l <= nupper; l++) {
             mx = l+nx;
-            x0 = y0*r1d[0][l];
+            x0 = y0*w1d[l];
             ekx -= x0*vdx_brick[mz][my][mx];
             eky -= x0*vdy_brick[mz][my][mx];
             ekz -= x0*vdz_brick[mz][my][mx];
@@ -622,17 +672,15 @@ void PPPMOMP::fieldforce_peratom()
 
   // loop over my charges, interpolate from nearby grid points
   // (nx,ny,nz) = global coords of grid pt to "lower left" of charge
-  // (dx,dy,dz) = distance to "lower left" grid pt
   // (mx,my,mz) = global coords of moving stencil pt
 
-  const auto * _noalias const x = (dbl3_t *) atom->x[0];
   const double * _noalias const q = atom->q;
 
 #if defined(_OPENMP)
 #pragma omp parallel LMP_DEFAULT_NONE
 #endif
   {
-    FFT_SCALAR dx,dy,dz,x0,y0,z0;
+    FFT_SCALAR x0,y0,z0;
     FFT_SCALAR u,v0,v1,v2,v3,v4,v5;
     int i,ifrom,ito,tid,l,m,n,nx,ny,nz,mx,my,mz;
 
@@ -641,28 +689,25 @@ void PPPMOMP::fieldforce_peratom()
     // get per thread data
     ThrData *thr = fix->get_thr(tid);
     thr->timer(Timer::START);
-    FFT_SCALAR * const * const r1d = static_cast<FFT_SCALAR **>(thr->get_rho1d());
+
+    // stencil weights were stored by make_rho() for the current positions
 
     for (i = ifrom; i < ito; ++i) {
       nx = part2grid[i][0];
       ny = part2grid[i][1];
       nz = part2grid[i][2];
-      dx = nx+shiftone - (x[i].x-boxlo[0])*delxinv;
-      dy = ny+shiftone - (x[i].y-boxlo[1])*delyinv;
-      dz = nz+shiftone - (x[i].z-boxlo[2])*delzinv;
-
-      compute_rho1d_thr(r1d,dx,dy,dz);
+      const FFT_SCALAR * const w1d = rho1d_atom[i] - nlower;
 
       u = v0 = v1 = v2 = v3 = v4 = v5 = ZEROF;
       for (n = nlower; n <= nupper; n++) {
         mz = n+nz;
-        z0 = r1d[2][n];
+        z0 = w1d[2*order+n];
         for (m = nlower; m <= nupper; m++) {
           my = m+ny;
-          y0 = z0*r1d[1][m];
+          y0 = z0*w1d[order+m];
           for (l = nlower; l <= nupper; l++) {
             mx = l+nx;
-            x0 = y0*r1d[0][l];
+            x0 = y0*w1d[l];
             if (eflag_atom) u += x0*u_brick[mz][my][mx];
             if (vflag_atom) {
               v0 += x0*v0_brick[mz][my][mx];
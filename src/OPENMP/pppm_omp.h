@@ -30,6 +30,7 @@ class PPPMOMP : public PPPM, public ThrOMP {
   PPPMOMP(class LAMMPS *);
   ~PPPMOMP() override;
   void compute(int, int) override;
+  double memory_usage() override;
 
  protected:
   void allocate() override;
@@ -48,6 +49,12 @@ class PPPMOMP : public PPPM, public ThrOMP {
   void compute_drho1d_thr(FFT_SCALAR *const *const, const FFT_SCALAR &, const FFT_SCALAR &,
                           const FFT_SCALAR &);
   //  void slabcorr(int);
+
+  int nmax_omp;              // # of atoms rho1d_atom and zbin_atom are allocated for
+  int maxzbin;               // allocated length of zbin_start
+  FFT_SCALAR **rho1d_atom;   // per-atom stencil weights in x, y and z
+  int *zbin_start;           // offset of first atom in each z-plane bin
+  int *zbin_atom;            // local atom indices sorted by z-plane bin
 };
 
 }    // namespace LAMMPS_NS
@@ -551,6 +551,20 @@ FixBondReact::FixBondReact(LAMMPS *lmp, int narg, char **arg) :
     }
   }
 
+  // signatures of initiator atoms in pre-reacted templates
+  // used to reject attempts before running the Superimpose Algorithm
+
+  isignature.resize(nreacts);
+  jsignature.resize(nreacts);
+  rejected.resize(nreacts);
+  for (int myrxn = 0; myrxn < nreacts; myrxn++) {
+    onemol = atom->molecules[unreacted_mol[myrxn]];
+    get_molxspecials();
+    template_signature(myrxn,ibonding[myrxn],isignature[myrxn]);
+    template_signature(myrxn,jbonding[myrxn],jsignature[myrxn]);
+  }
+  dynamic_fail = 0;
+
   // initialize Marsaglia RNG with processor-unique seed ('prob' keyword)
 
   random = new RanMars*[nreacts];
@@ -1320,11 +1334,39 @@ void FixBondReact::superimpose_algorithm()
 
   // let's finally begin the superimpose loop
   for (rxnID = 0; rxnID < nreacts; rxnID++) {
-    for (lcl_inst = 0; lcl_inst < nattempt[rxnID]; lcl_inst++) {
-
+    if (nattempt[rxnID] > 0) {
       onemol = atom->molecules[unreacted_mol[rxnID]];
       twomol = atom->molecules[reacted_mol[rxnID]];
       get_molxspecials();
+    }
+
+    for (lcl_inst = 0; lcl_inst < nattempt[rxnID]; lcl_inst++) {
+
+      // initiator atoms must match degree and neighbor types of template
+
+      tagint itag = attempt[lcl_inst][0][rxnID];
+      tagint jtag = attempt[lcl_inst][1][rxnID];
+      if (!check_signature(isignature[rxnID],itag) ||
+          !check_signature(jsignature[rxnID],jtag)) continue;
+
+      // skip attempt that failed for topological reasons before,
+      // unless topology of the atoms it assigned has changed since
+
+      std::pair<tagint,tagint> attempt_key(itag,jtag);
+      auto prior = rejected[rxnID].find(attempt_key);
+      if (prior != rejected[rxnID].end()) {
+        int valid;
+        unsigned long long hash = topology_hash(prior->second.touched,valid);
+        if (valid && hash == prior->second.hash) {
+          prior->second.stamp = update->ntimestep;
+          continue;
+        }
+        rejected[rxnID].erase(prior);
+      }
+      touched.clear();
+      touched.push_back(itag);
+      touched.push_back(jtag);
+      dynamic_fail = 0;
 
       status = PROCEED;
 
@@ -1343,10 +1385,10 @@ void FixBondReact::superimpose_algorithm()
       int myjbonding = jbonding[rxnID];
 
       glove[myibonding-1][0] = myibonding;
-      glove[myibonding-1][1] = attempt[lcl_inst][0][rxnID];
+      glove[myibonding-1][1] = itag;
       glove_counter++;
       glove[myjbonding-1][0] = myjbonding;
-      glove[myjbonding-1][1] = attempt[lcl_inst][1][rxnID];
+      glove[myjbonding-1][1] = jtag;
       glove_counter++;
 
       // special case, only two atoms in reaction templates
@@ -1430,6 +1472,29 @@ void FixBondReact::superimpose_algorithm()
               "via at least one path that does not involve edge atoms.");
         }
       }
+
+      // the outcome of the search depends only on the topology of the atoms it
+      // assigned, unless it was stopped by relaxing atoms or got to evaluate constraints
+
+      if (status == REJECT && !dynamic_fail && onemol->natoms > 2) {
+        Rejection &entry = rejected[rxnID][attempt_key];
+        std::sort(touched.begin(),touched.end());
+        touched.erase(std::unique(touched.begin(),touched.end()),touched.end());
+        entry.touched = touched;
+        int valid;
+        entry.hash = topology_hash(entry.touched,valid);
+        entry.stamp = update->ntimestep;
+        if (!valid) rejected[rxnID].erase(attempt_key);
+      }
+    }
+
+    // forget attempts which were not made again on this timestep
+
+    if (update->ntimestep % nevery[rxnID] == 0) {
+      for (auto it = rejected[rxnID].begin(); it != rejected[rxnID].end();) {
+        if (it->second.stamp != update->ntimestep) it = rejected[rxnID].erase(it);
+        else ++it;
+      }
     }
   }
 
@@ -1581,6 +1646,7 @@ void FixBondReact::make_a_guess()
       error->one(FLERR,"Fix bond/react: Fix bond/react needs ghost atoms from further away"); // parallel issues.
     }
     if (i_limit_tags[(int)atom->map(xspecial[atom->map(glove[pion][1])][i])] != 0) {
+      dynamic_fail = 1;
       status = GUESSFAIL;
       return;
     }
@@ -1605,31 +1671,19 @@ void FixBondReact::make_a_guess()
   if (assigned_count == nfirst_neighs) status = GUESSFAIL;
 
   // check if all neigh atom types are the same between simulation and unreacted mol
-  int *mol_ntypes = new int[atom->ntypes];
-  int *lcl_ntypes = new int[atom->ntypes];
-
-  for (int i = 0; i < atom->ntypes; i++) {
-    mol_ntypes[i] = 0;
-    lcl_ntypes[i] = 0;
-  }
+  mol_ntypes.assign(atom->ntypes,0);
+  lcl_ntypes.assign(atom->ntypes,0);
 
   for (int i = 0; i < nfirst_neighs; i++) {
     mol_ntypes[(int)onemol->type[(int)onemol_xspecial[pion][i]-1]-1]++;
     lcl_ntypes[(int)type[(int)atom->map(xspecial[atom->map(glove[pion][1])][i])]-1]++; //added -1
   }
 
-  for (int i = 0; i < atom->ntypes; i++) {
-    if (mol_ntypes[i] != lcl_ntypes[i]) {
-      status = GUESSFAIL;
-      delete [] mol_ntypes;
-      delete [] lcl_ntypes;
-      return;
-    }
+  if (mol_ntypes != lcl_ntypes) {
+    status = GUESSFAIL;
+    return;
   }
 
-  delete [] mol_ntypes;
-  delete [] lcl_ntypes;
-
   // okay everything seems to be in order. let's assign some ID pairs!!!
   neighbor_loop();
 }
@@ -1686,6 +1740,7 @@ void FixBondReact::check_a_neighbor()
           if (already_assigned == 0) {
             glove[(int)onemol_xspecial[pion][neigh]-1][0] = onemol_xspecial[pion][neigh];
             glove[(int)onemol_xspecial[pion][neigh]-1][1] = xspecial[(int)atom->map(glove[pion][1])][i];
+            touched.push_back(glove[(int)onemol_xspecial[pion][neigh]-1][1]);
 
             //another check for ghost atoms. perhaps remove the one in make_a_guess
             if (atom->map(glove[(int)onemol_xspecial[pion][neigh]-1][1]) < 0) {
@@ -1738,6 +1793,7 @@ void FixBondReact::check_a_neighbor()
       if (already_assigned == 0) {
         glove[(int)onemol_xspecial[pion][neigh]-1][0] = onemol_xspecial[pion][neigh];
         glove[(int)onemol_xspecial[pion][neigh]-1][1] = xspecial[(int)atom->map(glove[pion][1])][i];
+        touched.push_back(glove[(int)onemol_xspecial[pion][neigh]-1][1]);
 
         //another check for ghost atoms. perhaps remove the one in make_a_guess
         if (atom->map(glove[(int)onemol_xspecial[pion][neigh]-1][1]) < 0) {
@@ -1861,6 +1917,7 @@ void FixBondReact::inner_crosscheck_loop()
     } else {
       glove[onemol_xspecial[pion][neigh]-1][0] = onemol_xspecial[pion][neigh];
       glove[onemol_xspecial[pion][neigh]-1][1] = tag_choices[i];
+      touched.push_back(tag_choices[i]);
       guess_branch[avail_guesses-1]--;
       break;
     }
@@ -1937,6 +1994,9 @@ int FixBondReact::check_constraints()
   tagint atom1,atom2;
   double **x = atom->x;
 
+  // outcome depends on coordinates and random numbers
+  dynamic_fail = 1;
+
   int *satisfied;
   memory->create(satisfied,nconstraints[rxnID],"bond/react:satisfied");
   for (int i = 0; i < nconstraints[rxnID]; i++)
@@ -2586,6 +2646,98 @@ void FixBondReact::get_molxspecials()
   }
 }
 
+/* ----------------------------------------------------------------------
+  Signature of an initiator atom of pre-reacted template of rxn MYRXN:
+  its number of 1-2 neighbors, their types, and for non-edge neighbors
+  also their number of 1-2 neighbors. All must be the same for the
+  simulation atom in any successful match.
+------------------------------------------------------------------------- */
+
+void FixBondReact::template_signature(int myrxn, int iatom, Signature &sig)
+{
+  int i = iatom-1;
+  sig.edgeflag = edge[i][myrxn];
+  sig.degree = onemol_nxspecial[i][0];
+  sig.ntypes.clear();
+  sig.nfixed.clear();
+  for (int j = 0; j < sig.degree; j++) {
+    int k = onemol_xspecial[i][j]-1;
+    sig.ntypes.push_back(onemol->type[k]);
+    if (edge[k][myrxn] == 0)
+      sig.nfixed.emplace_back(onemol->type[k],onemol_nxspecial[k][0]);
+  }
+  std::sort(sig.ntypes.begin(),sig.ntypes.end());
+  std::sort(sig.nfixed.begin(),sig.nfixed.end());
+}
+
+/* ----------------------------------------------------------------------
+  Return 0 if simulation atom ID cannot match template atom with
+  signature SIG, 1 if it may
+------------------------------------------------------------------------- */
+
+int FixBondReact::check_signature(const Signature &sig, tagint id)
+{
+  if (sig.edgeflag) return 1;
+  int i = atom->map(id);
+  if (i < 0) return 1;
+  if (nxspecial[i][0] != sig.degree) return 0;
+
+  // missing ghost atoms are reported by the Superimpose Algorithm
+
+  int *type = atom->type;
+  lcl_nfixed.clear();
+  for (int j = 0; j < sig.degree; j++) {
+    int k = atom->map(xspecial[i][j]);
+    if (k < 0) return 1;
+    lcl_nfixed.emplace_back(type[k],nxspecial[k][0]);
+  }
+  std::sort(lcl_nfixed.begin(),lcl_nfixed.end());
+
+  for (int j = 0; j < sig.degree; j++)
+    if (lcl_nfixed[j].first != sig.ntypes[j]) return 0;
+  return std::includes(lcl_nfixed.begin(),lcl_nfixed.end(),sig.nfixed.begin(),sig.nfixed.end());
+}
+
+/* ----------------------------------------------------------------------
+  Fingerprint of everything the Superimpose Algorithm reads about atoms
+  assigned to the template: their 1-2 neighbor lists, and type, number
+  of 1-2 neighbors and relaxing status of them and their 1-2 neighbors.
+  VALID is set to 0 if any of these atoms is not known to this proc.
+------------------------------------------------------------------------- */
+
+unsigned long long FixBondReact::topology_hash(const std::vector<tagint> &atoms, int &valid)
+{
+  int *type = atom->type;
+  int flag,cols;
+  int index1 = atom->find_custom("limit_tags",flag,cols);
+  int *i_limit_tags = atom->ivector[index1];
+
+  unsigned long long hash = 14695981039346656037ULL;
+  auto mix = [&hash](unsigned long long value) {
+    hash = (hash ^ value) * 1099511628211ULL;
+    hash ^= hash >> 32;
+  };
+
+  valid = 0;
+  for (tagint id : atoms) {
+    int i = atom->map(id);
+    if (i < 0) return 0;
+    mix(id);
+    mix(type[i]);
+    mix(nxspecial[i][0]);
+    for (int j = 0; j < nxspecial[i][0]; j++) {
+      int k = atom->map(xspecial[i][j]);
+      if (k < 0) return 0;
+      mix(xspecial[i][j]);
+      mix(type[k]);
+      mix(nxspecial[k][0]);
+      mix(i_limit_tags[k] != 0);
+    }
+  }
+  valid = 1;
+  return hash;
+}
+
 /* ----------------------------------------------------------------------
   Determine which pre-reacted template atoms are at least three bonds
   away from edge atoms.
@@ -4552,6 +4704,9 @@ double FixBondReact::memory_usage()
   double bytes = (double)nmax * sizeof(int);
   bytes = 2*nmax * sizeof(tagint);
   bytes += (double)nmax * sizeof(double);
+  for (const auto &cache : rejected)
+    for (const auto &entry : cache)
+      bytes += sizeof(entry) + (double)entry.second.touched.capacity() * sizeof(tagint);
   return bytes;
 }
 
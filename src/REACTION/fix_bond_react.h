@@ -28,6 +28,7 @@ FixStyle(bond/react,FixBondReact);
 
 #include <map>
 #include <set>
+#include <utility>
 
 namespace LAMMPS_NS {
 
@@ -175,6 +176,26 @@ class FixBondReact : public Fix {
                            // but whose first neighbors haven't
   int glove_counter;       // used to determine when to terminate Superimpose Algorithm
 
+  // pruning and caching of attempts of the Superimpose Algorithm
+
+  struct Signature {
+    int edgeflag;                             // 1 if initiator is an edge atom, not checked
+    int degree;                               // num of 1-2 neighbors
+    std::vector<int> ntypes;                  // sorted types of 1-2 neighbors
+    std::vector<std::pair<int, int>> nfixed;  // sorted (type,degree) of non-edge 1-2 neighbors
+  };
+  struct Rejection {
+    std::vector<tagint> touched;    // atoms assigned to template during failed attempt
+    unsigned long long hash;        // fingerprint of their topology at that time
+    bigint stamp;                   // last timestep this attempt was made
+  };
+  std::vector<Signature> isignature, jsignature;    // of initiator atoms of each rxn
+  std::vector<std::map<std::pair<tagint, tagint>, Rejection>> rejected;    // per rxn
+  std::vector<tagint> touched;    // atoms assigned to template during current attempt
+  int dynamic_fail;               // 1 if current attempt depended on more than topology
+  std::vector<int> mol_ntypes, lcl_ntypes;
+  std::vector<std::pair<int, int>> lcl_nfixed;
+
   void read_variable_keyword(const char *, int, int);
   void read_map_file(int);
   void EdgeIDs(char *, int);
@@ -211,6 +232,9 @@ class FixBondReact : public Fix {
   void far_partner();
   void close_partner();
   void get_molxspecials();
+  void template_signature(int, int, Signature &);
+  int check_signature(const Signature &, tagint);
+  unsigned long long topology_hash(const std::vector<tagint> &, int &);
   void find_landlocked_atoms(int);
   void glove_ghostcheck();
   void ghost_glovecast();
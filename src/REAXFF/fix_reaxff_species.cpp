@@ -19,12 +19,14 @@
 
 #include "fix_reaxff_species.h"
 
+#include "async_writer.h"
 #include "atom.h"
 #include "atom_vec.h"
 #include "citeme.h"
 #include "comm.h"
 #include "domain.h"
 #include "error.h"
+#include "file_writer.h"
 #include "fix_ave_atom.h"
 #include "force.h"
 #include "group.h"
@@ -33,6 +35,7 @@
 #include "modify.h"
 #include "neigh_list.h"
 #include "neighbor.h"
+#include "union_find.h"
 #include "update.h"
 #include "variable.h"
 
@@ -43,6 +46,7 @@
 #include <cstring>
 #include <exception>
 #include <random>
+#include <unordered_map>
 
 using namespace LAMMPS_NS;
 using namespace FixConst;
@@ -62,9 +66,9 @@ static const char cite_reaxff_species_delete[] =
 /* ---------------------------------------------------------------------- */
 
 FixReaxFFSpecies::FixReaxFFSpecies(LAMMPS *lmp, int narg, char **arg) :
-    Fix(lmp, narg, arg), Name(nullptr), MolName(nullptr), NMol(nullptr), nd(nullptr),
-    MolType(nullptr), molmap(nullptr), mark(nullptr), Mol2Spec(nullptr), clusterID(nullptr),
-    x0(nullptr), BOCut(nullptr), fp(nullptr), pos(nullptr), fdel(nullptr), delete_Tcount(nullptr),
+    Fix(lmp, narg, arg), MolName(nullptr), NMol(nullptr), molmap(nullptr), mark(nullptr),
+    Mol2Spec(nullptr), clusterID(nullptr), x0(nullptr), BOCut(nullptr), uf(nullptr),
+    async_writer(nullptr), fp(nullptr), pos(nullptr), fdel(nullptr), delete_Tcount(nullptr),
     ele(nullptr), eletype(nullptr), filepos(nullptr), filedel(nullptr)
 {
   if (narg < 7) utils::missing_cmd_args(FLERR, "fix reaxff/species", error);
@@ -145,6 +149,8 @@ FixReaxFFSpecies::FixReaxFFSpecies(LAMMPS *lmp, int narg, char **arg) :
   memory->create(clusterID, ntmp, "reaxff/species:clusterID");
   vector_atom = clusterID;
 
+  uf = new UnionFind();
+
   nmax = 0;
   setupflag = 0;
 
@@ -158,7 +164,7 @@ FixReaxFFSpecies::FixReaxFFSpecies(LAMMPS *lmp, int narg, char **arg) :
   // optional args
   eletype = nullptr;
   ele = filepos = filedel = nullptr;
-  eleflag = posflag = padflag = 0;
+  eleflag = posflag = padflag = asyncflag = 0;
   delflag = specieslistflag = masslimitflag = 0;
   delete_Nlimit = delete_Nsteps = 0;
 
@@ -281,6 +287,11 @@ FixReaxFFSpecies::FixReaxFFSpecies(LAMMPS *lmp, int narg, char **arg) :
         multipos = 0;
       }
       iarg += 3;
+      // write output files from background thread
+    } else if (strcmp(arg[iarg], "async") == 0) {
+      if (iarg + 2 > narg) utils::missing_cmd_args(FLERR, "fix reaxff/species async", error);
+      asyncflag = utils::logical(FLERR, arg[iarg + 1], false, lmp);
+      iarg += 2;
     } else
       error->all(FLERR, "Unknown fix reaxff/species keyword: {}", arg[iarg]);
   }
@@ -316,24 +327,26 @@ FixReaxFFSpecies::~FixReaxFFSpecies()
   memory->destroy(BOCut);
   memory->destroy(clusterID);
   memory->destroy(x0);
+  delete uf;
 
-  memory->destroy(nd);
-  memory->destroy(Name);
   memory->destroy(NMol);
   memory->destroy(Mol2Spec);
-  memory->destroy(MolType);
   memory->destroy(MolName);
   memory->destroy(delete_Tcount);
 
   delete[] filepos;
   delete[] filedel;
 
+  // finish pending output before closing files
+
+  delete async_writer;
+
   if (comm->me == 0) {
     if (compressed)
       platform::pclose(fp);
     else
       fclose(fp);
-    if (posflag && multipos_opened) fclose(pos);
+    if (posflag && singlepos_opened) fclose(pos);
     if (fdel) fclose(fdel);
   }
 
@@ -358,7 +371,6 @@ int FixReaxFFSpecies::setmask()
 void FixReaxFFSpecies::setup(int /*vflag*/)
 {
   ntotal = static_cast<int>(atom->natoms);
-  if (Name == nullptr) memory->create(Name, ntypes, "reaxff/species:Name");
 
   post_integrate();
 }
@@ -418,7 +430,21 @@ void FixReaxFFSpecies::init_list(int /*id*/, NeighList *ptr)
 void FixReaxFFSpecies::post_integrate()
 {
   Output_ReaxFF_Bonds(update->ntimestep, fp);
-  if (comm->me == 0) fflush(fp);
+}
+
+/* ----------------------------------------------------------------------
+   output files are complete at the end of a run
+------------------------------------------------------------------------- */
+
+void FixReaxFFSpecies::post_run()
+{
+  if (!async_writer) return;
+
+  try {
+    async_writer->wait();
+  } catch (FileWriterException &e) {
+    error->one(FLERR, e.what());
+  }
 }
 
 /* ---------------------------------------------------------------------- */
@@ -462,10 +488,7 @@ void FixReaxFFSpecies::Output_ReaxFF_Bonds(bigint ntimestep, FILE * /*fp*/)
 
   if (comm->me == 0 && ntimestep >= 0) WriteFormulas(Nmole, Nspec);
 
-  if (posflag && ((ntimestep) % posfreq == 0)) {
-    WritePos(Nmole, Nspec);
-    if (comm->me == 0) fflush(pos);
-  }
+  if (posflag && ((ntimestep) % posfreq == 0)) WritePos(Nmole, Nspec);
 
   if (delflag) DeleteSpecies(Nmole, Nspec);
 
@@ -492,20 +515,26 @@ AtomCoord FixReaxFFSpecies::chAnchor(AtomCoord in1, AtomCoord in2)
 
 void FixReaxFFSpecies::FindMolecule()
 {
-  int i, j, ii, jj, inum, itype, jtype, loop, looptot;
-  int change, done, anychange;
+  MergeMolecules(reaxff->list->inum, reaxff->list->ilist);
+}
+
+/* ----------------------------------------------------------------------
+   assign lowest atom ID and lowest coordinate of each molecule to its atoms
+   molecules are atoms connected by averaged bond orders above the cutoff
+------------------------------------------------------------------------- */
+
+void FixReaxFFSpecies::MergeMolecules(int inum, int *ilist)
+{
+  int i, j, ii, jj, itype, jtype;
+  tagint *tag = atom->tag;
   int *mask = atom->mask;
-  int *ilist;
-  double bo_tmp, bo_cut;
+  int nall = atom->nlocal + atom->nghost;
   double **spec_atom = f_SPECBOND->array_atom;
 
-  inum = reaxff->list->inum;
-  ilist = reaxff->list->ilist;
-
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
     if (mask[i] & groupbit) {
-      clusterID[i] = atom->tag[i];
+      clusterID[i] = tag[i];
       x0[i].x = spec_atom[i][1];
       x0[i].y = spec_atom[i][2];
       x0[i].z = spec_atom[i][3];
@@ -513,50 +542,58 @@ void FixReaxFFSpecies::FindMolecule()
       clusterID[i] = 0.0;
   }
 
-  loop = 0;
-  while (true) {
-    comm->forward_comm(this);
-    loop++;
+  comm->forward_comm(this);
+
+  // single pass over bonds of my atoms, including bonds to ghost atoms
+  // if atom map exists, also merge ghost atoms with my copy of same atom
 
-    change = 0;
-    while (true) {
-      done = 1;
+  uf->reset(nall);
+
+  if (atom->map_style != Atom::MAP_NONE) {
+    for (i = atom->nlocal; i < nall; i++) {
+      j = atom->map(tag[i]);
+      if (j >= 0) uf->unite(i, j);
+    }
+  }
 
-      for (ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    if (!(mask[i] & groupbit)) continue;
+    itype = atom->type[i];
 
-        itype = atom->type[i];
+    for (jj = 0; jj < MAXSPECBOND; jj++) {
+      j = reaxff->tmpid[i][jj];
+      if ((j == 0) || (j < i)) continue;
+      if (!(mask[j] & groupbit)) continue;
 
-        for (jj = 0; jj < MAXSPECBOND; jj++) {
-          j = reaxff->tmpid[i][jj];
+      jtype = atom->type[j];
+      if (spec_atom[i][jj + 7] > BOCut[itype][jtype]) uf->unite(i, j);
+    }
+  }
 
-          if ((j == 0) || (j < i)) continue;
-          if (!(mask[j] & groupbit)) continue;
+  // merge molecules across procs, until no proc lowers a value of its atoms
+  // the anchor of a molecule is its lexicographically smallest coordinate
 
-          if (clusterID[i] == clusterID[j] && x0[i].x == x0[j].x && x0[i].y == x0[j].y &&
-              x0[i].z == x0[j].z)
-            continue;
+  int change, anychange;
+  AtomCoord anchor;
 
-          jtype = atom->type[j];
-          bo_cut = BOCut[itype][jtype];
-          bo_tmp = spec_atom[i][jj + 7];
+  while (true) {
+    change = uf->assign_min(clusterID, nlocal);
 
-          if (bo_tmp > bo_cut) {
-            clusterID[i] = clusterID[j] = MIN(clusterID[i], clusterID[j]);
-            x0[i] = x0[j] = chAnchor(x0[i], x0[j]);
-            done = 0;
-          }
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
+    for (i = 0; i < nall; i++) {
+      j = uf->find(i);
+      if (j != i) x0[j] = chAnchor(x0[j], x0[i]);
+    }
+    for (i = 0; i < nall; i++) {
+      anchor = x0[uf->find(i)];
+      if ((i < nlocal) && (anchor.x != x0[i].x || anchor.y != x0[i].y || anchor.z != x0[i].z))
+        change = 1;
+      x0[i] = anchor;
     }
+
     MPI_Allreduce(&change, &anychange, 1, MPI_INT, MPI_MAX, world);
     if (!anychange) break;
-
-    MPI_Allreduce(&loop, &looptot, 1, MPI_INT, MPI_SUM, world);
-    if (looptot >= 400 * comm->nprocs) break;
+    comm->forward_comm(this);
   }
 }
 
@@ -640,129 +677,119 @@ void FixReaxFFSpecies::SortMolecule(int &Nmole)
 
 void FixReaxFFSpecies::FindSpecies(int Nmole, int &Nspec)
 {
-  int k, l, m, n, itype, cid;
-  int flag_identity, flag_mol, flag_spec;
-  int flag_tmp;
+  int i, m, cid;
   int *mask = atom->mask;
-  int *Nameall, *NMolall;
+  int *type = atom->type;
+
+  // composition of all molecules with a single reduction
+
+  int *Count, *Countall;
+  memory->create(Count, Nmole * ntypes, "reaxff/species:Count");
+  memory->create(Countall, Nmole * ntypes, "reaxff/species:Countall");
+  for (i = 0; i < Nmole * ntypes; i++) Count[i] = 0;
+
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
+    cid = nint(clusterID[i]);
+    Count[ntypes * (cid - 1) + type[i] - 1]++;
+  }
+  MPI_Allreduce(Count, Countall, Nmole * ntypes, MPI_INT, MPI_SUM, world);
+  memory->destroy(Count);
 
   memory->destroy(MolName);
   MolName = nullptr;
-  memory->create(MolName, Nmole * (ntypes + 1), "reaxff/species:MolName");
+  memory->create(MolName, Nmole * ntypes, "reaxff/species:MolName");
 
   memory->destroy(NMol);
   NMol = nullptr;
   memory->create(NMol, Nmole, "reaxff/species:NMol");
-  for (m = 0; m < Nmole; m++) NMol[m] = 1;
-
-  memory->create(Nameall, ntypes, "reaxff/species:Nameall");
-  memory->create(NMolall, Nmole, "reaxff/species:NMolall");
 
   memory->destroy(Mol2Spec);
   Mol2Spec = nullptr;
   memory->create(Mol2Spec, Nmole, "reaxff/species:Mol2Spec");
-  for (m = 0; m < Nmole; m++) Mol2Spec[m] = -1;
-
-  for (m = 1, Nspec = 0; m <= Nmole; m++) {
-    for (n = 0; n < ntypes; n++) Name[n] = 0;
-    for (n = 0, flag_mol = 0; n < nlocal; n++) {
-      if (!(mask[n] & groupbit)) continue;
-      cid = nint(clusterID[n]);
-      if (cid == m) {
-        itype = atom->type[n] - 1;
-        Name[itype]++;
-        flag_mol = 1;
-      }
-    }
-    MPI_Allreduce(&flag_mol, &flag_tmp, 1, MPI_INT, MPI_MAX, world);
-    flag_mol = flag_tmp;
-
-    MPI_Allreduce(Name, Nameall, ntypes, MPI_INT, MPI_SUM, world);
-    for (n = 0; n < ntypes; n++) Name[n] = Nameall[n];
-
-    if (flag_mol == 1) {
-      flag_identity = 1;
-      for (k = 0; k < Nspec; k++) {
-        flag_spec = 0;
-        for (l = 0; l < ntypes; l++)
-          if (MolName[ntypes * k + l] != Name[l]) flag_spec = 1;
-        if (flag_spec == 0) {
-          NMol[k]++;
-          Mol2Spec[m - 1] = k;
-        }
-        flag_identity *= flag_spec;
-      }
-      if (Nspec == 0 || flag_identity == 1) {
-        for (l = 0; l < ntypes; l++) MolName[ntypes * Nspec + l] = Name[l];
-        Mol2Spec[m - 1] = Nspec;
-        Nspec++;
-      }
-    }
-  }
-  memory->destroy(NMolall);
-  memory->destroy(Nameall);
 
-  memory->destroy(nd);
-  nd = nullptr;
-  memory->create(nd, Nspec, "reaxff/species:nd");
+  // look up composition of each molecule in hash table of known species
+  // species are numbered in the order of their first molecule
+
+  std::unordered_map<std::string, int> species;
+  const std::size_t nbytes = ntypes * sizeof(int);
+
+  Nspec = 0;
+  for (m = 0; m < Nmole; m++) {
+    Mol2Spec[m] = -1;
+    const int *comp = Countall + ntypes * m;
+    int natoms = 0;
+    for (i = 0; i < ntypes; i++) natoms += comp[i];
+    if (natoms == 0) continue;
 
-  memory->destroy(MolType);
-  MolType = nullptr;
-  memory->create(MolType, Nspec * (ntypes + 2), "reaxff/species:MolType");
+    auto found = species.emplace(std::string((const char *) comp, nbytes), Nspec);
+    if (found.second) {
+      for (i = 0; i < ntypes; i++) MolName[ntypes * Nspec + i] = comp[i];
+      NMol[Nspec++] = 1;
+    } else
+      NMol[found.first->second]++;
+    Mol2Spec[m] = found.first->second;
+  }
+  memory->destroy(Countall);
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   chemical formula of species with composition COMP
+------------------------------------------------------------------------- */
 
-int FixReaxFFSpecies::CheckExistence(int id, int ntypes)
+std::string FixReaxFFSpecies::SpeciesName(const int *comp) const
 {
-  int i, j, molid, flag;
-
-  for (i = 0; i < Nmoltype; i++) {
-    flag = 0;
-    for (j = 0; j < ntypes; j++) {
-      molid = MolType[ntypes * i + j];
-      if (molid != MolName[ntypes * id + j]) flag = 1;
+  std::string name;
+  for (int j = 0; j < ntypes; j++) {
+    if (comp[j] != 0) {
+      if (eletype)
+        name += eletype[j];
+      else
+        name += ele[j];
+      if (comp[j] != 1) name += std::to_string(comp[j]);
     }
-    if (flag == 0) return i;
   }
-  for (i = 0; i < ntypes; i++) MolType[ntypes * Nmoltype + i] = MolName[ntypes * id + i];
+  return name;
+}
+
+/* ----------------------------------------------------------------------
+   run output task on background thread if requested, else right away
+   task must only access its own copy of the data
+------------------------------------------------------------------------- */
+
+void FixReaxFFSpecies::WriteOutput(const std::function<void()> &task)
+{
+  if (!asyncflag) {
+    task();
+    return;
+  }
 
-  Nmoltype++;
-  return Nmoltype - 1;
+  if (!async_writer) async_writer = new AsyncWriter();
+  try {
+    async_writer->submit(task);
+  } catch (FileWriterException &e) {
+    error->one(FLERR, e.what());
+  }
 }
 
 /* ---------------------------------------------------------------------- */
 
 void FixReaxFFSpecies::WriteFormulas(int Nmole, int Nspec)
 {
-  int i, j, itemp;
   bigint ntimestep = update->ntimestep;
-
-  fprintf(fp, "#  Timestep    No_Moles    No_Specs");
-
-  Nmoltype = 0;
-
-  for (i = 0; i < Nspec; i++) nd[i] = CheckExistence(i, ntypes);
-
-  for (i = 0; i < Nmoltype; i++) {
-    std::string molname;
-    for (j = 0; j < ntypes; j++) {
-      itemp = MolType[ntypes * i + j];
-      if (itemp != 0) {
-        if (eletype)
-          molname += eletype[j];
-        else
-          molname += ele[j];
-        if (itemp != 1) molname += std::to_string(itemp);
-      }
-    }
-    fmt::print(fp, " {:>11}", molname);
-  }
-  fputs("\n", fp);
-
-  fmt::print(fp, "{:>11} {:>11} {:>11}", ntimestep, Nmole, Nspec);
-  for (i = 0; i < Nmoltype; i++) fmt::print(fp, " {:>11}", NMol[i]);
-  fputs("\n", fp);
+  std::vector<int> molname(MolName, MolName + ntypes * Nspec);
+  std::vector<int> nmol(NMol, NMol + Nspec);
+  FILE *out = fp;
+
+  WriteOutput([=]() {
+    std::string line = "#  Timestep    No_Moles    No_Specs";
+    for (int i = 0; i < Nspec; i++) line += fmt::format(" {:>11}", SpeciesName(&molname[ntypes * i]));
+    line += fmt::format("\n{:>11} {:>11} {:>11}", ntimestep, Nmole, Nspec);
+    for (int i = 0; i < Nspec; i++) line += fmt::format(" {:>11}", nmol[i]);
+    line += "\n";
+    fputs(line.c_str(), out);
+    fflush(out);
+  });
 }
 
 /* ---------------------------------------------------------------------- */
@@ -784,11 +811,9 @@ void FixReaxFFSpecies::OpenPos()
 
 void FixReaxFFSpecies::WritePos(int Nmole, int Nspec)
 {
-  int i, itype, cid;
-  int count, count_tmp, m, n, k;
-  int *Nameall;
+  int i, k, m, cid;
   int *mask = atom->mask;
-  double avq, avq_tmp, avx[3], avx_tmp, box[3], halfbox[3];
+  double box[3], halfbox[3];
   double **spec_atom = f_SPECBOND->array_atom;
 
   if (multipos) OpenPos();
@@ -799,88 +824,84 @@ void FixReaxFFSpecies::WritePos(int Nmole, int Nspec)
 
   for (int j = 0; j < 3; j++) halfbox[j] = box[j] / 2;
 
-  if (comm->me == 0) {
-    fmt::print(pos,
-               "Timestep {} NMole {}  NSpec {}  xlo {:f}  "
-               "xhi {:f}  ylo {:f}  yhi {:f}  zlo {:f}  zhi {:f}\n",
-               update->ntimestep, Nmole, Nspec, domain->boxlo[0], domain->boxhi[0],
-               domain->boxlo[1], domain->boxhi[1], domain->boxlo[2], domain->boxhi[2]);
-
-    fprintf(pos, "ID\tAtom_Count\tType\tAve_q\t\tCoM_x\t\tCoM_y\t\tCoM_z\n");
+  // sum charge and unwrapped coordinates of all molecules with a single reduction
+
+  double *sum, *sumall;
+  memory->create(sum, 4 * Nmole, "reaxff/species:sum");
+  memory->create(sumall, 4 * Nmole, "reaxff/species:sumall");
+  for (m = 0; m < 4 * Nmole; m++) sum[m] = 0.0;
+
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
+    cid = nint(clusterID[i]) - 1;
+    sum[4 * cid] += spec_atom[i][0];
+    if ((x0[i].x - spec_atom[i][1]) > halfbox[0]) spec_atom[i][1] += box[0];
+    if ((spec_atom[i][1] - x0[i].x) > halfbox[0]) spec_atom[i][1] -= box[0];
+    if ((x0[i].y - spec_atom[i][2]) > halfbox[1]) spec_atom[i][2] += box[1];
+    if ((spec_atom[i][2] - x0[i].y) > halfbox[1]) spec_atom[i][2] -= box[1];
+    if ((x0[i].z - spec_atom[i][3]) > halfbox[2]) spec_atom[i][3] += box[2];
+    if ((spec_atom[i][3] - x0[i].z) > halfbox[2]) spec_atom[i][3] -= box[2];
+    for (k = 0; k < 3; k++) sum[4 * cid + k + 1] += spec_atom[i][k + 1];
   }
+  MPI_Reduce(sum, sumall, 4 * Nmole, MPI_DOUBLE, MPI_SUM, 0, world);
+  memory->destroy(sum);
 
-  Nameall = nullptr;
-  memory->create(Nameall, ntypes, "reaxff/species:Nameall");
-
-  for (m = 1; m <= Nmole; m++) {
-
-    count = 0;
-    avq = 0.0;
-    for (n = 0; n < 3; n++) avx[n] = 0.0;
-    for (n = 0; n < ntypes; n++) Name[n] = 0;
-
-    for (i = 0; i < nlocal; i++) {
-      if (!(mask[i] & groupbit)) continue;
-      cid = nint(clusterID[i]);
-      if (cid == m) {
-        itype = atom->type[i] - 1;
-        Name[itype]++;
-        count++;
-        avq += spec_atom[i][0];
-        if ((x0[i].x - spec_atom[i][1]) > halfbox[0]) spec_atom[i][1] += box[0];
-        if ((spec_atom[i][1] - x0[i].x) > halfbox[0]) spec_atom[i][1] -= box[0];
-        if ((x0[i].y - spec_atom[i][2]) > halfbox[1]) spec_atom[i][2] += box[1];
-        if ((spec_atom[i][2] - x0[i].y) > halfbox[1]) spec_atom[i][2] -= box[1];
-        if ((x0[i].z - spec_atom[i][3]) > halfbox[2]) spec_atom[i][3] += box[2];
-        if ((spec_atom[i][3] - x0[i].z) > halfbox[2]) spec_atom[i][3] -= box[2];
-        for (n = 0; n < 3; n++) avx[n] += spec_atom[i][n + 1];
-      }
-    }
+  if (comm->me == 0) {
 
-    avq_tmp = 0.0;
-    MPI_Allreduce(&avq, &avq_tmp, 1, MPI_DOUBLE, MPI_SUM, world);
-    avq = avq_tmp;
+    // average charge and fractional center of mass of each molecule
+    // atom count and formula of each molecule follow from its species
 
-    for (n = 0; n < 3; n++) {
-      avx_tmp = 0.0;
-      MPI_Reduce(&avx[n], &avx_tmp, 1, MPI_DOUBLE, MPI_SUM, 0, world);
-      avx[n] = avx_tmp;
-    }
+    std::vector<double> avg(sumall, sumall + 4 * Nmole);
+    std::vector<int> molname(Nmole * ntypes, 0);
+    std::vector<int> count(Nmole, 0);
 
-    MPI_Reduce(&count, &count_tmp, 1, MPI_INT, MPI_SUM, 0, world);
-    count = count_tmp;
-
-    MPI_Reduce(Name, Nameall, ntypes, MPI_INT, MPI_SUM, 0, world);
-    for (n = 0; n < ntypes; n++) Name[n] = Nameall[n];
-
-    if (comm->me == 0) {
-      fprintf(pos, "%d\t%d\t", m, count);
-      for (n = 0; n < ntypes; n++) {
-        if (Name[n] != 0) {
-          if (eletype)
-            fprintf(pos, "%s", eletype[n]);
-          else
-            fprintf(pos, "%c", ele[n]);
-          if (Name[n] != 1) fprintf(pos, "%d", Name[n]);
-        }
+    for (m = 0; m < Nmole; m++) {
+      if (Mol2Spec[m] < 0) continue;
+      const int *comp = MolName + ntypes * Mol2Spec[m];
+      for (k = 0; k < ntypes; k++) {
+        molname[ntypes * m + k] = comp[k];
+        count[m] += comp[k];
       }
-      if (count > 0) {
-        avq /= count;
-        for (k = 0; k < 3; k++) {
-          avx[k] /= count;
-          if (avx[k] >= domain->boxhi[k]) avx[k] -= box[k];
-          if (avx[k] < domain->boxlo[k]) avx[k] += box[k];
-
-          avx[k] -= domain->boxlo[k];
-          avx[k] /= box[k];
-        }
-        fprintf(pos, "\t%.8f \t%.8f \t%.8f \t%.8f", avq, avx[0], avx[1], avx[2]);
+      if (count[m] == 0) continue;
+      double *av = &avg[4 * m];
+      av[0] /= count[m];
+      for (k = 0; k < 3; k++) {
+        av[k + 1] /= count[m];
+        if (av[k + 1] >= domain->boxhi[k]) av[k + 1] -= box[k];
+        if (av[k + 1] < domain->boxlo[k]) av[k + 1] += box[k];
+        av[k + 1] -= domain->boxlo[k];
+        av[k + 1] /= box[k];
       }
-      fprintf(pos, "\n");
     }
+
+    auto header = fmt::format("Timestep {} NMole {}  NSpec {}  xlo {:f}  "
+                              "xhi {:f}  ylo {:f}  yhi {:f}  zlo {:f}  zhi {:f}\n",
+                              update->ntimestep, Nmole, Nspec, domain->boxlo[0],
+                              domain->boxhi[0], domain->boxlo[1], domain->boxhi[1],
+                              domain->boxlo[2], domain->boxhi[2]);
+    FILE *out = pos;
+    int closeflag = multipos;
+
+    WriteOutput([=]() {
+      std::string text = header;
+      text += "ID\tAtom_Count\tType\tAve_q\t\tCoM_x\t\tCoM_y\t\tCoM_z\n";
+      for (int m = 0; m < Nmole; m++) {
+        text += fmt::format("{}\t{}\t{}", m + 1, count[m], SpeciesName(&molname[ntypes * m]));
+        if (count[m] > 0)
+          text += fmt::format("\t{:.8f} \t{:.8f} \t{:.8f} \t{:.8f}", avg[4 * m], avg[4 * m + 1],
+                              avg[4 * m + 2], avg[4 * m + 3]);
+        text += "\n";
+      }
+      if (!closeflag) text += "#\n";
+      fputs(text.c_str(), out);
+      if (closeflag)
+        fclose(out);
+      else
+        fflush(out);
+    });
+    if (multipos) pos = nullptr;
   }
-  if (comm->me == 0 && !multipos) fprintf(pos, "#\n");
-  memory->destroy(Nameall);
+  memory->destroy(sumall);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -898,11 +919,10 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
     if (headroom == 0) return;
   }
 
-  int i, j, m, n, itype, cid;
-  int ndel, ndelone, count, count_tmp;
-  int *Nameall;
+  int i, j, m;
+  int ndel, ndelone, count;
   int *mask = atom->mask;
-  double localmass, totalmass;
+  double totalmass;
   std::string species_str;
 
   AtomVec *avec = atom->avec;
@@ -911,9 +931,6 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
   memory->create(mark, nlocal, "reaxff/species:mark");
   for (i = 0; i < nlocal; i++) mark[i] = 0;
 
-  Nameall = nullptr;
-  memory->create(Nameall, ntypes, "reaxff/species:Nameall");
-
   int ndelcomm;
   if (masslimitflag)
     ndelcomm = Nspec;
@@ -924,9 +941,21 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
   memory->create(deletecount, ndelcomm, "reaxff/species:deletecount");
   for (i = 0; i < ndelcomm; i++) deletecount[i] = 0;
 
-  int nmarklist;
-  int *marklist;
+  // sort my atoms by molecule, atoms of molecule M are
+  // marklist[molstart[M-1]] to marklist[molstart[M]-1]
+
+  int *marklist, *molstart;
   memory->create(marklist, nlocal, "reaxff/species:marklist");
+  memory->create(molstart, Nmole + 1, "reaxff/species:molstart");
+  for (m = 0; m <= Nmole; m++) molstart[m] = 0;
+  for (i = 0; i < nlocal; i++)
+    if (mask[i] & groupbit) molstart[nint(clusterID[i])]++;
+  for (m = 0; m < Nmole; m++) molstart[m + 1] += molstart[m];
+  int nmark = molstart[Nmole];
+  for (i = nlocal - 1; i >= 0; i--)
+    if (mask[i] & groupbit) marklist[--molstart[nint(clusterID[i])]] = i;
+  for (m = 0; m < Nmole; m++) molstart[m] = molstart[m + 1];
+  molstart[Nmole] = nmark;
 
   std::random_device rnd;
   std::minstd_rand park_rng(rnd());
@@ -939,43 +968,22 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
     MPI_Bcast(&molrange[0], Nmole, MPI_INT, 0, world);
   }
 
+  // atom count, mass, and formula of each molecule follow from its species
+
   int this_delete_Tcount = 0;
   for (int mm = 0; mm < Nmole; mm++) {
     if (this_delete_Tcount == headroom) break;
     m = molrange[mm];
-    localmass = totalmass = count = nmarklist = 0;
-    for (n = 0; n < ntypes; n++) Name[n] = 0;
-
-    for (i = 0; i < nlocal; i++) {
-      if (!(mask[i] & groupbit)) continue;
-      cid = nint(clusterID[i]);
-      if (cid == m) {
-        itype = atom->type[i] - 1;
-        Name[itype]++;
-        count++;
-        marklist[nmarklist++] = i;
-        localmass += atom->mass[atom->type[i]];
-      }
-    }
-
-    MPI_Allreduce(&count, &count_tmp, 1, MPI_INT, MPI_SUM, world);
-    count = count_tmp;
-
-    MPI_Allreduce(Name, Nameall, ntypes, MPI_INT, MPI_SUM, world);
-    for (n = 0; n < ntypes; n++) Name[n] = Nameall[n];
+    if (Mol2Spec[m - 1] < 0) continue;
+    const int *comp = MolName + ntypes * Mol2Spec[m - 1];
 
-    MPI_Allreduce(&localmass, &totalmass, 1, MPI_DOUBLE, MPI_SUM, world);
-
-    species_str = "";
+    count = 0;
+    totalmass = 0.0;
     for (j = 0; j < ntypes; j++) {
-      if (Name[j] != 0) {
-        if (eletype)
-          species_str += eletype[j];
-        else
-          species_str += ele[j];
-        if (Name[j] != 1) species_str += fmt::format("{}", Name[j]);
-      }
+      count += comp[j];
+      totalmass += comp[j] * atom->mass[j + 1];
     }
+    species_str = SpeciesName(comp);
 
     if (masslimitflag) {
 
@@ -983,7 +991,7 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
 
       if (totalmass > massmin && totalmass < massmax) {
         this_delete_Tcount++;
-        for (j = 0; j < nmarklist; j++) {
+        for (j = molstart[m - 1]; j < molstart[m]; j++) {
           mark[marklist[j]] = 1;
           deletecount[Mol2Spec[m - 1]] += 1.0 / (double) count;
         }
@@ -993,7 +1001,7 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
         for (i = 0; i < ndelspec; i++) {
           if (del_species[i] == species_str) {
             this_delete_Tcount++;
-            for (j = 0; j < nmarklist; j++) {
+            for (j = molstart[m - 1]; j < molstart[m]; j++) {
               mark[marklist[j]] = 1;
               deletecount[i] += 1.0 / (double) count;
             }
@@ -1078,8 +1086,8 @@ void FixReaxFFSpecies::DeleteSpecies(int Nmole, int Nspec)
 
   next_reneighbor = update->ntimestep;
 
-  memory->destroy(Nameall);
   memory->destroy(marklist);
+  memory->destroy(molstart);
   memory->destroy(mark);
   memory->destroy(deletecount);
   memory->destroy(molrange);
@@ -1149,6 +1157,7 @@ double FixReaxFFSpecies::memory_usage()
   double bytes;
 
   bytes = 4 * nmax * sizeof(double);    // clusterID + x0
+  bytes += uf->memory_usage();
 
   return bytes;
 }
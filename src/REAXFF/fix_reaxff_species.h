@@ -24,6 +24,8 @@ FixStyle(reax/c/species,FixReaxFFSpecies);
 
 #include "fix.h"
 
+#include <functional>
+
 #define BUFLEN 1000
 
 namespace LAMMPS_NS {
@@ -41,22 +43,25 @@ class FixReaxFFSpecies : public Fix {
   void init_list(int, class NeighList *) override;
   void setup(int) override;
   void post_integrate() override;
+  void post_run() override;
   double compute_vector(int) override;
 
  protected:
   int nmax, nlocal, ntypes, ntotal;
   int nrepeat, nfreq, posfreq, compressed, ndelspec;
-  int Nmoltype, vector_nmole, vector_nspec;
-  int *Name, *MolName, *NMol, *nd, *MolType, *molmap, *mark;
+  int vector_nmole, vector_nspec;
+  int *MolName, *NMol, *molmap, *mark;
   int *Mol2Spec;
   double *clusterID;
   AtomCoord *x0;
   double **BOCut;
+  class UnionFind *uf;
+  class AsyncWriter *async_writer;
 
   std::vector<std::string> del_species;
 
   FILE *fp, *pos, *fdel;
-  int eleflag, posflag, multipos, padflag, setupflag;
+  int eleflag, posflag, multipos, padflag, setupflag, asyncflag;
   int delflag, specieslistflag, masslimitflag;
   int delete_Nlimit, delete_Nlimit_varid;
   std::string delete_Nlimit_varname;
@@ -68,11 +73,13 @@ class FixReaxFFSpecies : public Fix {
   void Output_ReaxFF_Bonds(bigint, FILE *);
   AtomCoord chAnchor(AtomCoord, AtomCoord);
   virtual void FindMolecule();
+  void MergeMolecules(int, int *);
   void SortMolecule(int &);
   void FindSpecies(int, int &);
   void WriteFormulas(int, int);
   void DeleteSpecies(int, int);
-  int CheckExistence(int, int);
+  std::string SpeciesName(const int *) const;
+  void WriteOutput(const std::function<void()> &);
 
   int nint(const double &);
   int pack_forward_comm(int, int *, double *, int, int *) override;
@@ -721,6 +721,34 @@ void *PairReaxFF::extract(const char *str, int &dim)
   return nullptr;
 }
 
+/* ----------------------------------------------------------------------
+   estimate cost of each owned atom from its interactions in the last step
+   nonbonded: # of far neighbors, bonded: # of bonds, angles and torsions
+     that the atom is the center of, estimated from bond counts
+------------------------------------------------------------------------- */
+
+int PairReaxFF::cost_atom(double *cost)
+{
+  if (!api->lists || !api->system) return 0;
+  reax_list *far_nbrs = api->lists + FAR_NBRS;
+  reax_list *bonds = api->lists + BONDS;
+  if (!far_nbrs->allocated || !bonds->allocated) return 0;
+
+  const int nlocal = MIN(atom->nlocal, api->system->n);
+  bond_data *bond_list = bonds->select.bond_list;
+
+  for (int i = 0; i < nlocal; i++) {
+    double nbond = Num_Entries(i, bonds);
+    double ntors = 0.0;
+    for (int pj = Start_Index(i, bonds); pj < End_Index(i, bonds); pj++) {
+      int j = bond_list[pj].nbr;
+      ntors += (nbond - 1.0) * (Num_Entries(j, bonds) - 1.0);
+    }
+    cost[i] += Num_Entries(i, far_nbrs) + nbond + 0.5 * nbond * (nbond - 1.0) + MAX(ntors, 0.0);
+  }
+  return 1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 double PairReaxFF::memory_usage()
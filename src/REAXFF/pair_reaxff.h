@@ -51,6 +51,7 @@ class PairReaxFF : public Pair {
   void init_style() override;
   double init_one(int, int) override;
   void *extract(const char *, int &) override;
+  int cost_atom(double *) override;
   int fixbond_flag, fixspecies_flag;
   int **tmpid;
   double **tmpbo, **tmpr;
@@ -31,6 +31,7 @@ using namespace LAMMPS_NS;
 ComputePressureGrem::ComputePressureGrem(LAMMPS *lmp, int narg, char **arg) :
   ComputePressure(lmp, narg-1, arg)
 {
+  size_scalar_partial = size_vector_partial = 0;
   fix_grem = utils::strdup(arg[narg-1]);
 }
 
@@ -49,7 +49,8 @@ using namespace RigidConst;
 FixRigid::FixRigid(LAMMPS *lmp, int narg, char **arg) :
   Fix(lmp, narg, arg), step_respa(nullptr),
   inpfile(nullptr), nrigid(nullptr), mol2body(nullptr), body2mol(nullptr),
-  body(nullptr), displace(nullptr), masstotal(nullptr), xcm(nullptr),
+  body(nullptr), bodyfirst(nullptr), bodyatom(nullptr), displace(nullptr),
+  masstotal(nullptr), xcm(nullptr),
   vcm(nullptr), fcm(nullptr), inertia(nullptr), ex_space(nullptr),
   ey_space(nullptr), ez_space(nullptr), angmom(nullptr), omega(nullptr),
   torque(nullptr), quat(nullptr), imagebody(nullptr), fflag(nullptr),
@@ -289,6 +290,10 @@ FixRigid::FixRigid(LAMMPS *lmp, int narg, char **arg) :
   memory->create(all,nbody,6,"rigid:all");
   memory->create(remapflag,nbody,4,"rigid:remapflag");
 
+  memory->create(bodyfirst,nbody+1,"rigid:bodyfirst");
+  for (ibody = 0; ibody <= nbody; ibody++) bodyfirst[ibody] = 0;
+  maxbodyatom = 0;
+
   // initialize force/torque flags to default = 1.0
   // for 2d: fz, tx, ty = 0.0
 
@@ -652,6 +657,8 @@ FixRigid::~FixRigid()
   memory->destroy(sum);
   memory->destroy(all);
   memory->destroy(remapflag);
+  memory->destroy(bodyfirst);
+  memory->destroy(bodyatom);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -1026,49 +1033,53 @@ void FixRigid::compute_forces_and_torques()
 
   double **x = atom->x;
   double **f = atom->f;
-  int nlocal = atom->nlocal;
 
   double dx,dy,dz;
   double unwrap[3];
 
-  for (ibody = 0; ibody < nbody; ibody++)
-    for (i = 0; i < 6; i++) sum[ibody][i] = 0.0;
-
-  for (i = 0; i < nlocal; i++) {
-    if (body[i] < 0) continue;
-    ibody = body[i];
+  double **torque_one = atom->torque;
 
-    sum[ibody][0] += f[i][0];
-    sum[ibody][1] += f[i][1];
-    sum[ibody][2] += f[i][2];
+  // loop over bodies and their atoms via bodyfirst/bodyatom,
+  //   so sums of each body are accumulated in one place
+  // extended particles add their torque to torque of body
 
-    domain->unmap(x[i],xcmimage[i],unwrap);
-    dx = unwrap[0] - xcm[ibody][0];
-    dy = unwrap[1] - xcm[ibody][1];
-    dz = unwrap[2] - xcm[ibody][2];
+  for (ibody = 0; ibody < nbody; ibody++) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0, s5 = 0.0;
 
-    sum[ibody][3] += dy*f[i][2] - dz*f[i][1];
-    sum[ibody][4] += dz*f[i][0] - dx*f[i][2];
-    sum[ibody][5] += dx*f[i][1] - dy*f[i][0];
-  }
+    for (int k = bodyfirst[ibody]; k < bodyfirst[ibody+1]; k++) {
+      i = bodyatom[k];
 
-  // extended particles add their torque to torque of body
+      s0 += f[i][0];
+      s1 += f[i][1];
+      s2 += f[i][2];
 
-  if (extended) {
-    double **torque_one = atom->torque;
+      domain->unmap(x[i],xcmimage[i],unwrap);
+      dx = unwrap[0] - xcm[ibody][0];
+      dy = unwrap[1] - xcm[ibody][1];
+      dz = unwrap[2] - xcm[ibody][2];
 
-    for (i = 0; i < nlocal; i++) {
-      if (body[i] < 0) continue;
-      ibody = body[i];
+      s3 += dy*f[i][2] - dz*f[i][1];
+      s4 += dz*f[i][0] - dx*f[i][2];
+      s5 += dx*f[i][1] - dy*f[i][0];
 
-      if (eflags[i] & TORQUE) {
-        sum[ibody][3] += torque_one[i][0];
-        sum[ibody][4] += torque_one[i][1];
-        sum[ibody][5] += torque_one[i][2];
+      if (extended && (eflags[i] & TORQUE)) {
+        s3 += torque_one[i][0];
+        s4 += torque_one[i][1];
+        s5 += torque_one[i][2];
       }
     }
+
+    sum[ibody][0] = s0;
+    sum[ibody][1] = s1;
+    sum[ibody][2] = s2;
+    sum[ibody][3] = s3;
+    sum[ibody][4] = s4;
+    sum[ibody][5] = s5;
   }
 
+  // every proc stores all bodies and integrates them redundantly,
+  //   so each proc needs the total force and torque of every body
+
   MPI_Allreduce(sum[0],all[0],6*nbody,MPI_DOUBLE,MPI_SUM,world);
 
   // include Langevin thermostat forces
@@ -1167,6 +1178,7 @@ void FixRigid::final_integrate_respa(int ilevel, int /*iloop*/)
      or due to box flip
    also adjust imagebody = rigid body image flags, due to xcm remap
    also reset body xcmimage flags of all atoms in bodies
+     and regroup owned atoms by body
    xcmimage flags are relative to xcm so that body can be unwrapped
    if don't do this, would need xcm to move with true image flags
      then a body could end up very far away from box
@@ -1180,6 +1192,35 @@ void FixRigid::pre_neighbor()
   for (int ibody = 0; ibody < nbody; ibody++)
     domain->remap(xcm[ibody],imagebody[ibody]);
   image_shift();
+  group_atoms_by_body();
+}
+
+/* ----------------------------------------------------------------------
+   group owned atoms by the rigid body they are in via counting sort
+   atoms of each body stay in ascending order of their local index
+   done during pre_neighbor, since local indices only change on reneighboring
+------------------------------------------------------------------------- */
+
+void FixRigid::group_atoms_by_body()
+{
+  int nlocal = atom->nlocal;
+
+  if (nlocal > maxbodyatom) {
+    maxbodyatom = atom->nmax;
+    memory->destroy(bodyatom);
+    memory->create(bodyatom,maxbodyatom,"rigid:bodyatom");
+  }
+
+  for (int ibody = 0; ibody <= nbody; ibody++) bodyfirst[ibody] = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (body[i] >= 0) bodyfirst[body[i]+1]++;
+  for (int ibody = 0; ibody < nbody; ibody++)
+    bodyfirst[ibody+1] += bodyfirst[ibody];
+  for (int i = 0; i < nlocal; i++)
+    if (body[i] >= 0) bodyatom[bodyfirst[body[i]]++] = i;
+  for (int ibody = nbody; ibody > 0; ibody--)
+    bodyfirst[ibody] = bodyfirst[ibody-1];
+  bodyfirst[0] = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -2432,6 +2473,7 @@ double FixRigid::memory_usage()
     if (orientflag) bytes = (double)nmax*orientflag * sizeof(double);
     if (dorientflag) bytes = (double)nmax*3 * sizeof(double);
   }
+  bytes += (double)maxbodyatom * sizeof(int);
   return bytes;
 }
 
@@ -81,6 +81,9 @@ class FixRigid : public Fix {
   int maxmol;       // size of mol2body = max mol-ID
 
   int *body;            // which body each atom is part of (-1 if none)
+  int *bodyfirst;       // atoms of body I are bodyatom[bodyfirst[I]] to
+  int *bodyatom;        //   bodyatom[bodyfirst[I+1]-1] in ascending order
+  int maxbodyatom;      // allocated length of bodyatom
   double **displace;    // displacement of each atom in body coords
 
   double *masstotal;    // total mass of each rigid body
@@ -141,6 +144,7 @@ class FixRigid : public Fix {
   class AtomVecTri *avec_tri;
 
   void image_shift();
+  void group_atoms_by_body();
   void set_xv();
   void set_v();
   void setup_bodies_static();
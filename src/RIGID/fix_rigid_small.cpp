@@ -55,7 +55,8 @@ using namespace RigidConst;
 
 FixRigidSmall::FixRigidSmall(LAMMPS *lmp, int narg, char **arg) :
   Fix(lmp, narg, arg), step_respa(nullptr),
-  inpfile(nullptr), body(nullptr), bodyown(nullptr), bodytag(nullptr), atom2body(nullptr),
+  inpfile(nullptr), body(nullptr), bodyfirst(nullptr), bodyatom(nullptr), bodyown(nullptr),
+  bodytag(nullptr), atom2body(nullptr),
   xcmimage(nullptr), displace(nullptr), eflags(nullptr), orient(nullptr), dorient(nullptr),
   avec_ellipsoid(nullptr), avec_line(nullptr), avec_tri(nullptr), counts(nullptr),
   itensor(nullptr), mass_body(nullptr), langextra(nullptr), random(nullptr),
@@ -83,6 +84,7 @@ FixRigidSmall::FixRigidSmall(LAMMPS *lmp, int narg, char **arg) :
   // register with Atom class
 
   extended = orientflag = dorientflag = customflag = 0;
+  maxbodyfirst = maxbodyatom = 0;
   bodyown = nullptr;
   bodytag = nullptr;
   atom2body = nullptr;
@@ -486,6 +488,8 @@ FixRigidSmall::~FixRigidSmall()
   // delete locally stored arrays
 
   memory->sfree(body);
+  memory->destroy(bodyfirst);
+  memory->destroy(bodyatom);
 
   memory->destroy(bodyown);
   memory->destroy(bodytag);
@@ -903,55 +907,52 @@ void FixRigidSmall::compute_forces_and_torques()
 
   double **x = atom->x;
   double **f = atom->f;
-  int nlocal = atom->nlocal;
+
+  double **torque_one = atom->torque;
 
   double dx,dy,dz;
   double unwrap[3];
   double *xcm,*fcm,*tcm;
 
-  for (ibody = 0; ibody < nlocal_body+nghost_body; ibody++) {
-    fcm = body[ibody].fcm;
-    fcm[0] = fcm[1] = fcm[2] = 0.0;
-    tcm = body[ibody].torque;
-    tcm[0] = tcm[1] = tcm[2] = 0.0;
-  }
-
-  for (i = 0; i < nlocal; i++) {
-    if (atom2body[i] < 0) continue;
-    Body *b = &body[atom2body[i]];
-
-    fcm = b->fcm;
-    fcm[0] += f[i][0];
-    fcm[1] += f[i][1];
-    fcm[2] += f[i][2];
+  // loop over bodies and their atoms via bodyfirst/bodyatom,
+  //   so sums of each body are accumulated in one place
+  // extended particles add their torque to torque of body
 
-    domain->unmap(x[i],xcmimage[i],unwrap);
-    xcm = b->xcm;
-    dx = unwrap[0] - xcm[0];
-    dy = unwrap[1] - xcm[1];
-    dz = unwrap[2] - xcm[2];
+  for (ibody = 0; ibody < nlocal_body+nghost_body; ibody++) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0, s5 = 0.0;
+    xcm = body[ibody].xcm;
 
-    tcm = b->torque;
-    tcm[0] += dy*f[i][2] - dz*f[i][1];
-    tcm[1] += dz*f[i][0] - dx*f[i][2];
-    tcm[2] += dx*f[i][1] - dy*f[i][0];
-  }
+    for (int k = bodyfirst[ibody]; k < bodyfirst[ibody+1]; k++) {
+      i = bodyatom[k];
 
-  // extended particles add their torque to torque of body
+      s0 += f[i][0];
+      s1 += f[i][1];
+      s2 += f[i][2];
 
-  if (extended) {
-    double **torque = atom->torque;
+      domain->unmap(x[i],xcmimage[i],unwrap);
+      dx = unwrap[0] - xcm[0];
+      dy = unwrap[1] - xcm[1];
+      dz = unwrap[2] - xcm[2];
 
-    for (i = 0; i < nlocal; i++) {
-      if (atom2body[i] < 0) continue;
+      s3 += dy*f[i][2] - dz*f[i][1];
+      s4 += dz*f[i][0] - dx*f[i][2];
+      s5 += dx*f[i][1] - dy*f[i][0];
 
-      if (eflags[i] & TORQUE) {
-        tcm = body[atom2body[i]].torque;
-        tcm[0] += torque[i][0];
-        tcm[1] += torque[i][1];
-        tcm[2] += torque[i][2];
+      if (extended && (eflags[i] & TORQUE)) {
+        s3 += torque_one[i][0];
+        s4 += torque_one[i][1];
+        s5 += torque_one[i][2];
       }
     }
+
+    fcm = body[ibody].fcm;
+    fcm[0] = s0;
+    fcm[1] = s1;
+    fcm[2] = s2;
+    tcm = body[ibody].torque;
+    tcm[0] = s3;
+    tcm[1] = s4;
+    tcm[2] = s5;
   }
 
   // reverse communicate fcm, torque of all bodies
@@ -3352,6 +3353,7 @@ void FixRigidSmall::grow_body()
    reset atom2body for all owned atoms
    do this via bodyown of atom that owns the body the owned atom is in
    atom2body values can point to original body or any image of the body
+   also rebuild bodyfirst/bodyatom lists of owned atoms in each body
 ------------------------------------------------------------------------- */
 
 void FixRigidSmall::reset_atom2body()
@@ -3374,6 +3376,32 @@ void FixRigidSmall::reset_atom2body()
       atom2body[i] = bodyown[iowner];
     }
   }
+
+  // group owned atoms by body via counting sort
+  // atoms of each body stay in ascending order of their local index
+
+  const int nbody_all = nlocal_body + nghost_body;
+  if (nbody_all + 1 > maxbodyfirst) {
+    maxbodyfirst = nbody_all + 1;
+    memory->destroy(bodyfirst);
+    memory->create(bodyfirst,maxbodyfirst,"rigid/small:bodyfirst");
+  }
+  if (nlocal > maxbodyatom) {
+    maxbodyatom = atom->nmax;
+    memory->destroy(bodyatom);
+    memory->create(bodyatom,maxbodyatom,"rigid/small:bodyatom");
+  }
+
+  for (int ibody = 0; ibody <= nbody_all; ibody++) bodyfirst[ibody] = 0;
+  for (int i = 0; i < nlocal; i++)
+    if (atom2body[i] >= 0) bodyfirst[atom2body[i]+1]++;
+  for (int ibody = 0; ibody < nbody_all; ibody++)
+    bodyfirst[ibody+1] += bodyfirst[ibody];
+  for (int i = 0; i < nlocal; i++)
+    if (atom2body[i] >= 0) bodyatom[bodyfirst[atom2body[i]]++] = i;
+  for (int ibody = nbody_all; ibody > 0; ibody--)
+    bodyfirst[ibody] = bodyfirst[ibody-1];
+  bodyfirst[0] = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -3619,6 +3647,7 @@ double FixRigidSmall::memory_usage()
     if (dorientflag) bytes = (double)nmax*3 * sizeof(double);
   }
   bytes += (double)nmax_body * sizeof(Body);
+  bytes += (double)(maxbodyfirst + maxbodyatom) * sizeof(int);
   return bytes;
 }
 
@@ -112,6 +112,14 @@ class FixRigidSmall : public Fix {
   int nmax_body;      // max # of bodies that body can hold
   int bodysize;       // sizeof(Body) in doubles
 
+  // owned atoms grouped by the owned/ghost body they are in
+  // atoms of body I are bodyatom[bodyfirst[I]] to bodyatom[bodyfirst[I+1]-1]
+  // in ascending order, rebuilt together with atom2body
+
+  int *bodyfirst;    // offset of first atom of each body in bodyatom
+  int *bodyatom;     // local indices of owned atoms in rigid bodies
+  int maxbodyfirst, maxbodyatom;
+
   // per-atom quantities
   // only defined for owned atoms, except bodyown for own+ghost
 
@@ -33,6 +33,7 @@ using namespace LAMMPS_NS;
 ComputePressureUef::ComputePressureUef(LAMMPS *lmp, int narg, char **arg) :
   ComputePressure(lmp, narg, arg)
 {
+  size_scalar_partial = size_vector_partial = 0;
   ext_flags[0] = true;
   ext_flags[1] = true;
   ext_flags[2] = true;
@@ -29,6 +29,7 @@ using namespace LAMMPS_NS;
 ComputeTempUef::ComputeTempUef(LAMMPS *lmp, int narg, char **arg) :
   ComputeTemp(lmp, narg, arg)
 {
+  size_vector_partial = 0;
   rot_flag=true;
 }
 
@@ -0,0 +1,126 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "async_writer.h"
+
+#include "file_writer.h"
+
+#include <exception>
+
+using namespace LAMMPS_NS;
+
+/* ---------------------------------------------------------------------- */
+
+AsyncWriter::AsyncWriter(int maxqueue) : maxqueue(maxqueue), busy(false), shutdown(false)
+{
+  if (this->maxqueue < 1) this->maxqueue = 1;
+}
+
+/* ----------------------------------------------------------------------
+   drain all pending tasks, then stop the worker thread
+   errors of tasks executed here are discarded since we cannot throw
+------------------------------------------------------------------------- */
+
+AsyncWriter::~AsyncWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    shutdown = true;
+  }
+  ready.notify_all();
+  if (worker.joinable()) worker.join();
+}
+
+/* ----------------------------------------------------------------------
+   append task to queue, start worker thread on first use
+   block while the queue is full
+------------------------------------------------------------------------- */
+
+void AsyncWriter::submit(std::function<void()> task)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return (int) queue.size() < maxqueue; });
+    check_error();
+    queue.push_back(std::move(task));
+  }
+  if (!worker.joinable()) worker = std::thread(&AsyncWriter::run, this);
+  ready.notify_one();
+}
+
+/* ----------------------------------------------------------------------
+   block until all submitted tasks have completed
+------------------------------------------------------------------------- */
+
+void AsyncWriter::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] { return queue.empty() && !busy; });
+  check_error();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void AsyncWriter::set_max_queue(int n)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  maxqueue = (n < 1) ? 1 : n;
+}
+
+/* ----------------------------------------------------------------------
+   rethrow the first error recorded by the worker and reset it
+   must be called with mutex held
+------------------------------------------------------------------------- */
+
+void AsyncWriter::check_error()
+{
+  if (!errmsg.empty()) {
+    std::string msg = errmsg;
+    errmsg.clear();
+    throw FileWriterException(msg);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   worker thread main loop
+------------------------------------------------------------------------- */
+
+void AsyncWriter::run()
+{
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      ready.wait(lock, [this] { return shutdown || !queue.empty(); });
+      if (queue.empty()) return;
+      task = std::move(queue.front());
+      queue.pop_front();
+      busy = true;
+    }
+    done.notify_all();
+
+    std::string msg;
+    try {
+      task();
+    } catch (std::exception &e) {
+      msg = e.what();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      busy = false;
+      if (!msg.empty() && errmsg.empty()) errmsg = msg;
+    }
+    done.notify_all();
+  }
+}
@@ -0,0 +1,60 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_ASYNC_WRITER_H
+#define LMP_ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace LAMMPS_NS {
+
+// run output tasks (formatting, compression, file I/O) on a background thread
+// tasks are executed in submission order; the queue is bounded so that
+// submit() blocks when more than maxqueue tasks are pending
+// tasks must not call MPI or touch LAMMPS data owned by the main thread
+// a task signals failure by throwing; the message is rethrown as a
+// FileWriterException from the next call to submit() or wait()
+
+class AsyncWriter {
+ public:
+  AsyncWriter(int maxqueue = 2);
+  ~AsyncWriter();
+
+  void submit(std::function<void()> task);
+  void wait();
+  void set_max_queue(int);
+  int get_max_queue() const { return maxqueue; }
+
+ private:
+  int maxqueue;     // max # of pending tasks before submit() blocks
+  bool busy;        // true while worker executes a task
+  bool shutdown;    // true when worker should exit after draining queue
+  std::string errmsg;
+
+  std::deque<std::function<void()>> queue;
+  std::mutex mutex;
+  std::condition_variable ready;    // signals new task or shutdown to worker
+  std::condition_variable done;     // signals task completion to producer
+  std::thread worker;
+
+  void run();
+  void check_error();
+};
+}    // namespace LAMMPS_NS
+
+#endif
@@ -49,6 +49,7 @@ using namespace MathConst;
 
 #define DELTA 1
 #define EPSILON 1.0e-6
+#define BIG 1.0e30
 #define MAXLINE 256
 
 /* ----------------------------------------------------------------------
@@ -1038,11 +1039,14 @@ void Atom::deallocate_topology()
 /* ----------------------------------------------------------------------
    unpack N lines from Atom section of data file
    call style-specific routine to parse line
+   if keepall = 1, store all atoms in the box, not just those in my sub-domain
+     caller must migrate them to their owning procs
+     used when procs read different lines, so errors are not collective
 ------------------------------------------------------------------------- */
 
 void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
                       int type_offset, int shiftflag, double *shift,
-                      int labelflag, int *ilabel)
+                      int labelflag, int *ilabel, int keepall)
 {
   int xptr,iptr;
   imageint imagedata;
@@ -1054,7 +1058,10 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
 
   // use the first line to detect and validate the number of words/tokens per line
   next = strchr(buf,'\n');
-  if (!next) error->all(FLERR, "Missing data in {}", location);
+  if (!next) {
+    if (keepall) error->one(FLERR, "Missing data in {}", location);
+    error->all(FLERR, "Missing data in {}", location);
+  }
   *next = '\0';
   auto values = Tokenizer(buf).as_vector();
   int nwords = values.size();
@@ -1065,8 +1072,10 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
     }
   }
 
-  if ((nwords != avec->size_data_atom) && (nwords != avec->size_data_atom + 3))
+  if ((nwords != avec->size_data_atom) && (nwords != avec->size_data_atom + 3)) {
+    if (keepall) error->one(FLERR,"Incorrect format in {}: {}", location, utils::trim(buf));
     error->all(FLERR,"Incorrect format in {}: {}", location, utils::trim(buf));
+  }
 
   *next = '\n';
   // set bounds for my proc
@@ -1123,6 +1132,25 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
     }
   }
 
+  // if keepall, atoms are migrated to their owning procs later, so accept
+  //   the entire box, but still reject atoms outside a non-periodic boundary
+  //   since no proc would own them and the serial read would drop them
+
+  if (keepall) {
+    for (int idim = 0; idim < 3; idim++) {
+      if (domain->periodicity[idim]) {
+        sublo[idim] = -BIG;
+        subhi[idim] = BIG;
+      } else if (triclinic) {
+        sublo[idim] = 0.0;
+        subhi[idim] = 1.0;
+      } else {
+        sublo[idim] = domain->boxlo[idim];
+        subhi[idim] = domain->boxhi[idim];
+      }
+    }
+  }
+
   // xptr = which word in line starts xyz coords
   // iptr = which word in line starts ix,iy,iz image flags
 
@@ -1135,11 +1163,14 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
   // tokenize the line into values
   // extract xyz coords and image flags
   // remap atom into simulation box
-  // if atom is in my sub-domain, unpack its values
+  // if atom is in my sub-domain (or in the box if keepall), unpack its values
 
   for (int i = 0; i < n; i++) {
     next = strchr(buf,'\n');
-    if (!next) error->all(FLERR, "Missing data in {}", location);
+    if (!next) {
+      if (keepall) error->one(FLERR, "Missing data in {}", location);
+      error->all(FLERR, "Missing data in {}", location);
+    }
     *next = '\0';
     auto values = Tokenizer(buf).as_vector();
     int nvalues = values.size();
@@ -1147,6 +1178,7 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
       // skip over empty or comment lines
     } else if ((nvalues < nwords) ||
                ((nvalues > nwords) && (!utils::strmatch(values[nwords],"^#")))) {
+      if (keepall) error->one(FLERR, "Incorrect format in {}: {}", location, utils::trim(buf));
       error->all(FLERR, "Incorrect format in {}: {}", location, utils::trim(buf));
     } else {
       int imx = 0, imy = 0, imz = 0;
@@ -1154,8 +1186,10 @@ void Atom::data_atoms(int n, char *buf, tagint id_offset, tagint mol_offset,
         imx = utils::inumeric(FLERR,values[iptr],false,lmp);
         imy = utils::inumeric(FLERR,values[iptr+1],false,lmp);
         imz = utils::inumeric(FLERR,values[iptr+2],false,lmp);
-        if ((domain->dimension == 2) && (imz != 0))
+        if ((domain->dimension == 2) && (imz != 0)) {
+          if (keepall) error->one(FLERR,"Z-direction image flag must be 0 for 2d-systems");
           error->all(FLERR,"Z-direction image flag must be 0 for 2d-systems");
+        }
         if ((!domain->xperiodic) && (imx != 0)) { reset_image_flag[0] = true; imx = 0; }
         if ((!domain->yperiodic) && (imy != 0)) { reset_image_flag[1] = true; imy = 0; }
         if ((!domain->zperiodic) && (imz != 0)) { reset_image_flag[2] = true; imz = 0; }
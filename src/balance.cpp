@@ -31,6 +31,7 @@
 #include "imbalance.h"
 #include "imbalance_group.h"
 #include "imbalance_neigh.h"
+#include "imbalance_pair.h"
 #include "imbalance_store.h"
 #include "imbalance_time.h"
 #include "imbalance_var.h"
@@ -43,10 +44,12 @@
 
 #include <cmath>
 #include <cstring>
+#include <vector>
 
 using namespace LAMMPS_NS;
 
 double EPSNEIGH = 1.0e-3;
+static constexpr double MINFRAC = 1.0e-3;    // min extent of child partition in incremental RCB
 
 enum{XYZ,SHIFT,BISECTION};
 enum{NONE,UNIFORM,USER};
@@ -64,6 +67,10 @@ Balance::Balance(LAMMPS *lmp) : Command(lmp)
   proccost = allproccost = nullptr;
 
   rcb = nullptr;
+  incflag = 0;
+  incfrac = 0.0;
+  maxincsend = 0;
+  incsendproc = nullptr;
 
   nimbalance = 0;
   imbalances = nullptr;
@@ -97,6 +104,7 @@ Balance::~Balance()
   }
 
   delete rcb;
+  memory->destroy(incsendproc);
 
   for (int i = 0; i < nimbalance; i++) delete imbalances[i];
   delete[] imbalances;
@@ -253,6 +261,8 @@ void Balance::command(int narg, char **arg)
   // process remaining optional args
 
   options(iarg,narg,arg,1);
+  if (incflag && style != BISECTION)
+    error->all(FLERR,"Balance incremental keyword requires style rcb");
   if (wtflag) weight_storage(nullptr);
 
   // ensure particles are in current box & update box via shrink-wrap
@@ -342,9 +352,12 @@ void Balance::command(int narg, char **arg)
 
   // style BISECTION = recursive coordinate bisectioning
 
+  // layout is set afterwards, so bisection() can check for existing RCB cuts
+
+  int *sendproc = nullptr;
   if (style == BISECTION) {
+    sendproc = bisection();
     comm->layout = Comm::LAYOUT_TILED;
-    bisection();
   }
 
   // reset proc sub-domains
@@ -359,7 +372,7 @@ void Balance::command(int narg, char **arg)
   if (domain->triclinic) domain->x2lamda(atom->nlocal);
   auto irregular = new Irregular(lmp);
   if (wtflag) fixstore->disable = 0;
-  if (style == BISECTION) irregular->migrate_atoms(sortflag,1,rcb->sendproc);
+  if (style == BISECTION) irregular->migrate_atoms(sortflag,1,sendproc);
   else irregular->migrate_atoms(sortflag);
   delete irregular;
   if (domain->triclinic) domain->lamda2x(atom->nlocal);
@@ -441,6 +454,7 @@ void Balance::options(int iarg, int narg, char **arg, int sortflag_default)
   int outarg = 0;
   fp = nullptr;
   oldrcb = 0;
+  incflag = 0;
 
   while (iarg < narg) {
     if (strcmp(arg[iarg],"weight") == 0) {
@@ -459,6 +473,10 @@ void Balance::options(int iarg, int narg, char **arg, int sortflag_default)
         imb = new ImbalanceNeigh(lmp);
         nopt = imb->options(narg-iarg,arg+iarg+2);
         imbalances[nimbalance++] = imb;
+      } else if (strcmp(arg[iarg+1],"pair") == 0) {
+        imb = new ImbalancePair(lmp);
+        nopt = imb->options(narg-iarg,arg+iarg+2);
+        imbalances[nimbalance++] = imb;
       } else if (strcmp(arg[iarg+1],"var") == 0) {
         varflag = 1;
         imb = new ImbalanceVar(lmp);
@@ -487,6 +505,14 @@ void Balance::options(int iarg, int narg, char **arg, int sortflag_default)
       oldrcb = 1;
       iarg++;
 
+    } else if (strcmp(arg[iarg],"incremental") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "(fix) balance incremental", error);
+      incfrac = utils::numeric(FLERR,arg[iarg+1],false,lmp);
+      if (incfrac <= 0.0 || incfrac > 0.5)
+        error->all(FLERR,"Illegal (fix) balance incremental value: {}", incfrac);
+      incflag = 1;
+      iarg += 2;
+
     } else error->all(FLERR,"Illegal (fix) balance command");
   }
 
@@ -582,6 +608,13 @@ double Balance::imbalance_factor(double &maxcost)
 
 int *Balance::bisection()
 {
+  // adjust existing RCB cuts if requested and possible
+
+  if (incflag && comm->layout == Comm::LAYOUT_TILED) {
+    int *list = bisection_incremental();
+    if (list) return list;
+  }
+
   if (!rcb) rcb = new RCB(lmp);
 
   int dim = domain->dimension;
@@ -713,6 +746,235 @@ int *Balance::bisection()
   return rcb->sendproc;
 }
 
+/* ----------------------------------------------------------------------
+   perform balancing by adjusting the cuts of the current RCB decomposition
+   cuts are shifted top-down, one level of the RCB tree at a time,
+     by a first-order estimate from the weight of atoms close to the cut
+   a cut moves by at most incfrac times the extent of its partition,
+     so only atoms within that distance of a cut change their owner
+   return list of procs to send my atoms to
+   return nullptr if current cuts do not form a valid RCB tree
+------------------------------------------------------------------------- */
+
+int *Balance::bisection_incremental()
+{
+  int dimension = domain->dimension;
+  int triclinic = domain->triclinic;
+
+  double *boxlo,*prd;
+
+  if (triclinic == 0) {
+    boxlo = domain->boxlo;
+    prd = domain->prd;
+  } else {
+    boxlo = domain->boxlo_lamda;
+    prd = domain->prd_lamda;
+  }
+
+  // gather current cuts from all procs
+  // cut owned by proc M splits the partition in which M is the 1st upper proc
+
+  double mycut[2],*allcut;
+  mycut[0] = comm->rcbcutfrac;
+  mycut[1] = comm->rcbcutdim;
+  memory->create(allcut,2*nprocs,"balance:allcut");
+  MPI_Allgather(mycut,2,MPI_DOUBLE,allcut,2,MPI_DOUBLE,world);
+
+  // nodes of RCB tree = partitions with more than one proc, indexed by procmid
+  // lo/hi = fractional bounds of partition
+  // check that current cuts form a valid tree, e.g. not after a restart
+
+  struct Node {
+    int plo, phi, dim;
+    double cut, lo[3], hi[3];
+  };
+
+  std::vector<Node> node(nprocs);
+  std::vector<int> current,next;
+  double mylo[3] = {0.0, 0.0, 0.0};
+  double myhi[3] = {1.0, 1.0, 1.0};
+
+  int valid = 1;
+  if (nprocs > 1) {
+    Node root;
+    root.plo = 0;
+    root.phi = nprocs - 1;
+    for (int d = 0; d < 3; d++) {
+      root.lo[d] = 0.0;
+      root.hi[d] = 1.0;
+    }
+    std::vector<Node> stack(1,root);
+    while (!stack.empty()) {
+      Node one = stack.back();
+      stack.pop_back();
+      int procmid = one.plo + (one.phi - one.plo) / 2 + 1;
+      one.dim = static_cast<int>(allcut[2*procmid+1]);
+      one.cut = allcut[2*procmid];
+      if (one.dim < 0 || one.dim >= dimension ||
+          one.cut <= one.lo[one.dim] || one.cut >= one.hi[one.dim]) {
+        valid = 0;
+        break;
+      }
+      node[procmid] = one;
+      if (procmid-1 > one.plo) {
+        Node lower = one;
+        lower.phi = procmid - 1;
+        lower.hi[one.dim] = one.cut;
+        stack.push_back(lower);
+      }
+      if (one.phi > procmid) {
+        Node upper = one;
+        upper.plo = procmid;
+        upper.lo[one.dim] = one.cut;
+        stack.push_back(upper);
+      }
+    }
+    current.push_back((nprocs-1) / 2 + 1);
+  }
+
+  memory->destroy(allcut);
+  if (!valid) return nullptr;
+
+  // per-atom partition while descending the tree
+  // initially all atoms are in the root partition
+
+  double **x = atom->x;
+  int nlocal = atom->nlocal;
+
+  if (nlocal > maxincsend) {
+    maxincsend = atom->nmax;
+    memory->destroy(incsendproc);
+    memory->create(incsendproc,maxincsend,"balance:incsendproc");
+  }
+
+  std::vector<int> aplo(nlocal,0),aphi(nlocal,nprocs-1);
+  std::vector<int> index(nprocs);
+  std::vector<double> wlocal,wall;
+
+  if (wtflag) weight = fixstore->vstore;
+  if (triclinic) domain->x2lamda(nlocal);
+
+  while (!current.empty()) {
+    int n = current.size();
+    for (int k = 0; k < n; k++) index[current[k]] = k;
+
+    // weight below and above each cut of this level and within incfrac of it
+
+    wlocal.assign(3*n,0.0);
+    wall.resize(3*n);
+
+    for (int i = 0; i < nlocal; i++) {
+      if (aplo[i] == aphi[i]) continue;
+      int procmid = aplo[i] + (aphi[i] - aplo[i]) / 2 + 1;
+      const Node &one = node[procmid];
+      int k = index[procmid];
+      int d = one.dim;
+      double s = (x[i][d] - boxlo[d]) / prd[d];
+      double w = wtflag ? weight[i] : 1.0;
+      if (s < one.cut) wlocal[3*k] += w;
+      else wlocal[3*k+1] += w;
+      if (fabs(s - one.cut) < incfrac * (one.hi[d] - one.lo[d])) wlocal[3*k+2] += w;
+    }
+
+    MPI_Allreduce(wlocal.data(),wall.data(),3*n,MPI_DOUBLE,MPI_SUM,world);
+
+    // shift each cut so the weight below it matches its share of procs
+    // slope of weight vs cut position is estimated from weight near the cut
+    // then set bounds of child partitions, keeping their cuts inside them
+
+    next.clear();
+    for (int k = 0; k < n; k++) {
+      int procmid = current[k];
+      Node &one = node[procmid];
+      int d = one.dim;
+      double delta = incfrac * (one.hi[d] - one.lo[d]);
+      double wlo = wall[3*k];
+      double wtotal = wall[3*k] + wall[3*k+1];
+      double wnear = wall[3*k+2];
+
+      if (wtotal > 0.0) {
+        double target = wtotal * (procmid - one.plo) / (one.phi + 1 - one.plo);
+        double shift = 0.0;
+        if (wnear > 0.0) shift = (target - wlo) * 2.0 * delta / wnear;
+        else if (wlo > target) shift = -delta;
+        else if (wlo < target) shift = delta;
+        one.cut += MAX(-delta,MIN(delta,shift));
+      }
+      double small = MINFRAC * (one.hi[d] - one.lo[d]);
+      one.cut = MAX(one.lo[d]+small,MIN(one.hi[d]-small,one.cut));
+
+      for (int side = 0; side < 2; side++) {
+        int plo = side ? procmid : one.plo;
+        int phi = side ? one.phi : procmid-1;
+        double lo[3],hi[3];
+        for (int m = 0; m < 3; m++) {
+          lo[m] = one.lo[m];
+          hi[m] = one.hi[m];
+        }
+        if (side) lo[d] = one.cut;
+        else hi[d] = one.cut;
+
+        if (plo == phi) {
+          if (plo == me) {
+            for (int m = 0; m < 3; m++) {
+              mylo[m] = lo[m];
+              myhi[m] = hi[m];
+            }
+          }
+          continue;
+        }
+
+        int childmid = plo + (phi - plo) / 2 + 1;
+        Node &child = node[childmid];
+        for (int m = 0; m < 3; m++) {
+          child.lo[m] = lo[m];
+          child.hi[m] = hi[m];
+        }
+        int cd = child.dim;
+        small = MINFRAC * (hi[cd] - lo[cd]);
+        child.cut = MAX(lo[cd]+small,MIN(hi[cd]-small,child.cut));
+        next.push_back(childmid);
+      }
+    }
+
+    // move atoms into child partitions on either side of the new cuts
+
+    for (int i = 0; i < nlocal; i++) {
+      if (aplo[i] == aphi[i]) continue;
+      int procmid = aplo[i] + (aphi[i] - aplo[i]) / 2 + 1;
+      const Node &one = node[procmid];
+      int d = one.dim;
+      if ((x[i][d] - boxlo[d]) / prd[d] < one.cut) aphi[i] = procmid - 1;
+      else aplo[i] = procmid;
+    }
+
+    current.swap(next);
+  }
+
+  if (triclinic) domain->lamda2x(nlocal);
+
+  for (int i = 0; i < nlocal; i++) incsendproc[i] = aplo[i];
+
+  // store new cut and sub-domain in Comm, same as for bisection()
+
+  comm->rcbnew = 1;
+  if (me > 0) {
+    comm->rcbcutfrac = node[me].cut;
+    comm->rcbcutdim = node[me].dim;
+  } else {
+    comm->rcbcutfrac = 0.0;
+    comm->rcbcutdim = -1;
+  }
+
+  double (*mysplit)[2] = comm->mysplit;
+  for (int m = 0; m < 3; m++) {
+    mysplit[m][0] = mylo[m];
+    mysplit[m][1] = myhi[m];
+  }
+
+  return incsendproc;
+}
+
 /* ----------------------------------------------------------------------
    setup static load balance operations
    called from command and indirectly initially from fix balance
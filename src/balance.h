@@ -32,6 +32,7 @@ class Balance : public Command {
   int varflag;                     // 1 if weight style var(iable) is used
   int sortflag;                    // 1 if sorting of comm messages is done
   int outflag;                     // 1 for output of balance results to file
+  int incflag;                     // 1 if RCB cuts are adjusted incrementally
 
   Balance(class LAMMPS *);
   ~Balance() override;
@@ -56,6 +57,9 @@ class Balance : public Command {
   int xflag, yflag, zflag;                            // xyz LB flags
   double *user_xsplit, *user_ysplit, *user_zsplit;    // params for xyz LB
   int oldrcb;                                         // use old-style RCB compute
+  double incfrac;                                     // max shift of cut for incremental RCB
+  int maxincsend;                                     // allocated size of incsendproc
+  int *incsendproc;                                   // procs to send atoms to for incremental RCB
 
   int nitermax;    // params for shift LB
   double stopthresh;
@@ -87,6 +91,7 @@ class Balance : public Command {
   void shift_setup_static(char *);
   void tally(int, int, double *);
   int adjust(int, double *);
+  int *bisection_incremental();
 #ifdef BALANCE_DEBUG
   void debug_shift_output(int, int, int, double *);
 #endif
@@ -14,6 +14,8 @@
 
 #include "comm.h"
 
+#include "comm_shm.h"
+
 #include "accelerator_kokkos.h"
 #include "atom.h"               // IWYU pragma: keep
 #include "atom_vec.h"
@@ -62,6 +64,8 @@ Comm::Comm(LAMMPS *lmp) : Pointers(lmp)
   ncollections = 0;
   ncollections_cutoff = 0;
   ghost_velocity = 0;
+  overlap = 0;
+  shmem = 0;
 
   user_procgrid[0] = user_procgrid[1] = user_procgrid[2] = 0;
   coregrid[0] = coregrid[1] = coregrid[2] = 1;
@@ -392,6 +396,16 @@ void Comm::modify_params(int narg, char **arg)
       if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "comm_modify vel", error);
       ghost_velocity = utils::logical(FLERR,arg[iarg+1],false,lmp);
       iarg += 2;
+    } else if (strcmp(arg[iarg],"overlap") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "comm_modify overlap", error);
+      overlap = utils::logical(FLERR,arg[iarg+1],false,lmp);
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"shmem") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "comm_modify shmem", error);
+      shmem = utils::logical(FLERR,arg[iarg+1],false,lmp);
+      if (shmem && !CommShm::available())
+        error->all(FLERR,"Comm_modify shmem requires an MPI library with shared memory windows");
+      iarg += 2;
     } else error->all(FLERR,"Unknown comm_modify keyword: {}", arg[iarg]);
   }
 }
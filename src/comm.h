@@ -35,6 +35,8 @@ class Comm : protected Pointers {
 
   int me, nprocs;               // proc info
   int ghost_velocity;           // 1 if ghost atoms have velocity, 0 if not
+  int overlap;                  // 1 if forward comm may overlap with pair compute
+  int shmem;                    // 1 if procs on same node exchange via shared memory
   double cutghost[3];           // cutoffs used for acquiring ghost atoms
   double cutghostuser;          // user-specified ghost cutoff (mode == SINGLE)
   double *cutusermulti;         // per collection user ghost cutoff (mode == MULTI)
@@ -85,6 +87,12 @@ class Comm : protected Pointers {
   virtual void exchange() = 0;                     // move atoms to new procs
   virtual void borders() = 0;                      // setup list of atoms to comm
 
+  // forward comm of atom coords split in two phases
+  // default is to complete the comm in the start phase
+
+  virtual void forward_comm_start() { forward_comm(); }
+  virtual void forward_comm_finish() {}
+
   // forward/reverse comm from a Pair, Bond, Fix, Compute, Dump
 
   virtual void forward_comm(class Pair *) = 0;
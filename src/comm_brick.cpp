@@ -21,6 +21,7 @@
 #include "atom.h"
 #include "atom_vec.h"
 #include "bond.h"
+#include "comm_shm.h"
 #include "compute.h"
 #include "domain.h"
 #include "dump.h"
@@ -43,12 +44,13 @@ using namespace LAMMPS_NS;
 
 CommBrick::CommBrick(LAMMPS *lmp) :
   Comm(lmp),
-  sendnum(nullptr), recvnum(nullptr), sendproc(nullptr), recvproc(nullptr),
+  sendnum(nullptr), recvnum(nullptr), sendnum_local(nullptr), recvnum_local(nullptr), sendproc(nullptr), recvproc(nullptr),
   size_forward_recv(nullptr), size_reverse_send(nullptr), size_reverse_recv(nullptr),
   slablo(nullptr), slabhi(nullptr), multilo(nullptr), multihi(nullptr),
   multioldlo(nullptr), multioldhi(nullptr), cutghostmulti(nullptr), cutghostmultiold(nullptr),
   pbc_flag(nullptr), pbc(nullptr), firstrecv(nullptr), sendlist(nullptr),
-  localsendlist(nullptr), maxsendlist(nullptr), buf_send(nullptr), buf_recv(nullptr)
+  localsendlist(nullptr), maxsendlist(nullptr), buf_send(nullptr), buf_recv(nullptr),
+  buf_overlap(nullptr), requests(nullptr), shm(nullptr)
 {
   style = Comm::BRICK;
   layout = Comm::LAYOUT_UNIFORM;
@@ -78,6 +80,8 @@ CommBrick::~CommBrick()
 
   memory->destroy(buf_send);
   memory->destroy(buf_recv);
+  memory->destroy(buf_overlap);
+  delete shm;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -115,6 +119,12 @@ void CommBrick::init_buffers()
   CommBrick::grow_send(maxsend,2);
   memory->create(buf_recv,maxrecv,"comm:buf_recv");
 
+  buf_overlap = nullptr;
+  maxoverlap = 0;
+  nrequest = 0;
+  overlap_active = 0;
+  shm = nullptr;
+
   nswap = 0;
   maxswap = 6;
   CommBrick::allocate_swap(maxswap);
@@ -549,7 +559,10 @@ void CommBrick::forward_comm(int /*dummy*/)
 
   for (int iswap = 0; iswap < nswap; iswap++) {
     if (sendproc[iswap] != me) {
-      if (comm_x_only) {
+      if (shm && (shm->send_onnode(iswap,CommShm::FORWARD) ||
+                  shm->recv_onnode(iswap,CommShm::FORWARD))) {
+        forward_swap_shm(iswap);
+      } else if (comm_x_only) {
         if (size_forward_recv[iswap]) {
           buf = x[firstrecv[iswap]];
           MPI_Irecv(buf,size_forward_recv[iswap],MPI_DOUBLE,recvproc[iswap],0,world,&request);
@@ -590,6 +603,98 @@ void CommBrick::forward_comm(int /*dummy*/)
   }
 }
 
+/* ----------------------------------------------------------------------
+   start forward communication of atom coords
+   send coords of owned atoms in all swaps with non-blocking messages
+   coords of ghost atoms that are passed on are sent by forward_comm_finish()
+   caller may only access owned atoms until forward_comm_finish() is called
+   requires comm_x_only, else do the complete comm here
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_comm_start()
+{
+  int iswap,n,offset;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+
+  if (!overlap || !comm_x_only) {
+    forward_comm();
+    return;
+  }
+
+  n = 0;
+  for (iswap = 0; iswap < nswap; iswap++)
+    if (sendproc[iswap] != me) n += sendnum_local[iswap]*size_forward;
+  if (n > maxoverlap) {
+    maxoverlap = n;
+    memory->destroy(buf_overlap);
+    memory->create(buf_overlap,maxoverlap,"comm:buf_overlap");
+  }
+
+  // post all receives first, then send owned atoms of each swap
+  // messages are tagged by swap, since several may be pending to same proc
+  // if other proc is self, just copy
+
+  nrequest = 0;
+  for (iswap = 0; iswap < nswap; iswap++)
+    if (sendproc[iswap] != me && recvnum_local[iswap])
+      MPI_Irecv(x[firstrecv[iswap]],recvnum_local[iswap]*size_forward,MPI_DOUBLE,
+                recvproc[iswap],iswap+1,world,&requests[nrequest++]);
+
+  offset = 0;
+  for (iswap = 0; iswap < nswap; iswap++) {
+    if (!sendnum_local[iswap]) continue;
+    if (sendproc[iswap] != me) {
+      n = avec->pack_comm(sendnum_local[iswap],sendlist[iswap],&buf_overlap[offset],
+                          pbc_flag[iswap],pbc[iswap]);
+      MPI_Isend(&buf_overlap[offset],n,MPI_DOUBLE,sendproc[iswap],iswap+1,world,
+                &requests[nrequest++]);
+      offset += n;
+    } else {
+      avec->pack_comm(sendnum_local[iswap],sendlist[iswap],x[firstrecv[iswap]],
+                      pbc_flag[iswap],pbc[iswap]);
+    }
+  }
+
+  overlap_active = 1;
+}
+
+/* ----------------------------------------------------------------------
+   complete forward communication started by forward_comm_start()
+   wait for owned atom coords, then pass on ghost atom coords swap by swap
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_comm_finish()
+{
+  int iswap,n,nsend,nrecv;
+  MPI_Request request;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+
+  if (!overlap_active) return;
+  overlap_active = 0;
+
+  if (nrequest) MPI_Waitall(nrequest,requests,MPI_STATUSES_IGNORE);
+  nrequest = 0;
+
+  for (iswap = 0; iswap < nswap; iswap++) {
+    nsend = sendnum[iswap] - sendnum_local[iswap];
+    nrecv = recvnum[iswap] - recvnum_local[iswap];
+    if (sendproc[iswap] != me) {
+      if (nrecv)
+        MPI_Irecv(x[firstrecv[iswap]+recvnum_local[iswap]],nrecv*size_forward,MPI_DOUBLE,
+                  recvproc[iswap],0,world,&request);
+      n = avec->pack_comm(nsend,&sendlist[iswap][sendnum_local[iswap]],buf_send,
+                          pbc_flag[iswap],pbc[iswap]);
+      if (n) MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
+      if (nrecv) MPI_Wait(&request,MPI_STATUS_IGNORE);
+    } else if (nsend) {
+      avec->pack_comm(nsend,&sendlist[iswap][sendnum_local[iswap]],
+                      x[firstrecv[iswap]+recvnum_local[iswap]],pbc_flag[iswap],pbc[iswap]);
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    reverse communication of forces on atoms every timestep
    other per-atom attributes may also be sent via pack/unpack routines
@@ -609,6 +714,11 @@ void CommBrick::reverse_comm()
 
   for (int iswap = nswap-1; iswap >= 0; iswap--) {
     if (sendproc[iswap] != me) {
+      if (shm && (shm->send_onnode(iswap,CommShm::REVERSE) ||
+                  shm->recv_onnode(iswap,CommShm::REVERSE))) {
+        reverse_swap_shm(iswap);
+        continue;
+      }
       if (comm_f_only) {
         if (size_reverse_recv[iswap])
           MPI_Irecv(buf_recv,size_reverse_recv[iswap],MPI_DOUBLE,sendproc[iswap],0,world,&request);
@@ -638,6 +748,109 @@ void CommBrick::reverse_comm()
   }
 }
 
+/* ----------------------------------------------------------------------
+   forward comm of one swap where send and/or recv proc is on my node
+   pack directly into the shared memory slot of the recv proc
+   and unpack directly from my own slot, use MPI for the other side
+------------------------------------------------------------------------- */
+
+void CommBrick::forward_swap_shm(int iswap)
+{
+  int n;
+  double *buf = buf_recv;
+  MPI_Request request;
+  AtomVec *avec = atom->avec;
+  double **x = atom->x;
+
+  const int sendshm = shm->send_onnode(iswap,CommShm::FORWARD);
+  const int recvshm = shm->recv_onnode(iswap,CommShm::FORWARD);
+
+  if (!recvshm && size_forward_recv[iswap]) {
+    if (comm_x_only) buf = x[firstrecv[iswap]];
+    MPI_Irecv(buf,size_forward_recv[iswap],MPI_DOUBLE,recvproc[iswap],0,world,&request);
+  }
+
+  if (sendnum[iswap]) {
+    double *sbuf = sendshm ? shm->acquire_send(iswap,CommShm::FORWARD) : buf_send;
+    if (ghost_velocity)
+      n = avec->pack_comm_vel(sendnum[iswap],sendlist[iswap],sbuf,pbc_flag[iswap],pbc[iswap]);
+    else
+      n = avec->pack_comm(sendnum[iswap],sendlist[iswap],sbuf,pbc_flag[iswap],pbc[iswap]);
+    if (sendshm) shm->release_send(iswap,CommShm::FORWARD);
+    else MPI_Send(buf_send,n,MPI_DOUBLE,sendproc[iswap],0,world);
+  }
+
+  if (size_forward_recv[iswap]) {
+    if (recvshm) buf = shm->acquire_recv(iswap,CommShm::FORWARD);
+    else MPI_Wait(&request,MPI_STATUS_IGNORE);
+
+    if (comm_x_only) {
+      if (recvshm) memcpy(x[firstrecv[iswap]],buf,size_forward_recv[iswap]*sizeof(double));
+    } else if (ghost_velocity) {
+      avec->unpack_comm_vel(recvnum[iswap],firstrecv[iswap],buf);
+    } else {
+      avec->unpack_comm(recvnum[iswap],firstrecv[iswap],buf);
+    }
+    if (recvshm) shm->release_recv(iswap,CommShm::FORWARD);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   reverse comm of one swap where send and/or recv proc is on my node
+------------------------------------------------------------------------- */
+
+void CommBrick::reverse_swap_shm(int iswap)
+{
+  double *buf = buf_recv;
+  MPI_Request request;
+  AtomVec *avec = atom->avec;
+  double **f = atom->f;
+
+  const int sendshm = shm->send_onnode(iswap,CommShm::REVERSE);
+  const int recvshm = shm->recv_onnode(iswap,CommShm::REVERSE);
+
+  if (!recvshm && size_reverse_recv[iswap])
+    MPI_Irecv(buf_recv,size_reverse_recv[iswap],MPI_DOUBLE,sendproc[iswap],0,world,&request);
+
+  if (recvnum[iswap]) {
+    if (sendshm) {
+      double *sbuf = shm->acquire_send(iswap,CommShm::REVERSE);
+      if (comm_f_only) memcpy(sbuf,f[firstrecv[iswap]],size_reverse_send[iswap]*sizeof(double));
+      else avec->pack_reverse(recvnum[iswap],firstrecv[iswap],sbuf);
+      shm->release_send(iswap,CommShm::REVERSE);
+    } else if (comm_f_only) {
+      MPI_Send(f[firstrecv[iswap]],size_reverse_send[iswap],MPI_DOUBLE,recvproc[iswap],0,world);
+    } else {
+      int n = avec->pack_reverse(recvnum[iswap],firstrecv[iswap],buf_send);
+      MPI_Send(buf_send,n,MPI_DOUBLE,recvproc[iswap],0,world);
+    }
+  }
+
+  if (size_reverse_recv[iswap]) {
+    if (recvshm) buf = shm->acquire_recv(iswap,CommShm::REVERSE);
+    else MPI_Wait(&request,MPI_STATUS_IGNORE);
+    avec->unpack_reverse(sendnum[iswap],sendlist[iswap],buf);
+    if (recvshm) shm->release_recv(iswap,CommShm::REVERSE);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   (re)assign shared memory slots after the swap pattern has changed
+   slots must hold the largest forward or reverse message I send
+------------------------------------------------------------------------- */
+
+void CommBrick::setup_shm()
+{
+  if (!shm) shm = new CommShm(lmp);
+
+  bigint need = 0;
+  for (int iswap = 0; iswap < nswap; iswap++) {
+    need = MAX(need,(bigint) size_forward*sendnum[iswap]);
+    need = MAX(need,(bigint) size_reverse*recvnum[iswap]);
+  }
+  shm->setup(nswap,sendproc,recvproc,need);
+}
+
 /* ----------------------------------------------------------------------
    exchange: move atoms to correct processors
    atoms exchanged with all 6 stencil neighbors
@@ -772,6 +985,7 @@ void CommBrick::borders()
 {
   int i,n,itype,icollection,iswap,dim,ineed,twoneed;
   int nsend,nrecv,sendflag,nfirst,nlast,ngroup,nprior;
+  int nsend_local,nrecv_local,sendcount[2],recvcount[2];
   double lo,hi;
   int *type;
   int *collection;
@@ -906,6 +1120,12 @@ void CommBrick::borders()
         }
       }
 
+      // owned atoms are always added to sendlist before ghost atoms
+      // count them, so forward_comm_start() can send them separately
+
+      nsend_local = 0;
+      while (nsend_local < nsend && sendlist[iswap][nsend_local] < atom->nlocal) nsend_local++;
+
       // pack up list of border atoms
 
       if (nsend*size_border > maxsend) grow_send(nsend*size_border,0);
@@ -920,8 +1140,12 @@ void CommBrick::borders()
       // if swapping with self, simply copy, no messages
 
       if (sendproc[iswap] != me) {
-        MPI_Sendrecv(&nsend,1,MPI_INT,sendproc[iswap],0,
-                     &nrecv,1,MPI_INT,recvproc[iswap],0,world,MPI_STATUS_IGNORE);
+        sendcount[0] = nsend;
+        sendcount[1] = nsend_local;
+        MPI_Sendrecv(sendcount,2,MPI_INT,sendproc[iswap],0,
+                     recvcount,2,MPI_INT,recvproc[iswap],0,world,MPI_STATUS_IGNORE);
+        nrecv = recvcount[0];
+        nrecv_local = recvcount[1];
         if (nrecv*size_border > maxrecv) grow_recv(nrecv*size_border);
         if (nrecv) MPI_Irecv(buf_recv,nrecv*size_border,MPI_DOUBLE,
                              recvproc[iswap],0,world,&request);
@@ -930,6 +1154,7 @@ void CommBrick::borders()
         buf = buf_recv;
       } else {
         nrecv = nsend;
+        nrecv_local = nsend_local;
         buf = buf_send;
       }
 
@@ -946,6 +1171,8 @@ void CommBrick::borders()
       rmax = MAX(rmax,nrecv);
       sendnum[iswap] = nsend;
       recvnum[iswap] = nrecv;
+      sendnum_local[iswap] = nsend_local;
+      recvnum_local[iswap] = nrecv_local;
       size_forward_recv[iswap] = nrecv*size_forward;
       size_reverse_send[iswap] = nrecv*size_reverse;
       size_reverse_recv[iswap] = nsend*size_reverse;
@@ -973,6 +1200,14 @@ void CommBrick::borders()
   max = MAX(maxforward*rmax,maxreverse*smax);
   if (max > maxrecv) grow_recv(max);
 
+  // update shared memory slots for swaps with procs on the same node
+
+  if (shmem) setup_shm();
+  else if (shm) {
+    delete shm;
+    shm = nullptr;
+  }
+
   // reset global->local map
 
   if (map_style != Atom::MAP_NONE) atom->map_set();
@@ -1535,6 +1770,9 @@ void CommBrick::allocate_swap(int n)
 {
   memory->create(sendnum,n,"comm:sendnum");
   memory->create(recvnum,n,"comm:recvnum");
+  memory->create(sendnum_local,n,"comm:sendnum_local");
+  memory->create(recvnum_local,n,"comm:recvnum_local");
+  requests = new MPI_Request[2*n];
   memory->create(sendproc,n,"comm:sendproc");
   memory->create(recvproc,n,"comm:recvproc");
   memory->create(size_forward_recv,n,"comm:size");
@@ -1576,6 +1814,10 @@ void CommBrick::free_swap()
 {
   memory->destroy(sendnum);
   memory->destroy(recvnum);
+  memory->destroy(sendnum_local);
+  memory->destroy(recvnum_local);
+  delete[] requests;
+  requests = nullptr;
   memory->destroy(sendproc);
   memory->destroy(recvproc);
   memory->destroy(size_forward_recv);
@@ -1651,5 +1893,7 @@ double CommBrick::memory_usage()
     bytes += memory->usage(sendlist[i],maxsendlist[i]);
   bytes += memory->usage(buf_send,maxsend+bufextra);
   bytes += memory->usage(buf_recv,maxrecv);
+  bytes += memory->usage(buf_overlap,maxoverlap);
+  if (shm) bytes += shm->memory_usage();
   return bytes;
 }
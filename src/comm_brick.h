@@ -31,6 +31,8 @@ class CommBrick : public Comm {
   void reverse_comm() override;                 // reverse comm of forces
   void exchange() override;                     // move atoms to new procs
   void borders() override;                      // setup list of atoms to comm
+  void forward_comm_start() override;           // post comm of owned atom coords
+  void forward_comm_finish() override;          // complete comm of atom coords
 
   void forward_comm(class Pair *) override;                 // forward comm from a Pair
   void reverse_comm(class Pair *) override;                 // reverse comm from a Pair
@@ -55,6 +57,7 @@ class CommBrick : public Comm {
   int maxneed[3];                       // max procs away any proc needs, per dim
   int maxswap;                          // max # of swaps memory is allocated for
   int *sendnum, *recvnum;               // # of atoms to send/recv in each swap
+  int *sendnum_local, *recvnum_local;   // # of those atoms that are owned by the sender
   int *sendproc, *recvproc;             // proc to send/recv to/from at each swap
   int *size_forward_recv;               // # of values to recv in each forward comm
   int *size_reverse_send;               // # to send in each reverse comm
@@ -77,9 +80,21 @@ class CommBrick : public Comm {
   int maxsend, maxrecv;    // current size of send/recv buffer
   int smax, rmax;          // max size in atoms of single borders send/recv
 
+  double *buf_overlap;        // send buffer for overlapped forward comm of owned atoms
+  int maxoverlap;             // current size of overlap send buffer
+  MPI_Request *requests;      // pending requests of overlapped forward comm
+  int nrequest;               // # of pending requests
+  int overlap_active;         // 1 if forward_comm_start() left comm pending
+
+  class CommShm *shm;         // exchange with procs on same node via shared memory
+
   // NOTE: init_buffers is called from a constructor and must not be made virtual
   void init_buffers();
 
+  void setup_shm();
+  void forward_swap_shm(int);
+  void reverse_swap_shm(int);
+
   int updown(int, int, int, double, int, double *);
   // compare cutoff to procs
   virtual void grow_send(int, int);       // reallocate send buffer
@@ -0,0 +1,275 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "comm_shm.h"
+
+#include "comm.h"
+#include "error.h"
+#include "memory.h"
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace LAMMPS_NS;
+
+static constexpr double BUFFACTOR = 1.5;
+static constexpr int HEADER = 128;    // two counters, each on its own cache line
+static constexpr int NSPIN = 1000;    // busy wait iterations before yielding the CPU
+
+using counter_t = std::atomic<bigint>;
+
+static inline counter_t *ready_counter(char *slot)
+{
+  return reinterpret_cast<counter_t *>(slot);
+}
+static inline counter_t *done_counter(char *slot)
+{
+  return reinterpret_cast<counter_t *>(slot + HEADER / 2);
+}
+
+/* ---------------------------------------------------------------------- */
+
+CommShm::CommShm(LAMMPS *lmp) :
+    Pointers(lmp), nswap(0), maxslot(0), slotbytes(0), nonnode(0), onnode(nullptr),
+    sendslot(nullptr), recvslot(nullptr)
+{
+#if defined(LMP_COMM_SHM)
+  nodecomm = MPI_COMM_NULL;
+  worldgroup = nodegroup = MPI_GROUP_NULL;
+  base = nullptr;
+  winflag = 0;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   must be called by all procs, since freeing the window is collective
+------------------------------------------------------------------------- */
+
+CommShm::~CommShm()
+{
+#if defined(LMP_COMM_SHM)
+  deallocate();
+  if (nodecomm != MPI_COMM_NULL) {
+    MPI_Group_free(&worldgroup);
+    MPI_Group_free(&nodegroup);
+    MPI_Comm_free(&nodecomm);
+  }
+#endif
+  memory->destroy(onnode);
+  memory->sfree(sendslot);
+  memory->sfree(recvslot);
+}
+
+/* ----------------------------------------------------------------------
+   return true if LAMMPS was compiled with an MPI library with shared memory windows
+------------------------------------------------------------------------- */
+
+bool CommShm::available()
+{
+#if defined(LMP_COMM_SHM)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   determine which swaps are with procs on the same node
+   and (re)allocate window if any proc on the node needs larger slots
+   n = # of swaps, sendproc/recvproc = procs for each swap
+   need = max # of doubles sent in any swap by this proc
+   must be called by all procs, after all messages of the previous
+     swap pattern have been received
+------------------------------------------------------------------------- */
+
+void CommShm::setup(int n, int *sendproc, int *recvproc, bigint need)
+{
+  memory->destroy(onnode);
+  memory->create(onnode, 2 * n, "comm/shm:onnode");
+  for (int i = 0; i < 2 * n; i++) onnode[i] = 0;
+  nonnode = 0;
+
+#if defined(LMP_COMM_SHM)
+  if (nodecomm == MPI_COMM_NULL) {
+    MPI_Comm_split_type(world, MPI_COMM_TYPE_SHARED, comm->me, MPI_INFO_NULL, &nodecomm);
+    MPI_Comm_group(world, &worldgroup);
+    MPI_Comm_group(nodecomm, &nodegroup);
+  }
+
+  // map send/recv procs of each swap to ranks in node communicator
+
+  std::vector<int> procs(2 * n), noderank(2 * n);
+  for (int i = 0; i < n; i++) {
+    procs[2 * i] = sendproc[i];
+    procs[2 * i + 1] = recvproc[i];
+  }
+  if (n) MPI_Group_translate_ranks(worldgroup, 2 * n, procs.data(), nodegroup, noderank.data());
+
+  // all procs on the node must agree on the slot layout
+
+  bigint mine[2], all[2];
+  mine[0] = n;
+  mine[1] = need;
+  MPI_Allreduce(mine, all, 2, MPI_LMP_BIGINT, MPI_MAX, nodecomm);
+  if (!winflag || (all[0] > nswap) || (all[1] > maxslot))
+    allocate((int) all[0], MAX(all[1], (bigint) (BUFFACTOR * maxslot)));
+
+  // forward comm sends to sendproc and recvs from recvproc, reverse comm vice versa
+  // slot for swap I and direction D is written by my peer and read by me
+
+  memory->sfree(sendslot);
+  memory->sfree(recvslot);
+  sendslot = (char **) memory->smalloc(sizeof(char *) * 2 * n, "comm/shm:sendslot");
+  recvslot = (char **) memory->smalloc(sizeof(char *) * 2 * n, "comm/shm:recvslot");
+
+  const int me = comm->me;
+  for (int i = 0; i < n; i++) {
+    const int sendnode = (sendproc[i] != me) && (noderank[2 * i] != MPI_UNDEFINED);
+    const int recvnode = (recvproc[i] != me) && (noderank[2 * i + 1] != MPI_UNDEFINED);
+    for (int dir = FORWARD; dir <= REVERSE; dir++) {
+      const int m = 2 * i + dir;
+      const int speer = (dir == FORWARD) ? sendnode : recvnode;
+      const int rpeer = (dir == FORWARD) ? recvnode : sendnode;
+      sendslot[m] = recvslot[m] = nullptr;
+      if (speer) {
+        onnode[m] |= 1;
+        sendslot[m] = peer_slot(noderank[(dir == FORWARD) ? 2 * i : 2 * i + 1], i, dir);
+      }
+      if (rpeer) {
+        onnode[m] |= 2;
+        recvslot[m] = base + m * slotbytes;
+      }
+      if (onnode[m]) nonnode++;
+    }
+  }
+#else
+  (void) sendproc;
+  (void) recvproc;
+  (void) need;
+  error->all(FLERR, "Communication via shared memory requires an MPI-3 library");
+#endif
+}
+
+/* ----------------------------------------------------------------------
+   wait until peer has consumed the previous message in its slot
+   return ptr to slot data that the message can be packed into
+------------------------------------------------------------------------- */
+
+double *CommShm::acquire_send(int iswap, int dir)
+{
+  char *slot = sendslot[2 * iswap + dir];
+  const bigint ready = ready_counter(slot)->load(std::memory_order_relaxed);
+  int spin = 0;
+  while (done_counter(slot)->load(std::memory_order_acquire) != ready)
+    if (++spin % NSPIN == 0) std::this_thread::yield();
+  return reinterpret_cast<double *>(slot + HEADER);
+}
+
+/* ----------------------------------------------------------------------
+   publish the message packed into the peer's slot
+------------------------------------------------------------------------- */
+
+void CommShm::release_send(int iswap, int dir)
+{
+  char *slot = sendslot[2 * iswap + dir];
+  ready_counter(slot)->fetch_add(1, std::memory_order_release);
+}
+
+/* ----------------------------------------------------------------------
+   wait until peer has written a new message into my slot
+   return ptr to slot data that the message can be unpacked from
+------------------------------------------------------------------------- */
+
+double *CommShm::acquire_recv(int iswap, int dir)
+{
+  char *slot = recvslot[2 * iswap + dir];
+  const bigint done = done_counter(slot)->load(std::memory_order_relaxed);
+  int spin = 0;
+  while (ready_counter(slot)->load(std::memory_order_acquire) == done)
+    if (++spin % NSPIN == 0) std::this_thread::yield();
+  return reinterpret_cast<double *>(slot + HEADER);
+}
+
+/* ----------------------------------------------------------------------
+   mark message in my slot as consumed, so the peer can write the next one
+------------------------------------------------------------------------- */
+
+void CommShm::release_recv(int iswap, int dir)
+{
+  char *slot = recvslot[2 * iswap + dir];
+  done_counter(slot)->fetch_add(1, std::memory_order_release);
+}
+
+/* ---------------------------------------------------------------------- */
+
+double CommShm::memory_usage()
+{
+  return (double) 2 * nswap * slotbytes + (double) 2 * nswap * (sizeof(int) + 2 * sizeof(char *));
+}
+
+#if defined(LMP_COMM_SHM)
+
+/* ----------------------------------------------------------------------
+   allocate window with 2 slots per swap of n doubles each on every proc
+   collective over all procs of the node
+------------------------------------------------------------------------- */
+
+void CommShm::allocate(int n, bigint size)
+{
+  deallocate();
+
+  nswap = n;
+  maxslot = size;
+  slotbytes = HEADER + ((maxslot * sizeof(double) + HEADER - 1) / HEADER) * HEADER;
+
+  MPI_Aint nbytes = (MPI_Aint) 2 * nswap * slotbytes;
+  int rv = MPI_Win_allocate_shared(nbytes, 1, MPI_INFO_NULL, nodecomm, &base, &win);
+  if (rv != MPI_SUCCESS) error->one(FLERR, "Could not allocate shared memory window for comm");
+  winflag = 1;
+
+  for (int m = 0; m < 2 * nswap; m++) {
+    new (ready_counter(base + m * slotbytes)) counter_t(0);
+    new (done_counter(base + m * slotbytes)) counter_t(0);
+  }
+
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+  MPI_Barrier(nodecomm);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void CommShm::deallocate()
+{
+  if (!winflag) return;
+  MPI_Win_unlock_all(win);
+  MPI_Win_free(&win);
+  base = nullptr;
+  winflag = 0;
+}
+
+/* ----------------------------------------------------------------------
+   return ptr to slot for swap iswap and direction dir in segment of node rank
+------------------------------------------------------------------------- */
+
+char *CommShm::peer_slot(int rank, int iswap, int dir)
+{
+  MPI_Aint size;
+  int disp;
+  char *ptr;
+  MPI_Win_shared_query(win, rank, &size, &disp, &ptr);
+  return ptr + (2 * iswap + dir) * slotbytes;
+}
+
+#endif
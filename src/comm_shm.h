@@ -0,0 +1,76 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_COMM_SHM_H
+#define LMP_COMM_SHM_H
+
+#include "pointers.h"
+
+#if defined(MPI_VERSION) && (MPI_VERSION > 2) && !defined(MPI_STUBS)
+#define LMP_COMM_SHM 1
+#endif
+
+namespace LAMMPS_NS {
+
+// exchange per-swap data with procs on the same node via an MPI-3 shared memory window
+// each proc owns one slot per swap and direction that its peer writes into
+// a slot header holds two counters: the writer bumps "ready" after writing,
+// the reader copies "ready" to "done" after reading, so one message can be
+// in flight per slot and the writer waits until the previous one was consumed
+
+class CommShm : protected Pointers {
+ public:
+  enum { FORWARD, REVERSE };
+
+  CommShm(class LAMMPS *);
+  ~CommShm() override;
+
+  static bool available();
+
+  void setup(int, int *, int *, bigint);
+  int send_onnode(int iswap, int dir) const { return onnode[2 * iswap + dir] & 1; }
+  int recv_onnode(int iswap, int dir) const { return onnode[2 * iswap + dir] & 2; }
+  int get_nonnode() const { return nonnode; }
+
+  double *acquire_send(int, int);
+  void release_send(int, int);
+  double *acquire_recv(int, int);
+  void release_recv(int, int);
+
+  double memory_usage();
+
+ private:
+  int nswap;             // # of swaps the slots are laid out for
+  bigint maxslot;        // # of doubles per slot
+  bigint slotbytes;      // size of one slot incl. header
+  int nonnode;           // # of swaps and directions that use shared memory
+  int *onnode;           // bit 1 = send via shared memory, bit 2 = recv via shared memory
+  char **sendslot;       // slot in peer segment that I write to, per swap and direction
+  char **recvslot;       // slot in my segment that my peer writes to, per swap and direction
+
+#if defined(LMP_COMM_SHM)
+  MPI_Comm nodecomm;      // procs sharing memory with me
+  MPI_Group worldgroup;
+  MPI_Group nodegroup;
+  MPI_Win win;            // shared memory window
+  char *base;             // my segment of the window
+  int winflag;            // 1 if window is allocated
+
+  void allocate(int, bigint);
+  void deallocate();
+  char *peer_slot(int, int, int);
+#endif
+};
+}    // namespace LAMMPS_NS
+
+#endif
@@ -117,6 +117,8 @@ void CommTiled::init()
 {
   Comm::init();
 
+  if (shmem) error->all(FLERR,"Comm_modify shmem is only supported by comm_style brick");
+
   // cannot set nswap in init_buffers() b/c
   // dimension command can be after comm_style command
 
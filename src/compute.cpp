@@ -62,6 +62,10 @@ Compute::Compute(LAMMPS *lmp, int narg, char **arg) :
   scalar_flag = vector_flag = array_flag = 0;
   peratom_flag = local_flag = pergrid_flag = 0;
   size_vector_variable = size_array_rows_variable = 0;
+  size_scalar_partial = size_vector_partial = 0;
+  batch_flag = 0;
+  batch_owner = nullptr;
+  batch_active = 0;
 
   tempflag = pressflag = peflag = 0;
   pressatomflag = peatomflag = 0;
@@ -107,6 +111,7 @@ Compute::~Compute()
 
   delete[] id;
   delete[] style;
+  delete[] batch_owner;
   memory->destroy(tlist);
 }
 
@@ -227,3 +232,47 @@ void Compute::clearstep()
 {
   ntime = 0;
 }
+
+/* ----------------------------------------------------------------------
+   make fix the only user of the array of a compute with batch_flag set
+   another fix can only take over when the previous one was deleted
+------------------------------------------------------------------------- */
+
+void Compute::batch_claim(Fix *fix)
+{
+  if (batch_owner && (strcmp(batch_owner, fix->id) == 0)) return;
+  if (batch_owner && modify->get_fix_by_id(batch_owner))
+    error->all(FLERR, "Compute {} with batch yes is already used by fix {} "
+               "and cannot be used by fix {}", id, batch_owner, fix->id);
+  delete[] batch_owner;
+  batch_owner = utils::strdup(fix->id);
+}
+
+/* ----------------------------------------------------------------------
+   call compute_array() or, if finish is set, finish_array() for the fix
+     that claimed the array of a compute with batch_flag set
+------------------------------------------------------------------------- */
+
+void Compute::batch_invoke(Fix *fix, int finish)
+{
+  if (!batch_owner || (strcmp(batch_owner, fix->id) != 0))
+    error->all(FLERR, "Fix {} has not claimed compute {} with batch yes", fix->id, id);
+
+  batch_active = 1;
+  if (finish) finish_array();
+  else compute_array();
+  batch_active = 0;
+}
+
+/* ----------------------------------------------------------------------
+   stop if the array of a batch compute is invoked other than by its owner
+   an additional sample or reduction would corrupt the average of the owner
+------------------------------------------------------------------------- */
+
+void Compute::batch_check()
+{
+  if (batch_active) return;
+  if (batch_owner)
+    error->all(FLERR, "Compute {} with batch yes can only be used by fix {}", id, batch_owner);
+  error->all(FLERR, "Compute {} with batch yes can only be used by fix ave/time in vector mode", id);
+}
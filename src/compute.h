@@ -54,6 +54,9 @@ class Compute : protected Pointers {
   int size_array_cols;             // columns in global array
   int size_vector_variable;        // 1 if vec length is unknown in advance
   int size_array_rows_variable;    // 1 if array rows is unknown in advance
+  int size_scalar_partial;         // # of partial sums for compute_scalar(), 0 if not supported
+  int size_vector_partial;         // # of partial sums for compute_vector(), 0 if not supported
+  int batch_flag;                  // 1 if compute_array() only samples until finish_array()
 
   int peratom_flag;         // 0/1 if compute_peratom() function exists
   int size_peratom_cols;    // 0 = vector, N = columns in peratom array
@@ -127,6 +130,25 @@ class Compute : protected Pointers {
   virtual void compute_pergrid() {}
   virtual void set_arrays(int) {}
 
+  // compute_scalar() and compute_vector() split into the local part that
+  // packs per-proc partial sums and the part that completes the computation
+  // from the sums across all procs, so the caller can combine reductions
+
+  virtual void pack_scalar_partial(double *) {}
+  virtual void unpack_scalar_partial(double *) {}
+  virtual void pack_vector_partial(double *) {}
+  virtual void unpack_vector_partial(double *) {}
+
+  // with batch_flag set, compute_array() only accumulates a sample on each
+  // proc and finish_array() sets the array to the average of all samples
+  // since its previous call, so there is one reduction for many samples
+  // the single fix using the array claims it in its init() and must call
+  // both through batch_invoke(), other calls are an error via batch_check()
+
+  virtual void finish_array() {}
+  void batch_claim(class Fix *);
+  void batch_invoke(class Fix *, int);
+
   virtual int pack_forward_comm(int, int *, double *, int, int *) { return 0; }
   virtual void unpack_forward_comm(int, int, double *) {}
   virtual int pack_reverse_comm(int, int, double *) { return 0; }
@@ -186,11 +208,15 @@ class Compute : protected Pointers {
   double **vbiasall;    // stored velocity bias for all atoms
   int maxbias;          // size of vbiasall array
 
+  char *batch_owner;    // ID of fix that uses the array of a batch compute
+  int batch_active;     // 1 while batch_invoke() calls compute_array() or finish_array()
+
   inline int sbmask(int j) const { return j >> SBBITS & 3; }
 
   // private methods
 
   void adjust_dof_fix();
+  void batch_check();
 };
 
 }    // namespace LAMMPS_NS
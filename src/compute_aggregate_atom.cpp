@@ -28,6 +28,7 @@
 #include "neigh_list.h"
 #include "neighbor.h"
 #include "pair.h"
+#include "union_find.h"
 #include "update.h"
 
 #include <cmath>
@@ -38,7 +39,7 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 ComputeAggregateAtom::ComputeAggregateAtom(LAMMPS *lmp, int narg, char **arg) :
-    Compute(lmp, narg, arg), aggregateID(nullptr)
+    Compute(lmp, narg, arg), aggregateID(nullptr), uf(nullptr)
 {
   if (narg != 4) error->all(FLERR, "Illegal compute aggregate/atom command");
 
@@ -54,6 +55,7 @@ ComputeAggregateAtom::ComputeAggregateAtom(LAMMPS *lmp, int narg, char **arg) :
   comm_reverse = 1;
 
   nmax = 0;
+  uf = new UnionFind();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -61,6 +63,7 @@ ComputeAggregateAtom::ComputeAggregateAtom(LAMMPS *lmp, int narg, char **arg) :
 ComputeAggregateAtom::~ComputeAggregateAtom()
 {
   memory->destroy(aggregateID);
+  delete uf;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -139,84 +142,81 @@ void ComputeAggregateAtom::compute_peratom()
   int **firstneigh = list->firstneigh;
   double **x = atom->x;
 
-  for (i = 0; i < nlocal + atom->nghost; i++)
+  int nall = nlocal + atom->nghost;
+
+  for (i = 0; i < nall; i++)
     if (mask[i] & groupbit)
       aggregateID[i] = tag[i];
     else
       aggregateID[i] = 0;
 
-  // loop until no more changes on any proc:
-  // acquire aggregateIDs of ghost atoms
-  // loop over my atoms, and check atoms bound to it
-  // if both atoms are in aggregate, assign lowest aggregateID to both
-  // then loop over my atoms, checking distance to neighbors
-  // if both atoms are in cluster, assign lowest clusterID to both
-  // iterate until no changes in my atoms
-  // then check if any proc made changes
+  // single pass over bond partners and neighbors of my atoms
+  // merge local aggregates of bonded atoms and atoms within cutoff
+  // also merge ghost atoms with my copy of same atom
 
-  commflag = 1;
+  uf->reset(nall);
 
-  int change, done, anychange;
+  for (i = nlocal; i < nall; i++) {
+    k = atom->map(tag[i]);
+    if (k >= 0) uf->unite(i, k);
+  }
 
-  while (true) {
-    comm->forward_comm(this);
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
+
+    for (j = 0; j < num_bond[i]; j++) {
+      if (bond_type[i][j] == 0) continue;
+      k = atom->map(bond_atom[i][j]);
+      if (k < 0) continue;
+      if (!(mask[k] & groupbit)) continue;
+      uf->unite(i, k);
+    }
+  }
 
-    // reverse communication when bonds are not stored on every processor
-
-    if (force->newton_bond) comm->reverse_comm(this);
-
-    change = 0;
-    while (true) {
-      done = 1;
-      for (i = 0; i < nlocal; i++) {
-        if (!(mask[i] & groupbit)) continue;
-
-        for (j = 0; j < num_bond[i]; j++) {
-          if (bond_type[i][j] == 0) continue;
-          k = atom->map(bond_atom[i][j]);
-          if (k < 0) continue;
-          if (!(mask[k] & groupbit)) continue;
-          if (aggregateID[i] == aggregateID[k]) continue;
-
-          aggregateID[i] = aggregateID[k] = MIN(aggregateID[i], aggregateID[k]);
-          done = 0;
-        }
-      }
-
-      for (int ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
-
-        const double xtmp = x[i][0];
-        const double ytmp = x[i][1];
-        const double ztmp = x[i][2];
-        int *jlist = firstneigh[i];
-        const int jnum = numneigh[i];
-
-        for (int jj = 0; jj < jnum; jj++) {
-          j = jlist[jj];
-          j &= NEIGHMASK;
-          if (!(mask[j] & groupbit)) continue;
-          if (aggregateID[i] == aggregateID[j]) continue;
-
-          const double delx = xtmp - x[j][0];
-          const double dely = ytmp - x[j][1];
-          const double delz = ztmp - x[j][2];
-          const double rsq = delx * delx + dely * dely + delz * delz;
-          if (rsq < cutsq) {
-            aggregateID[i] = aggregateID[j] = MIN(aggregateID[i], aggregateID[j]);
-            done = 0;
-          }
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
+  for (int ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    if (!(mask[i] & groupbit)) continue;
+
+    const double xtmp = x[i][0];
+    const double ytmp = x[i][1];
+    const double ztmp = x[i][2];
+    int *jlist = firstneigh[i];
+    const int jnum = numneigh[i];
+
+    for (int jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (!(mask[j] & groupbit)) continue;
+
+      const double delx = xtmp - x[j][0];
+      const double dely = ytmp - x[j][1];
+      const double delz = ztmp - x[j][2];
+      const double rsq = delx * delx + dely * dely + delz * delz;
+      if (rsq < cutsq) uf->unite(i, j);
     }
+  }
+
+  // merge aggregates across procs:
+  // assign lowest aggregateID of each local aggregate to all its atoms
+  // reverse communication when bonds are not stored on every processor
+  // stop if no proc changed the aggregateID of one of its atoms
+  // else acquire aggregateIDs of ghost atoms and repeat
+  // # of iterations scales with # of procs an aggregate spans, not its size
+
+  commflag = 1;
 
-    // stop if all procs are done
+  int change, anychange;
 
+  while (true) {
+    change = uf->assign_min(aggregateID, nlocal);
+    if (force->newton_bond) {
+      reverse_change = 0;
+      comm->reverse_comm(this);
+      change |= reverse_change;
+    }
     MPI_Allreduce(&change, &anychange, 1, MPI_INT, MPI_MAX, world);
     if (!anychange) break;
+    comm->forward_comm(this);
   }
 }
 
@@ -291,7 +291,10 @@ void ComputeAggregateAtom::unpack_reverse_comm(int n, int *list, double *buf)
 
     // only overwrite local IDs with values lower than current ones
 
-    aggregateID[j] = MIN(x, aggregateID[j]);
+    if (x < aggregateID[j]) {
+      aggregateID[j] = x;
+      reverse_change = 1;
+    }
   }
 }
 
@@ -302,5 +305,6 @@ void ComputeAggregateAtom::unpack_reverse_comm(int n, int *list, double *buf)
 double ComputeAggregateAtom::memory_usage()
 {
   double bytes = (double) nmax * sizeof(double);
+  bytes += uf->memory_usage();
   return bytes;
 }
@@ -22,6 +22,7 @@
 #include "neigh_list.h"
 #include "neighbor.h"
 #include "pair.h"
+#include "union_find.h"
 #include "update.h"
 
 #include <cmath>
@@ -32,7 +33,7 @@ using namespace LAMMPS_NS;
 /* ---------------------------------------------------------------------- */
 
 ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
-    Compute(lmp, narg, arg), clusterID(nullptr)
+    Compute(lmp, narg, arg), clusterID(nullptr), uf(nullptr)
 {
   if (narg != 4) error->all(FLERR, "Illegal compute cluster/atom command");
 
@@ -44,6 +45,7 @@ ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
   comm_forward = 1;
 
   nmax = 0;
+  uf = new UnionFind();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -51,6 +53,7 @@ ComputeClusterAtom::ComputeClusterAtom(LAMMPS *lmp, int narg, char **arg) :
 ComputeClusterAtom::~ComputeClusterAtom()
 {
   memory->destroy(clusterID);
+  delete uf;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -113,69 +116,71 @@ void ComputeClusterAtom::compute_peratom()
   firstneigh = list->firstneigh;
 
   // every atom starts in its own cluster, with clusterID = atomID
+  // includes ghost atoms, their IDs are the same as on the owning proc
 
   tagint *tag = atom->tag;
   int *mask = atom->mask;
+  int nlocal = atom->nlocal;
+  int nall = nlocal + atom->nghost;
 
-  for (ii = 0; ii < inum; ii++) {
-    i = ilist[ii];
+  for (i = 0; i < nall; i++) {
     if (mask[i] & groupbit)
       clusterID[i] = tag[i];
     else
       clusterID[i] = 0;
   }
 
-  // loop until no more changes on any proc:
-  // acquire clusterIDs of ghost atoms
-  // loop over my atoms, checking distance to neighbors
-  // if both atoms are in cluster, assign lowest clusterID to both
-  // iterate until no changes in my atoms
-  // then check if any proc made changes
+  // single pass over neighbor pairs of my atoms
+  // merge local clusters of atoms within cutoff, including ghost atoms
+  // if atom map exists, also merge ghost atoms with my copy of same atom
 
-  double **x = atom->x;
+  uf->reset(nall);
 
-  int change, done, anychange;
+  if (atom->map_style != Atom::MAP_NONE) {
+    for (i = nlocal; i < nall; i++) {
+      j = atom->map(tag[i]);
+      if (j >= 0) uf->unite(i, j);
+    }
+  }
 
-  while (true) {
-    comm->forward_comm(this);
+  double **x = atom->x;
 
-    change = 0;
-    while (true) {
-      done = 1;
-      for (ii = 0; ii < inum; ii++) {
-        i = ilist[ii];
-        if (!(mask[i] & groupbit)) continue;
-
-        xtmp = x[i][0];
-        ytmp = x[i][1];
-        ztmp = x[i][2];
-        jlist = firstneigh[i];
-        jnum = numneigh[i];
-
-        for (jj = 0; jj < jnum; jj++) {
-          j = jlist[jj];
-          j &= NEIGHMASK;
-          if (!(mask[j] & groupbit)) continue;
-          if (clusterID[i] == clusterID[j]) continue;
-
-          delx = xtmp - x[j][0];
-          dely = ytmp - x[j][1];
-          delz = ztmp - x[j][2];
-          rsq = delx * delx + dely * dely + delz * delz;
-          if (rsq < cutsq) {
-            clusterID[i] = clusterID[j] = MIN(clusterID[i], clusterID[j]);
-            done = 0;
-          }
-        }
-      }
-      if (!done) change = 1;
-      if (done) break;
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    if (!(mask[i] & groupbit)) continue;
+
+    xtmp = x[i][0];
+    ytmp = x[i][1];
+    ztmp = x[i][2];
+    jlist = firstneigh[i];
+    jnum = numneigh[i];
+
+    for (jj = 0; jj < jnum; jj++) {
+      j = jlist[jj];
+      j &= NEIGHMASK;
+      if (!(mask[j] & groupbit)) continue;
+
+      delx = xtmp - x[j][0];
+      dely = ytmp - x[j][1];
+      delz = ztmp - x[j][2];
+      rsq = delx * delx + dely * dely + delz * delz;
+      if (rsq < cutsq) uf->unite(i, j);
     }
+  }
 
-    // stop if all procs are done
+  // merge clusters across procs:
+  // assign lowest clusterID of each local cluster to all its atoms
+  // stop if no proc changed the clusterID of one of its atoms
+  // else acquire clusterIDs of ghost atoms and repeat
+  // # of iterations scales with # of procs a cluster spans, not its size
 
+  int change, anychange;
+
+  while (true) {
+    change = uf->assign_min(clusterID, nlocal);
     MPI_Allreduce(&change, &anychange, 1, MPI_INT, MPI_MAX, world);
     if (!anychange) break;
+    comm->forward_comm(this);
   }
 }
 
@@ -213,5 +218,6 @@ void ComputeClusterAtom::unpack_forward_comm(int n, int first, double *buf)
 double ComputeClusterAtom::memory_usage()
 {
   double bytes = (double) nmax * sizeof(double);
+  bytes += uf->memory_usage();
   return bytes;
 }
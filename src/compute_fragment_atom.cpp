@@ -25,14 +25,13 @@
 #include "group.h"
 #include "memory.h"
 #include "modify.h"
+#include "union_find.h"
 #include "update.h"
 
 #include <cstring>
 
 using namespace LAMMPS_NS;
 
-#define BIG 1.0e20
-
 /* ---------------------------------------------------------------------- */
 
 ComputeFragmentAtom::ComputeFragmentAtom(LAMMPS *lmp, int narg, char **arg) :
@@ -60,19 +59,15 @@ ComputeFragmentAtom::ComputeFragmentAtom(LAMMPS *lmp, int narg, char **arg) :
   }
 
   nmax = 0;
-  stack = nullptr;
-  clist = nullptr;
-  markflag = nullptr;
+  uf = new UnionFind();
 }
 
 /* ---------------------------------------------------------------------- */
 
 ComputeFragmentAtom::~ComputeFragmentAtom()
 {
-  memory->destroy(stack);
-  memory->destroy(clist);
-  memory->destroy(markflag);
   memory->destroy(fragmentID);
+  delete uf;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -93,23 +88,15 @@ void ComputeFragmentAtom::init()
 void ComputeFragmentAtom::compute_peratom()
 {
   int i,j,k,m,n;
-  int nstack,ncluster,done,alldone;
-  double newID,cID;
   tagint *list;
 
   invoked_peratom = update->ntimestep;
 
-  // grow work and fragmentID vectors if necessary
+  // grow fragmentID vector if necessary
 
   if (atom->nmax > nmax) {
-    memory->destroy(stack);
-    memory->destroy(clist);
-    memory->destroy(markflag);
     memory->destroy(fragmentID);
     nmax = atom->nmax;
-    memory->create(stack,nmax,"fragment/atom:stack");
-    memory->create(clist,nmax,"fragment/atom:clist");
-    memory->create(markflag,nmax,"fragment/atom:markflag");
     memory->create(fragmentID,nmax,"fragment/atom:fragmentID");
     vector_atom = fragmentID;
   }
@@ -123,6 +110,7 @@ void ComputeFragmentAtom::compute_peratom()
 
   // owned + ghost atoms start with fragmentID = atomID
   // atoms not in group have fragmentID = 0
+  // if singleflag = 0 atoms without bonds are assigned fragmentID = 0
 
   tagint *tag = atom->tag;
   int *mask = atom->mask;
@@ -135,93 +123,52 @@ void ComputeFragmentAtom::compute_peratom()
     if (mask[i] & groupbit) fragmentID[i] = tag[i];
     else fragmentID[i] = 0;
   }
+  if (!singleflag)
+    for (i = 0; i < nlocal; i++)
+      if (nspecial[i][0] == 0) fragmentID[i] = 0;
 
-  // loop until no ghost atom fragment ID is changed
-  // acquire fragmentIDs of ghost atoms
-  // loop over clusters of atoms, which include ghost atoms
-  // set fragmentIDs for each cluster to min framentID in the clusters
-  // if singleflag = 0 atoms without bonds are assigned fragmentID = 0
-  // iterate until no changes to ghost atom fragmentIDs
-
-  commflag = 1;
-
-  while (true) {
-    comm->forward_comm(this);
-    done = 1;
-
-    // set markflag = 0 for all owned atoms, for new iteration
-
-    for (i = 0; i < nlocal; i++) markflag[i] = 0;
-
-    // loop over all owned atoms
-    // each unmarked atom starts a cluster search
-
-    for (i = 0; i < nlocal; i++) {
-
-      // skip atom I if not in group or already marked
-      // if singleflag = 0 and atom has no bond partners, fragID = 0 and done
+  // single pass over bond partners of my atoms
+  // merge local fragments of bonded atoms, including ghost atoms
+  // also merge ghost atoms with my copy of same atom
 
-      if (!(mask[i] & groupbit)) continue;
-      if (markflag[i]) continue;
-      if (!singleflag && (nspecial[i][0] == 0)) {
-        fragmentID[i] = 0.0;
-        continue;
-      }
+  uf->reset(nall);
 
-      // find one cluster of bond-connected atoms
-      // ncluster = # of owned and ghost atoms in cluster
-      // clist = vector of local indices of the ncluster atoms
-      // stack is used to walk the bond topology
-
-      ncluster = nstack = 0;
-      stack[nstack++] = i;
-
-      while (nstack) {
-        j = stack[--nstack];
-        clist[ncluster++] = j;
-        markflag[j] = 1;
-
-        n = nspecial[j][0];
-        list = special[j];
-        for (m = 0; m < n; m++) {
-          k = atom->map(list[m]);
-
-          // skip bond neighbor K if not in group or already marked
-
-          if (k < 0) continue;
-          if (!(mask[k] & groupbit)) continue;
-          if (k < nlocal && markflag[k]) continue;
+  for (i = nlocal; i < nall; i++) {
+    j = atom->map(tag[i]);
+    if (j >= 0) uf->unite(i,j);
+  }
 
-          // owned bond neighbors are added to stack for further walking
-          // ghost bond neighbors are added directly w/out use of stack
+  for (i = 0; i < nlocal; i++) {
+    if (!(mask[i] & groupbit)) continue;
 
-          if (k < nlocal) stack[nstack++] = k;
-          else clist[ncluster++] = k;
-        }
-      }
+    n = nspecial[i][0];
+    list = special[i];
+    for (m = 0; m < n; m++) {
+      k = atom->map(list[m]);
 
-      // newID = minimum fragment ID in cluster list, including ghost atoms
+      // skip bond neighbor K if not in group
 
-      newID = BIG;
-      for (m = 0; m < ncluster; m++) {
-        cID = fragmentID[clist[m]];
-        newID = MIN(newID,cID);
-      }
+      if (k < 0) continue;
+      if (!(mask[k] & groupbit)) continue;
+      uf->unite(i,k);
+    }
+  }
 
-      // set fragmentID = newID for all atoms in cluster, including ghost atoms
-      // not done with iterations if change the fragmentID of a ghost atom
+  // merge fragments across procs:
+  // assign lowest fragmentID of each local fragment to all its atoms
+  // stop if no proc changed the fragmentID of one of its atoms
+  // else acquire fragmentIDs of ghost atoms and repeat
+  // # of iterations scales with # of procs a fragment spans, not its size
 
-      for (m = 0; m < ncluster; m++) {
-        j = clist[m];
-        if (j >= nlocal && fragmentID[j] != newID) done = 0;
-        fragmentID[j] = newID;
-      }
-    }
+  int change,anychange;
 
-    // stop if all procs are done
+  commflag = 1;
 
-    MPI_Allreduce(&done,&alldone,1,MPI_INT,MPI_MIN,world);
-    if (alldone) break;
+  while (true) {
+    change = uf->assign_min(fragmentID,nlocal);
+    MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
+    if (!anychange) break;
+    comm->forward_comm(this);
   }
 }
 
@@ -278,6 +225,6 @@ void ComputeFragmentAtom::unpack_forward_comm(int n, int first, double *buf)
 double ComputeFragmentAtom::memory_usage()
 {
   double bytes = (double)nmax * sizeof(double);
-  bytes += (double)3*nmax * sizeof(int);
+  bytes += uf->memory_usage();
   return bytes;
 }
@@ -36,8 +36,8 @@ class ComputeFragmentAtom : public Compute {
 
  private:
   int nmax, commflag, singleflag;
-  int *stack, *clist, *markflag;
   double *fragmentID;
+  class UnionFind *uf;
 };
 
 }    // namespace LAMMPS_NS
@@ -42,6 +42,7 @@ ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) : Compute(lmp, narg, arg
   extscalar = 1;
   peflag = 1;
   timeflag = 1;
+  size_scalar_partial = 1;
 
   if (narg == 3) {
     pairflag = 1;
@@ -83,8 +84,20 @@ ComputePE::ComputePE(LAMMPS *lmp, int narg, char **arg) : Compute(lmp, narg, arg
 
 double ComputePE::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
-  if (update->eflag_global != invoked_scalar)
+  double one, all;
+  pack_scalar_partial(&one);
+  MPI_Allreduce(&one, &all, 1, MPI_DOUBLE, MPI_SUM, world);
+  unpack_scalar_partial(&all);
+  return scalar;
+}
+
+/* ----------------------------------------------------------------------
+   local part of compute_scalar(): energies tallied by this proc
+------------------------------------------------------------------------- */
+
+void ComputePE::pack_scalar_partial(double *buf)
+{
+  if (update->eflag_global != update->ntimestep)
     error->all(FLERR, "Energy was not tallied on needed timestep");
 
   double one = 0.0;
@@ -97,7 +110,18 @@ double ComputePE::compute_scalar()
     if (improperflag && force->improper) one += force->improper->energy;
   }
 
-  MPI_Allreduce(&one, &scalar, 1, MPI_DOUBLE, MPI_SUM, world);
+  buf[0] = one;
+}
+
+/* ----------------------------------------------------------------------
+   add contributions which are already summed across procs
+------------------------------------------------------------------------- */
+
+void ComputePE::unpack_scalar_partial(double *buf)
+{
+  invoked_scalar = update->ntimestep;
+
+  scalar = buf[0];
 
   if (kspaceflag && force->kspace) scalar += force->kspace->energy;
 
@@ -107,6 +131,4 @@ double ComputePE::compute_scalar()
   }
 
   if (fixflag && modify->n_energy_global) scalar += modify->energy_global();
-
-  return scalar;
 }
@@ -30,6 +30,9 @@ class ComputePE : public Compute {
   void init() override {}
   double compute_scalar() override;
 
+  void pack_scalar_partial(double *) override;
+  void unpack_scalar_partial(double *) override;
+
  private:
   int pairflag, bondflag, angleflag, dihedralflag, improperflag, kspaceflag, fixflag;
 };
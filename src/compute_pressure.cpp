@@ -47,6 +47,8 @@ ComputePressure::ComputePressure(LAMMPS *lmp, int narg, char **arg) :
   extvector = 0;
   pressflag = 1;
   timeflag = 1;
+  size_scalar_partial = 3;
+  size_vector_partial = 6;
 
   // store temperature ID used by pressure computation
   // ensure it is valid for temperature computation
@@ -227,10 +229,45 @@ void ComputePressure::init()
 
 double ComputePressure::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
-  if (update->vflag_global != invoked_scalar)
+  double v[3], vsum[3];
+  pack_scalar_partial(v);
+  MPI_Allreduce(v,vsum,3,MPI_DOUBLE,MPI_SUM,world);
+  unpack_scalar_partial(vsum);
+  return scalar;
+}
+
+/* ----------------------------------------------------------------------
+   compute pressure tensor
+------------------------------------------------------------------------- */
+
+void ComputePressure::compute_vector()
+{
+  double v[6], vsum[6];
+  pack_vector_partial(v);
+  MPI_Allreduce(v,vsum,6,MPI_DOUBLE,MPI_SUM,world);
+  unpack_vector_partial(vsum);
+}
+
+/* ----------------------------------------------------------------------
+   local part of compute_scalar(): diagonal virial of this proc
+------------------------------------------------------------------------- */
+
+void ComputePressure::pack_scalar_partial(double *buf)
+{
+  if (update->vflag_global != update->ntimestep)
     error->all(FLERR,"Virial was not tallied on needed timestep");
 
+  virial_local(3,buf);
+}
+
+/* ----------------------------------------------------------------------
+   complete compute_scalar() from virial summed across procs
+------------------------------------------------------------------------- */
+
+void ComputePressure::unpack_scalar_partial(double *buf)
+{
+  invoked_scalar = update->ntimestep;
+
   // invoke temperature if it hasn't been already
 
   if (keflag) {
@@ -240,7 +277,7 @@ double ComputePressure::compute_scalar()
 
   if (dimension == 3) {
     inv_volume = 1.0 / (domain->xprd * domain->yprd * domain->zprd);
-    virial_compute(3,3);
+    virial_global(buf,3,3);
     if (keflag)
       scalar = (temperature->dof * boltz * temperature->scalar +
                 virial[0] + virial[1] + virial[2]) / 3.0 * inv_volume * nktv2p;
@@ -248,32 +285,39 @@ double ComputePressure::compute_scalar()
       scalar = (virial[0] + virial[1] + virial[2]) / 3.0 * inv_volume * nktv2p;
   } else {
     inv_volume = 1.0 / (domain->xprd * domain->yprd);
-    virial_compute(2,2);
+    virial_global(buf,2,2);
     if (keflag)
       scalar = (temperature->dof * boltz * temperature->scalar +
                 virial[0] + virial[1]) / 2.0 * inv_volume * nktv2p;
     else
       scalar = (virial[0] + virial[1]) / 2.0 * inv_volume * nktv2p;
   }
-
-  return scalar;
 }
 
 /* ----------------------------------------------------------------------
-   compute pressure tensor
-   assume KE tensor has already been computed
+   local part of compute_vector(): full virial of this proc
 ------------------------------------------------------------------------- */
 
-void ComputePressure::compute_vector()
+void ComputePressure::pack_vector_partial(double *buf)
 {
-  invoked_vector = update->ntimestep;
-  if (update->vflag_global != invoked_vector)
+  if (update->vflag_global != update->ntimestep)
     error->all(FLERR,"Virial was not tallied on needed timestep");
 
   if (force->kspace && kspace_virial && force->kspace->scalar_pressure_flag)
     error->all(FLERR,"Must use 'kspace_modify pressure/scalar no' for "
                "tensor components with kspace_style msm");
 
+  virial_local(6,buf);
+}
+
+/* ----------------------------------------------------------------------
+   complete compute_vector() from virial summed across procs
+------------------------------------------------------------------------- */
+
+void ComputePressure::unpack_vector_partial(double *buf)
+{
+  invoked_vector = update->ntimestep;
+
   // invoke temperature if it hasn't been already
 
   double *ke_tensor;
@@ -285,7 +329,7 @@ void ComputePressure::compute_vector()
 
   if (dimension == 3) {
     inv_volume = 1.0 / (domain->xprd * domain->yprd * domain->zprd);
-    virial_compute(6,3);
+    virial_global(buf,6,3);
     if (keflag) {
       for (int i = 0; i < 6; i++)
         vector[i] = (ke_tensor[i] + virial[i]) * inv_volume * nktv2p;
@@ -294,7 +338,7 @@ void ComputePressure::compute_vector()
         vector[i] = virial[i] * inv_volume * nktv2p;
   } else {
     inv_volume = 1.0 / (domain->xprd * domain->yprd);
-    virial_compute(4,2);
+    virial_global(buf,4,2);
     if (keflag) {
       vector[0] = (ke_tensor[0] + virial[0]) * inv_volume * nktv2p;
       vector[1] = (ke_tensor[1] + virial[1]) * inv_volume * nktv2p;
@@ -312,22 +356,41 @@ void ComputePressure::compute_vector()
 /* ---------------------------------------------------------------------- */
 
 void ComputePressure::virial_compute(int n, int ndiag)
+{
+  double v[6],vsum[6];
+
+  virial_local(n,v);
+  MPI_Allreduce(v,vsum,n,MPI_DOUBLE,MPI_SUM,world);
+  virial_global(vsum,n,ndiag);
+}
+
+/* ----------------------------------------------------------------------
+   sum contributions to virial from forces and fixes on this proc
+------------------------------------------------------------------------- */
+
+void ComputePressure::virial_local(int n, double *v)
 {
   int i,j;
-  double v[6],*vcomponent;
+  double *vcomponent;
 
   for (i = 0; i < n; i++) v[i] = 0.0;
 
-  // sum contributions to virial from forces and fixes
-
   for (j = 0; j < nvirial; j++) {
     vcomponent = vptr[j];
     for (i = 0; i < n; i++) v[i] += vcomponent[i];
   }
+}
+
+/* ----------------------------------------------------------------------
+   set virial from contributions summed across procs
+   and add contributions which are not distributed
+------------------------------------------------------------------------- */
 
-  // sum virial across procs
+void ComputePressure::virial_global(double *vsum, int n, int ndiag)
+{
+  int i;
 
-  MPI_Allreduce(v,virial,n,MPI_DOUBLE,MPI_SUM,world);
+  for (i = 0; i < n; i++) virial[i] = vsum[i];
 
   // KSpace virial contribution is already summed across procs
 
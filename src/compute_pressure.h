@@ -33,6 +33,11 @@ class ComputePressure : public Compute {
   void compute_vector() override;
   void reset_extra_compute_fix(const char *) override;
 
+  void pack_scalar_partial(double *) override;
+  void unpack_scalar_partial(double *) override;
+  void pack_vector_partial(double *) override;
+  void unpack_vector_partial(double *) override;
+
  protected:
   double boltz, nktv2p, inv_volume;
   int nvirial, dimension;
@@ -47,6 +52,8 @@ class ComputePressure : public Compute {
   int fixflag, kspaceflag;
 
   void virial_compute(int, int);
+  void virial_local(int, double *);
+  void virial_global(double *, int, int);
 
  private:
   char *pstyle;
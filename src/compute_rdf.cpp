@@ -43,8 +43,8 @@ using namespace MathConst;
 ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
   Compute(lmp, narg, arg),
   rdfpair(nullptr), nrdfpair(nullptr), ilo(nullptr), ihi(nullptr), jlo(nullptr), jhi(nullptr),
-  hist(nullptr), histall(nullptr), typecount(nullptr), icount(nullptr), jcount(nullptr),
-  duplicates(nullptr)
+  hist(nullptr), histall(nullptr), coord(nullptr), batchsum(nullptr), batchall(nullptr),
+  typecount(nullptr), icount(nullptr), jcount(nullptr), duplicates(nullptr)
 {
   if (narg < 4) error->all(FLERR,"Illegal compute rdf command");
 
@@ -58,10 +58,12 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
   // nargpair = # of pairwise args, starting at iarg = 4
 
   cutflag = 0;
+  cutcoord = 0.0;
 
   int iarg;
   for (iarg = 4; iarg < narg; iarg++)
-    if (strcmp(arg[iarg],"cutoff") == 0) break;
+    if ((strcmp(arg[iarg],"cutoff") == 0) || (strcmp(arg[iarg],"coord") == 0) ||
+        (strcmp(arg[iarg],"batch") == 0)) break;
 
   int nargpair = iarg - 4;
 
@@ -72,6 +74,15 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
       if (cutoff_user <= 0.0) cutflag = 0;
       else cutflag = 1;
       iarg += 2;
+    } else if (strcmp(arg[iarg],"coord") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal compute rdf command");
+      cutcoord = utils::numeric(FLERR,arg[iarg+1],false,lmp);
+      if (cutcoord <= 0.0) error->all(FLERR,"Illegal compute rdf command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"batch") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal compute rdf command");
+      batch_flag = utils::logical(FLERR,arg[iarg+1],false,lmp);
+      iarg += 2;
     } else error->all(FLERR,"Illegal compute rdf command");
   }
 
@@ -124,6 +135,27 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
   memory->create(hist,npairs,nbin,"rdf:hist");
   memory->create(histall,npairs,nbin,"rdf:histall");
   memory->create(array,nbin,1+2*npairs,"rdf:array");
+  if (batch_flag) {
+    memory->create(batchsum,2*npairs,nbin,"rdf:batchsum");
+    memory->create(batchall,2*npairs,nbin,"rdf:batchall");
+    for (i = 0; i < 2*npairs; i++)
+      for (j = 0; j < nbin; j++)
+        batchsum[i][j] = 0.0;
+    for (i = 0; i < nbin; i++)
+      for (j = 1; j < 1+2*npairs; j++)
+        array[i][j] = 0.0;
+  }
+  nsample = 0;
+
+  // coordination numbers within cutcoord for each histogram
+
+  if (cutcoord > 0.0) {
+    vector_flag = 1;
+    size_vector = npairs;
+    extvector = 0;
+    memory->create(vector,npairs,"rdf:vector");
+    memory->create(coord,npairs,"rdf:coord");
+  }
   typecount = new int[ntypes+1];
   icount = new int[npairs];
   jcount = new int[npairs];
@@ -131,6 +163,7 @@ ComputeRDF::ComputeRDF(LAMMPS *lmp, int narg, char **arg) :
 
   dynamic = 0;
   natoms_old = 0;
+  tally_step = -1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -146,6 +179,10 @@ ComputeRDF::~ComputeRDF()
   memory->destroy(hist);
   memory->destroy(histall);
   memory->destroy(array);
+  memory->destroy(vector);
+  memory->destroy(coord);
+  memory->destroy(batchsum);
+  memory->destroy(batchall);
   delete [] typecount;
   delete [] icount;
   delete [] jcount;
@@ -184,6 +221,9 @@ void ComputeRDF::init()
 
   delrinv = 1.0/delr;
 
+  if (cutcoord > nbin*delr)
+    error->all(FLERR,"Compute rdf coord cutoff exceeds cutoff of RDF");
+
   // set 1st column of output array to bin coords
 
   for (int i = 0; i < nbin; i++)
@@ -259,12 +299,149 @@ void ComputeRDF::init_norm()
 
 /* ---------------------------------------------------------------------- */
 
+void ComputeRDF::compute_vector()
+{
+  invoked_vector = update->ntimestep;
+  tally_pairs(INVOKED_ARRAY);
+
+  MPI_Allreduce(coord,vector,npairs,MPI_DOUBLE,MPI_SUM,world);
+  for (int m = 0; m < npairs; m++)
+    vector[m] = (icount[m] > 0) ? vector[m]/icount[m] : 0.0;
+}
+
+/* ---------------------------------------------------------------------- */
+
 void ComputeRDF::compute_array()
 {
-  int i,j,m,ii,jj,inum,jnum,itype,jtype,ipair,jpair,ibin,ihisto;
-  double xtmp,ytmp,ztmp,delx,dely,delz,r;
-  int *ilist,*jlist,*numneigh,**firstneigh;
-  double factor_lj,factor_coul;
+  int m,ibin;
+
+  if (batch_flag) batch_check();
+
+  invoked_array = update->ntimestep;
+  tally_pairs(INVOKED_VECTOR);
+
+  // in batch mode only add histograms weighted by their normalization
+  // to the sums of this proc, finish_array() completes the average
+
+  if (batch_flag) {
+    double constant,normfac,gnorm,cnorm;
+    if (domain->dimension == 3)
+      constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
+    else constant = MY_PI / (domain->xprd*domain->yprd);
+
+    for (m = 0; m < npairs; m++) {
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      if (normfac == 0.0) continue;
+      gnorm = 1.0 / (constant * normfac * icount[m]);
+      cnorm = 1.0 / icount[m];
+      for (ibin = 0; ibin < nbin; ibin++) {
+        batchsum[m][ibin] += hist[m][ibin] * gnorm;
+        batchsum[npairs+m][ibin] += hist[m][ibin] * cnorm;
+      }
+    }
+    nsample++;
+    return;
+  }
+
+  // sum histograms across procs
+
+  MPI_Allreduce(hist[0],histall[0],npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
+
+  // convert counts to g(r) and coord(r) and copy into output array
+  // vfrac = fraction of volume in shell m
+  // npairs = number of pairs, corrected for duplicates
+  // duplicates = pairs in which both atoms are the same
+
+  double constant,vfrac,gr,ncoord,rlower,rupper,normfac;
+
+  if (domain->dimension == 3) {
+    constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
+
+    for (m = 0; m < npairs; m++) {
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      ncoord = 0.0;
+      for (ibin = 0; ibin < nbin; ibin++) {
+        rlower = ibin*delr;
+        rupper = (ibin+1)*delr;
+        vfrac = constant * (rupper*rupper*rupper - rlower*rlower*rlower);
+        if (vfrac * normfac != 0.0)
+          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
+        else gr = 0.0;
+        if (icount[m] != 0)
+          ncoord += gr * vfrac * normfac;
+        array[ibin][1+2*m] = gr;
+        array[ibin][2+2*m] = ncoord;
+      }
+    }
+
+  } else {
+    constant = MY_PI / (domain->xprd*domain->yprd);
+
+    for (m = 0; m < npairs; m++) {
+      ncoord = 0.0;
+      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
+                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
+      for (ibin = 0; ibin < nbin; ibin++) {
+        rlower = ibin*delr;
+        rupper = (ibin+1)*delr;
+        vfrac = constant * (rupper*rupper - rlower*rlower);
+        if (vfrac * normfac != 0.0)
+          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
+        else gr = 0.0;
+        if (icount[m] != 0)
+          ncoord += gr * vfrac * normfac;
+        array[ibin][1+2*m] = gr;
+        array[ibin][2+2*m] = ncoord;
+      }
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   set array to average g(r) and coord(r) of all samples in batch mode
+------------------------------------------------------------------------- */
+
+void ComputeRDF::finish_array()
+{
+  int m,ibin;
+  double shell,ncoord,rlower,rupper;
+
+  batch_check();
+  if (nsample == 0) return;
+
+  MPI_Allreduce(batchsum[0],batchall[0],2*npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
+
+  for (m = 0; m < npairs; m++) {
+    ncoord = 0.0;
+    for (ibin = 0; ibin < nbin; ibin++) {
+      rlower = ibin*delr;
+      rupper = (ibin+1)*delr;
+      if (domain->dimension == 3) shell = rupper*rupper*rupper - rlower*rlower*rlower;
+      else shell = rupper*rupper - rlower*rlower;
+      ncoord += batchall[npairs+m][ibin] / nsample;
+      array[ibin][1+2*m] = batchall[m][ibin] / (shell * nsample);
+      array[ibin][2+2*m] = ncoord;
+    }
+  }
+
+  for (m = 0; m < 2*npairs; m++)
+    for (ibin = 0; ibin < nbin; ibin++)
+      batchsum[m][ibin] = 0.0;
+  nsample = 0;
+}
+
+/* ----------------------------------------------------------------------
+   histogram pair distances and count pairs within cutcoord for my atoms
+   done only once per step if the caller has already invoked the OTHER
+   of compute_array() and compute_vector() in the same step
+------------------------------------------------------------------------- */
+
+void ComputeRDF::tally_pairs(int other)
+{
+  if ((invoked_flag & other) && (tally_step == update->ntimestep)) return;
+  tally_step = update->ntimestep;
 
   if (natoms_old != atom->natoms) {
     dynamic = 1;
@@ -277,23 +454,35 @@ void ComputeRDF::compute_array()
 
   if (dynamic) init_norm();
 
-  invoked_array = update->ntimestep;
-
   // invoke half neighbor list (will copy or build if necessary)
 
   neighbor->build_one(list);
 
+  // zero the histogram counts
+
+  for (int i = 0; i < npairs; i++)
+    for (int j = 0; j < nbin; j++)
+      hist[i][j] = 0;
+  if (coord)
+    for (int i = 0; i < npairs; i++) coord[i] = 0.0;
+
+  tally();
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeRDF::tally()
+{
+  int i,j,m,ii,jj,inum,jnum,itype,jtype,ipair,jpair,ibin,ihisto,incoord;
+  double xtmp,ytmp,ztmp,delx,dely,delz,rsq,r;
+  int *ilist,*jlist,*numneigh,**firstneigh;
+  double factor_lj,factor_coul;
+
   inum = list->inum;
   ilist = list->ilist;
   numneigh = list->numneigh;
   firstneigh = list->firstneigh;
 
-  // zero the histogram counts
-
-  for (i = 0; i < npairs; i++)
-    for (j = 0; j < nbin; j++)
-      hist[i][j] = 0;
-
   // tally the RDF
   // both atom i and j must be in fix group
   // itype,jtype must have been specified by user
@@ -308,6 +497,7 @@ void ComputeRDF::compute_array()
   double *special_coul = force->special_coul;
   double *special_lj = force->special_lj;
   int newton_pair = force->newton_pair;
+  double cutcoordsq = cutcoord*cutcoord;
 
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
@@ -340,74 +530,35 @@ void ComputeRDF::compute_array()
       delx = xtmp - x[j][0];
       dely = ytmp - x[j][1];
       delz = ztmp - x[j][2];
-      r = sqrt(delx*delx + dely*dely + delz*delz);
+      rsq = delx*delx + dely*dely + delz*delz;
+      r = sqrt(rsq);
       ibin = static_cast<int> (r*delrinv);
       if (ibin >= nbin) continue;
+      incoord = (rsq < cutcoordsq);
 
       for (ihisto = 0; ihisto < ipair; ihisto++) {
         m = rdfpair[ihisto][itype][jtype];
         hist[m][ibin] += 1.0;
+        if (incoord) coord[m] += 1.0;
       }
       if (newton_pair || j < nlocal) {
         for (ihisto = 0; ihisto < jpair; ihisto++) {
           m = rdfpair[ihisto][jtype][itype];
           hist[m][ibin] += 1.0;
+          if (incoord) coord[m] += 1.0;
         }
       }
     }
   }
+}
 
-  // sum histograms across procs
-
-  MPI_Allreduce(hist[0],histall[0],npairs*nbin,MPI_DOUBLE,MPI_SUM,world);
-
-  // convert counts to g(r) and coord(r) and copy into output array
-  // vfrac = fraction of volume in shell m
-  // npairs = number of pairs, corrected for duplicates
-  // duplicates = pairs in which both atoms are the same
-
-  double constant,vfrac,gr,ncoord,rlower,rupper,normfac;
-
-  if (domain->dimension == 3) {
-    constant = 4.0*MY_PI / (3.0*domain->xprd*domain->yprd*domain->zprd);
-
-    for (m = 0; m < npairs; m++) {
-      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
-                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
-      ncoord = 0.0;
-      for (ibin = 0; ibin < nbin; ibin++) {
-        rlower = ibin*delr;
-        rupper = (ibin+1)*delr;
-        vfrac = constant * (rupper*rupper*rupper - rlower*rlower*rlower);
-        if (vfrac * normfac != 0.0)
-          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
-        else gr = 0.0;
-        if (icount[m] != 0)
-          ncoord += gr * vfrac * normfac;
-        array[ibin][1+2*m] = gr;
-        array[ibin][2+2*m] = ncoord;
-      }
-    }
-
-  } else {
-    constant = MY_PI / (domain->xprd*domain->yprd);
+/* ---------------------------------------------------------------------- */
 
-    for (m = 0; m < npairs; m++) {
-      ncoord = 0.0;
-      normfac = (icount[m] > 0) ? static_cast<double>(jcount[m])
-                - static_cast<double>(duplicates[m])/icount[m] : 0.0;
-      for (ibin = 0; ibin < nbin; ibin++) {
-        rlower = ibin*delr;
-        rupper = (ibin+1)*delr;
-        vfrac = constant * (rupper*rupper - rlower*rlower);
-        if (vfrac * normfac != 0.0)
-          gr = histall[m][ibin] / (vfrac * normfac * icount[m]);
-        else gr = 0.0;
-        if (icount[m] != 0)
-          ncoord += gr * vfrac * normfac;
-        array[ibin][1+2*m] = gr;
-        array[ibin][2+2*m] = ncoord;
-      }
-    }
-  }
+double ComputeRDF::memory_usage()
+{
+  double bytes = (double) 2*npairs*nbin * sizeof(double);
+  bytes += (double) nbin*(1+2*npairs) * sizeof(double);
+  if (batch_flag) bytes += (double) 4*npairs*nbin * sizeof(double);
+  if (coord) bytes += (double) 2*npairs * sizeof(double);
+  return bytes;
 }
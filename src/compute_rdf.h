@@ -30,20 +30,29 @@ class ComputeRDF : public Compute {
   ~ComputeRDF() override;
   void init() override;
   void init_list(int, class NeighList *) override;
+  void compute_vector() override;
   void compute_array() override;
+  void finish_array() override;
+  double memory_usage() override;
 
- private:
+ protected:
   int nbin;                // # of rdf bins
   int cutflag;             // user cutoff flag
   int npairs;              // # of rdf pairs
   double delr, delrinv;    // bin width and its inverse
   double cutoff_user;      // user-specified cutoff
   double mycutneigh;       // user-specified cutoff + neighbor skin
+  double cutcoord;         // cutoff for coordination numbers, 0.0 if none
   int ***rdfpair;          // map 2 type pair to rdf pair for each histo
   int **nrdfpair;          // # of histograms for each type pair
   int *ilo, *ihi, *jlo, *jhi;
-  double **hist;       // histogram bins
-  double **histall;    // summed histogram bins across all procs
+  double **hist;          // histogram bins
+  double **histall;       // summed histogram bins across all procs
+  double *coord;          // # of pairs within cutcoord for each histo
+  double **batchsum;      // normalized histograms summed over samples in batch mode
+  double **batchall;      // summed batchsum across all procs
+  int nsample;            // # of samples in batchsum
+  bigint tally_step;      // timestep of last tally_pairs()
 
   int *typecount;
   int *icount, *jcount;
@@ -51,6 +60,8 @@ class ComputeRDF : public Compute {
 
   class NeighList *list;    // half neighbor list
   void init_norm();
+  void tally_pairs(int);
+  virtual void tally();
   bigint natoms_old;
 };
 
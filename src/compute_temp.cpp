@@ -33,6 +33,8 @@ ComputeTemp::ComputeTemp(LAMMPS *lmp, int narg, char **arg) : Compute(lmp, narg,
   extscalar = 0;
   extvector = 1;
   tempflag = 1;
+  size_scalar_partial = 1;
+  size_vector_partial = 6;
 
   vector = new double[size_vector];
 }
@@ -71,8 +73,29 @@ void ComputeTemp::dof_compute()
 
 double ComputeTemp::compute_scalar()
 {
-  invoked_scalar = update->ntimestep;
+  double t, tsum;
+  pack_scalar_partial(&t);
+  MPI_Allreduce(&t, &tsum, 1, MPI_DOUBLE, MPI_SUM, world);
+  unpack_scalar_partial(&tsum);
+  return scalar;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeTemp::compute_vector()
+{
+  double t[6], tsum[6];
+  pack_vector_partial(t);
+  MPI_Allreduce(t, tsum, 6, MPI_DOUBLE, MPI_SUM, world);
+  unpack_vector_partial(tsum);
+}
 
+/* ----------------------------------------------------------------------
+   local part of compute_scalar(): sum of m v^2 of my atoms
+------------------------------------------------------------------------- */
+
+void ComputeTemp::pack_scalar_partial(double *buf)
+{
   double **v = atom->v;
   double *mass = atom->mass;
   double *rmass = atom->rmass;
@@ -92,22 +115,30 @@ double ComputeTemp::compute_scalar()
         t += (v[i][0] * v[i][0] + v[i][1] * v[i][1] + v[i][2] * v[i][2]) * mass[type[i]];
   }
 
-  MPI_Allreduce(&t, &scalar, 1, MPI_DOUBLE, MPI_SUM, world);
+  buf[0] = t;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeTemp::unpack_scalar_partial(double *buf)
+{
+  invoked_scalar = update->ntimestep;
+
+  scalar = buf[0];
   if (dynamic) dof_compute();
   if (dof < 0.0 && natoms_temp > 0.0)
     error->all(FLERR, "Temperature compute degrees of freedom < 0");
   scalar *= tfactor;
-  return scalar;
 }
 
-/* ---------------------------------------------------------------------- */
+/* ----------------------------------------------------------------------
+   local part of compute_vector(): KE tensor of my atoms
+------------------------------------------------------------------------- */
 
-void ComputeTemp::compute_vector()
+void ComputeTemp::pack_vector_partial(double *buf)
 {
   int i;
 
-  invoked_vector = update->ntimestep;
-
   double **v = atom->v;
   double *mass = atom->mass;
   double *rmass = atom->rmass;
@@ -132,6 +163,14 @@ void ComputeTemp::compute_vector()
       t[5] += massone * v[i][1] * v[i][2];
     }
 
-  MPI_Allreduce(t, vector, 6, MPI_DOUBLE, MPI_SUM, world);
-  for (i = 0; i < 6; i++) vector[i] *= force->mvv2e;
+  for (i = 0; i < 6; i++) buf[i] = t[i];
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ComputeTemp::unpack_vector_partial(double *buf)
+{
+  invoked_vector = update->ntimestep;
+
+  for (int i = 0; i < 6; i++) vector[i] = buf[i] * force->mvv2e;
 }
@@ -33,6 +33,11 @@ class ComputeTemp : public Compute {
   double compute_scalar() override;
   void compute_vector() override;
 
+  void pack_scalar_partial(double *) override;
+  void unpack_scalar_partial(double *) override;
+  void pack_vector_partial(double *) override;
+  void unpack_vector_partial(double *) override;
+
  protected:
   double tfactor;
 
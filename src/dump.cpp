@@ -14,10 +14,12 @@
 
 #include "dump.h"
 
+#include "async_writer.h"
 #include "atom.h"
 #include "compute.h"
 #include "domain.h"
 #include "error.h"
+#include "file_writer.h"
 #include "fix.h"
 #include "group.h"
 #include "input.h"
@@ -28,6 +30,7 @@
 #include "update.h"
 #include "variable.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <stdexcept>
 
@@ -51,7 +54,7 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) :
     format_int_user(nullptr), format_bigint_user(nullptr), format_column_user(nullptr), fp(nullptr),
     nameslist(nullptr), buf(nullptr), sbuf(nullptr), ids(nullptr), bufsort(nullptr),
     idsort(nullptr), index(nullptr), proclist(nullptr), xpbc(nullptr), vpbc(nullptr),
-    imagepbc(nullptr), irregular(nullptr)
+    imagepbc(nullptr), irregular(nullptr), async_writer(nullptr)
 {
   MPI_Comm_rank(world, &me);
   MPI_Comm_size(world, &nprocs);
@@ -78,6 +81,9 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) :
   append_flag = 0;
   buffer_allow = 0;
   buffer_flag = 0;
+  async_allow = 0;
+  async_flag = 0;
+  async_queue = 2;
   padflag = 0;
   pbcflag = 0;
   time_flag = 0;
@@ -143,6 +149,10 @@ Dump::Dump(LAMMPS *lmp, int /*narg*/, char **arg) :
 
 Dump::~Dump()
 {
+  // finish pending background output before any file is closed
+
+  delete async_writer;
+
   delete[] id;
   delete[] style;
   delete[] filename;
@@ -374,7 +384,7 @@ void Dump::write()
   // do this after skip check, so no file is opened if skip occurs
 
   if (multifile) openfile();
-  if (fp) clearerr(fp);
+  if (fp && !async_flag) clearerr(fp);
 
   // ntotal = total # of dump lines in snapshot
   // nmax = max # of dump lines on any proc
@@ -450,6 +460,23 @@ void Dump::write()
     MPI_Allreduce(&bnme,&nheader,1,MPI_LMP_BIGINT,MPI_SUM,clustercomm);
   }
 
+  // with async output, this proc formats the snapshot into a memory stream
+  // which is handed to the background writer thread after the footer
+  // from here on only the writer thread accesses the dump file
+
+  FILE *fpfile = nullptr;
+  char *asyncbuf = nullptr;
+  size_t asyncsize = 0;
+
+#if !defined(_WIN32)
+  if (async_flag && fp) {
+    fpfile = fp;
+    fp = open_memstream(&asyncbuf,&asyncsize);
+    if (fp == nullptr)
+      error->one(FLERR,"Cannot create async buffer for dump {}: {}", id, utils::getsyserror());
+  }
+#endif
+
   if (filewriter && write_header_flag) write_header(nheader);
 
   // if buffering, convert doubles into strings
@@ -539,6 +566,47 @@ void Dump::write()
 
   if (fp && ferror(fp)) error->one(FLERR,"Error writing dump {}: {}", id, utils::getsyserror());
 
+  // queue the formatted snapshot for the writer thread
+  // it owns the buffer and, if file per timestep, also closes the file
+
+  if (fpfile) {
+    fclose(fp);
+    fp = fpfile;
+
+    if (!async_writer) async_writer = new AsyncWriter(async_queue);
+    std::string dumpid = id;
+    int flushflag = flush_flag;
+    int closeflag = multifile;
+    int pipeflag = compressed;
+
+    try {
+      async_writer->submit([=]() {
+        size_t nwrite = fwrite(asyncbuf,1,asyncsize,fpfile);
+        free(asyncbuf);
+        bool failed = (nwrite != asyncsize) || (flushflag && fflush(fpfile)) || ferror(fpfile);
+        std::string errmsg = failed ? utils::getsyserror() : "";
+        if (closeflag) {
+          if (pipeflag) platform::pclose(fpfile);
+          else fclose(fpfile);
+        }
+        if (failed)
+          throw FileWriterException(fmt::format("Error writing dump {}: {}", dumpid, errmsg));
+      });
+    } catch (FileWriterException &e) {
+
+      // task was not queued, so release its buffer and file here
+
+      free(asyncbuf);
+      if (multifile) {
+        if (compressed) platform::pclose(fpfile);
+        else fclose(fpfile);
+        fp = nullptr;
+      }
+      error->one(FLERR, e.what());
+    }
+    if (multifile) fp = nullptr;
+  }
+
   // if file per timestep, close file if I am filewriter
 
   if (multifile) {
@@ -551,6 +619,22 @@ void Dump::write()
   }
 }
 
+/* ----------------------------------------------------------------------
+   wait until the background writer thread has written all queued snapshots
+   called at the end of a run and whenever the file must be complete
+------------------------------------------------------------------------- */
+
+void Dump::flush_async()
+{
+  if (!async_writer) return;
+
+  try {
+    async_writer->wait();
+  } catch (FileWriterException &e) {
+    error->one(FLERR, e.what());
+  }
+}
+
 /* ----------------------------------------------------------------------
    generic opening of a dump file
    ASCII or binary or compressed
@@ -1061,6 +1145,32 @@ void Dump::modify_params(int narg, char **arg)
       append_flag = utils::logical(FLERR,arg[iarg+1],false,lmp);
       iarg += 2;
 
+    } else if (strcmp(arg[iarg],"async") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "dump_modify async", error);
+      async_flag = utils::logical(FLERR,arg[iarg+1],false,lmp);
+
+      // switching back to synchronous output must not interleave with
+      // snapshots still queued for the writer thread
+
+      if (!async_flag) {
+        flush_async();
+        if (fp) fflush(fp);
+      }
+      if (async_flag && async_allow == 0)
+        error->all(FLERR,"Dump_modify async yes not allowed for this style");
+#if defined(_WIN32)
+      if (async_flag) error->all(FLERR,"Dump_modify async yes is not supported on Windows");
+#endif
+      iarg += 2;
+
+    } else if (strcmp(arg[iarg],"async/queue") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "dump_modify async/queue", error);
+      async_queue = utils::inumeric(FLERR,arg[iarg+1],false,lmp);
+      if (async_queue <= 0)
+        error->all(FLERR, "Invalid dump_modify async/queue argument: {}", async_queue);
+      if (async_writer) async_writer->set_max_queue(async_queue);
+      iarg += 2;
+
     } else if (strcmp(arg[iarg],"balance") == 0) {
       if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "dump_modify balance", error);
       if (nprocs > 1)
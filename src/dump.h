@@ -57,6 +57,7 @@ class Dump : protected Pointers {
   virtual void unpack_reverse_comm(int, int *, double *) {}
 
   void modify_params(int, char **);
+  void flush_async();
   virtual double memory_usage();
 
  protected:
@@ -79,6 +80,9 @@ class Dump : protected Pointers {
   int append_flag;          // 1 if open file in append mode, 0 if not
   int buffer_allow;         // 1 if style allows for buffer_flag, 0 if not
   int buffer_flag;          // 1 if buffer output as one big string, 0 if not
+  int async_allow;          // 1 if style allows for async_flag, 0 if not
+  int async_flag;           // 1 if file output is done by a background thread
+  int async_queue;          // max # of snapshots pending in background thread
   int padflag;              // timestep padding in filename
   int pbcflag;              // 1 if remap dumped atoms via PBC, 0 if not
   int singlefile_opened;    // 1 = one big file, already opened, else 0
@@ -155,6 +159,7 @@ class Dump : protected Pointers {
   int maxpbc;
 
   class Irregular *irregular;
+  class AsyncWriter *async_writer;
 
   virtual void init_style() = 0;
   virtual void openfile();
@@ -64,6 +64,7 @@ DumpImage::DumpImage(LAMMPS *lmp, int narg, char **arg) :
   avec_line(nullptr), avec_tri(nullptr), avec_body(nullptr), fixptr(nullptr), image(nullptr),
   chooseghost(nullptr), bufcopy(nullptr)
 {
+  async_allow = 0;
   if (binary || multiproc) error->all(FLERR,"Invalid dump image filename");
 
   // force binary flag on to avoid corrupted output on Windows
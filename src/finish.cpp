@@ -18,6 +18,7 @@
 #include "atom.h"
 #include "atom_vec.h"
 #include "comm.h"
+#include "dump.h"
 #include "error.h"
 #include "force.h"
 #include "kspace.h"
@@ -75,6 +76,10 @@ void Finish::end(int flag)
 
   const int nthreads = comm->nthreads;
 
+  // wait for dump snapshots still pending in background writer threads
+
+  for (auto &dump : output->get_dump_list()) dump->flush_async();
+
   // recompute natoms in case atoms have been lost
 
   bigint nblocal = atom->nlocal;
@@ -356,6 +361,10 @@ void Finish::end(int flag)
     }
   }
 
+  // fine grained timings of individual styles
+
+  if (timeflag && timer->has_detail()) detail_timings(time_loop);
+
 #ifdef LMP_OPENMP
   FixOMP *fixomp = dynamic_cast<FixOMP *>(modify->get_fix_by_id("package_omp"));
 
@@ -680,3 +689,78 @@ void omp_times(FixOMP *fix, const char *label, enum Timer::ttype which,
 }
 #endif
 
+/* ----------------------------------------------------------------------
+   print min/avg/max across procs of fine grained timers
+   of fixes, computes, pair sub-styles, and dumps
+   optionally also write them to a JSON file
+------------------------------------------------------------------------- */
+
+void Finish::detail_timings(double time_loop)
+{
+  const auto &details = timer->get_details();
+  int ndetail = details.size();
+
+  int nmin, nmax;
+  MPI_Allreduce(&ndetail,&nmin,1,MPI_INT,MPI_MIN,world);
+  MPI_Allreduce(&ndetail,&nmax,1,MPI_INT,MPI_MAX,world);
+  if (nmin != nmax) {
+    if (comm->me == 0)
+      error->warning(FLERR,"Fine grained timers differ between MPI ranks, no detailed timings");
+    return;
+  }
+  if (ndetail == 0) return;
+
+  std::vector<double> wall(ndetail), wmin(ndetail), wmax(ndetail), wsum(ndetail);
+  std::vector<bigint> calls(ndetail), cmax(ndetail);
+  for (int i = 0; i < ndetail; i++) {
+    wall[i] = details[i].wall;
+    calls[i] = details[i].calls;
+  }
+
+  MPI_Allreduce(wall.data(),wmin.data(),ndetail,MPI_DOUBLE,MPI_MIN,world);
+  MPI_Allreduce(wall.data(),wmax.data(),ndetail,MPI_DOUBLE,MPI_MAX,world);
+  MPI_Allreduce(wall.data(),wsum.data(),ndetail,MPI_DOUBLE,MPI_SUM,world);
+  MPI_Allreduce(calls.data(),cmax.data(),ndetail,MPI_LMP_BIGINT,MPI_MAX,world);
+
+  if (comm->me != 0) return;
+
+  const int nprocs = comm->nprocs;
+  const double scale = (time_loop > 0.0) ? 100.0/time_loop : 0.0;
+
+  std::string mesg = "\nDetailed timing breakdown:\nSection | ID (style)               "
+    "|   calls   |  min time  |  avg time  |  max time  | %total\n"
+    "--------------------------------------------------------------------------------"
+    "-------------------\n";
+  for (int i = 0; i < ndetail; i++) {
+    if (cmax[i] == 0) continue;
+    auto name = fmt::format("{} ({})",details[i].id,details[i].style);
+    mesg += fmt::format("{:<8s}| {:<24s} | {:>9} | {:<10.5g} | {:<10.5g} | {:<10.5g} |{:6.2f}\n",
+                        details[i].category,name,cmax[i],wmin[i],wsum[i]/nprocs,wmax[i],
+                        wsum[i]/nprocs*scale);
+  }
+  utils::logmesg(lmp,mesg);
+
+  const auto &file = timer->get_detail_file();
+  if (file.empty()) return;
+
+  FILE *fp = fopen(file.c_str(),"w");
+  if (!fp) {
+    error->warning(FLERR,"Cannot open timer JSON file {}: {}",file,utils::getsyserror());
+    return;
+  }
+
+  fmt::print(fp,"{{\n  \"lammps_version\": \"{}\",\n  \"nprocs\": {},\n  \"nthreads\": {},\n"
+             "  \"natoms\": {},\n  \"nsteps\": {},\n  \"loop_time\": {:.8g},\n  \"timers\": [",
+             lmp->version,nprocs,comm->nthreads,atom->natoms,update->nsteps,time_loop);
+  int first = 1;
+  for (int i = 0; i < ndetail; i++) {
+    if (cmax[i] == 0) continue;
+    fmt::print(fp,"{}\n    {{\"category\": \"{}\", \"id\": \"{}\", \"style\": \"{}\", "
+               "\"calls\": {}, \"min\": {:.8g}, \"avg\": {:.8g}, \"max\": {:.8g}}}",
+               first ? "" : ",",details[i].category,details[i].id,details[i].style,
+               cmax[i],wmin[i],wsum[i]/nprocs,wmax[i]);
+    first = 0;
+  }
+  fmt::print(fp,"\n  ]\n}}\n");
+  fclose(fp);
+}
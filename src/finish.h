@@ -25,6 +25,7 @@ class Finish : protected Pointers {
 
  private:
   void stats(int, double *, double *, double *, double *, int, int *);
+  void detail_timings(double);
 };
 
 }    // namespace LAMMPS_NS
@@ -463,6 +463,8 @@ void FixAveTime::init()
       val.val.c = modify->get_compute_by_id(val.id);
       if (!val.val.c)
         error->all(FLERR,"Compute ID {} for fix ave/time does not exist", val.id);
+      if ((mode == VECTOR) && val.argindex && val.val.c->batch_flag)
+        val.val.c->batch_claim(this);
     } else if (val.which == ArgInfo::FIX) {
       val.val.f = modify->get_fix_by_id(val.id);
       if (!val.val.f)
@@ -737,13 +739,27 @@ void FixAveTime::invoke_vector(bigint ntimestep)
 
       } else {
         if (!(val.val.c->invoked_flag & Compute::INVOKED_ARRAY)) {
-          val.val.c->compute_array();
+          if (val.val.c->batch_flag) val.val.c->batch_invoke(this, 0);
+          else val.val.c->compute_array();
           val.val.c->invoked_flag |= Compute::INVOKED_ARRAY;
         }
+        // a batch compute averages its own samples until finish_array(),
+        // so use its average on the last repeat, weighted by nrepeat
+        // to undo the division by nrepeat at the end of the epoch
+
+        if (val.val.c->batch_flag) {
+          if (irepeat < nrepeat-1) {
+            ++j;
+            continue;
+          }
+          val.val.c->batch_invoke(this, 1);
+        }
+
         double **carray = val.val.c->array;
         int icol = val.argindex-1;
+        double weight = (val.val.c->batch_flag && !val.offcol) ? nrepeat : 1.0;
         for (int i = 0; i < nrows; i++)
-          column[i] = carray[i][icol];
+          column[i] = weight*carray[i][icol];
       }
 
     // access fix fields, guaranteed to be ready
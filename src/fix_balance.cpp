@@ -105,6 +105,8 @@ FixBalance::FixBalance(LAMMPS *lmp, int narg, char **arg) :
   balance = new Balance(lmp);
   if (lbstyle == SHIFT) balance->shift_setup(bstr,nitermax,thresh);
   balance->options(iarg,narg,arg,0);
+  if (balance->incflag && lbstyle != BISECTION)
+    error->all(FLERR,"Fix balance incremental keyword requires style rcb");
   wtflag = balance->wtflag;
   sortflag = balance->sortflag;
 
@@ -242,10 +242,9 @@ void FixNeighHistory::pre_exchange()
 
 void FixNeighHistory::pre_exchange_onesided()
 {
-  int i, j, ii, jj, m, n, inum, jnum;
+  int i, ii, jj, m, n, inum, jnum;
   int *ilist, *jlist, *numneigh, **firstneigh;
   int *allflags;
-  double *allvalues, *onevalues;
 
   // NOTE: all operations until very end are with nlocal_neigh <= current nlocal
   // because previous neigh list was built with nlocal_neigh
@@ -268,14 +267,19 @@ void FixNeighHistory::pre_exchange_onesided()
   numneigh = list->numneigh;
   firstneigh = list->firstneigh;
 
+  contacts.clear();
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
     jlist = firstneigh[i];
     jnum = numneigh[i];
     allflags = firstflag[i];
 
-    for (jj = 0; jj < jnum; jj++)
-      if (allflags[jj]) npartner[i]++;
+    for (jj = 0; jj < jnum; jj++) {
+      if (allflags[jj]) {
+        npartner[i]++;
+        contacts.push_back({i, jlist[jj] & NEIGHMASK, &firstvalue[i][dnum * jj]});
+      }
+    }
   }
 
   // get page chunks to store partner IDs and values for owned atoms
@@ -289,29 +293,17 @@ void FixNeighHistory::pre_exchange_onesided()
       error->one(FLERR, "Neighbor history overflow, boost neigh_modify one");
   }
 
-  // 2nd loop over neighbor list, I = sphere, J = tri
+  // loop over contacts found in 1st loop, I = sphere, J = tri
   // store partner IDs and values for owned+ghost atoms
   // re-zero npartner to use as counter
 
   for (i = 0; i < nlocal_neigh; i++) npartner[i] = 0;
 
-  for (ii = 0; ii < inum; ii++) {
-    i = ilist[ii];
-    jlist = firstneigh[i];
-    jnum = numneigh[i];
-    allflags = firstflag[i];
-    allvalues = firstvalue[i];
-
-    for (jj = 0; jj < jnum; jj++) {
-      if (allflags[jj]) {
-        onevalues = &allvalues[dnum * jj];
-        j = jlist[jj];
-        j &= NEIGHMASK;
-        m = npartner[i]++;
-        partner[i][m] = tag[j];
-        memcpy(&valuepartner[i][dnum * m], onevalues, dnumbytes);
-      }
-    }
+  for (const auto &c : contacts) {
+    i = c.i;
+    m = npartner[i]++;
+    partner[i][m] = tag[c.j];
+    memcpy(&valuepartner[i][dnum * m], c.values, dnumbytes);
   }
 
   // set maxpartner = max # of partners of any owned atom
@@ -337,7 +329,7 @@ void FixNeighHistory::pre_exchange_newton()
   int i, j, ii, jj, m, n, inum, jnum;
   int *ilist, *jlist, *numneigh, **firstneigh;
   int *allflags;
-  double *allvalues, *onevalues, *jvalues;
+  double *onevalues, *jvalues;
   int *type = atom->type;
 
   // NOTE: all operations until very end are with
@@ -365,6 +357,7 @@ void FixNeighHistory::pre_exchange_newton()
   numneigh = list->numneigh;
   firstneigh = list->firstneigh;
 
+  contacts.clear();
   for (ii = 0; ii < inum; ii++) {
     i = ilist[ii];
     jlist = firstneigh[i];
@@ -377,6 +370,7 @@ void FixNeighHistory::pre_exchange_newton()
         j = jlist[jj];
         j &= NEIGHMASK;
         npartner[j]++;
+        contacts.push_back({i, j, &firstvalue[i][dnum * jj]});
       }
     }
   }
@@ -407,36 +401,26 @@ void FixNeighHistory::pre_exchange_newton()
     }
   }
 
-  // 2nd loop over neighbor list
+  // loop over contacts found in 1st loop
   // store partner IDs and values for owned+ghost atoms
   // re-zero npartner to use as counter
 
   for (i = 0; i < MAX(nall_neigh, nall); i++) npartner[i] = 0;
 
-  for (ii = 0; ii < inum; ii++) {
-    i = ilist[ii];
-    jlist = firstneigh[i];
-    jnum = numneigh[i];
-    allflags = firstflag[i];
-    allvalues = firstvalue[i];
-
-    for (jj = 0; jj < jnum; jj++) {
-      if (allflags[jj]) {
-        onevalues = &allvalues[dnum * jj];
-        j = jlist[jj];
-        j &= NEIGHMASK;
-        m = npartner[i]++;
-        partner[i][m] = tag[j];
-        memcpy(&valuepartner[i][dnum * m], onevalues, dnumbytes);
-        m = npartner[j]++;
-        partner[j][m] = tag[i];
-        jvalues = &valuepartner[j][dnum * m];
-        if (pair->nondefault_history_transfer)
-          pair->transfer_history(onevalues, jvalues, type[i], type[j]);
-        else
-          for (n = 0; n < dnum; n++) jvalues[n] = -onevalues[n];
-      }
-    }
+  for (const auto &c : contacts) {
+    i = c.i;
+    j = c.j;
+    onevalues = c.values;
+    m = npartner[i]++;
+    partner[i][m] = tag[j];
+    memcpy(&valuepartner[i][dnum * m], onevalues, dnumbytes);
+    m = npartner[j]++;
+    partner[j][m] = tag[i];
+    jvalues = &valuepartner[j][dnum * m];
+    if (pair->nondefault_history_transfer)
+      pair->transfer_history(onevalues, jvalues, type[i], type[j]);
+    else
+      for (n = 0; n < dnum; n++) jvalues[n] = -onevalues[n];
   }
 
   // perform reverse comm to augment
@@ -471,7 +455,7 @@ void FixNeighHistory::pre_exchange_no_newton()
   int i, j, ii, jj, m, n, inum, jnum;
   int *ilist, *jlist, *numneigh, **firstneigh;
   int *allflags;
-  double *allvalues, *onevalues, *jvalues;
+  double *onevalues, *jvalues;
   int *type = atom->type;
 
   // NOTE: all operations until very end are with nlocal_neigh <= current nlocal
@@ -487,6 +471,7 @@ void FixNeighHistory::pre_exchange_no_newton()
   // calculate npartner for owned atoms
 
   for (i = 0; i < nlocal_neigh; i++) npartner[i] = 0;
+  contacts.clear();
 
   tagint *tag = atom->tag;
   NeighList *list = pair->list;
@@ -507,6 +492,7 @@ void FixNeighHistory::pre_exchange_no_newton()
         j = jlist[jj];
         j &= NEIGHMASK;
         if (j < nlocal_neigh) npartner[j]++;
+        contacts.push_back({i, j, &firstvalue[i][dnum * jj]});
       }
     }
   }
@@ -522,37 +508,27 @@ void FixNeighHistory::pre_exchange_no_newton()
       error->one(FLERR, "Neighbor history overflow, boost neigh_modify one");
   }
 
-  // 2nd loop over neighbor list
-  // store partner IDs and values for owned+ghost atoms
+  // loop over contacts found in 1st loop
+  // store partner IDs and values for owned atoms
   // re-zero npartner to use as counter
 
   for (i = 0; i < nlocal_neigh; i++) npartner[i] = 0;
 
-  for (ii = 0; ii < inum; ii++) {
-    i = ilist[ii];
-    jlist = firstneigh[i];
-    jnum = numneigh[i];
-    allflags = firstflag[i];
-    allvalues = firstvalue[i];
-
-    for (jj = 0; jj < jnum; jj++) {
-      if (allflags[jj]) {
-        onevalues = &allvalues[dnum * jj];
-        j = jlist[jj];
-        j &= NEIGHMASK;
-        m = npartner[i]++;
-        partner[i][m] = tag[j];
-        memcpy(&valuepartner[i][dnum * m], onevalues, dnumbytes);
-        if (j < nlocal_neigh) {
-          m = npartner[j]++;
-          partner[j][m] = tag[i];
-          jvalues = &valuepartner[j][dnum * m];
-          if (pair->nondefault_history_transfer)
-            pair->transfer_history(onevalues, jvalues, type[i], type[j]);
-          else
-            for (n = 0; n < dnum; n++) jvalues[n] = -onevalues[n];
-        }
-      }
+  for (const auto &c : contacts) {
+    i = c.i;
+    j = c.j;
+    onevalues = c.values;
+    m = npartner[i]++;
+    partner[i][m] = tag[j];
+    memcpy(&valuepartner[i][dnum * m], onevalues, dnumbytes);
+    if (j < nlocal_neigh) {
+      m = npartner[j]++;
+      partner[j][m] = tag[i];
+      jvalues = &valuepartner[j][dnum * m];
+      if (pair->nondefault_history_transfer)
+        pair->transfer_history(onevalues, jvalues, type[i], type[j]);
+      else
+        for (n = 0; n < dnum; n++) jvalues[n] = -onevalues[n];
     }
   }
 
@@ -584,7 +560,7 @@ void FixNeighHistory::min_pre_exchange()
 
 void FixNeighHistory::post_neighbor()
 {
-  int i, j, m, ii, jj, nn, np, inum, jnum, rflag;
+  int i, j, m, ii, jj, nn, np, inum, jnum, rflag, usehash;
   tagint jtag;
   int *ilist, *jlist, *numneigh, **firstneigh;
   int *allflags;
@@ -630,6 +606,8 @@ void FixNeighHistory::post_neighbor()
     firstvalue[i] = allvalues = dpage_neigh->get(jnum * dnum);
     np = npartner[i];
     nn = 0;
+    usehash = (np > NPARTNER_LINEAR);
+    if (usehash) phash.build(partner[i], np);
 
     for (jj = 0; jj < jnum; jj++) {
       j = jlist[jj];
@@ -653,8 +631,13 @@ void FixNeighHistory::post_neighbor()
 
       if (rflag) {
         jtag = tag[j];
-        for (m = 0; m < np; m++)
-          if (partner[i][m] == jtag) break;
+        if (usehash) {
+          m = phash.find(jtag);
+          if (m < 0) m = np;
+        } else {
+          for (m = 0; m < np; m++)
+            if (partner[i][m] == jtag) break;
+        }
         if (m < np) {
           allflags[jj] = 1;
           memcpy(&allvalues[nn], &valuepartner[i][dnum * m], dnumbytes);
@@ -671,6 +654,31 @@ void FixNeighHistory::post_neighbor()
   }
 }
 
+/* ----------------------------------------------------------------------
+   fill hash table with N partner IDs
+   table is at most half full, so every probe sequence ends at an empty slot
+   for duplicate IDs the first index is kept, same as for a linear search
+------------------------------------------------------------------------- */
+
+void FixNeighHistory::PartnerHash::build(const tagint *ids, int n)
+{
+  int bits = 1;
+  while ((1 << bits) < 2 * n) bits++;
+  const int size = 1 << bits;
+  mask = size - 1;
+  shift = 64 - bits;
+  key.assign(size, 0);
+  index.resize(size);
+
+  for (int m = 0; m < n; m++) {
+    int h = slot(ids[m]);
+    while (key[h] && (key[h] != ids[m])) h = (h + 1) & mask;
+    if (key[h]) continue;
+    key[h] = ids[m];
+    index[h] = m;
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void FixNeighHistory::min_post_neighbor()
@@ -697,6 +705,7 @@ double FixNeighHistory::memory_usage()
   bytes += (double) nmax * sizeof(double *);       // valuepartner
   bytes += (double) maxatom * sizeof(int *);       // firstflag
   bytes += (double) maxatom * sizeof(double *);    // firstvalue
+  bytes += (double) contacts.capacity() * sizeof(Contact);
 
   int nmypage = comm->nthreads;
   for (int i = 0; i < nmypage; i++) {
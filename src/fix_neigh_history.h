@@ -22,6 +22,8 @@ FixStyle(NEIGH_HISTORY,FixNeighHistory);
 
 #include "fix.h"
 
+#include <vector>
+
 namespace LAMMPS_NS {
 
 class FixNeighHistory : public Fix {
@@ -83,11 +85,52 @@ class FixNeighHistory : public Fix {
   MyPage<tagint> *ipage_atom;    // pages of partner atom IDs
   MyPage<double> *dpage_atom;    // pages of partner values
 
+  // flagged neighbors of the previous neighbor list found by pre_exchange()
+  // its 2nd pass loops over them instead of the entire neighbor list
+
+  struct Contact {
+    int i, j;          // local indices of the two atoms
+    double *values;    // values stored with I in firstvalue
+  };
+  std::vector<Contact> contacts;
+
   // per-neighbor data structs pointed to by firstflag & firstvalue
 
   MyPage<int> *ipage_neigh;       // pages of local atom indices
   MyPage<double> *dpage_neigh;    // pages of partner values
 
+  // open-addressed hash of the partner IDs of one atom to their index in
+  // its partner list, replaces a linear search in post_neighbor()
+  // for atoms with more than NPARTNER_LINEAR partners
+
+  static constexpr int NPARTNER_LINEAR = 8;
+
+  class PartnerHash {
+   public:
+    void build(const tagint *, int);
+
+    // index of first partner with this ID, -1 if none
+
+    int find(tagint id) const
+    {
+      int h = slot(id);
+      while (key[h]) {
+        if (key[h] == id) return index[h];
+        h = (h + 1) & mask;
+      }
+      return -1;
+    }
+
+   private:
+    std::vector<tagint> key;    // partner IDs, 0 = empty slot
+    std::vector<int> index;     // index of each ID in partner list
+    int mask = 0, shift = 0;
+
+    int slot(tagint id) const { return (int) (((uint64_t) id * 0x9E3779B97F4A7C15ULL) >> shift); }
+  };
+
+  PartnerHash phash;
+
   virtual void pre_exchange_onesided();
   virtual void pre_exchange_newton();
   virtual void pre_exchange_no_newton();
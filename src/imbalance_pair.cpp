@@ -0,0 +1,139 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "imbalance_pair.h"
+
+#include "atom.h"
+#include "comm.h"
+#include "error.h"
+#include "force.h"
+#include "memory.h"
+#include "neighbor.h"
+#include "pair.h"
+#include "update.h"
+
+using namespace LAMMPS_NS;
+
+#define BIG 1.0e20
+
+/* -------------------------------------------------------------------- */
+
+ImbalancePair::ImbalancePair(LAMMPS *lmp) : Imbalance(lmp)
+{
+  fixflag = 0;
+  did_warn = 0;
+  maxcost = 0;
+  cost = nullptr;
+}
+
+/* -------------------------------------------------------------------- */
+
+ImbalancePair::~ImbalancePair()
+{
+  memory->destroy(cost);
+}
+
+/* -------------------------------------------------------------------- */
+
+int ImbalancePair::options(int narg, char **arg)
+{
+  if (narg < 1) error->all(FLERR, "Illegal balance weight command");
+  factor = utils::numeric(FLERR, arg[0], false, lmp);
+  if (factor <= 0.0) error->all(FLERR, "Illegal balance weight command");
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   flag = 1 if called from FixBalance at start of run
+------------------------------------------------------------------------- */
+
+void ImbalancePair::init(int flag)
+{
+  fixflag = flag;
+}
+
+/* -------------------------------------------------------------------- */
+
+void ImbalancePair::compute(double *weight)
+{
+  // per-atom estimates refer to the atoms of the last force computation
+  // that is only guaranteed when called from fix balance during a run,
+  //   not during setup or from the balance command after exchange()
+
+  if (!fixflag || update->setupflag) {
+    if (!fixflag && comm->me == 0 && !did_warn)
+      error->warning(FLERR, "Balance weight pair is only supported by fix balance");
+    did_warn = 1;
+    return;
+  }
+
+  const int nlocal = atom->nlocal;
+  if (nlocal > maxcost) {
+    maxcost = atom->nmax;
+    memory->destroy(cost);
+    memory->create(cost, maxcost, "imbalance:cost");
+  }
+
+  // cost = 1 for the atom itself plus estimate of the pair style
+
+  for (int i = 0; i < nlocal; i++) cost[i] = 0.0;
+  int flag = 0;
+  if (force->pair && (neighbor->ago >= 0)) flag = force->pair->cost_atom(cost);
+
+  int flagall;
+  MPI_Allreduce(&flag, &flagall, 1, MPI_INT, MPI_MIN, world);
+  if (!flagall) {
+    if (comm->me == 0 && !did_warn)
+      error->warning(FLERR, "Balance weight pair skipped b/c pair style provides no cost estimate");
+    did_warn = 1;
+    return;
+  }
+
+  for (int i = 0; i < nlocal; i++) {
+    if (cost[i] < 0.0) error->one(FLERR, "Balance weight < 0.0");
+    cost[i] += 1.0;
+  }
+
+  // apply factor if specified != 1.0
+  // wtlo,wthi = lo/hi values of all atoms
+  // lo value does not change
+  // newhi = new hi value to give hi/lo ratio factor times larger/smaller
+  // expand/contract all cost values from lo->hi to lo->newhi
+
+  if (factor != 1.0) {
+    double mylo = BIG;
+    double myhi = 0.0;
+    for (int i = 0; i < nlocal; i++) {
+      mylo = MIN(mylo, cost[i]);
+      myhi = MAX(myhi, cost[i]);
+    }
+    double wtlo, wthi;
+    MPI_Allreduce(&mylo, &wtlo, 1, MPI_DOUBLE, MPI_MIN, world);
+    MPI_Allreduce(&myhi, &wthi, 1, MPI_DOUBLE, MPI_MAX, world);
+
+    if (wthi > wtlo) {
+      double newhi = wthi * factor;
+      for (int i = 0; i < nlocal; i++)
+        cost[i] = wtlo + ((cost[i] - wtlo) / (wthi - wtlo)) * (newhi - wtlo);
+    }
+  }
+
+  for (int i = 0; i < nlocal; i++) weight[i] *= cost[i];
+}
+
+/* -------------------------------------------------------------------- */
+
+std::string ImbalancePair::info()
+{
+  return fmt::format("  pair cost weight factor: {}\n", factor);
+}
@@ -0,0 +1,46 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#ifndef LMP_IMBALANCE_PAIR_H
+#define LMP_IMBALANCE_PAIR_H
+
+#include "imbalance.h"
+
+namespace LAMMPS_NS {
+
+class ImbalancePair : public Imbalance {
+ public:
+  ImbalancePair(class LAMMPS *);
+  ~ImbalancePair() override;
+
+ public:
+  // parse options, return number of arguments consumed
+  int options(int, char **) override;
+  // reinitialize internal data
+  void init(int) override;
+  // compute and apply weight factors to local atom array
+  void compute(double *) override;
+  // print information about the state of this imbalance compute
+  std::string info() override;
+
+ private:
+  double factor;    // weight factor for pair style cost estimates
+  int fixflag;      // 1 if used by fix balance
+  int did_warn;     // 1 if warned about missing cost estimates
+  int maxcost;      // allocated size of cost
+  double *cost;     // per-atom cost estimates
+};
+
+}    // namespace LAMMPS_NS
+
+#endif
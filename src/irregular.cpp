@@ -23,6 +23,7 @@
 #include "modify.h"
 
 #include <cstring>
+#include <vector>
 
 using namespace LAMMPS_NS;
 
@@ -40,6 +41,8 @@ static int compare_standalone(const int, const int, void *);
 #define BUFMIN 1024
 #define BUFEXTRA 1024
 
+static constexpr int TAG_COUNT = 1;    // tag for messages with sizes of plan messages
+
 /* ---------------------------------------------------------------------- */
 
 Irregular::Irregular(LAMMPS *lmp) : Pointers(lmp)
@@ -308,40 +311,6 @@ int Irregular::create_atom(int n, int *sizes, int *proclist, int sortflag)
 {
   int i;
 
-  // setup for collective comm
-  // work1 = 1 for procs I send a message to, not including self
-  // work2 = 1 for all procs, used for ReduceScatter
-
-  for (i = 0; i < nprocs; i++) {
-    work1[i] = 0;
-    work2[i] = 1;
-  }
-  for (i = 0; i < n; i++) work1[proclist[i]] = 1;
-  work1[me] = 0;
-
-  // nrecv_proc = # of procs I receive messages from, not including self
-  // options for performing ReduceScatter operation
-  // some are more efficient on some machines at big sizes
-
-#ifdef LAMMPS_RS_ALLREDUCE_INPLACE
-  MPI_Allreduce(MPI_IN_PLACE,work1,nprocs,MPI_INT,MPI_SUM,world);
-  nrecv_proc = work1[me];
-#else
-#ifdef LAMMPS_RS_ALLREDUCE
-  MPI_Allreduce(work1,work2,nprocs,MPI_INT,MPI_SUM,world);
-  nrecv_proc = work2[me];
-#else
-  MPI_Reduce_scatter(work1,&nrecv_proc,work2,MPI_INT,MPI_SUM,world);
-#endif
-#endif
-
-  // allocate receive arrays
-
-  proc_recv = new int[nrecv_proc];
-  length_recv = new int[nrecv_proc];
-  request = new MPI_Request[nrecv_proc];
-  status = new MPI_Status[nrecv_proc];
-
   // nsend_proc = # of messages I send
 
   for (i = 0; i < nprocs; i++) work1[i] = 0;
@@ -403,37 +372,177 @@ int Irregular::create_atom(int n, int *sizes, int *proclist, int sortflag)
     else offset_send[i] = 0;
   }
 
-  // tell receivers how much data I send
   // sendmax_proc = # of doubles I send in largest single message
 
   sendmax_proc = 0;
-  for (i = 0; i < nsend_proc; i++) {
-    MPI_Request tmpReq; // Use non-blocking send to avoid possible deadlock
-    MPI_Isend(&length_send[i],1,MPI_INT,proc_send[i],0,world,&tmpReq);
-    MPI_Request_free(&tmpReq); // the MPI_Barrier below marks completion
-    sendmax_proc = MAX(sendmax_proc,length_send[i]);
-  }
+  for (i = 0; i < nsend_proc; i++) sendmax_proc = MAX(sendmax_proc,length_send[i]);
 
-  // receive incoming messages
+  // tell receivers how much data I send
   // proc_recv = procs I recv from
   // length_recv = # of doubles each proc sends me
   // nrecvsize = total size of atom data I recv
 
-  int nrecvsize = 0;
+  int nrecvsize = setup_recv(length_send,length_recv,sortflag);
+
+  // return size of atom data I will receive
+
+  return nrecvsize;
+}
+
+/* ----------------------------------------------------------------------
+   tell receivers how much data I send and find out who sends to me
+   sendcounts = amount of data I send to each proc in proc_send
+   recvcounts = allocated here, amount of data each proc in proc_recv sends me
+   sortflag = flag for sorting order of received messages by proc ID
+   sets nrecv_proc and allocates proc_recv, request, status
+   return total amount of data I will recv (not including self)
+------------------------------------------------------------------------- */
+
+int Irregular::setup_recv(int *sendcounts, int *&recvcounts, int sortflag)
+{
+  int i;
+
+#if defined(LMP_IRREGULAR_NBX)
+
+  // reuse list of procs I recv from if no proc changed the procs it sends to
+  // the allreduce also ensures that no proc can start sending counts
+  //   of the next plan while I am still receiving counts for this one
+
+  int same = (nsend_proc == (int) send_partners.size());
+  for (i = 0; same && i < nsend_proc; i++)
+    if (proc_send[i] != send_partners[i]) same = 0;
+
+  int allsame;
+  MPI_Allreduce(&same,&allsame,1,MPI_INT,MPI_MIN,world);
+
+  if (allsame) {
+    nrecv_proc = recv_partners.size();
+    proc_recv = new int[nrecv_proc];
+    recvcounts = new int[nrecv_proc];
+    request = new MPI_Request[nrecv_proc];
+    status = new MPI_Status[nrecv_proc];
+
+    for (i = 0; i < nrecv_proc; i++) {
+      proc_recv[i] = recv_partners[i];
+      MPI_Irecv(&recvcounts[i],1,MPI_INT,proc_recv[i],TAG_COUNT,world,&request[i]);
+    }
+    for (i = 0; i < nsend_proc; i++)
+      MPI_Send(&sendcounts[i],1,MPI_INT,proc_send[i],TAG_COUNT,world);
+    if (nrecv_proc) MPI_Waitall(nrecv_proc,request,status);
+
+  } else {
+
+    // sparse data exchange (NBX): synchronous sends complete only once
+    //   they were received, so after all my sends completed I enter a
+    //   non-blocking barrier and keep receiving until all procs have entered it
+    // cost scales with # of procs I exchange data with, not with # of procs
+
+    std::vector<int> procs, counts;
+    std::vector<MPI_Request> sendreq(nsend_proc);
+    for (i = 0; i < nsend_proc; i++)
+      MPI_Issend(&sendcounts[i],1,MPI_INT,proc_send[i],TAG_COUNT,world,&sendreq[i]);
+
+    MPI_Request barrier;
+    MPI_Status tmpstatus;
+    int flag,count;
+    int barrier_active = 0;
+    int done = 0;
+
+    while (!done) {
+      MPI_Iprobe(MPI_ANY_SOURCE,TAG_COUNT,world,&flag,&tmpstatus);
+      if (flag) {
+        MPI_Recv(&count,1,MPI_INT,tmpstatus.MPI_SOURCE,TAG_COUNT,world,MPI_STATUS_IGNORE);
+        procs.push_back(tmpstatus.MPI_SOURCE);
+        counts.push_back(count);
+      }
+      if (barrier_active) MPI_Test(&barrier,&done,MPI_STATUS_IGNORE);
+      else {
+        MPI_Testall(nsend_proc,sendreq.data(),&flag,MPI_STATUSES_IGNORE);
+        if (flag) {
+          MPI_Ibarrier(world,&barrier);
+          barrier_active = 1;
+        }
+      }
+    }
+
+    nrecv_proc = procs.size();
+    proc_recv = new int[nrecv_proc];
+    recvcounts = new int[nrecv_proc];
+    request = new MPI_Request[nrecv_proc];
+    status = new MPI_Status[nrecv_proc];
+    for (i = 0; i < nrecv_proc; i++) {
+      proc_recv[i] = procs[i];
+      recvcounts[i] = counts[i];
+    }
+
+    send_partners.assign(proc_send,proc_send+nsend_proc);
+    recv_partners = procs;
+  }
+
+#else
+
+  // setup for collective comm
+  // work1 = 1 for procs I send a message to, not including self
+  // work2 = 1 for all procs, used for ReduceScatter
+
+  for (i = 0; i < nprocs; i++) {
+    work1[i] = 0;
+    work2[i] = 1;
+  }
+  for (i = 0; i < nsend_proc; i++) work1[proc_send[i]] = 1;
+
+  // nrecv_proc = # of procs I receive messages from, not including self
+  // options for performing ReduceScatter operation
+  // some are more efficient on some machines at big sizes
+
+#ifdef LAMMPS_RS_ALLREDUCE_INPLACE
+  MPI_Allreduce(MPI_IN_PLACE,work1,nprocs,MPI_INT,MPI_SUM,world);
+  nrecv_proc = work1[me];
+#else
+#ifdef LAMMPS_RS_ALLREDUCE
+  MPI_Allreduce(work1,work2,nprocs,MPI_INT,MPI_SUM,world);
+  nrecv_proc = work2[me];
+#else
+  MPI_Reduce_scatter(work1,&nrecv_proc,work2,MPI_INT,MPI_SUM,world);
+#endif
+#endif
+
+  // allocate receive arrays
+
+  proc_recv = new int[nrecv_proc];
+  recvcounts = new int[nrecv_proc];
+  request = new MPI_Request[nrecv_proc];
+  status = new MPI_Status[nrecv_proc];
+
+  for (i = 0; i < nsend_proc; i++) {
+    MPI_Request tmpReq; // Use non-blocking send to avoid possible deadlock
+    MPI_Isend(&sendcounts[i],1,MPI_INT,proc_send[i],TAG_COUNT,world,&tmpReq);
+    MPI_Request_free(&tmpReq); // the MPI_Barrier below marks completion
+  }
+
   for (i = 0; i < nrecv_proc; i++) {
-    MPI_Recv(&length_recv[i],1,MPI_INT,MPI_ANY_SOURCE,0,world,status);
+    MPI_Recv(&recvcounts[i],1,MPI_INT,MPI_ANY_SOURCE,TAG_COUNT,world,status);
     proc_recv[i] = status->MPI_SOURCE;
-    nrecvsize += length_recv[i];
   }
 
-  // sort proc_recv and length_recv by proc ID if requested
-  // useful for debugging to ensure reproducible ordering of received atoms
+  // barrier to ensure all MPI_ANY_SOURCE messages are received
+  // else another proc could proceed to exchange and send to me
+
+  MPI_Barrier(world);
+
+#endif
+
+  int nrecvtotal = 0;
+  for (i = 0; i < nrecv_proc; i++) nrecvtotal += recvcounts[i];
+
+  // sort proc_recv and recvcounts by proc ID if requested
+  // useful for debugging to ensure reproducible ordering of received data
   // invoke by adding final arg = 1 to create_atom() call in migrate_atoms()
 
   if (sortflag) {
     int *order = new int[nrecv_proc];
     int *proc_recv_ordered = new int[nrecv_proc];
-    int *length_recv_ordered = new int[nrecv_proc];
+    int *recvcounts_ordered = new int[nrecv_proc];
 
     for (i = 0; i < nrecv_proc; i++) order[i] = i;
 
@@ -448,24 +557,17 @@ int Irregular::create_atom(int n, int *sizes, int *proclist, int sortflag)
     for (i = 0; i < nrecv_proc; i++) {
       j = order[i];
       proc_recv_ordered[i] = proc_recv[j];
-      length_recv_ordered[i] = length_recv[j];
+      recvcounts_ordered[i] = recvcounts[j];
     }
 
     memcpy(proc_recv,proc_recv_ordered,nrecv_proc*sizeof(int));
-    memcpy(length_recv,length_recv_ordered,nrecv_proc*sizeof(int));
+    memcpy(recvcounts,recvcounts_ordered,nrecv_proc*sizeof(int));
     delete [] order;
     delete [] proc_recv_ordered;
-    delete [] length_recv_ordered;
+    delete [] recvcounts_ordered;
   }
 
-  // barrier to ensure all MPI_ANY_SOURCE messages are received
-  // else another proc could proceed to exchange_atom() and send to me
-
-  MPI_Barrier(world);
-
-  // return size of atom data I will receive
-
-  return nrecvsize;
+  return nrecvtotal;
 }
 
 #if defined(LMP_QSORT)
@@ -581,40 +683,6 @@ int Irregular::create_data(int n, int *proclist, int sortflag)
 {
   int i,m;
 
-  // setup for collective comm
-  // work1 = 1 for procs I send a message to, not including self
-  // work2 = 1 for all procs, used for ReduceScatter
-
-  for (i = 0; i < nprocs; i++) {
-    work1[i] = 0;
-    work2[i] = 1;
-  }
-  for (i = 0; i < n; i++) work1[proclist[i]] = 1;
-  work1[me] = 0;
-
-  // nrecv_proc = # of procs I receive messages from, not including self
-  // options for performing ReduceScatter operation
-  // some are more efficient on some machines at big sizes
-
-#ifdef LAMMPS_RS_ALLREDUCE_INPLACE
-  MPI_Allreduce(MPI_IN_PLACE,work1,nprocs,MPI_INT,MPI_SUM,world);
-  nrecv_proc = work1[me];
-#else
-#ifdef LAMMPS_RS_ALLREDUCE
-  MPI_Allreduce(work1,work2,nprocs,MPI_INT,MPI_SUM,world);
-  nrecv_proc = work2[me];
-#else
-  MPI_Reduce_scatter(work1,&nrecv_proc,work2,MPI_INT,MPI_SUM,world);
-#endif
-#endif
-
-  // allocate receive arrays
-
-  proc_recv = new int[nrecv_proc];
-  num_recv = new int[nrecv_proc];
-  request = new MPI_Request[nrecv_proc];
-  status = new MPI_Status[nrecv_proc];
-
   // work1 = # of datums I send to each proc, including self
   // nsend_proc = # of procs I send messages to, not including self
 
@@ -677,66 +745,19 @@ int Irregular::create_data(int n, int *proclist, int sortflag)
     }
   }
 
-  // tell receivers how much data I send
   // sendmax_proc = largest # of datums I send in a single message
 
   sendmax_proc = 0;
-  for (i = 0; i < nsend_proc; i++) {
-    MPI_Request tmpReq; // Use non-blocking send to avoid possible deadlock
-    MPI_Isend(&num_send[i],1,MPI_INT,proc_send[i],0,world,&tmpReq);
-    MPI_Request_free(&tmpReq); // the MPI_Barrier below marks completion
-    sendmax_proc = MAX(sendmax_proc,num_send[i]);
-  }
+  for (i = 0; i < nsend_proc; i++) sendmax_proc = MAX(sendmax_proc,num_send[i]);
 
-  // receive incoming messages
+  // tell receivers how much data I send
   // proc_recv = procs I recv from
   // num_recv = # of datums each proc sends me
   // nrecvdatum = total # of datums I recv
 
-  int nrecvdatum = 0;
-  for (i = 0; i < nrecv_proc; i++) {
-    MPI_Recv(&num_recv[i],1,MPI_INT,MPI_ANY_SOURCE,0,world,status);
-    proc_recv[i] = status->MPI_SOURCE;
-    nrecvdatum += num_recv[i];
-  }
+  int nrecvdatum = setup_recv(num_send,num_recv,sortflag);
   nrecvdatum += num_self;
 
-  // sort proc_recv and num_recv by proc ID if requested
-  // useful for debugging to ensure reproducible ordering of received datums
-
-  if (sortflag) {
-    int *order = new int[nrecv_proc];
-    int *proc_recv_ordered = new int[nrecv_proc];
-    int *num_recv_ordered = new int[nrecv_proc];
-
-    for (i = 0; i < nrecv_proc; i++) order[i] = i;
-
-#if defined(LMP_QSORT)
-    proc_recv_copy = proc_recv;
-    qsort(order,nrecv_proc,sizeof(int),compare_standalone);
-#else
-    utils::merge_sort(order,nrecv_proc,(void *)proc_recv,compare_standalone);
-#endif
-
-    int j;
-    for (i = 0; i < nrecv_proc; i++) {
-      j = order[i];
-      proc_recv_ordered[i] = proc_recv[j];
-      num_recv_ordered[i] = num_recv[j];
-    }
-
-    memcpy(proc_recv,proc_recv_ordered,nrecv_proc*sizeof(int));
-    memcpy(num_recv,num_recv_ordered,nrecv_proc*sizeof(int));
-    delete [] order;
-    delete [] proc_recv_ordered;
-    delete [] num_recv_ordered;
-  }
-
-  // barrier to ensure all MPI_ANY_SOURCE messages are received
-  // else another proc could proceed to exchange_data() and send to me
-
-  MPI_Barrier(world);
-
   // return # of datums I will receive
 
   return nrecvdatum;
@@ -754,39 +775,6 @@ int Irregular::create_data_grouped(int n, int *procs, int sortflag)
 {
   int i,j,k,m;
 
-  // setup for collective comm
-  // work1 = # of datums I send to each proc, set self to 0
-  // work2 = 1 for all procs, used for ReduceScatter
-
-  for (i = 0; i < nprocs; i++) {
-    work1[i] = procs[i];
-    work2[i] = 1;
-  }
-  work1[me] = 0;
-
-  // nrecv_proc = # of procs I receive messages from, not including self
-  // options for performing ReduceScatter operation
-  // some are more efficient on some machines at big sizes
-
-#ifdef LAMMPS_RS_ALLREDUCE_INPLACE
-  MPI_Allreduce(MPI_IN_PLACE,work1,nprocs,MPI_INT,MPI_SUM,world);
-  nrecv_proc = work1[me];
-#else
-#ifdef LAMMPS_RS_ALLREDUCE
-  MPI_Allreduce(work1,work2,nprocs,MPI_INT,MPI_SUM,world);
-  nrecv_proc = work2[me];
-#else
-  MPI_Reduce_scatter(work1,&nrecv_proc,work2,MPI_INT,MPI_SUM,world);
-#endif
-#endif
-
-  // allocate receive arrays
-
-  proc_recv = new int[nrecv_proc];
-  num_recv = new int[nrecv_proc];
-  request = new MPI_Request[nrecv_proc];
-  status = new MPI_Status[nrecv_proc];
-
   // work1 = # of datums I send to each proc, including self
   // nsend_proc = # of procs I send messages to, not including self
 
@@ -851,65 +839,19 @@ int Irregular::create_data_grouped(int n, int *procs, int sortflag)
     }
   }
 
-  // tell receivers how much data I send
   // sendmax_proc = largest # of datums I send in a single message
 
   sendmax_proc = 0;
-  for (i = 0; i < nsend_proc; i++) {
-    MPI_Request tmpReq; // Use non-blocking send to avoid possible deadlock
-    MPI_Isend(&num_send[i],1,MPI_INT,proc_send[i],0,world,&tmpReq);
-    MPI_Request_free(&tmpReq); // the MPI_Barrier below marks completion
-    sendmax_proc = MAX(sendmax_proc,num_send[i]);
-  }
+  for (i = 0; i < nsend_proc; i++) sendmax_proc = MAX(sendmax_proc,num_send[i]);
 
-  // receive incoming messages
+  // tell receivers how much data I send
   // proc_recv = procs I recv from
   // num_recv = # of datums each proc sends me
   // nrecvdatum = total # of datums I recv
 
-  int nrecvdatum = 0;
-  for (i = 0; i < nrecv_proc; i++) {
-    MPI_Recv(&num_recv[i],1,MPI_INT,MPI_ANY_SOURCE,0,world,status);
-    proc_recv[i] = status->MPI_SOURCE;
-    nrecvdatum += num_recv[i];
-  }
+  int nrecvdatum = setup_recv(num_send,num_recv,sortflag);
   nrecvdatum += num_self;
 
-  // sort proc_recv and num_recv by proc ID if requested
-  // useful for debugging to ensure reproducible ordering of received datums
-
-  if (sortflag) {
-    int *order = new int[nrecv_proc];
-    int *proc_recv_ordered = new int[nrecv_proc];
-    int *num_recv_ordered = new int[nrecv_proc];
-
-    for (i = 0; i < nrecv_proc; i++) order[i] = i;
-
-#if defined(LMP_QSORT)
-    proc_recv_copy = proc_recv;
-    qsort(order,nrecv_proc,sizeof(int),compare_standalone);
-#else
-    utils::merge_sort(order,nrecv_proc,(void *)proc_recv,compare_standalone);
-#endif
-
-    for (i = 0; i < nrecv_proc; i++) {
-      j = order[i];
-      proc_recv_ordered[i] = proc_recv[j];
-      num_recv_ordered[i] = num_recv[j];
-    }
-
-    memcpy(proc_recv,proc_recv_ordered,nrecv_proc*sizeof(int));
-    memcpy(num_recv,num_recv_ordered,nrecv_proc*sizeof(int));
-    delete [] order;
-    delete [] proc_recv_ordered;
-    delete [] num_recv_ordered;
-  }
-
-  // barrier to ensure all MPI_ANY_SOURCE messages are received
-  // else another proc could proceed to exchange_data() and send to me
-
-  MPI_Barrier(world);
-
   // return # of datums I will receive
 
   return nrecvdatum;
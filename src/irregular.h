@@ -16,6 +16,15 @@
 
 #include "pointers.h"
 
+#include <vector>
+
+// use sparse data exchange to set up plans unless the collective variant is requested
+
+#if defined(MPI_VERSION) && (MPI_VERSION > 2) && !defined(MPI_STUBS) && \
+    !defined(LAMMPS_IRREGULAR_COLLECTIVE)
+#define LMP_IRREGULAR_NBX 1
+#endif
+
 namespace LAMMPS_NS {
 
 class Irregular : protected Pointers {
@@ -82,11 +91,17 @@ class Irregular : protected Pointers {
   int num_self;       // # of datums to copy to self
   int *index_self;    // list of which datums to copy to self
 
+  // partner lists of the last plan, reused if no proc changes its partners
+
+  std::vector<int> send_partners;
+  std::vector<int> recv_partners;
+
   // private methods
 
   int create_atom(int, int *, int *, int);
   void exchange_atom(double *, int *, double *);
   void destroy_atom();
+  int setup_recv(int *, int *&, int);
 
   int binary(double, int, double *);
 
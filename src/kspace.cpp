@@ -19,10 +19,13 @@
 #include "comm.h"
 #include "domain.h"
 #include "error.h"
+#include "fix_store_atom.h"
 #include "force.h"
 #include "memory.h"
+#include "modify.h"
 #include "pair.h"
 #include "suffix.h"
+#include "update.h"
 
 #include <cmath>
 #include <cstring>
@@ -52,6 +55,17 @@ KSpace::KSpace(LAMMPS *lmp) : Pointers(lmp)
   minorder = 2;
   overlap_allowed = 1;
   fftbench = 0;
+  fft_pipeline = 0;
+  fft_procs = 0;
+  fft_tune = 0;
+  mts_every = 1;
+  mts_mode = MTS_IMPULSE;
+  maxmts = 0;
+  fmts = nullptr;
+  id_mts = nullptr;
+  fix_mts = nullptr;
+  mts_noff = mts_nextra = 0;
+  mts_warned = 0;
 
   // default to using MPI collectives for FFT/remap only on IBM BlueGene
 
@@ -158,6 +172,10 @@ KSpace::~KSpace()
   memory->destroy(vatom);
   memory->destroy(gcons);
   memory->destroy(dgcons);
+  memory->destroy(fmts);
+
+  if (id_mts && modify->nfix) modify->delete_fix(id_mts);
+  delete[] id_mts;
 }
 
 /* ----------------------------------------------------------------------
@@ -186,6 +204,133 @@ void KSpace::compute_dummy(int eflag, int vflag)
   ev_init(eflag,vflag);
 }
 
+/* ----------------------------------------------------------------------
+   check settings for multiple time stepping of kspace forces
+   create fix to store per-atom kspace forces between updates if needed
+   called by Verlet::init()
+------------------------------------------------------------------------- */
+
+void KSpace::mts_init()
+{
+  if (mts_every == 1) return;
+
+  mts_noff = mts_nextra = 0;
+  mts_warned = 0;
+
+  if (suffix_flag & (Suffix::GPU | Suffix::OMP | Suffix::INTEL | Suffix::KOKKOS))
+    error->all(FLERR,"Kspace_modify mts is not compatible with accelerated kspace styles");
+  if (dipoleflag || spinflag)
+    error->all(FLERR,"Kspace_modify mts is not compatible with dipole or spin kspace styles");
+
+  if (mts_mode == MTS_EXTRAPOLATE) {
+
+    // tip4p styles add forces to ghost atoms, which cannot be stored across reneighboring
+
+    if (tip4pflag)
+      error->all(FLERR,"Kspace_modify mts extrapolate is not compatible with TIP4P kspace styles");
+
+    if (!id_mts) id_mts = utils::strdup("KSPACE_MTS_STORE");
+    fix_mts = dynamic_cast<FixStoreAtom *>(modify->get_fix_by_id(id_mts));
+    if (!fix_mts)
+      fix_mts = dynamic_cast<FixStoreAtom *>
+        (modify->add_fix(fmt::format("{} all STORE/ATOM 3 0 0 0",id_mts)));
+  }
+}
+
+/* ----------------------------------------------------------------------
+   compute long-range forces only every mts_every steps
+   on those steps either scale kspace forces by mts_every (impulse)
+     or store them and add the stored forces on the following steps (extrapolate)
+   on other steps with energy/virial tally, compute kspace energy/virial
+     but keep the forces of the impulse or extrapolation scheme
+   during setup, always compute and store forces for extrapolation
+------------------------------------------------------------------------- */
+
+void KSpace::compute_mts(int eflag, int vflag)
+{
+  int i;
+
+  const int nlocal = atom->nlocal;
+  const int nall = nlocal + atom->nghost;
+  const int every = mts_every;
+  const int mtsflag = (update->ntimestep % every == 0) ||
+    (update->setupflag && mts_mode == MTS_EXTRAPOLATE);
+
+  double **f = atom->f;
+
+  // energy or virial requested on most steps in between, e.g. by thermo
+  //   output every step, a barostat, or fix ave/time of compute pe,
+  //   forces kspace evaluation on those steps and removes any speedup
+
+  if (!mtsflag && !update->setupflag) {
+    mts_noff++;
+    if (eflag || vflag) mts_nextra++;
+    if (!mts_warned && (mts_noff >= 2*every) && (2*mts_nextra > mts_noff)) {
+      if (comm->me == 0)
+        error->warning(FLERR,"Kspace_modify mts {} has no effect: long-range energy or virial "
+                       "is required on most timesteps, e.g. by thermo output, a barostat, "
+                       "or a compute pe or pressure used every step",every);
+      mts_warned = 1;
+    }
+  }
+
+  if (!mtsflag && !eflag && !vflag) {
+    if (mts_mode == MTS_EXTRAPOLATE) {
+      double **fk = fix_mts->astore;
+      for (i = 0; i < nlocal; i++) {
+        f[i][0] += fk[i][0];
+        f[i][1] += fk[i][1];
+        f[i][2] += fk[i][2];
+      }
+    }
+    return;
+  }
+
+  // save forces so the kspace contribution can be extracted after compute()
+
+  if (atom->nmax > maxmts) {
+    memory->destroy(fmts);
+    maxmts = atom->nmax;
+    memory->create(fmts,maxmts,3,"kspace:fmts");
+  }
+  for (i = 0; i < nall; i++) {
+    fmts[i][0] = f[i][0];
+    fmts[i][1] = f[i][1];
+    fmts[i][2] = f[i][2];
+  }
+
+  compute(eflag,vflag);
+
+  if (mts_mode == MTS_IMPULSE) {
+    const double factor = mtsflag ? every : 0.0;
+    for (i = 0; i < nall; i++) {
+      f[i][0] = fmts[i][0] + factor*(f[i][0]-fmts[i][0]);
+      f[i][1] = fmts[i][1] + factor*(f[i][1]-fmts[i][1]);
+      f[i][2] = fmts[i][2] + factor*(f[i][2]-fmts[i][2]);
+    }
+  } else {
+    double **fk = fix_mts->astore;
+    if (mtsflag) {
+      for (i = 0; i < nlocal; i++) {
+        fk[i][0] = f[i][0] - fmts[i][0];
+        fk[i][1] = f[i][1] - fmts[i][1];
+        fk[i][2] = f[i][2] - fmts[i][2];
+      }
+    } else {
+      for (i = 0; i < nlocal; i++) {
+        f[i][0] = fmts[i][0] + fk[i][0];
+        f[i][1] = fmts[i][1] + fk[i][1];
+        f[i][2] = fmts[i][2] + fk[i][2];
+      }
+      for (i = nlocal; i < nall; i++) {
+        f[i][0] = fmts[i][0];
+        f[i][1] = fmts[i][1];
+        f[i][2] = fmts[i][2];
+      }
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    check that pair style is compatible with long-range solver
 ------------------------------------------------------------------------- */
@@ -549,6 +694,32 @@ void KSpace::modify_params(int narg, char **arg)
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       collective_flag = utils::logical(FLERR,arg[iarg+1],false,lmp);
       iarg += 2;
+    } else if (strcmp(arg[iarg],"fft/pipeline") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      fft_pipeline = utils::logical(FLERR,arg[iarg+1],false,lmp);
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"fft/procs") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      if (strcmp(arg[iarg+1],"all") == 0) fft_procs = 0;
+      else fft_procs = utils::inumeric(FLERR,arg[iarg+1],false,lmp);
+      if (fft_procs < 0) error->all(FLERR,"Illegal kspace_modify fft/procs value");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"fft/tune") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      fft_tune = utils::logical(FLERR,arg[iarg+1],false,lmp);
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"mts") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
+      mts_every = utils::inumeric(FLERR,arg[iarg+1],false,lmp);
+      if (mts_every <= 0) error->all(FLERR,"Illegal kspace_modify mts value");
+      iarg += 2;
+      if (iarg < narg && strcmp(arg[iarg],"impulse") == 0) {
+        mts_mode = MTS_IMPULSE;
+        iarg++;
+      } else if (iarg < narg && strcmp(arg[iarg],"extrapolate") == 0) {
+        mts_mode = MTS_EXTRAPOLATE;
+        iarg++;
+      }
     } else if (strcmp(arg[iarg],"diff") == 0) {
       if (iarg+2 > narg) error->all(FLERR,"Illegal kspace_modify command");
       if (strcmp(arg[iarg+1],"ad") == 0) differentiation_flag = 1;
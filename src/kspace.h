@@ -96,10 +96,17 @@ class KSpace : protected Pointers {
   int compute_flag;       // 0 if skip compute()
   int fftbench;           // 0 if skip FFT timing
   int collective_flag;    // 1 if use MPI collectives for FFT/remap
+  int fft_pipeline;       // 1 if overlap 1d FFTs with FFT remaps
+  int fft_procs;          // # of procs doing the FFTs, 0 = all
+  int fft_tune;           // 1 if choose fft_procs and fft_pipeline by timing
   int stagger_flag;       // 1 if using staggered PPPM grids
+  int mts_every;          // compute long-range forces every this many steps
+  int mts_mode;           // MTS_IMPULSE or MTS_EXTRAPOLATE
 
   double splittol;    // tolerance for when to truncate splitting
 
+  enum { MTS_IMPULSE, MTS_EXTRAPOLATE };
+
   KSpace(class LAMMPS *);
   ~KSpace() override;
   void two_charge();
@@ -107,6 +114,8 @@ class KSpace : protected Pointers {
   void modify_params(int, char **);
   void *extract(const char *);
   void compute_dummy(int, int);
+  void mts_init();
+  void compute_mts(int, int);
 
   // triclinic
 
@@ -197,6 +206,14 @@ class KSpace : protected Pointers {
   double qsum, qsqsum, q2;
   double **gcons, **dgcons;    // accumulated per-atom energy/virial
 
+  int maxmts;                     // allocated length of fmts
+  double **fmts;                  // forces before kspace compute in compute_mts()
+  char *id_mts;                   // ID of fix storing forces for MTS extrapolation
+  class FixStoreAtom *fix_mts;    // fix storing forces for MTS extrapolation
+  bigint mts_noff;                // # of steps in this run that are not multiples of mts_every
+  bigint mts_nextra;              // # of those steps with kspace compute for energy/virial
+  int mts_warned;                 // 1 if warned about kspace being computed on most steps
+
   int evflag, evflag_atom;
   int eflag_either, eflag_global, eflag_atom;
   int vflag_either, vflag_global, vflag_atom;
@@ -25,6 +25,7 @@
 #include "input.h"
 #include "memory.h"
 #include "region.h"
+#include "timer.h"
 #include "update.h"
 #include "variable.h"
 
@@ -247,6 +248,13 @@ void Modify::init()
   n_post_force_any = n_post_force + n_post_force_group;
   n_post_force_respa_any = n_post_force_respa + n_post_force_group;
 
+  // register fixes with fine grained timers, if enabled
+  // only the callbacks of regular time steps are timed,
+  //   the setup, r-RESPA and minimizer variants are not
+
+  fix_timer.resize(nfix);
+  for (i = 0; i < nfix; i++) fix_timer[i] = timer->add_detail("fix", fix[i]->id, fix[i]->style);
+
   // create list of computes that store invocation times
 
   list_init_compute();
@@ -388,8 +396,12 @@ void Modify::setup_pre_reverse(int eflag, int vflag)
 
 void Modify::initial_integrate(int vflag)
 {
-  for (int i = 0; i < n_initial_integrate; i++)
-    fix[list_initial_integrate[i]]->initial_integrate(vflag);
+  for (int i = 0; i < n_initial_integrate; i++) {
+    const int ifix = list_initial_integrate[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->initial_integrate(vflag);
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -398,7 +410,12 @@ void Modify::initial_integrate(int vflag)
 
 void Modify::post_integrate()
 {
-  for (int i = 0; i < n_post_integrate; i++) fix[list_post_integrate[i]]->post_integrate();
+  for (int i = 0; i < n_post_integrate; i++) {
+    const int ifix = list_post_integrate[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->post_integrate();
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -407,7 +424,12 @@ void Modify::post_integrate()
 
 void Modify::pre_exchange()
 {
-  for (int i = 0; i < n_pre_exchange; i++) fix[list_pre_exchange[i]]->pre_exchange();
+  for (int i = 0; i < n_pre_exchange; i++) {
+    const int ifix = list_pre_exchange[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->pre_exchange();
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -416,7 +438,12 @@ void Modify::pre_exchange()
 
 void Modify::pre_neighbor()
 {
-  for (int i = 0; i < n_pre_neighbor; i++) fix[list_pre_neighbor[i]]->pre_neighbor();
+  for (int i = 0; i < n_pre_neighbor; i++) {
+    const int ifix = list_pre_neighbor[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->pre_neighbor();
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -425,7 +452,12 @@ void Modify::pre_neighbor()
 
 void Modify::post_neighbor()
 {
-  for (int i = 0; i < n_post_neighbor; i++) fix[list_post_neighbor[i]]->post_neighbor();
+  for (int i = 0; i < n_post_neighbor; i++) {
+    const int ifix = list_post_neighbor[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->post_neighbor();
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -434,7 +466,12 @@ void Modify::post_neighbor()
 
 void Modify::pre_force(int vflag)
 {
-  for (int i = 0; i < n_pre_force; i++) fix[list_pre_force[i]]->pre_force(vflag);
+  for (int i = 0; i < n_pre_force; i++) {
+    const int ifix = list_pre_force[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->pre_force(vflag);
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 /* ----------------------------------------------------------------------
    pre_reverse call, only for relevant fixes
@@ -442,7 +479,12 @@ void Modify::pre_force(int vflag)
 
 void Modify::pre_reverse(int eflag, int vflag)
 {
-  for (int i = 0; i < n_pre_reverse; i++) fix[list_pre_reverse[i]]->pre_reverse(eflag, vflag);
+  for (int i = 0; i < n_pre_reverse; i++) {
+    const int ifix = list_pre_reverse[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->pre_reverse(eflag, vflag);
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -454,11 +496,21 @@ void Modify::pre_reverse(int eflag, int vflag)
 void Modify::post_force(int vflag)
 {
   if (n_post_force_group) {
-    for (int i = 0; i < n_post_force_group; i++) fix[list_post_force_group[i]]->post_force(vflag);
+    for (int i = 0; i < n_post_force_group; i++) {
+      const int ifix = list_post_force_group[i];
+      const double tstart = timer->detail_start();
+      fix[ifix]->post_force(vflag);
+      timer->detail_stop(fix_timer[ifix], tstart);
+    }
   }
 
   if (n_post_force) {
-    for (int i = 0; i < n_post_force; i++) fix[list_post_force[i]]->post_force(vflag);
+    for (int i = 0; i < n_post_force; i++) {
+      const int ifix = list_post_force[i];
+      const double tstart = timer->detail_start();
+      fix[ifix]->post_force(vflag);
+      timer->detail_stop(fix_timer[ifix], tstart);
+    }
   }
 }
 
@@ -468,7 +520,12 @@ void Modify::post_force(int vflag)
 
 void Modify::final_integrate()
 {
-  for (int i = 0; i < n_final_integrate; i++) fix[list_final_integrate[i]]->final_integrate();
+  for (int i = 0; i < n_final_integrate; i++) {
+    const int ifix = list_final_integrate[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->final_integrate();
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -478,8 +535,13 @@ void Modify::final_integrate()
 
 void Modify::end_of_step()
 {
-  for (int i = 0; i < n_end_of_step; i++)
-    if (update->ntimestep % end_of_step_every[i] == 0) fix[list_end_of_step[i]]->end_of_step();
+  for (int i = 0; i < n_end_of_step; i++) {
+    if (update->ntimestep % end_of_step_every[i]) continue;
+    const int ifix = list_end_of_step[i];
+    const double tstart = timer->detail_start();
+    fix[ifix]->end_of_step();
+    timer->detail_stop(fix_timer[ifix], tstart);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -173,6 +173,8 @@ class Modify : protected Pointers {
 
   int *end_of_step_every;
 
+  std::vector<int> fix_timer;    // index of fine grained timer for each fix
+
   int n_timeflag;    // list of computes that store time invocation
   int *list_timeflag;
 
@@ -21,6 +21,8 @@
 #include "my_page.h"
 #include "memory.h"
 
+#include <vector>
+
 using namespace LAMMPS_NS;
 
 #define PGDELTA 1
@@ -36,6 +38,7 @@ NeighList::NeighList(LAMMPS *lmp) : Pointers(lmp)
   inum = gnum = 0;
   ilist = nullptr;
   numneigh = nullptr;
+  numneigh_local = nullptr;
   firstneigh = nullptr;
 
   // defaults, but may be reset by post_constructor()
@@ -43,6 +46,7 @@ NeighList::NeighList(LAMMPS *lmp) : Pointers(lmp)
   occasional = 0;
   ghost = 0;
   ssa = 0;
+  split = 0;
   history = 0;
   respaouter = 0;
   respamiddle = 0;
@@ -105,6 +109,7 @@ NeighList::~NeighList()
     memory->sfree(firstneigh);
     delete [] ipage;
   }
+  memory->destroy(numneigh_local);
 
   if (respainner) {
     memory->destroy(ilist_inner);
@@ -141,6 +146,7 @@ void NeighList::post_constructor(NeighRequest *nq)
   occasional = nq->occasional;
   ghost = nq->ghost;
   ssa = nq->ssa;
+  split = nq->split;
   history = nq->history;
   respaouter = nq->respaouter;
   respamiddle = nq->respamiddle;
@@ -226,6 +232,10 @@ void NeighList::grow(int nlocal, int nall)
   memory->create(numneigh,maxatom,"neighlist:numneigh");
   firstneigh = (int **) memory->smalloc(maxatom*sizeof(int *),
                                         "neighlist:firstneigh");
+  if (split) {
+    memory->destroy(numneigh_local);
+    memory->create(numneigh_local,maxatom,"neighlist:numneigh_local");
+  }
 
   if (respainner) {
     memory->destroy(ilist_inner);
@@ -285,6 +295,7 @@ void NeighList::print_attributes()
   printf("  %d = kokkos host\n",rq->kokkos_host);
   printf("  %d = kokkos device\n",rq->kokkos_device);
   printf("  %d = ssa flag\n",ssa);
+  printf("  %d = split flag\n",split);
   printf("\n");
   printf("  %d = skip flag\n",rq->skip);
   printf("  %d = off2on\n",rq->off2on);
@@ -307,6 +318,7 @@ double NeighList::memory_usage()
   bytes += memory->usage(ilist,maxatom);
   bytes += memory->usage(numneigh,maxatom);
   bytes += (double)maxatom * sizeof(int *);
+  if (split) bytes += memory->usage(numneigh_local,maxatom);
 
   int nmypage = comm->nthreads;
 
@@ -337,3 +349,31 @@ double NeighList::memory_usage()
 
   return bytes;
 }
+
+/* ----------------------------------------------------------------------
+   reorder neighbors of each I atom so that owned J atoms come first
+   numneigh_local = # of owned J atoms, relative order is preserved
+   allows a pair style to compute owned pairs while ghosts are in transit
+------------------------------------------------------------------------- */
+
+void NeighList::split_local()
+{
+  const int nlocal = atom->nlocal;
+  std::vector<int> ghosts;
+
+  for (int ii = 0; ii < inum; ii++) {
+    const int i = ilist[ii];
+    int *jlist = firstneigh[i];
+    const int jnum = numneigh[i];
+
+    int n = 0;
+    ghosts.clear();
+    for (int jj = 0; jj < jnum; jj++) {
+      const int j = jlist[jj];
+      if ((j & NEIGHMASK) < nlocal) jlist[n++] = j;
+      else ghosts.push_back(j);
+    }
+    numneigh_local[i] = n;
+    for (const auto &j : ghosts) jlist[n++] = j;
+  }
+}
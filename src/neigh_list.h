@@ -37,6 +37,7 @@ class NeighList : protected Pointers {
   int occasional;     // 0 if build every reneighbor, 1 if not
   int ghost;          // 1 if list stores neighbors of ghosts
   int ssa;            // 1 if list stores Shardlow data
+  int split;          // 1 if owned J neighbors are stored before ghost J neighbors
   int history;        // 1 if there is neigh history (FixNeighHist)
   int respaouter;     // 1 if list is a rRespa outer list
   int respamiddle;    // 1 if there is also a rRespa middle list
@@ -54,7 +55,8 @@ class NeighList : protected Pointers {
   int *ilist;          // local indices of I atoms
   int *numneigh;       // # of J neighbors for each I atom
   int **firstneigh;    // ptr to 1st J int value of each I atom
-  int maxatom;         // size of allocated per-atom arrays
+  int *numneigh_local;    // # of owned J neighbors for each I atom, if split is set
+  int maxatom;            // size of allocated per-atom arrays
 
   int pgsize;            // size of each page
   int oneatom;           // max size for one atom
@@ -107,6 +109,7 @@ class NeighList : protected Pointers {
   void post_constructor(class NeighRequest *);
   void setup_pages(int, int);    // setup page data structures
   void grow(int, int);           // grow all data structs
+  void split_local();            // reorder neighbors so owned J atoms come first
   void print_attributes();       // debug routine
   int get_maxlocal() { return maxatom; }
   double memory_usage();
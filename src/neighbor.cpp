@@ -1520,6 +1520,11 @@ void Neighbor::morph_copy_trim()
 
       if (irq->ghost && !jrq->ghost) continue;
 
+      // do not copy to or from a split list
+      // b/c its per-atom count of owned neighbors is not shared
+
+      if (irq->split || jrq->split) continue;
+
       // do not copy from a list with respa middle/inner
       // b/c its outer list will not be complete
 
@@ -2455,6 +2460,7 @@ void Neighbor::build(int topoflag)
       lists[m]->grow(nlocal,nall);
     neigh_pair[m]->build_setup();
     neigh_pair[m]->build(lists[m]);
+    if (lists[m]->split) lists[m]->split_local();
   }
 
   // build topology lists for bonds/angles/etc
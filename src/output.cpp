@@ -29,6 +29,7 @@
 #include "memory.h"
 #include "modify.h"
 #include "thermo.h"
+#include "timer.h"
 #include "update.h"
 #include "variable.h"
 #include "write_restart.h"
@@ -95,6 +96,10 @@ Output::Output(LAMMPS *lmp) : Pointers(lmp)
   var_restart_single = var_restart_double = nullptr;
   restart = nullptr;
 
+  restart_base = nullptr;
+  restart_base_step = restart_base_offset = 0;
+  restart_base_nchunk = restart_ndelta = 0;
+
   dump_map = new DumpCreatorMap();
 
 #define DUMP_CLASS
@@ -132,6 +137,7 @@ Output::~Output()
   delete[] var_restart_single;
   delete[] var_restart_double;
   delete restart;
+  delete[] restart_base;
 
   delete dump_map;
 }
@@ -150,6 +156,9 @@ void Output::init()
   }
 
   for (int i = 0; i < ndump; i++) dump[i]->init();
+  dump_timer.resize(ndump);
+  for (int i = 0; i < ndump; i++)
+    dump_timer[i] = timer->add_detail("dump",dump[i]->id,dump[i]->style);
   any_time_dumps = 0;
   for (int i = 0; i < ndump; i++) {
     if (mode_dump[i]) any_time_dumps = 1;
@@ -387,7 +396,9 @@ void Output::write(bigint ntimestep)
         // perform dump
         // set next_dump and next_time_dump
 
+        const double tstart = timer->detail_start();
         dump[idump]->write();
+        timer->detail_stop(dump_timer[idump], tstart);
         last_dump[idump] = ntimestep;
         calculate_next_dump(WRITE,idump,ntimestep);
 
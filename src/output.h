@@ -66,6 +66,12 @@ class Output : protected Pointers {
   char *restart2a, *restart2b;    // names of double restart files
   class WriteRestart *restart;    // class for writing restart files
 
+  char *restart_base;             // base file of incremental restart files
+  bigint restart_base_step;       // timestep of base file
+  bigint restart_base_offset;     // file offset of per-atom data in base file
+  int restart_base_nchunk;        // # of per-proc chunks in base file
+  int restart_ndelta;             // # of incremental files written since base
+
   typedef Dump *(*DumpCreator)(LAMMPS *, int, char **);
   typedef std::map<std::string, DumpCreator> DumpCreatorMap;
   DumpCreatorMap *dump_map;
@@ -100,6 +106,7 @@ class Output : protected Pointers {
 
  private:
   std::vector<Dump *> dump_list;
+  std::vector<int> dump_timer;    // index of fine grained timer for each dump
   void calculate_next_dump(int, int, bigint);
 };
 
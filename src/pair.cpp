@@ -28,6 +28,7 @@
 #include "math_const.h"
 #include "math_special.h"
 #include "memory.h"
+#include "neigh_list.h"
 #include "neighbor.h"
 #include "suffix.h"
 #include "update.h"
@@ -73,6 +74,7 @@ Pair::Pair(LAMMPS *lmp) :
   single_hessian_enable = 0;
   restartinfo = 1;
   respa_enable = 0;
+  overlap_enable = 0;
   one_coeff = 0;
   no_virial_fdotr_compute = 0;
   writedata = 0;
@@ -2000,6 +2002,30 @@ void Pair::hessian_twobody(double fforce, double dfac, double delr[3], double ph
     }
   }
 }
+/* ----------------------------------------------------------------------
+   add estimated relative cost of computing forces for each owned atom to cost
+   used by balance weight pair, only called between the last force computation
+     and the next exchange of atoms, so neighbor lists match the owned atoms
+   default: # of neighbors in the neighbor list of the pair style
+   return 1 if an estimate was added, 0 if not available
+------------------------------------------------------------------------- */
+
+int Pair::cost_atom(double *cost)
+{
+  if (!list) return 0;
+
+  const int nlocal = atom->nlocal;
+  const int inum = list->inum;
+  int *ilist = list->ilist;
+  int *numneigh = list->numneigh;
+
+  for (int ii = 0; ii < inum; ii++) {
+    const int i = ilist[ii];
+    if (i < nlocal) cost[i] += numneigh[i];
+  }
+  return 1;
+}
+
 /* ---------------------------------------------------------------------- */
 
 double Pair::memory_usage()
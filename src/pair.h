@@ -56,6 +56,7 @@ class Pair : protected Pointers {
   int single_hessian_enable;      // 1 if single_hessian() routine exists
   int restartinfo;                // 1 if pair style writes restart info
   int respa_enable;               // 1 if inner/middle/outer rRESPA routines
+  int overlap_enable;             // 1 if interior/boundary routines for comm overlap
   int one_coeff;                  // 1 if allows only one coeff * * call
   int manybody_flag;              // 1 if a manybody potential
   int unit_convert_flag;          // value != 0 indicates support for unit conversion.
@@ -156,6 +157,8 @@ class Pair : protected Pointers {
   virtual void compute_inner() {}
   virtual void compute_middle() {}
   virtual void compute_outer(int, int) {}
+  virtual void compute_interior(int, int) {}
+  virtual void compute_boundary(int, int) {}
 
   virtual double single(int, int, int, int, double, double, double, double &fforce)
   {
@@ -227,6 +230,7 @@ class Pair : protected Pointers {
   virtual void transfer_history(double *, double *, int, int) {}
   virtual double atom2cut(int) { return 0.0; }
   virtual double radii2cut(double, double) { return 0.0; }
+  virtual int cost_atom(double *);
 
   // management of callbacks to be run from ev_tally()
 
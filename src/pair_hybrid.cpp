@@ -25,6 +25,7 @@
 #include "pair.h"
 #include "respa.h"
 #include "suffix.h"
+#include "timer.h"
 #include "update.h"
 
 #include <cstring>
@@ -130,9 +131,11 @@ void PairHybrid::compute(int eflag, int vflag)
       // outerflag is set and sub-style has a compute_outer() method
 
       if (styles[m]->compute_flag == 0) continue;
+      const double tstart = timer->detail_start();
       if (outerflag && styles[m]->respa_enable)
         styles[m]->compute_outer(eflag,vflag_substyle);
       else styles[m]->compute(eflag,vflag_substyle);
+      timer->detail_stop(style_timer[m],tstart);
     }
 
     restore_special(saved_special);
@@ -638,6 +641,16 @@ void PairHybrid::init_style()
 
   for (istyle = 0; istyle < nstyles; istyle++) styles[istyle]->init_style();
 
+  // register sub-styles with fine grained timers, if enabled
+  // use sub-style name with instance number as ID
+
+  style_timer.resize(nstyles);
+  for (istyle = 0; istyle < nstyles; istyle++) {
+    std::string name = keywords[istyle];
+    if (multiple[istyle]) name += fmt::format(":{}",multiple[istyle]);
+    style_timer[istyle] = timer->add_detail("pair",name,keywords[istyle]);
+  }
+
   // create skip lists inside each pair neigh request
   // any kind of list can have its skip flag set in this loop
 
@@ -1208,6 +1221,19 @@ double PairHybrid::radii2cut(double r1, double r2)
   return cut;
 }
 
+/* ----------------------------------------------------------------------
+   sum cost estimates of all sub-styles
+   return 1 if any sub-style provided one
+------------------------------------------------------------------------- */
+
+int PairHybrid::cost_atom(double *cost)
+{
+  int flag = 0;
+  for (int m = 0; m < nstyles; m++)
+    if (styles[m]->cost_atom(cost)) flag = 1;
+  return flag;
+}
+
 /* ----------------------------------------------------------------------
    memory usage of each sub-style
 ------------------------------------------------------------------------- */
@@ -55,6 +55,7 @@ class PairHybrid : public Pair {
 
   void modify_params(int narg, char **arg) override;
   double memory_usage() override;
+  int cost_atom(double *) override;
 
   void compute_inner() override;
   void compute_middle() override;
@@ -85,6 +86,7 @@ class PairHybrid : public Pair {
   double **special_lj;      // list of per style LJ exclusion factors
   double **special_coul;    // list of per style Coulomb exclusion factors
   int *compute_tally;       // list of on/off flags for tally computes
+  std::vector<int> style_timer;    // index of fine grained timer for each sub-style
 
   void allocate();
   void flags();
@@ -39,6 +39,7 @@ using namespace MathConst;
 PairLJCut::PairLJCut(LAMMPS *lmp) : Pair(lmp)
 {
   respa_enable = 1;
+  overlap_enable = 1;
   born_matrix_enable = 1;
   writedata = 1;
 }
@@ -138,6 +139,101 @@ void PairLJCut::compute(int eflag, int vflag)
   if (vflag_fdotr) virial_fdotr_compute();
 }
 
+/* ----------------------------------------------------------------------
+   compute interactions between owned atoms only
+   called while coords of ghost atoms are still in transit
+------------------------------------------------------------------------- */
+
+void PairLJCut::compute_interior(int eflag, int vflag)
+{
+  ev_init(eflag, vflag);
+  compute_split(eflag, vflag, 0);
+}
+
+/* ----------------------------------------------------------------------
+   compute remaining interactions with ghost atoms
+------------------------------------------------------------------------- */
+
+void PairLJCut::compute_boundary(int eflag, int vflag)
+{
+  compute_split(eflag, vflag, 1);
+  if (vflag_fdotr) virial_fdotr_compute();
+}
+
+/* ----------------------------------------------------------------------
+   loop over owned (boundary = 0) or ghost (boundary = 1) neighbors
+   of a split neighbor list
+------------------------------------------------------------------------- */
+
+void PairLJCut::compute_split(int eflag, int /*vflag*/, int boundary)
+{
+  int i, j, ii, jj, inum, jfrom, jto, itype, jtype;
+  double xtmp, ytmp, ztmp, delx, dely, delz, evdwl, fpair;
+  double rsq, r2inv, r6inv, forcelj, factor_lj;
+  int *ilist, *jlist, *numneigh, *numneigh_local, **firstneigh;
+
+  evdwl = 0.0;
+
+  double **x = atom->x;
+  double **f = atom->f;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+  double *special_lj = force->special_lj;
+  int newton_pair = force->newton_pair;
+
+  inum = list->inum;
+  ilist = list->ilist;
+  numneigh = list->numneigh;
+  numneigh_local = list->numneigh_local;
+  firstneigh = list->firstneigh;
+
+  for (ii = 0; ii < inum; ii++) {
+    i = ilist[ii];
+    xtmp = x[i][0];
+    ytmp = x[i][1];
+    ztmp = x[i][2];
+    itype = type[i];
+    jlist = firstneigh[i];
+    jfrom = boundary ? numneigh_local[i] : 0;
+    jto = boundary ? numneigh[i] : numneigh_local[i];
+
+    for (jj = jfrom; jj < jto; jj++) {
+      j = jlist[jj];
+      factor_lj = special_lj[sbmask(j)];
+      j &= NEIGHMASK;
+
+      delx = xtmp - x[j][0];
+      dely = ytmp - x[j][1];
+      delz = ztmp - x[j][2];
+      rsq = delx * delx + dely * dely + delz * delz;
+      jtype = type[j];
+
+      if (rsq < cutsq[itype][jtype]) {
+        r2inv = 1.0 / rsq;
+        r6inv = r2inv * r2inv * r2inv;
+        forcelj = r6inv * (lj1[itype][jtype] * r6inv - lj2[itype][jtype]);
+        fpair = factor_lj * forcelj * r2inv;
+
+        f[i][0] += delx * fpair;
+        f[i][1] += dely * fpair;
+        f[i][2] += delz * fpair;
+        if (newton_pair || j < nlocal) {
+          f[j][0] -= delx * fpair;
+          f[j][1] -= dely * fpair;
+          f[j][2] -= delz * fpair;
+        }
+
+        if (eflag) {
+          evdwl = r6inv * (lj3[itype][jtype] * r6inv - lj4[itype][jtype]) - offset[itype][jtype];
+          evdwl *= factor_lj;
+        }
+
+        if (evflag) ev_tally(i, j, nlocal, newton_pair, evdwl, 0.0, fpair, delx, dely, delz);
+      }
+    }
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void PairLJCut::compute_inner()
@@ -482,6 +578,8 @@ void PairLJCut::init_style()
     auto respa = dynamic_cast<Respa *>(update->integrate);
     if (respa->level_inner >= 0) list_style = NeighConst::REQ_RESPA_INOUT;
     if (respa->level_middle >= 0) list_style = NeighConst::REQ_RESPA_ALL;
+  } else if (overlap_enable && comm->overlap) {
+    list_style = NeighConst::REQ_SPLIT;
   }
   neighbor->add_request(this, list_style);
 
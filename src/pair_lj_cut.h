@@ -47,6 +47,9 @@ class PairLJCut : public Pair {
   void compute_middle() override;
   void compute_outer(int, int) override;
 
+  void compute_interior(int, int) override;
+  void compute_boundary(int, int) override;
+
  protected:
   double cut_global;
   double **cut;
@@ -55,6 +58,7 @@ class PairLJCut : public Pair {
   double *cut_respa;
 
   virtual void allocate();
+  void compute_split(int, int, int);
 };
 
 }    // namespace LAMMPS_NS
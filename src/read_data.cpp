@@ -51,6 +51,7 @@ static constexpr double LB_FACTOR = 1.1;
 static constexpr int CHUNK = 1024;
 static constexpr int DELTA = 4;       // must be 2 or larger
 static constexpr int MAXBODY = 32;    // max # of lines in one body
+static constexpr bigint PARBLOCK = 16 * 1024 * 1024;    // bytes per reader per round
 
 // customize for new sections
 
@@ -154,6 +155,8 @@ void ReadData::command(int narg, char **arg)
       extra_improper_types = 0;
 
   groupbit = 0;
+  nreader = 0;
+  atoms_end = -1;
 
   nfix = 0;
   fix_index = nullptr;
@@ -300,6 +303,15 @@ void ReadData::command(int narg, char **arg)
       int igroup = group->find_or_create(arg[iarg + 1]);
       groupbit = group->bitmask[igroup];
       iarg += 2;
+    } else if (strcmp(arg[iarg], "readers") == 0) {
+      if (iarg + 2 > narg) utils::missing_cmd_args(FLERR, "read_data readers", error);
+      if (strcmp(arg[iarg + 1], "all") == 0)
+        nreader = comm->nprocs;
+      else
+        nreader = utils::inumeric(FLERR, arg[iarg + 1], false, lmp);
+      if (nreader < 0) error->all(FLERR, "Illegal read_data readers value {}", nreader);
+      nreader = MIN(nreader, comm->nprocs);
+      iarg += 2;
     } else if (strcmp(arg[iarg], "fix") == 0) {
       if (iarg + 4 > narg) utils::missing_cmd_args(FLERR, "read_data fix", error);
       fix_index =
@@ -365,6 +377,15 @@ void ReadData::command(int narg, char **arg)
 
   if (!platform::file_is_readable(arg[0]))
     error->all(FLERR, fmt::format("Cannot open file {}: {}", arg[0], utils::getsyserror()));
+  datafile = arg[0];
+
+  // compressed files are read through a pipe and cannot be read in parallel
+
+  if (nreader && platform::has_compress_extension(arg[0])) {
+    if (comm->me == 0)
+      error->warning(FLERR, "Compressed data file {} is read by a single processor", arg[0]);
+    nreader = 0;
+  }
 
   // reset so we can warn about reset image flags exactly once per data file
 
@@ -621,6 +642,8 @@ void ReadData::command(int narg, char **arg)
                 FLERR, "Atom style in data file {} differs from currently defined atom style {}",
                 style, atom->atom_style);
           atoms();
+        } else if (atoms_end >= 0) {
+          if (me == 0) platform::fseek(fp, atoms_end);
         } else
           skip_lines(natoms);
 
@@ -1397,19 +1420,29 @@ void ReadData::atoms()
 {
   int nchunk, eof;
 
-  if (me == 0) utils::logmesg(lmp, "  reading atoms ...\n");
+  if (me == 0) {
+    if (nreader)
+      utils::logmesg(lmp, "  reading atoms with {} readers ...\n", nreader);
+    else
+      utils::logmesg(lmp, "  reading atoms ...\n");
+  }
 
-  bigint nread = 0;
+  if (nreader) {
+    atoms_parallel();
+  } else {
+    bigint nread = 0;
 
-  while (nread < natoms) {
-    nchunk = MIN(natoms - nread, CHUNK);
-    eof = utils::read_lines_from_file(fp, nchunk, MAXLINE, buffer, me, world);
-    if (eof) error->all(FLERR, "Unexpected end of data file");
-    if (tlabelflag && !lmap->is_complete(Atom::ATOM))
-      error->all(FLERR, "Label map is incomplete: all types must be assigned a unique type label");
-    atom->data_atoms(nchunk, buffer, id_offset, mol_offset, toffset, shiftflag, shift, tlabelflag,
-                     lmap->lmap2lmap.atom);
-    nread += nchunk;
+    while (nread < natoms) {
+      nchunk = MIN(natoms - nread, CHUNK);
+      eof = utils::read_lines_from_file(fp, nchunk, MAXLINE, buffer, me, world);
+      if (eof) error->all(FLERR, "Unexpected end of data file");
+      if (tlabelflag && !lmap->is_complete(Atom::ATOM))
+        error->all(FLERR,
+                   "Label map is incomplete: all types must be assigned a unique type label");
+      atom->data_atoms(nchunk, buffer, id_offset, mol_offset, toffset, shiftflag, shift,
+                       tlabelflag, lmap->lmap2lmap.atom);
+      nread += nchunk;
+    }
   }
 
   // warn if we have read data with non-zero image flags for non-periodic boundaries.
@@ -1458,6 +1491,150 @@ void ReadData::atoms()
   }
 }
 
+/* ----------------------------------------------------------------------
+   read all atoms in parallel
+   nreader procs open the data file and read the Atoms section in rounds,
+     each reader takes a block of PARBLOCK bytes and owns the lines
+     that start within its block, a prefix sum over line counts
+     tells each reader which of its lines are atoms
+   readers keep all atoms they parse, which are then sent to their
+     owning procs via Irregular, here or after the whole file is read
+     when adding to existing atoms
+   proc 0 repositions its file pointer after the Atoms section
+------------------------------------------------------------------------- */
+
+void ReadData::atoms_parallel()
+{
+  if (tlabelflag && !lmap->is_complete(Atom::ATOM))
+    error->all(FLERR, "Label map is incomplete: all types must be assigned a unique type label");
+
+  // readers are every Nth proc, so they are spread across nodes
+  // proc 0 is always reader 0
+
+  int nprocs = comm->nprocs;
+  int stride = nprocs / nreader;
+  int ireader = -1;
+  if (me % stride == 0 && me / stride < nreader) ireader = me / stride;
+
+  MPI_Comm readcomm;
+  MPI_Comm_split(world, (ireader >= 0) ? 0 : MPI_UNDEFINED, me, &readcomm);
+
+  bigint start;
+  if (me == 0) start = platform::ftell(fp);
+  MPI_Bcast(&start, 1, MPI_LMP_BIGINT, 0, world);
+
+  int eof = 0;
+  bigint end = -1;
+
+  if (ireader >= 0) {
+    FILE *fpread = fopen(datafile.c_str(), "rb");
+    if (!fpread) error->one(FLERR, "Cannot open file {}: {}", datafile, utils::getsyserror());
+
+    std::string block;
+    bigint offset = start;    // file offset of current round
+    bigint nread = 0;         // # of lines in previous rounds
+
+    while (true) {
+
+      // read my block plus the remainder of its last line
+      // prepend the preceding byte to detect if first line starts at lo
+
+      bigint lo = offset + ireader * PARBLOCK;
+      bigint hi = lo + PARBLOCK;
+      bigint first = (lo > start) ? lo - 1 : lo;
+      block.resize(hi - first);
+      platform::fseek(fpread, first);
+      size_t nbytes = fread(&block[0], 1, hi - first, fpread);
+      block.resize(nbytes);
+      if (nbytes == (size_t) (hi - first) && block.back() != '\n') {
+        char chunk[MAXLINE];
+        while (fgets(chunk, MAXLINE, fpread)) {
+          block += chunk;
+          if (block.back() == '\n') break;
+        }
+      }
+      if (!block.empty() && block.back() != '\n') block += '\n';
+
+      // skip partial line owned by previous reader
+
+      size_t ptr = 0;
+      if (lo > start) {
+        if (block.size() > 1 && block[0] != '\n') {
+          ptr = block.find('\n', 1);
+          ptr = (ptr == std::string::npos) ? block.size() : ptr + 1;
+        } else
+          ptr = 1;
+        ptr = MIN(ptr, block.size());
+      }
+
+      bigint nmine = 0;
+      for (size_t i = ptr; i < block.size(); i++)
+        if (block[i] == '\n') nmine++;
+
+      bigint nprefix, ntotal;
+      MPI_Scan(&nmine, &nprefix, 1, MPI_LMP_BIGINT, MPI_SUM, readcomm);
+      MPI_Allreduce(&nmine, &ntotal, 1, MPI_LMP_BIGINT, MPI_SUM, readcomm);
+      bigint ifirst = nread + nprefix - nmine;
+
+      // parse my lines which belong to the Atoms section
+      // the reader with the last atom line reports the end of the section
+
+      bigint nparse = MAX(0, MIN(nmine, natoms - ifirst));
+      bigint myend = -1;
+      if (nparse > 0) {
+        size_t pend = ptr;
+        for (bigint i = 0; i < nparse; i++) pend = block.find('\n', pend) + 1;
+        atom->data_atoms((int) nparse, &block[ptr], id_offset, mol_offset, toffset, shiftflag,
+                         shift, tlabelflag, lmap->lmap2lmap.atom, 1);
+        if (ifirst + nparse == natoms) myend = first + pend;
+      }
+      MPI_Allreduce(&myend, &end, 1, MPI_LMP_BIGINT, MPI_MAX, readcomm);
+      if (end >= 0) break;
+      if (ntotal == 0) {
+        eof = 1;
+        break;
+      }
+
+      nread += ntotal;
+      offset += nreader * PARBLOCK;
+    }
+    fclose(fpread);
+    MPI_Comm_free(&readcomm);
+  }
+
+  MPI_Bcast(&eof, 1, MPI_INT, 0, world);
+  if (eof) error->all(FLERR, "Unexpected end of data file");
+  if (me == 0) platform::fseek(fp, end);
+  MPI_Bcast(&end, 1, MPI_LMP_BIGINT, 0, world);
+  atoms_end = end;
+
+  // combine flags for image flags reset by any reader
+
+  for (int i = 0; i < 3; i++) {
+    int flag = atom->reset_image_flag[i] ? 1 : 0, flagall;
+    MPI_Allreduce(&flag, &flagall, 1, MPI_INT, MPI_MAX, world);
+    atom->reset_image_flag[i] = (flagall != 0);
+  }
+
+  // move atoms to the procs owning them
+  // first do map_init() since irregular->migrate_atoms() will do map_clear()
+  // if adding atoms, keep them on the readers for now: migrating here would
+  //   also move previously owned atoms and scramble the new atoms stored
+  //   after nlocal_previous, all atoms are migrated once the file is read
+
+  if (atom->map_style != Atom::MAP_NONE) {
+    atom->map_init();
+    atom->map_set();
+  }
+  if (addflag == NONE) {
+    if (domain->triclinic) domain->x2lamda(atom->nlocal);
+    auto irregular = new Irregular(lmp);
+    irregular->migrate_atoms(1);
+    delete irregular;
+    if (domain->triclinic) domain->lamda2x(atom->nlocal);
+  }
+}
+
 /* ----------------------------------------------------------------------
    read all velocities
    to find atoms, must build atom map if not a molecular system
@@ -76,6 +76,10 @@ class ReadData : public Command {
   int extra_dihedral_types, extra_improper_types;
   int groupbit;
 
+  std::string datafile;
+  int nreader;         // # of procs reading Atoms section in parallel, 0 = proc 0 only
+  bigint atoms_end;    // file offset after Atoms section, -1 if unknown
+
   int nfix;
   Fix **fix_index;
   char **fix_header;
@@ -93,6 +97,7 @@ class ReadData : public Command {
   int style_match(const char *, const char *);
 
   void atoms();
+  void atoms_parallel();
   void velocities();
 
   void bonds(int);
@@ -36,6 +36,12 @@
 #include "update.h"
 
 #include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#ifdef LAMMPS_ZSTD
+#include <zstd.h>
+#endif
 
 #include "lmprestart.h"
 
@@ -43,7 +49,10 @@ using namespace LAMMPS_NS;
 
 /* ---------------------------------------------------------------------- */
 
-ReadRestart::ReadRestart(LAMMPS *lmp) : Command(lmp), mpiio(nullptr) {}
+ReadRestart::ReadRestart(LAMMPS *lmp) :
+    Command(lmp), mpiio(nullptr), deltaflag(0), basefile(nullptr)
+{
+}
 
 /* ---------------------------------------------------------------------- */
 
@@ -204,6 +213,10 @@ void ReadRestart::command(int narg, char **arg)
     while (m < assignedChunkSize) m += avec->unpack_restart(&buf[m]);
   }
 
+  // input of incremental file, combined with its base file
+
+  else if (deltaflag) read_delta(file);
+
   // input of single native file
   // nprocs_file = # of chunks in file
   // proc 0 reads a chunk and bcasts it to other procs
@@ -405,12 +418,13 @@ void ReadRestart::command(int narg, char **arg)
   // clean-up memory
 
   delete[] file;
+  delete[] basefile;
   memory->destroy(buf);
 
-  // for multiproc or MPI-IO files:
+  // for multiproc, MPI-IO or incremental files:
   // perform irregular comm to migrate atoms to correct procs
 
-  if (multiproc || mpiioflag) {
+  if (multiproc || mpiioflag || deltaflag) {
 
     // if remapflag set, remap all atoms I read back to box before migrating
 
@@ -1091,7 +1105,27 @@ void ReadRestart::file_layout()
         memory->destroy(nproc_chunk_sizes);
         memory->destroy(nproc_chunk_offsets);
       }
-    }
+
+    } else if (flag == DELTA_BASE) {
+      deltaflag = 1;
+      delete[] basefile;
+      basefile = read_string();
+    } else if (flag == DELTA_STEP) {
+      base_step = read_bigint();
+    } else if (flag == DELTA_OFFSET) {
+      base_offset = read_bigint();
+    } else if (flag == DELTA_NCHUNK) {
+      base_nchunk = read_int();
+    } else if (flag == DELTA_PRECISION) {
+      precision = read_double();
+    } else if (flag == DELTA_COMPRESS) {
+      compressflag = read_int();
+#ifndef LAMMPS_ZSTD
+      if (compressflag)
+        error->all(FLERR,"Incremental restart file is compressed but LAMMPS was built "
+                   "without Zstd support");
+#endif
+    } else error->all(FLERR,"Invalid flag in file layout section of restart file");
 
     flag = read_int();
   }
@@ -1105,6 +1139,188 @@ void ReadRestart::file_layout()
   }
 }
 
+/* ----------------------------------------------------------------------
+   read per-atom data of incremental restart file
+   proc 0 reads per-proc chunks of base file and bcasts them
+   each proc keeps base records of atoms with ID % nprocs = me
+   proc 0 reads (and decompresses) per-proc chunks of delta data and bcasts them
+   each proc combines delta data of its atoms with their base record
+   atoms are migrated to the correct procs afterwards
+------------------------------------------------------------------------- */
+
+void ReadRestart::read_delta(const std::string &deltafile)
+{
+  AtomVec *avec = atom->avec;
+
+  // proc 0 opens base file and checks its timestep
+  // base file name is stored as it was given when writing, if it cannot
+  //   be opened from here, look for it next to the incremental file
+  // read_int() and friends operate on fp, so swap file pointers
+
+  FILE *fpdelta = fp;
+  fp = nullptr;
+  if (me == 0) {
+    std::string base = basefile;
+    if (!platform::file_is_readable(base)) {
+      auto nextto = platform::path_join(platform::path_dirname(deltafile),
+                                        platform::path_basename(base));
+      if (platform::file_is_readable(nextto)) base = nextto;
+    }
+    fp = fopen(base.c_str(),"rb");
+    if (fp == nullptr)
+      error->one(FLERR,"Cannot open base file {} of incremental restart file: {}",
+                 basefile, utils::getsyserror());
+  }
+
+  magic_string();
+  endian();
+  read_int();
+
+  int flag = read_int();
+  while (flag >= 0 && flag != NTIMESTEP) {
+    if (flag == VERSION || flag == UNITS) delete[] read_string();
+    else read_int();
+    flag = read_int();
+  }
+  bigint step = -1;
+  if (flag == NTIMESTEP) step = read_bigint();
+  if (step != base_step)
+    error->all(FLERR,"Base file {} of incremental restart file is for timestep {} not {}",
+               basefile, step, base_step);
+
+  if (me == 0) platform::fseek(fp,base_offset);
+
+  // keep base records of my atoms in basebuf, indexed by atom ID
+
+  std::vector<double> basebuf;
+  std::unordered_map<tagint,bigint> basemap;
+  double *buf = nullptr;
+  int maxbuf = 0;
+  int n,m,size;
+  tagint itag;
+
+  for (int ichunk = 0; ichunk < base_nchunk; ichunk++) {
+    if (read_int() != PERPROC)
+      error->all(FLERR,"Invalid flag in peratom section of restart file {}", basefile);
+
+    n = read_int();
+    if (n > maxbuf) {
+      maxbuf = n;
+      memory->destroy(buf);
+      memory->create(buf,maxbuf,"read_restart:buf");
+    }
+    read_double_vec(n,buf);
+
+    m = 0;
+    while (m < n) {
+      size = static_cast<int> (buf[m]);
+      itag = (tagint) ubuf(buf[m+4]).i;
+      if (itag % nprocs == me) {
+        basemap[itag] = basebuf.size();
+        basebuf.insert(basebuf.end(),&buf[m],&buf[m+size]);
+      }
+      m += size;
+    }
+  }
+
+  if (me == 0) fclose(fp);
+  fp = fpdelta;
+
+  // read delta data of each proc that wrote the file
+
+  int sizes[2];
+  char *cbuf = nullptr;
+  char *zbuf = nullptr;
+  int maxcbuf = 0;
+  int maxzbuf = 0;
+  int q[3];
+  imageint iimage;
+  double v[3];
+
+  for (int iproc = 0; iproc < nprocs_file; iproc++) {
+    if (read_int() != PERPROC_DELTA)
+      error->all(FLERR,"Invalid flag in peratom section of restart file");
+    read_int_vec(2,sizes);
+
+    if (sizes[0] > maxcbuf) {
+      maxcbuf = sizes[0];
+      memory->destroy(cbuf);
+      memory->create(cbuf,maxcbuf,"read_restart:cbuf");
+    }
+
+    if (me == 0) {
+      if (compressflag) {
+        if (sizes[1] > maxzbuf) {
+          maxzbuf = sizes[1];
+          memory->destroy(zbuf);
+          memory->create(zbuf,maxzbuf,"read_restart:zbuf");
+        }
+        utils::sfread(FLERR,zbuf,sizeof(char),sizes[1],fp,nullptr,error);
+#ifdef LAMMPS_ZSTD
+        size_t nraw = ZSTD_decompress(cbuf,sizes[0],zbuf,sizes[1]);
+        if (ZSTD_isError(nraw) || (nraw != (size_t) sizes[0]))
+          error->one(FLERR,"Zstd decompression of incremental restart data failed");
+#endif
+      } else utils::sfread(FLERR,cbuf,sizeof(char),sizes[0],fp,nullptr,error);
+    }
+    MPI_Bcast(cbuf,sizes[0],MPI_CHAR,0,world);
+
+    // decode records, unpack the ones of my atoms
+
+    char *ptr = cbuf;
+    char *end = cbuf + sizes[0];
+    while (ptr < end) {
+      memcpy(&itag,ptr,sizeof(tagint));
+      ptr += sizeof(tagint);
+
+      if (itag < 0) {
+        itag = -itag;
+        memcpy(&size,ptr,sizeof(int));
+        ptr += sizeof(int);
+        if (itag % nprocs == me) {
+          if (size > maxbuf) {
+            maxbuf = size;
+            memory->destroy(buf);
+            memory->create(buf,maxbuf,"read_restart:buf");
+          }
+          memcpy(buf,ptr,size*sizeof(double));
+          avec->unpack_restart(buf);
+        }
+        ptr += size*sizeof(double);
+
+      } else {
+        memcpy(q,ptr,3*sizeof(int));
+        ptr += 3*sizeof(int);
+        memcpy(&iimage,ptr,sizeof(imageint));
+        ptr += sizeof(imageint);
+        memcpy(v,ptr,3*sizeof(double));
+        ptr += 3*sizeof(double);
+        if (itag % nprocs == me) {
+          auto found = basemap.find(itag);
+          if (found == basemap.end())
+            error->one(FLERR,"Atom {} of incremental restart file not found in base file {}",
+                       itag, basefile);
+          double *rec = &basebuf[found->second];
+          size = static_cast<int> (rec[0]);
+          for (int k = 0; k < 3; k++) rec[1+k] += q[k] * precision;
+          rec[7] = ubuf(iimage).d;
+          for (int k = 0; k < 3; k++) rec[8+k] = v[k];
+          avec->unpack_restart(rec);
+        }
+      }
+    }
+  }
+
+  if (me == 0) {
+    fclose(fp);
+    fp = nullptr;
+  }
+
+  memory->destroy(buf);
+  memory->destroy(cbuf);
+  memory->destroy(zbuf);
+}
+
 // ----------------------------------------------------------------------
 // ----------------------------------------------------------------------
 // low-level fread methods
@@ -46,6 +46,16 @@ class ReadRestart : public Command {
   bigint assignedChunkSize;
   MPI_Offset assignedChunkOffset, headerOffset;
 
+  // incremental restart values
+
+  int deltaflag;          // 1 if file stores per-atom data as deltas to a base file
+  char *basefile;         // name of base file
+  bigint base_step;       // timestep of base file
+  bigint base_offset;     // file offset of per-atom data in base file
+  int base_nchunk;        // # of per-proc chunks in base file
+  double precision;       // resolution of quantized position deltas
+  int compressflag;       // 1 if delta data is compressed with Zstd
+
   std::string file_search(const std::string &);
   void header();
   void type_arrays();
@@ -56,6 +66,7 @@ class ReadRestart : public Command {
   void format_revision();
   void check_eof_magic();
   void file_layout();
+  void read_delta(const std::string &);
 
   int read_int();
   bigint read_bigint();
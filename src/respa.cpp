@@ -304,6 +304,11 @@ void Respa::init()
     if (force->pair && force->pair->respa_enable == 0)
       error->all(FLERR, "Pair style does not support rRESPA inner/middle/outer");
 
+  // multiple time stepping of kspace is done by the respa levels
+
+  if (force->kspace && force->kspace->mts_every > 1)
+    error->all(FLERR, "Kspace_modify mts cannot be used with run_style respa");
+
   // virial_style = VIRIAL_PAIR (explicit)
   //   since never computed implicitly with virial_fdotr_compute() like Verlet
 
@@ -111,6 +111,7 @@ Thermo::Thermo(LAMMPS *_lmp, int narg, char **arg) :
   lostflag = lostbond = Thermo::ERROR;
   lostbefore = warnbefore = 0;
   flushflag = 0;
+  fusedflag = 1;
   ntimestep = -1;
 
   // set style and corresponding lineflag
@@ -284,10 +285,15 @@ void Thermo::init()
   delete format_line;
 
   // find current ptr for each Compute ID
+  // fine grained timers only cover invocations by thermo output,
+  //   computes invoked by fixes, dumps or variables are timed as part
+  //   of their caller, no timer is called at the compute level
 
+  compute_timer.resize(ncompute);
   for (int i = 0; i < ncompute; i++) {
     computes[i] = modify->get_compute_by_id(id_compute[i]);
     if (!computes[i]) error->all(FLERR, "Could not find thermo compute with ID {}", id_compute[i]);
+    compute_timer[i] = timer->add_detail("compute", computes[i]->id, computes[i]->style);
   }
 
   // find current ptr for each Fix ID
@@ -374,34 +380,95 @@ void Thermo::compute(int flag)
   firststep = flag;
   ntimestep = update->ntimestep;
 
+  // computes which provide partial sums for compute_scalar() or compute_vector()
+  //   are combined with the lost atom check into a single reduction
+  // computes already invoked on this step are skipped
+
+  int nsum = 2;
+  std::vector<int> npartial(ncompute, 0);
+  if (fusedflag) {
+    for (i = 0; i < ncompute; i++) {
+      if ((compute_which[i] == SCALAR) &&
+          !(computes[i]->invoked_flag & Compute::INVOKED_SCALAR))
+        npartial[i] = computes[i]->size_scalar_partial;
+      else if ((compute_which[i] == VECTOR) &&
+               !(computes[i]->invoked_flag & Compute::INVOKED_VECTOR))
+        npartial[i] = computes[i]->size_vector_partial;
+      nsum += npartial[i];
+    }
+  }
+
+  std::vector<double> partial(nsum), sum(nsum);
+  partial[0] = atom->nlocal;
+  partial[1] = error->get_numwarn();
+  int m = 2;
+  for (i = 0; i < ncompute; i++) {
+    if (!npartial[i]) continue;
+    const double tstart = timer->detail_start();
+    if (compute_which[i] == SCALAR)
+      computes[i]->pack_scalar_partial(&partial[m]);
+    else
+      computes[i]->pack_vector_partial(&partial[m]);
+    timer->detail_stop(compute_timer[i], tstart, 0);
+    m += npartial[i];
+  }
+
+  MPI_Allreduce(partial.data(), sum.data(), nsum, MPI_DOUBLE, MPI_SUM, world);
+
   // check for lost atoms
   // turn off normflag if natoms = 0 to avoid divide by 0
 
-  natoms = atom->natoms = lost_check();
+  bigint ntotal[2] = {(bigint) sum[0], (bigint) sum[1]};
+  natoms = atom->natoms = lost_check(ntotal);
   if (natoms == 0)
     normflag = 0;
   else
     normflag = normvalue;
 
-  // invoke Compute methods needed for thermo keywords
+  // complete computes from summed partial values
+  // temperature computes first, since pressure computes may use them
+  // then invoke remaining Compute methods needed for thermo keywords
+
+  for (int pass = 0; pass < 2; pass++) {
+    m = 2;
+    for (i = 0; i < ncompute; i++) {
+      if (npartial[i] && (computes[i]->tempflag == 1 - pass)) {
+        const double tstart = timer->detail_start();
+        if (compute_which[i] == SCALAR) {
+          computes[i]->unpack_scalar_partial(&sum[m]);
+          computes[i]->invoked_flag |= Compute::INVOKED_SCALAR;
+        } else {
+          computes[i]->unpack_vector_partial(&sum[m]);
+          computes[i]->invoked_flag |= Compute::INVOKED_VECTOR;
+        }
+        timer->detail_stop(compute_timer[i], tstart);
+      }
+      m += npartial[i];
+    }
+  }
 
-  for (i = 0; i < ncompute; i++)
+  for (i = 0; i < ncompute; i++) {
+    const double tstart = timer->detail_start();
     if (compute_which[i] == SCALAR) {
       if (!(computes[i]->invoked_flag & Compute::INVOKED_SCALAR)) {
         computes[i]->compute_scalar();
         computes[i]->invoked_flag |= Compute::INVOKED_SCALAR;
+        timer->detail_stop(compute_timer[i], tstart);
       }
     } else if (compute_which[i] == VECTOR) {
       if (!(computes[i]->invoked_flag & Compute::INVOKED_VECTOR)) {
         computes[i]->compute_vector();
         computes[i]->invoked_flag |= Compute::INVOKED_VECTOR;
+        timer->detail_stop(compute_timer[i], tstart);
       }
     } else if (compute_which[i] == ARRAY) {
       if (!(computes[i]->invoked_flag & Compute::INVOKED_ARRAY)) {
         computes[i]->compute_array();
         computes[i]->invoked_flag |= Compute::INVOKED_ARRAY;
+        timer->detail_stop(compute_timer[i], tstart);
       }
     }
+  }
 
   // if lineflag = MULTILINE, prepend step/cpu header line
 
@@ -462,6 +529,15 @@ bigint Thermo::lost_check()
   nlocal[0] = atom->nlocal;
   nlocal[1] = error->get_numwarn();
   MPI_Allreduce(nlocal, ntotal, 2, MPI_LMP_BIGINT, MPI_SUM, world);
+  return lost_check(ntotal);
+}
+
+/* ----------------------------------------------------------------------
+   same as lost_check() with atom and warning counts already summed
+------------------------------------------------------------------------- */
+
+bigint Thermo::lost_check(bigint *ntotal)
+{
   if (ntotal[0] < 0) error->all(FLERR, "Too many total atoms");
 
   // print notification, if future warnings will be ignored
@@ -621,6 +697,11 @@ void Thermo::modify_params(int narg, char **arg)
       flushflag = utils::logical(FLERR, arg[iarg + 1], false, lmp);
       iarg += 2;
 
+    } else if (strcmp(arg[iarg], "fused") == 0) {
+      if (iarg + 2 > narg) utils::missing_cmd_args(FLERR, "thermo_modify fused", error);
+      fusedflag = utils::logical(FLERR, arg[iarg + 1], false, lmp);
+      iarg += 2;
+
     } else if (strcmp(arg[iarg], "line") == 0) {
       if (iarg + 2 > narg) utils::missing_cmd_args(FLERR, "thermo_modify line", error);
       if (strcmp(arg[iarg + 1], "one") == 0)
@@ -36,6 +36,7 @@ class Thermo : protected Pointers {
   ~Thermo() override;
   void init();
   bigint lost_check();
+  bigint lost_check(bigint *);
   void modify_params(int, char **);
   void header();
   void footer();
@@ -64,6 +65,7 @@ class Thermo : protected Pointers {
   int firststep;
   int lostbefore, warnbefore;
   int flushflag, lineflag;
+  int fusedflag;    // 1 if computes are reduced together with lost atom check
 
   double last_tpcpu, last_spcpu;
   double last_time;
@@ -92,6 +94,7 @@ class Thermo : protected Pointers {
   char **id_compute;           // their IDs
   int *compute_which;          // 0/1/2 if should call scalar,vector,array
   class Compute **computes;    // list of ptrs to the Compute objects
+  std::vector<int> compute_timer;    // index of fine grained timer for each Compute
 
   int nfix;             // # of Fix objects called by thermo
   char **id_fix;        // their IDs
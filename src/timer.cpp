@@ -32,6 +32,7 @@ Timer::Timer(LAMMPS *_lmp) : Pointers(_lmp)
   _s_timeout = -1;
   _checkfreq = 10;
   _nextcheck = -1;
+  _detail = false;
   this->_stamp(RESET);
 }
 
@@ -43,6 +44,32 @@ void Timer::init()
     cpu_array[i] = 0.0;
     wall_array[i] = 0.0;
   }
+  for (auto &d : details) {
+    d.wall = 0.0;
+    d.calls = 0;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   register fine grained timer for category and ID, return its index
+   an existing timer is reused and its style updated
+   return -1 if fine grained timing is disabled
+   must be called in the same order on all MPI ranks
+------------------------------------------------------------------------- */
+
+int Timer::add_detail(const std::string &category, const std::string &id,
+                      const std::string &style)
+{
+  if (!_detail) return -1;
+
+  for (std::size_t i = 0; i < details.size(); i++) {
+    if ((details[i].category == category) && (details[i].id == id)) {
+      details[i].style = style;
+      return i;
+    }
+  }
+  details.push_back({category, id, style, 0.0, 0});
+  return details.size() - 1;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -225,6 +252,21 @@ void Timer::modify_params(int narg, char **arg)
       _sync = OFF;
     } else if (strcmp(arg[iarg], timer_mode[NORMAL]) == 0) {
       _sync = NORMAL;
+    } else if (strcmp(arg[iarg], "detail") == 0) {
+      _detail = true;
+    } else if (strcmp(arg[iarg], "nodetail") == 0) {
+      _detail = false;
+    } else if (strcmp(arg[iarg], "json") == 0) {
+      ++iarg;
+      if (iarg < narg) {
+        if (strcmp(arg[iarg], "none") == 0) {
+          _detail_file.clear();
+        } else {
+          _detail_file = arg[iarg];
+          _detail = true;
+        }
+      } else
+        error->all(FLERR, "Illegal timer command");
     } else if (strcmp(arg[iarg], "timeout") == 0) {
       ++iarg;
       if (iarg < narg) {
@@ -253,7 +295,7 @@ void Timer::modify_params(int narg, char **arg)
       timeout = fmt::format("{:02d}:{:%M:%S}", tv.tm_yday * 24 + tv.tm_hour, tv);
     }
 
-    utils::logmesg(lmp, "New timer settings: style={}  mode={}  timeout={}\n", timer_style[_level],
-                   timer_mode[_sync], timeout);
+    utils::logmesg(lmp, "New timer settings: style={}  mode={}  timeout={}  detail={}\n",
+                   timer_style[_level], timer_mode[_sync], timeout, _detail ? "yes" : "no");
   }
 }
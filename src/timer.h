@@ -104,6 +104,31 @@ class Timer : protected Pointers {
 
   void modify_params(int, char **);
 
+  // optional fine grained timing of individual fixes, computes, pair sub-styles, and dumps
+  // callers register a timer with add_detail() during init and wrap the timed
+  // call with detail_start() and detail_stop(), which do nothing unless enabled
+
+  struct Detail {
+    std::string category;    // fix, compute, pair, dump
+    std::string id;          // ID of fix, compute, dump or sub-style name
+    std::string style;       // style of fix, compute, or dump
+    double wall;             // accumulated wall time
+    bigint calls;            // number of timed calls
+  };
+
+  bool has_detail() const { return _detail; }
+  int add_detail(const std::string &, const std::string &, const std::string &);
+  double detail_start() const { return _detail ? platform::walltime() : 0.0; }
+  void detail_stop(int index, double start, int ncall = 1)
+  {
+    if (_detail && (index >= 0)) {
+      details[index].wall += platform::walltime() - start;
+      details[index].calls += ncall;
+    }
+  }
+  const std::vector<Detail> &get_details() const { return details; }
+  const std::string &get_detail_file() const { return _detail_file; }
+
  private:
   double cpu_array[NUM_TIMER];
   double wall_array[NUM_TIMER];
@@ -116,6 +141,9 @@ class Timer : protected Pointers {
   int _s_timeout;    // copy of timeout for restoring after a forced timeout
   int _checkfreq;    // frequency of timeout checking
   int _nextcheck;    // loop number of next timeout check
+  bool _detail;      // true if fine grained timing is enabled
+  std::string _detail_file;       // JSON file for fine grained timings, empty if none
+  std::vector<Detail> details;    // fine grained timers
 
   // update one specific timer array
   void _stamp(enum ttype);
@@ -0,0 +1,93 @@
+/* -*- c++ -*- ----------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------
+   disjoint sets of local indices (union-find) with path halving
+   used to find clusters of atoms in a single pass over pairs or bonds
+------------------------------------------------------------------------- */
+
+#ifndef LMP_UNION_FIND_H
+#define LMP_UNION_FIND_H
+
+#include <vector>
+
+namespace LAMMPS_NS {
+
+class UnionFind {
+ public:
+  // make each of N indices its own set
+
+  void reset(int n)
+  {
+    parent.resize(n);
+    for (int i = 0; i < n; i++) parent[i] = i;
+  }
+
+  // root index of set containing I
+
+  int find(int i)
+  {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  }
+
+  // merge sets containing I and J, root with lower index is kept
+
+  void unite(int i, int j)
+  {
+    i = find(i);
+    j = find(j);
+    if (i < j)
+      parent[j] = i;
+    else if (j < i)
+      parent[i] = j;
+  }
+
+  // set value of each index to minimum value of its set
+  // return 1 if the value of any of the first NFIRST indices was lowered
+
+  int assign_min(double *value, int nfirst)
+  {
+    const int n = parent.size();
+    minval.resize(n);
+    for (int i = 0; i < n; i++) minval[i] = value[i];
+    for (int i = 0; i < n; i++) {
+      const int r = find(i);
+      if (value[i] < minval[r]) minval[r] = value[i];
+    }
+
+    int change = 0;
+    for (int i = 0; i < n; i++) {
+      const double v = minval[find(i)];
+      if ((i < nfirst) && (v < value[i])) change = 1;
+      value[i] = v;
+    }
+    return change;
+  }
+
+  double memory_usage() const
+  {
+    return (double) parent.capacity() * sizeof(int) + (double) minval.capacity() * sizeof(double);
+  }
+
+ private:
+  std::vector<int> parent;
+  std::vector<double> minval;
+};
+
+}    // namespace LAMMPS_NS
+
+#endif
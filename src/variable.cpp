@@ -76,6 +76,10 @@ enum{SUM,XMIN,XMAX,AVE,TRAP,SLOPE};
 
 static constexpr double BIG = 1.0e20;
 
+// # of atoms per block for bytecode evaluation of atom-style variables
+
+static constexpr int NBLOCK = 256;
+
 // INT64_MAX cannot be represented with a double. reduce to avoid overflow when casting back
 
 #if defined(LAMMPS_SMALLBIG) || defined(LAMMPS_BIGBIG)
@@ -1146,7 +1150,14 @@ void Variable::compute_atom(int ivar, int igroup, double *result, int stride, in
   int *mask = atom->mask;
   int nlocal = atom->nlocal;
 
-  if (style[ivar] == ATOM) {
+  // use compiled formula unless the tree contains unsupported operations
+
+  std::vector<Bytecode> code;
+  int depth = 0;
+  if ((style[ivar] == ATOM) && compile_tree(tree,code,0,depth)) {
+    eval_bytecode(code,depth,tree,groupbit,result,stride,sumflag);
+
+  } else if (style[ivar] == ATOM) {
     if (sumflag == 0) {
       int m = 0;
       for (int i = 0; i < nlocal; i++) {
@@ -3224,6 +3235,260 @@ double Variable::eval_tree(Tree *tree, int i)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   compile parse tree of atom-style variable into bytecode
+   code is the tree in post-order, i.e. operands before their operation,
+     so it can be executed with a stack of per-atom values
+   depth = current stack depth, maxdepth = max stack depth of code
+   return 1 if successful
+   return 0 if tree contains an operation not supported by eval_bytecode(),
+     e.g. random numbers or region tests, caller then uses eval_tree()
+------------------------------------------------------------------------- */
+
+int Variable::compile_tree(Tree *tree, std::vector<Bytecode> &code, int depth, int &maxdepth)
+{
+  switch (tree->type) {
+    case VALUE:
+    case ATOMARRAY:
+    case TYPEARRAY:
+    case INTARRAY:
+    case BIGINTARRAY:
+    case VECTORARRAY:
+      maxdepth = MAX(maxdepth,depth+1);
+      break;
+
+    case ADD: case SUBTRACT: case MULTIPLY: case DIVIDE: case MODULO: case CARAT:
+    case EQ: case NE: case LT: case LE: case GT: case GE: case AND: case OR: case XOR:
+    case ATAN2:
+      if (!compile_tree(tree->first,code,depth,maxdepth)) return 0;
+      if (!compile_tree(tree->second,code,depth+1,maxdepth)) return 0;
+      break;
+
+    case UNARY: case NOT: case SQRT: case EXP: case LN: case LOG: case ABS:
+    case SIN: case COS: case TAN: case ASIN: case ACOS: case ATAN:
+    case CEIL: case FLOOR: case ROUND:
+      if (!compile_tree(tree->first,code,depth,maxdepth)) return 0;
+      break;
+
+    default:
+      return 0;
+  }
+
+  code.push_back({tree->type,tree});
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   evaluate compiled atom-style formula for all owned atoms
+   atoms are processed in blocks of NBLOCK, each instruction is applied
+     to a whole block with a simple loop that the compiler can vectorize
+   values of atoms not in group are computed but not used
+   if a math error occurs for an atom in group, the block is re-evaluated
+     with eval_tree() so errors are reported exactly as without bytecode
+   store in result with stride, same as compute_atom()
+------------------------------------------------------------------------- */
+
+void Variable::eval_bytecode(const std::vector<Bytecode> &code, int depth, Tree *tree,
+                             int groupbit, double *result, int stride, int sumflag)
+{
+  int *mask = atom->mask;
+  int *type = atom->type;
+  int nlocal = atom->nlocal;
+
+  std::vector<double> stack(depth*NBLOCK);
+  int ingroup[NBLOCK];
+
+  for (int ifirst = 0; ifirst < nlocal; ifirst += NBLOCK) {
+    const int n = MIN(NBLOCK,nlocal-ifirst);
+    for (int j = 0; j < n; j++) ingroup[j] = mask[ifirst+j] & groupbit;
+
+    // a = operand below top of stack, b = top of stack, c = next free slot
+    // binary operations replace a and pop b, unary ones replace b
+    // a and b are only formed when they exist, pointers before the
+    //   start of the stack are undefined behavior
+
+    int nstack = 0;
+    int invalid = 0;
+
+    for (const auto &op : code) {
+      double *c = stack.data() + nstack*NBLOCK;
+      double *b = (nstack > 0) ? c - NBLOCK : nullptr;
+      double *a = (nstack > 1) ? c - 2*NBLOCK : nullptr;
+      const Tree *t = op.tree;
+
+      switch (op.type) {
+        case VALUE: {
+          const double value = t->value;
+          for (int j = 0; j < n; j++) c[j] = value;
+          nstack++;
+        } break;
+        case ATOMARRAY:
+        case VECTORARRAY: {
+          const double *array = t->array + (bigint) ifirst*t->nstride;
+          const int nstride = t->nstride;
+          for (int j = 0; j < n; j++) c[j] = array[j*nstride];
+          nstack++;
+        } break;
+        case TYPEARRAY: {
+          const double *array = t->array;
+          for (int j = 0; j < n; j++) c[j] = array[type[ifirst+j]];
+          nstack++;
+        } break;
+        case INTARRAY: {
+          const int *iarray = t->iarray + (bigint) ifirst*t->nstride;
+          const int nstride = t->nstride;
+          for (int j = 0; j < n; j++) c[j] = (double) iarray[j*nstride];
+          nstack++;
+        } break;
+        case BIGINTARRAY: {
+          const bigint *barray = t->barray + (bigint) ifirst*t->nstride;
+          const int nstride = t->nstride;
+          for (int j = 0; j < n; j++) c[j] = (double) barray[j*nstride];
+          nstack++;
+        } break;
+
+        case ADD:
+          for (int j = 0; j < n; j++) a[j] = a[j] + b[j];
+          nstack--;
+          break;
+        case SUBTRACT:
+          for (int j = 0; j < n; j++) a[j] = a[j] - b[j];
+          nstack--;
+          break;
+        case MULTIPLY:
+          for (int j = 0; j < n; j++) a[j] = a[j] * b[j];
+          nstack--;
+          break;
+        case DIVIDE:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && (b[j] == 0.0);
+          for (int j = 0; j < n; j++) a[j] = a[j] / b[j];
+          nstack--;
+          break;
+        case MODULO:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && (b[j] == 0.0);
+          for (int j = 0; j < n; j++) a[j] = fmod(a[j],b[j]);
+          nstack--;
+          break;
+        case CARAT:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && (b[j] == 0.0);
+          for (int j = 0; j < n; j++) a[j] = pow(a[j],b[j]);
+          nstack--;
+          break;
+        case EQ:
+          for (int j = 0; j < n; j++) a[j] = (a[j] == b[j]) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case NE:
+          for (int j = 0; j < n; j++) a[j] = (a[j] != b[j]) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case LT:
+          for (int j = 0; j < n; j++) a[j] = (a[j] < b[j]) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case LE:
+          for (int j = 0; j < n; j++) a[j] = (a[j] <= b[j]) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case GT:
+          for (int j = 0; j < n; j++) a[j] = (a[j] > b[j]) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case GE:
+          for (int j = 0; j < n; j++) a[j] = (a[j] >= b[j]) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case AND:
+          for (int j = 0; j < n; j++) a[j] = ((a[j] != 0.0) && (b[j] != 0.0)) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case OR:
+          for (int j = 0; j < n; j++) a[j] = ((a[j] != 0.0) || (b[j] != 0.0)) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case XOR:
+          for (int j = 0; j < n; j++) a[j] = ((a[j] == 0.0) != (b[j] == 0.0)) ? 1.0 : 0.0;
+          nstack--;
+          break;
+        case ATAN2:
+          for (int j = 0; j < n; j++) a[j] = atan2(a[j],b[j]);
+          nstack--;
+          break;
+
+        case UNARY:
+          for (int j = 0; j < n; j++) b[j] = -b[j];
+          break;
+        case NOT:
+          for (int j = 0; j < n; j++) b[j] = (b[j] == 0.0) ? 1.0 : 0.0;
+          break;
+        case SQRT:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && (b[j] < 0.0);
+          for (int j = 0; j < n; j++) b[j] = sqrt(b[j]);
+          break;
+        case EXP:
+          for (int j = 0; j < n; j++) b[j] = exp(b[j]);
+          break;
+        case LN:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && (b[j] <= 0.0);
+          for (int j = 0; j < n; j++) b[j] = log(b[j]);
+          break;
+        case LOG:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && (b[j] <= 0.0);
+          for (int j = 0; j < n; j++) b[j] = log10(b[j]);
+          break;
+        case ABS:
+          for (int j = 0; j < n; j++) b[j] = fabs(b[j]);
+          break;
+        case SIN:
+          for (int j = 0; j < n; j++) b[j] = sin(b[j]);
+          break;
+        case COS:
+          for (int j = 0; j < n; j++) b[j] = cos(b[j]);
+          break;
+        case TAN:
+          for (int j = 0; j < n; j++) b[j] = tan(b[j]);
+          break;
+        case ASIN:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && ((b[j] < -1.0) || (b[j] > 1.0));
+          for (int j = 0; j < n; j++) b[j] = asin(b[j]);
+          break;
+        case ACOS:
+          for (int j = 0; j < n; j++) invalid |= ingroup[j] && ((b[j] < -1.0) || (b[j] > 1.0));
+          for (int j = 0; j < n; j++) b[j] = acos(b[j]);
+          break;
+        case ATAN:
+          for (int j = 0; j < n; j++) b[j] = atan(b[j]);
+          break;
+        case CEIL:
+          for (int j = 0; j < n; j++) b[j] = ceil(b[j]);
+          break;
+        case FLOOR:
+          for (int j = 0; j < n; j++) b[j] = floor(b[j]);
+          break;
+        case ROUND:
+          for (int j = 0; j < n; j++) b[j] = MYROUND(b[j]);
+          break;
+      }
+    }
+
+    // error in block: evaluate again atom by atom to get the same error
+    //   or result as eval_tree(), e.g. for AND/OR which skip 2nd operand
+
+    double *value = stack.data();
+    if (invalid)
+      for (int j = 0; j < n; j++)
+        if (ingroup[j]) value[j] = eval_tree(tree,ifirst+j);
+
+    double *ptr = result + (bigint) ifirst*stride;
+    if (sumflag == 0) {
+      for (int j = 0; j < n; j++) ptr[j*stride] = ingroup[j] ? value[j] : 0.0;
+    } else {
+      for (int j = 0; j < n; j++)
+        if (ingroup[j]) ptr[j*stride] += value[j];
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    scan entire tree, find size of vectors for vector-style variable
    return N for consistent vector size
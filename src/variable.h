@@ -127,6 +127,11 @@ class Variable : protected Pointers {
     }
   };
 
+  struct Bytecode {    // instruction of atom-style formula compiled from parse tree
+    int type;          // operation, same as Tree::type
+    Tree *tree;        // tree node with the data of VALUE and array operands
+  };
+
   int compute_python(int);
   void remove(int);
   void grow();
@@ -134,6 +139,8 @@ class Variable : protected Pointers {
   double evaluate(char *, Tree **, int);
   double collapse_tree(Tree *);
   double eval_tree(Tree *, int);
+  int compile_tree(Tree *, std::vector<Bytecode> &, int, int &);
+  void eval_bytecode(const std::vector<Bytecode> &, int, Tree *, int, double *, int, int);
   int size_tree_vector(Tree *);
   int compare_tree_vector(int, int);
   void free_tree(Tree *);
@@ -75,6 +75,10 @@ void Verlet::init()
 
   if (modify->get_fix_by_id("package_omp")) external_force_clear = 1;
 
+  // check settings for multiple time stepping of kspace
+
+  if (force->kspace) force->kspace->mts_init();
+
   // set flags for arrays to clear in force_clear()
 
   torqueflag = extraflag = 0;
@@ -84,6 +88,7 @@ void Verlet::init()
   // orthogonal vs triclinic simulation box
 
   triclinic = domain->triclinic;
+  overlap = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -108,6 +113,18 @@ void Verlet::setup(int flag)
 
   update->setupflag = 1;
 
+  // overlap forward comm with pair compute of owned atoms on regular steps
+  // requires a pair style with interior/boundary routines
+  // and no pre_force fixes, since those may need ghost atom coords
+
+  overlap = 0;
+  if (comm->overlap) {
+    if (pair_compute_flag && force->pair->overlap_enable && !modify->n_pre_force) overlap = 1;
+    else if (comm->me == 0)
+      error->warning(FLERR,"Comm overlap is not supported for this pair style or "
+                     "with pre_force fixes, using regular communication");
+  }
+
   // setup domain, communication and neighboring
   // acquire ghosts
   // build neighbor lists
@@ -149,8 +166,9 @@ void Verlet::setup(int flag)
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
-    else force->kspace->compute_dummy(eflag,vflag);
+    if (!kspace_compute_flag) force->kspace->compute_dummy(eflag,vflag);
+    else if (force->kspace->mts_every > 1) force->kspace->compute_mts(eflag,vflag);
+    else force->kspace->compute(eflag,vflag);
   }
 
   modify->setup_pre_reverse(eflag,vflag);
@@ -211,8 +229,9 @@ void Verlet::setup_minimal(int flag)
 
   if (force->kspace) {
     force->kspace->setup();
-    if (kspace_compute_flag) force->kspace->compute(eflag,vflag);
-    else force->kspace->compute_dummy(eflag,vflag);
+    if (!kspace_compute_flag) force->kspace->compute_dummy(eflag,vflag);
+    else if (force->kspace->mts_every > 1) force->kspace->compute_mts(eflag,vflag);
+    else force->kspace->compute(eflag,vflag);
   }
 
   modify->setup_pre_reverse(eflag,vflag);
@@ -265,7 +284,8 @@ void Verlet::run(int n)
 
     if (nflag == 0) {
       timer->stamp();
-      comm->forward_comm();
+      if (overlap) comm->forward_comm_start();
+      else comm->forward_comm();
       timer->stamp(Timer::COMM);
     } else {
       if (n_pre_exchange) {
@@ -313,7 +333,13 @@ void Verlet::run(int n)
     }
 
     if (pair_compute_flag) {
-      force->pair->compute(eflag,vflag);
+      if (overlap && nflag == 0) {
+        force->pair->compute_interior(eflag,vflag);
+        timer->stamp(Timer::PAIR);
+        comm->forward_comm_finish();
+        timer->stamp(Timer::COMM);
+        force->pair->compute_boundary(eflag,vflag);
+      } else force->pair->compute(eflag,vflag);
       timer->stamp(Timer::PAIR);
     }
 
@@ -326,7 +352,8 @@ void Verlet::run(int n)
     }
 
     if (kspace_compute_flag) {
-      force->kspace->compute(eflag,vflag);
+      if (force->kspace->mts_every > 1) force->kspace->compute_mts(eflag,vflag);
+      else force->kspace->compute(eflag,vflag);
       timer->stamp(Timer::KSPACE);
     }
 
@@ -37,6 +37,7 @@ class Verlet : public Integrate {
  protected:
   int triclinic;    // 0 if domain is orthog, 1 if triclinic
   int torqueflag, extraflag;
+  int overlap;    // 1 if forward comm overlaps with pair compute
 };
 
 }    // namespace LAMMPS_NS
@@ -23,6 +23,7 @@
 #include "domain.h"
 #include "error.h"
 #include "fix.h"
+#include "fix_store_atom.h"
 #include "force.h"
 #include "group.h"
 #include "improper.h"
@@ -36,12 +37,41 @@
 #include "thermo.h"
 #include "update.h"
 
+#include <cmath>
 #include <cstring>
 
+#ifdef LAMMPS_ZSTD
+#include <zstd.h>
+#endif
+
 #include "lmprestart.h"
 
 using namespace LAMMPS_NS;
 
+static const char id_base[] = "WRITE_RESTART_BASE";
+
+/* ----------------------------------------------------------------------
+   64-bit FNV-1a hash of a packed per-atom restart record
+   excludes coords, image flags and velocities which are stored as deltas
+------------------------------------------------------------------------- */
+
+static int64_t record_hash(const double *rec)
+{
+  const int size = static_cast<int> (rec[0]);
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](const double *ptr, int n) {
+    auto bytes = (const unsigned char *) ptr;
+    for (std::size_t k = 0; k < n*sizeof(double); k++) {
+      hash ^= bytes[k];
+      hash *= 1099511628211ULL;
+    }
+  };
+  add(rec,1);
+  add(&rec[4],3);
+  if (size > 11) add(&rec[11],size-11);
+  return static_cast<int64_t> (hash);
+}
+
 /* ---------------------------------------------------------------------- */
 
 WriteRestart::WriteRestart(LAMMPS *lmp) : Command(lmp)
@@ -51,6 +81,15 @@ WriteRestart::WriteRestart(LAMMPS *lmp) : Command(lmp)
   multiproc = 0;
   noinit = 0;
   fp = nullptr;
+
+  incremental = 0;
+  precision = 1.0e-6;
+#ifdef LAMMPS_ZSTD
+  compressflag = 1;
+#else
+  compressflag = 0;
+#endif
+  deltaflag = 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -195,8 +234,44 @@ void WriteRestart::multiproc_options(int multiproc_caller, int mpiioflag_caller,
     } else if (strcmp(arg[iarg],"noinit") == 0) {
       noinit = 1;
       iarg++;
+
+    } else if (strcmp(arg[iarg],"incremental") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "write_restart incremental", error);
+      incremental = utils::inumeric(FLERR,arg[iarg+1],false,lmp);
+      if (incremental < 0)
+        error->all(FLERR,"Invalid write_restart incremental value {}", incremental);
+      iarg += 2;
+
+    } else if (strcmp(arg[iarg],"precision") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "write_restart precision", error);
+      precision = utils::numeric(FLERR,arg[iarg+1],false,lmp);
+      if (precision <= 0.0)
+        error->all(FLERR,"Invalid write_restart precision value {}", precision);
+      iarg += 2;
+
+    } else if (strcmp(arg[iarg],"compress") == 0) {
+      if (iarg+2 > narg) utils::missing_cmd_args(FLERR, "write_restart compress", error);
+      compressflag = utils::logical(FLERR,arg[iarg+1],false,lmp);
+#ifndef LAMMPS_ZSTD
+      if (compressflag)
+        error->all(FLERR,"Write_restart compress yes requires LAMMPS built with Zstd support");
+#endif
+      iarg += 2;
+
     } else error->all(FLERR,"Unknown write_restart keyword: {}", arg[iarg]);
   }
+
+  // incremental files store the per-atom state of the last base file
+  //   in a fix so that it migrates with the atoms
+
+  if (incremental) {
+    if (multiproc || mpiioflag)
+      error->all(FLERR,"Write_restart incremental cannot be used with multi-proc or MPI-IO files");
+    if (!atom->tag_enable)
+      error->all(FLERR,"Write_restart incremental requires atom IDs");
+    if (!modify->get_fix_by_id(id_base))
+      modify->add_fix(fmt::format("{} all STORE/ATOM 5 0 0 0",id_base));
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -224,6 +299,15 @@ void WriteRestart::write(const std::string &file)
     error->all(FLERR,"Atom count is inconsistent: {} vs {}, cannot write restart file",
                natoms, atom->natoms);
 
+  // incremental output writes a delta file if a base file exists,
+  //   the max # of deltas for it is not reached and it is not overwritten
+  // else a full restart file is written which becomes the new base file
+
+  deltaflag = 0;
+  if (incremental && output->restart_base && (output->restart_ndelta < incremental) &&
+      (file != output->restart_base) && modify->get_fix_by_id(id_base))
+    deltaflag = 1;
+
   // open single restart file or base file for multiproc case
 
   if (me == 0) {
@@ -274,6 +358,14 @@ void WriteRestart::write(const std::string &file)
 
   file_layout(send_size);
 
+  // offset of per-atom data, needed if this file becomes a base file
+
+  bigint atomoffset = 0;
+  if (incremental && !deltaflag) {
+    if (me == 0) atomoffset = platform::ftell(fp);
+    MPI_Bcast(&atomoffset,1,MPI_LMP_BIGINT,0,world);
+  }
+
   // header info is complete
   // if multiproc output:
   //   close header file, open multiname file on each writing proc,
@@ -354,9 +446,18 @@ void WriteRestart::write(const std::string &file)
     }
   }
 
+  // remember per-atom state of a new base file before buf is reused
+
+  if (incremental && !deltaflag) store_base(buf);
+
+  // incremental output of deltas to base file
+
+  if (deltaflag) {
+    io_error = write_delta(buf);
+
   // MPI-IO output to single file
 
-  if (mpiioflag) {
+  } else if (mpiioflag) {
     if (me == 0 && fp) {
       magic_string();
       if (ferror(fp)) io_error = 1;
@@ -405,6 +506,18 @@ void WriteRestart::write(const std::string &file)
   MPI_Allreduce(&io_error,&io_all,1,MPI_INT,MPI_MAX,world);
   if (io_all) error->all(FLERR,"I/O error while writing restart");
 
+  // update bookkeeping of incremental restart files
+
+  if (deltaflag) output->restart_ndelta++;
+  else if (incremental) {
+    delete[] output->restart_base;
+    output->restart_base = utils::strdup(file);
+    output->restart_base_step = update->ntimestep;
+    output->restart_base_offset = atomoffset;
+    output->restart_base_nchunk = nprocs;
+    output->restart_ndelta = 0;
+  }
+
   // clean up
 
   memory->destroy(buf);
@@ -583,6 +696,15 @@ void WriteRestart::file_layout(int send_size)
     write_int(MPIIO,mpiioflag);
   }
 
+  if (deltaflag && (me == 0)) {
+    write_string(DELTA_BASE,output->restart_base);
+    write_bigint(DELTA_STEP,output->restart_base_step);
+    write_bigint(DELTA_OFFSET,output->restart_base_offset);
+    write_int(DELTA_NCHUNK,output->restart_base_nchunk);
+    write_double(DELTA_PRECISION,precision);
+    write_int(DELTA_COMPRESS,compressflag);
+  }
+
   if (mpiioflag) {
     int *all_send_sizes;
     memory->create(all_send_sizes,nprocs,"write_restart:all_send_sizes");
@@ -607,6 +729,170 @@ void WriteRestart::file_layout(int send_size)
   }
 }
 
+/* ----------------------------------------------------------------------
+   store coords, ID and record hash of my atoms as written to a base file
+   buf = packed per-atom records of my atoms
+------------------------------------------------------------------------- */
+
+void WriteRestart::store_base(double *buf)
+{
+  auto fix = dynamic_cast<FixStoreAtom *>(modify->get_fix_by_id(id_base));
+  double **base = fix->astore;
+
+  int m = 0;
+  for (int i = 0; i < atom->nlocal; i++) {
+    base[i][0] = buf[m+1];
+    base[i][1] = buf[m+2];
+    base[i][2] = buf[m+3];
+    base[i][3] = buf[m+4];
+    base[i][4] = ubuf(record_hash(&buf[m])).d;
+    m += static_cast<int> (buf[m]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   write per-atom data of all procs as deltas to the base file
+   buf = packed per-atom records of my atoms
+   an atom whose record only changed in coords, image flags, velocities
+     is stored as ID, quantized coord offset, image flags, velocities
+   all other atoms are stored as negative ID and full record
+   each proc encodes (and compresses) its own atoms, proc 0 writes them
+   return 1 on I/O error, else 0
+------------------------------------------------------------------------- */
+
+int WriteRestart::write_delta(double *buf)
+{
+  auto fix = dynamic_cast<FixStoreAtom *>(modify->get_fix_by_id(id_base));
+  double **base = fix->astore;
+  int nlocal = atom->nlocal;
+
+  // upper bound of encoded size = full records for all my atoms
+
+  bigint maxbytes = 0;
+  int m = 0;
+  for (int i = 0; i < nlocal; i++) {
+    maxbytes += sizeof(tagint) + sizeof(int) + sizeof(double) * static_cast<int> (buf[m]);
+    m += static_cast<int> (buf[m]);
+  }
+  if (maxbytes > MAXSMALLINT)
+    error->one(FLERR,"Too much per-proc data for incremental restart file");
+
+  char *cbuf;
+  memory->create(cbuf,MAX(maxbytes,1),"write_restart:cbuf");
+
+  const double invprec = 1.0/precision;
+  tagint itag;
+  imageint iimage;
+  int q[3];
+  double dq;
+
+  char *ptr = cbuf;
+  m = 0;
+  for (int i = 0; i < nlocal; i++) {
+    const int size = static_cast<int> (buf[m]);
+    itag = (tagint) ubuf(buf[m+4]).i;
+
+    int full = 1;
+    if (((tagint) ubuf(base[i][3]).i == itag) && (ubuf(base[i][4]).i == record_hash(&buf[m]))) {
+      full = 0;
+      for (int k = 0; k < 3; k++) {
+        dq = (buf[m+1+k] - base[i][k]) * invprec;
+        if (fabs(dq) >= MAXSMALLINT) full = 1;
+        else q[k] = static_cast<int> (lround(dq));
+      }
+    }
+
+    if (full) {
+      itag = -itag;
+      memcpy(ptr,&itag,sizeof(tagint));
+      ptr += sizeof(tagint);
+      memcpy(ptr,&size,sizeof(int));
+      ptr += sizeof(int);
+      memcpy(ptr,&buf[m],size*sizeof(double));
+      ptr += size*sizeof(double);
+    } else {
+      iimage = (imageint) ubuf(buf[m+7]).i;
+      memcpy(ptr,&itag,sizeof(tagint));
+      ptr += sizeof(tagint);
+      memcpy(ptr,q,3*sizeof(int));
+      ptr += 3*sizeof(int);
+      memcpy(ptr,&iimage,sizeof(imageint));
+      ptr += sizeof(imageint);
+      memcpy(ptr,&buf[m+8],3*sizeof(double));
+      ptr += 3*sizeof(double);
+    }
+    m += size;
+  }
+
+  // sizes[0] = # of encoded bytes, sizes[1] = # of bytes stored in file
+
+  int sizes[2];
+  sizes[0] = sizes[1] = ptr - cbuf;
+  char *sendbuf = cbuf;
+
+#ifdef LAMMPS_ZSTD
+  char *zbuf = nullptr;
+  if (compressflag) {
+    size_t bound = ZSTD_compressBound(sizes[0]);
+    memory->create(zbuf,MAX(static_cast<int>(bound),1),"write_restart:zbuf");
+    size_t ncomp = ZSTD_compress(zbuf,bound,cbuf,sizes[0],ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(ncomp))
+      error->one(FLERR,"Zstd compression of incremental restart data failed: {}",
+                 ZSTD_getErrorName(ncomp));
+    sizes[1] = static_cast<int> (ncomp);
+    sendbuf = zbuf;
+  }
+#endif
+
+  int maxsend;
+  MPI_Allreduce(&sizes[1],&maxsend,1,MPI_INT,MPI_MAX,world);
+
+  // proc 0 pings each proc, receives its data, writes it to file
+
+  int io_error = 0;
+  int tmp;
+  if (me == 0) {
+    int *allsizes;
+    memory->create(allsizes,2*nprocs,"write_restart:allsizes");
+    MPI_Gather(sizes,2,MPI_INT,allsizes,2,MPI_INT,0,world);
+
+    char *rbuf;
+    memory->create(rbuf,MAX(maxsend,1),"write_restart:rbuf");
+    MPI_Request request;
+    for (int iproc = 0; iproc < nprocs; iproc++) {
+      char *data = sendbuf;
+      if (iproc) {
+        MPI_Irecv(rbuf,maxsend,MPI_CHAR,iproc,0,world,&request);
+        MPI_Send(&tmp,0,MPI_INT,iproc,0,world);
+        MPI_Wait(&request,MPI_STATUS_IGNORE);
+        data = rbuf;
+      }
+      int flag = PERPROC_DELTA;
+      fwrite(&flag,sizeof(int),1,fp);
+      fwrite(&allsizes[2*iproc],sizeof(int),2,fp);
+      fwrite(data,sizeof(char),allsizes[2*iproc+1],fp);
+    }
+    memory->destroy(rbuf);
+    memory->destroy(allsizes);
+
+    magic_string();
+    if (ferror(fp)) io_error = 1;
+    fclose(fp);
+    fp = nullptr;
+
+  } else {
+    MPI_Gather(sizes,2,MPI_INT,nullptr,2,MPI_INT,0,world);
+    MPI_Recv(&tmp,0,MPI_INT,0,0,world,MPI_STATUS_IGNORE);
+    MPI_Rsend(sendbuf,sizes[1],MPI_CHAR,0,0,world);
+  }
+
+  memory->destroy(cbuf);
+#ifdef LAMMPS_ZSTD
+  memory->destroy(zbuf);
+#endif
+  return io_error;
+}
+
 // ----------------------------------------------------------------------
 // ----------------------------------------------------------------------
 // low-level fwrite methods
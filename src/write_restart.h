@@ -50,10 +50,19 @@ class WriteRestart : public Command {
   class RestartMPIIO *mpiio;    // MPIIO for restart file output
   MPI_Offset headerOffset;
 
+  // incremental restart files
+
+  int incremental;     // # of delta files written after each base file, 0 = off
+  double precision;    // resolution of quantized position deltas
+  int compressflag;    // 1 if delta data is compressed with Zstd, else 0
+  int deltaflag;       // 1 if current file is written as delta to base file
+
   void header();
   void type_arrays();
   void force_fields();
   void file_layout(int);
+  void store_base(double *);
+  int write_delta(double *);
 
   void magic_string();
   void endian();
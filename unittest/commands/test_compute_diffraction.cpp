@@ -0,0 +1,126 @@
+// unit tests for FFT based structure factors of compute xrd and compute saed
+// compared to the direct sum, run on one and on several MPI ranks
+
+#define LAMMPS_LIB_MPI 1
+#include "comm.h"
+#include "compute.h"
+#include "input.h"
+#include "lammps.h"
+#include "modify.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+using ::testing::ContainsRegex;
+
+namespace LAMMPS_NS {
+
+class ComputeDiffractionTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+
+        // disordered two component fcc crystal, so that also the
+        // diffuse intensity between the Bragg peaks is non-zero
+
+        command("units metal");
+        command("lattice fcc 4.05");
+        command("region box block 0 3 0 3 0 3");
+        command("create_box 2 box");
+        command("create_atoms 1 box");
+        command("set type 1 type/fraction 2 0.3 8723");
+        command("displace_atoms all random 0.2 0.2 0.2 4981 units box");
+        command("mass * 27.0");
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    Compute *get_compute(const std::string &id) { return lmp->modify->get_compute_by_id(id); }
+};
+
+TEST_F(ComputeDiffractionTest, xrd)
+{
+    if (!verbose) ::testing::internal::CaptureStdout();
+    command("compute direct all xrd 1.541838 Al Ni 2Theta 10 100 c 1 1 1");
+    command("compute fft all xrd 1.541838 Al Ni 2Theta 10 100 c 1 1 1 fft 1.0e-10");
+    command("run 0 post no");
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+
+    auto direct = get_compute("direct");
+    auto fft    = get_compute("fft");
+    ASSERT_EQ(direct->size_array_rows, fft->size_array_rows);
+    ASSERT_GT(direct->size_array_rows, 100);
+    direct->compute_array();
+    fft->compute_array();
+
+    double imax = 0.0;
+    for (int i = 0; i < direct->size_array_rows; ++i)
+        imax = std::max(imax, direct->array[i][1]);
+    ASSERT_GT(imax, 0.0);
+
+    for (int i = 0; i < direct->size_array_rows; ++i) {
+        EXPECT_DOUBLE_EQ(fft->array[i][0], direct->array[i][0]);
+        EXPECT_NEAR(fft->array[i][1], direct->array[i][1], 1.0e-7 * imax);
+    }
+}
+
+TEST_F(ComputeDiffractionTest, saed)
+{
+    if (!verbose) ::testing::internal::CaptureStdout();
+    command("compute direct all saed 0.0251 Al Ni Kmax 1.0 Zone 0 0 0 c 0.5 0.5 0.5");
+    command("compute fft all saed 0.0251 Al Ni Kmax 1.0 Zone 0 0 0 c 0.5 0.5 0.5 fft 1.0e-10");
+    command("run 0 post no");
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+
+    auto direct = get_compute("direct");
+    auto fft    = get_compute("fft");
+    ASSERT_EQ(direct->size_vector, fft->size_vector);
+    ASSERT_GT(direct->size_vector, 1000);
+    direct->compute_vector();
+    fft->compute_vector();
+
+    double imax = 0.0;
+    for (int i = 0; i < direct->size_vector; ++i)
+        imax = std::max(imax, direct->vector[i]);
+    ASSERT_GT(imax, 0.0);
+
+    for (int i = 0; i < direct->size_vector; ++i)
+        EXPECT_NEAR(fft->vector[i], direct->vector[i], 1.0e-7 * imax);
+}
+
+// a grid that would need too much memory falls back to the direct sum
+
+TEST_F(ComputeDiffractionTest, fallback)
+{
+    ::testing::internal::CaptureStdout();
+    command("compute fft all xrd 1.541838 Al Ni 2Theta 10 40 c 0.05 0.05 0.05 fft 1.0e-6");
+    auto output = ::testing::internal::GetCapturedStdout();
+    if (lmp->comm->me == 0)
+        ASSERT_THAT(output, ContainsRegex(".*WARNING: Compute XRD FFT grid [0-9]+x[0-9]+x[0-9]+ "
+                                          "needs about [0-9.]+ GB per MPI rank, using direct "
+                                          "summation instead.*"));
+}
+} // namespace LAMMPS_NS
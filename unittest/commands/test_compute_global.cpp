@@ -12,16 +12,23 @@
 ------------------------------------------------------------------------- */
 
 #include "../testing/core.h"
+#include "compute.h"
+#include "fix.h"
 #include "info.h"
 #include "input.h"
 #include "lammps.h"
 #include "library.h"
+#include "modify.h"
+#include "output.h"
+#include "thermo.h"
 #include "utils.h"
+#include "variable.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #include <cstdio>
 #include <mpi.h>
+#include <vector>
 
 // whether to print verbose output (i.e. not capturing LAMMPS screen output).
 bool verbose = false;
@@ -146,6 +153,48 @@ TEST_F(ComputeGlobalTest, Energy)
     TEST_FAILURE(".*ERROR: Illegal compute command.*", command("compute pe potential"););
 }
 
+TEST_F(ComputeGlobalTest, FusedThermo)
+{
+    if (lammps_get_natoms(lmp) == 0.0) GTEST_SKIP();
+
+    BEGIN_HIDE_OUTPUT();
+    command("pair_style lj/cut/coul/cut 10.0");
+    command("pair_coeff * * 0.01 3.0");
+    command("bond_style harmonic");
+    command("bond_coeff * 100.0 1.5");
+    command("compute pe2 all pe bond");
+    command("compute pr2 all pressure NULL virial");
+    command("compute tmp2 allwater temp");
+    command("thermo_style custom step press temp pe ke etotal pxx pyy pzz pxy pxz pyz "
+            "c_pe2 c_pr2 c_pr2[*] c_tmp2 c_tmp2[*] atoms");
+    command("run 0 post no");
+    END_HIDE_OUTPUT();
+
+    // thermo output must not change when computes are reduced one by one
+
+    auto thermo = lmp->output->thermo;
+    auto value  = [](const multitype &field) -> double {
+        return (field.type == multitype::LAMMPS_DOUBLE) ? field.data.d : field.data.b;
+    };
+    std::vector<double> fused;
+    for (const auto &field : thermo->get_fields())
+        fused.push_back(value(field));
+
+    BEGIN_HIDE_OUTPUT();
+    command("thermo_modify fused no");
+    command("run 0 post no");
+    END_HIDE_OUTPUT();
+
+    const auto &fields = thermo->get_fields();
+    ASSERT_EQ(fields.size(), fused.size());
+    for (std::size_t i = 0; i < fused.size(); ++i)
+        EXPECT_DOUBLE_EQ(value(fields[i]), fused[i]);
+    EXPECT_DOUBLE_EQ(fused.back(), lammps_get_natoms(lmp));
+
+    TEST_FAILURE(".*ERROR: Expected boolean parameter instead of 'xxx'.*",
+                 command("thermo_modify fused xxx"););
+}
+
 TEST_F(ComputeGlobalTest, Geometry)
 {
     if (lammps_get_natoms(lmp) == 0.0) GTEST_SKIP();
@@ -386,6 +435,137 @@ TEST_F(ComputeGlobalTest, Counts)
     EXPECT_DOUBLE_EQ(icnt[0], 1.0);
     EXPECT_DOUBLE_EQ(icnt[1], 1.0);
 }
+
+TEST_F(ComputeGlobalTest, RDF)
+{
+    if (lammps_get_natoms(lmp) == 0.0) GTEST_SKIP();
+
+    BEGIN_HIDE_OUTPUT();
+    command("pair_style zero 8.0");
+    command("pair_coeff * *");
+    command("compute rdf all rdf 40 * * 1 3 coord 3.0");
+    command("compute batch all rdf 40 * * 1 3 coord 3.0 batch yes");
+    command("thermo_style custom step c_rdf[*]");
+    command("run 0 post no");
+    END_HIDE_OUTPUT();
+
+    // coordination numbers within 3.0 match coord(r) at the upper end of bin 14
+
+    auto rdf   = get_array("rdf");
+    auto coord = get_vector("rdf");
+    EXPECT_NEAR(coord[0], rdf[14][2], 1.0e-12);
+    EXPECT_NEAR(coord[1], rdf[14][4], 1.0e-12);
+    EXPECT_GT(coord[0], 0.0);
+
+    // batched samples must give the same average as fix ave/time of the unbatched compute
+
+    BEGIN_HIDE_OUTPUT();
+    command("thermo_style one");
+    command("velocity all create 300.0 4928459");
+    command("fix nve all nve");
+    command("fix ave all ave/time 1 5 10 c_rdf[*] mode vector");
+    command("fix avebatch all ave/time 1 5 10 c_batch[*] mode vector");
+    command("run 20 post no");
+    END_HIDE_OUTPUT();
+
+    auto ave      = lmp->modify->get_fix_by_id("ave");
+    auto avebatch = lmp->modify->get_fix_by_id("avebatch");
+    for (int i = 0; i < 40; ++i)
+        for (int j = 0; j < 5; ++j)
+            EXPECT_NEAR(ave->compute_array(i, j), avebatch->compute_array(i, j), 1.0e-10);
+    EXPECT_GT(avebatch->compute_array(20, 1), 0.0);
+
+    // the array of a batched compute can only be used by the fix ave/time that
+    // claimed it, its vector is not batched and can be used by anything
+
+    BEGIN_HIDE_OUTPUT();
+    command("thermo_style custom step c_batch[1] c_batch[2]");
+    command("fix coord all ave/time 1 1 1 c_batch[1] c_batch[2]");
+    command("run 0 post no");
+    END_HIDE_OUTPUT();
+    coord      = get_vector("rdf");
+    auto batch = get_vector("batch");
+    EXPECT_DOUBLE_EQ(batch[0], coord[0]);
+    EXPECT_DOUBLE_EQ(batch[1], coord[1]);
+    EXPECT_DOUBLE_EQ(lmp->modify->get_fix_by_id("coord")->compute_vector(1), coord[1]);
+
+    TEST_FAILURE(".*ERROR: Compute batch with batch yes can only be used by fix avebatch.*",
+                 lmp->input->variable->compute_equal("c_batch[1][2]"););
+    TEST_FAILURE(".*ERROR: Compute batch with batch yes can only be used by fix avebatch.*",
+                 command("thermo_style custom step c_batch[1][2]"); command("run 0 post no"););
+    BEGIN_HIDE_OUTPUT();
+    command("thermo_style one");
+    command("fix bad all ave/histo 1 1 1 0.0 1.0 10 c_batch[2] mode vector");
+    END_HIDE_OUTPUT();
+    TEST_FAILURE(".*ERROR: Compute batch with batch yes can only be used by fix avebatch.*",
+                 command("run 0 post no"););
+
+    // two fix ave/time commands would add each others samples to their averages
+
+    BEGIN_HIDE_OUTPUT();
+    command("unfix bad");
+    command("fix bad all ave/time 1 5 10 c_batch[*] mode vector");
+    END_HIDE_OUTPUT();
+    TEST_FAILURE(".*ERROR: Compute batch with batch yes is already used by fix avebatch and "
+                 "cannot be used by fix bad.*",
+                 command("run 0 post no"););
+
+    // once the owner is deleted, another fix ave/time can take over
+
+    BEGIN_HIDE_OUTPUT();
+    command("unfix avebatch");
+    command("unfix coord");
+    command("run 10 post no");
+    END_HIDE_OUTPUT();
+    ave        = lmp->modify->get_fix_by_id("ave");
+    auto other = lmp->modify->get_fix_by_id("bad");
+    for (int i = 0; i < 40; ++i)
+        for (int j = 0; j < 5; ++j)
+            EXPECT_NEAR(ave->compute_array(i, j), other->compute_array(i, j), 1.0e-10);
+
+    // compute rdf/omp tallies with per-thread histograms of integer counts,
+    // so it must give exactly the same result as compute rdf
+
+    if (!info->has_style("compute", "rdf/omp")) return;
+
+    BEGIN_HIDE_OUTPUT();
+    command("clear");
+    command("package omp 2");
+    command("include \"${input_dir}/in.fourmol\"");
+    command("pair_style zero 8.0");
+    command("pair_coeff * *");
+    command("compute rdf all rdf 40 * * 1 3 coord 3.0");
+    command("compute omp all rdf/omp 40 * * 1 3 coord 3.0");
+    command("compute ompbatch all rdf/omp 40 * * 1 3 coord 3.0 batch yes");
+    command("run 0 post no");
+    END_HIDE_OUTPUT();
+
+    auto omp = lmp->modify->get_compute_by_id("omp");
+    omp->compute_array();
+    omp->compute_vector();
+    rdf   = get_array("rdf");
+    coord = get_vector("rdf");
+    for (int i = 0; i < 40; ++i)
+        for (int j = 0; j < 5; ++j)
+            EXPECT_DOUBLE_EQ(omp->array[i][j], rdf[i][j]);
+    EXPECT_DOUBLE_EQ(omp->vector[0], coord[0]);
+    EXPECT_DOUBLE_EQ(omp->vector[1], coord[1]);
+    EXPECT_GT(omp->array[20][1], 0.0);
+
+    BEGIN_HIDE_OUTPUT();
+    command("velocity all create 300.0 4928459");
+    command("fix nve all nve");
+    command("fix ave all ave/time 1 5 10 c_rdf[*] mode vector");
+    command("fix avebatch all ave/time 1 5 10 c_ompbatch[*] mode vector");
+    command("run 20 post no");
+    END_HIDE_OUTPUT();
+
+    ave      = lmp->modify->get_fix_by_id("ave");
+    avebatch = lmp->modify->get_fix_by_id("avebatch");
+    for (int i = 0; i < 40; ++i)
+        for (int j = 0; j < 5; ++j)
+            EXPECT_NEAR(ave->compute_array(i, j), avebatch->compute_array(i, j), 1.0e-10);
+}
 } // namespace LAMMPS_NS
 
 int main(int argc, char **argv)
@@ -0,0 +1,203 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS Development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "../testing/core.h"
+#include "atom.h"
+#include "fix.h"
+#include "info.h"
+#include "input.h"
+#include "lammps.h"
+#include "modify.h"
+#include "platform.h"
+#include "utils.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <mpi.h>
+#include <vector>
+
+// whether to print verbose output (i.e. not capturing LAMMPS screen output).
+bool verbose = false;
+
+namespace LAMMPS_NS {
+
+// fix bond/react with a reaction that bonds a dimer 1(t1)-2(t2) to the end
+// of a chain 3(t3)-4(t1)-5(t1)-6(t1), the initiator atoms are 2 and 3.
+// the system has several copies of the reactants within the reaction
+// cutoff, some of them differ from the template far from the initiators,
+// so that they pass the initiator signatures but are rejected by the
+// template search until their topology is changed.
+
+class FixBondReactTest : public LAMMPSTest {
+protected:
+    static constexpr int NCOPY = 6;    // number of dimer/chain pairs
+
+    void SetUp() override
+    {
+        testbinary = "FixBondReactTest";
+        LAMMPSTest::SetUp();
+        if (!info->has_style("fix", "bond/react")) GTEST_SKIP();
+
+        write_template("rxn_pre.mol", false);
+        write_template("rxn_post.mol", true);
+        FILE *fp = fopen("rxn.map", "w");
+        fputs("# map for dimer + chain\n\n6 equivalences\n\nInitiatorIDs\n\n2\n3\n\n"
+              "Equivalences\n\n",
+              fp);
+        for (int i = 1; i <= 6; ++i)
+            fprintf(fp, "%d %d\n", i, i);
+        fclose(fp);
+    }
+
+    void TearDown() override
+    {
+        LAMMPSTest::TearDown();
+        platform::unlink("rxn_pre.mol");
+        platform::unlink("rxn_post.mol");
+        platform::unlink("rxn.map");
+    }
+
+    void write_template(const std::string &file, bool reacted)
+    {
+        FILE *fp = fopen(file.c_str(), "w");
+        fprintf(fp, "# %s template\n\n6 atoms\n%d bonds\n\nCoords\n\n",
+                reacted ? "post-reaction" : "pre-reaction", reacted ? 5 : 4);
+        for (int i = 1; i <= 6; ++i)
+            fprintf(fp, "%d %g 0.0 0.0\n", i, 1.0 * (i - 1) + (i > 2 ? 0.5 : 0.0));
+        fputs("\nTypes\n\n1 1\n2 2\n3 3\n4 1\n5 1\n6 1\n\nBonds\n\n"
+              "1 1 1 2\n2 1 3 4\n3 1 4 5\n4 1 5 6\n",
+              fp);
+        if (reacted) fputs("5 1 2 3\n", fp);
+        fclose(fp);
+    }
+
+    // copy K has atom IDs 6*K+1 to 6*K+6, in the same order as the template.
+    // the chain of copy K is modified by MISMATCH(K):
+    // 1 = last atom has a different type, 2 = last atom is not bonded
+
+    void create_system(const std::vector<int> &mismatch)
+    {
+        command("clear");
+        command("units lj");
+        command("atom_style bond");
+        command("atom_modify map array");
+        command("region box block 0 20 0 20 0 20");
+        command("create_box 4 box bond/types 1 extra/bond/per/atom 4 extra/special/per/atom 10");
+        command("mass * 1.0");
+        command("pair_style zero 3.0");
+        command("pair_coeff * *");
+        command("bond_style zero");
+        command("bond_coeff 1 1.0");
+        command("special_bonds lj/coul 0.0 1.0 1.0");
+        const int types[] = {1, 2, 3, 1, 1, 1};
+        for (int k = 0; k < NCOPY; ++k) {
+            const double y = 1.0 + 3.0 * k;
+            for (int i = 0; i < 6; ++i) {
+                int type = types[i];
+                if ((i == 5) && (mismatch[k] == 1)) type = 4;
+                command(fmt::format("create_atoms {} single {} {} 10.0 units box", type,
+                                    5.0 + 1.0 * i + (i > 1 ? 0.5 : 0.0), y));
+            }
+            const int id = 6 * k;
+            command(fmt::format("create_bonds single/bond 1 {} {}", id + 1, id + 2));
+            command(fmt::format("create_bonds single/bond 1 {} {}", id + 3, id + 4));
+            command(fmt::format("create_bonds single/bond 1 {} {}", id + 4, id + 5));
+            if (mismatch[k] != 2)
+                command(fmt::format("create_bonds single/bond 1 {} {}", id + 5, id + 6));
+        }
+        command("molecule pre rxn_pre.mol");
+        command("molecule post rxn_post.mol");
+        command("fix rxn all bond/react reset_mol_ids no react rxn1 all 1 0.0 2.0 pre post rxn.map");
+    }
+
+    double nreactions() { return lmp->modify->get_fix_by_id("rxn")->compute_vector(0); }
+
+    // whether the initiator atoms of copy K are bonded
+
+    bool reacted(int k)
+    {
+        auto atom = lmp->atom;
+        const int i = atom->map(6 * k + 2);
+        for (int m = 0; m < atom->nspecial[i][0]; ++m)
+            if (atom->special[i][m] == 6 * k + 3) return true;
+        return false;
+    }
+};
+
+TEST_F(FixBondReactTest, counts)
+{
+    const std::vector<int> mismatch = {0, 1, 0, 2, 0, 1};
+
+    BEGIN_HIDE_OUTPUT();
+    create_system(mismatch);
+    command("run 10 post no");
+    END_HIDE_OUTPUT();
+
+    // each matching pair reacts exactly once, the others are rejected on
+    // every attempt
+
+    ASSERT_DOUBLE_EQ(nreactions(), 3.0);
+    for (int k = 0; k < NCOPY; ++k)
+        EXPECT_EQ(reacted(k), mismatch[k] == 0) << "copy " << k;
+    EXPECT_EQ(lmp->atom->nbonds, 4 * NCOPY - 1 + 3);
+
+    // rejected pairs whose chains now match the template must react
+    // in the next run, so they must not be skipped as cached rejections
+
+    BEGIN_HIDE_OUTPUT();
+    command("set atom 12 type 1");
+    command("run 10 post no");
+    END_HIDE_OUTPUT();
+    ASSERT_DOUBLE_EQ(nreactions(), 4.0);
+    EXPECT_TRUE(reacted(1));
+    EXPECT_FALSE(reacted(3));
+    EXPECT_FALSE(reacted(5));
+
+    BEGIN_HIDE_OUTPUT();
+    command("create_bonds single/bond 1 23 24");
+    command("set atom 36 type 1");
+    command("run 10 post no");
+    END_HIDE_OUTPUT();
+    ASSERT_DOUBLE_EQ(nreactions(), 6.0);
+    for (int k = 0; k < NCOPY; ++k)
+        EXPECT_TRUE(reacted(k)) << "copy " << k;
+    EXPECT_EQ(lmp->atom->nbonds, 5 * NCOPY);
+}
+} // namespace LAMMPS_NS
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleMock(&argc, argv);
+
+    if (LAMMPS_NS::platform::mpi_vendor() == "Open MPI" && !LAMMPS_NS::Info::has_exceptions())
+        std::cout << "Warning: using OpenMPI without exceptions. Death tests will be skipped\n";
+
+    // handle arguments passed via environment variable
+    if (const char *var = getenv("TEST_ARGS")) {
+        std::vector<std::string> env = LAMMPS_NS::utils::split_words(var);
+        for (auto arg : env) {
+            if (arg == "-v") {
+                verbose = true;
+            }
+        }
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) verbose = true;
+
+    int rv = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return rv;
+}
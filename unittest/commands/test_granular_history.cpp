@@ -0,0 +1,165 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS Development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "../testing/core.h"
+#include "atom.h"
+#include "compute.h"
+#include "info.h"
+#include "input.h"
+#include "lammps.h"
+#include "math_const.h"
+#include "modify.h"
+#include "platform.h"
+#include "utils.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mpi.h>
+#include <vector>
+
+// whether to print verbose output (i.e. not capturing LAMMPS screen output).
+bool verbose = false;
+
+namespace LAMMPS_NS {
+
+// contact history of a large sphere touching many small ones, so that
+// fix NEIGH_HISTORY looks up its partners through the hash and not the
+// linear search, which is used up to NPARTNER_LINEAR = 8 partners
+
+class GranularHistoryTest : public LAMMPSTest {
+protected:
+    static constexpr int NSMALL = 20;    // number of small spheres
+
+    void SetUp() override
+    {
+        testbinary = "GranularHistoryTest";
+        LAMMPSTest::SetUp();
+        if (!info->has_style("pair", "gran/hooke/history")) GTEST_SKIP();
+    }
+
+    // large sphere at the origin, small spheres on a shell slightly
+    // overlapping it, small spheres do not touch each other
+
+    void create_system(const std::string &pair, const std::string &neigh)
+    {
+        command("clear");
+        command("units lj");
+        command("atom_style sphere");
+        command("atom_modify map array");
+        command("comm_modify vel yes");
+        command("region box block -10 10 -10 10 -10 10");
+        command("create_box 1 box");
+        command("create_atoms 1 single 0.0 0.0 0.0");
+        const double golden = MathConst::MY_PI * (3.0 - sqrt(5.0));
+        for (int i = 0; i < NSMALL; ++i) {
+            const double z   = 1.0 - (2.0 * i + 1.0) / NSMALL;
+            const double r   = sqrt(1.0 - z * z);
+            const double phi = golden * i;
+            command(fmt::format("create_atoms 1 single {} {} {}", 4.45 * r * cos(phi),
+                                4.45 * r * sin(phi), 4.45 * z));
+        }
+        command("set atom 1 diameter 8.0");
+        command("set atom 2* diameter 1.0");
+        command("set atom * density 1.0");
+        command("velocity all create 0.1 4928 loop geom");
+        command("pair_style " + pair);
+        command("pair_coeff * *");
+        command("neighbor 0.5 bin");
+        command("neigh_modify " + neigh);
+        command("fix 1 all nve/sphere");
+        command("timestep 0.0001");
+    }
+
+    // positions and angular velocities of all atoms after N steps
+
+    std::vector<double> run_history(const std::string &pair, const std::string &neigh)
+    {
+        BEGIN_HIDE_OUTPUT();
+        create_system(pair, neigh);
+        command("run 100 post no");
+        END_HIDE_OUTPUT();
+
+        auto atom = lmp->atom;
+        std::vector<double> data(6 * atom->natoms);
+        for (int i = 0; i < atom->nlocal; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                data[6 * (atom->tag[i] - 1) + k]     = atom->x[i][k];
+                data[6 * (atom->tag[i] - 1) + 3 + k] = atom->omega[i][k];
+            }
+        }
+        return data;
+    }
+};
+
+TEST_F(GranularHistoryTest, many_partners)
+{
+    const std::string hooke = "gran/hooke/history 2000.0 NULL 50.0 NULL 0.5 0";
+
+    // the large sphere must keep all its contacts during the run
+
+    BEGIN_HIDE_OUTPUT();
+    create_system(hooke, "every 1 delay 0 check no");
+    command("compute contact all contact/atom");
+    command("run 100 post no");
+    END_HIDE_OUTPUT();
+    auto contact = lmp->modify->get_compute_by_id("contact");
+    contact->compute_peratom();
+    const int big = lmp->atom->map(1);
+    ASSERT_GE(big, 0);
+    ASSERT_DOUBLE_EQ(contact->vector_atom[big], NSMALL);
+
+    // contact history carried over in every reneighboring must give the
+    // same trajectory as a neighbor list built once for the whole run
+
+    auto ref = run_history(hooke, "every 1000 delay 0 check no");
+    auto val = run_history(hooke, "every 1 delay 0 check no");
+    for (std::size_t i = 0; i < ref.size(); ++i)
+        EXPECT_NEAR(val[i], ref[i], 1.0e-10 * (1.0 + fabs(ref[i]))) << "index " << i;
+
+    // without the shear history the rotation is different
+
+    auto nohistory = run_history("gran/hooke 2000.0 NULL 50.0 NULL 0.5 0", "every 1000");
+    double maxdiff = 0.0;
+    for (std::size_t i = 0; i < ref.size(); ++i)
+        maxdiff = std::max(maxdiff, fabs(nohistory[i] - ref[i]));
+    EXPECT_GT(maxdiff, 1.0e-6);
+}
+} // namespace LAMMPS_NS
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    ::testing::InitGoogleMock(&argc, argv);
+
+    if (LAMMPS_NS::platform::mpi_vendor() == "Open MPI" && !LAMMPS_NS::Info::has_exceptions())
+        std::cout << "Warning: using OpenMPI without exceptions. Death tests will be skipped\n";
+
+    // handle arguments passed via environment variable
+    if (const char *var = getenv("TEST_ARGS")) {
+        std::vector<std::string> env = LAMMPS_NS::utils::split_words(var);
+        for (auto arg : env) {
+            if (arg == "-v") {
+                verbose = true;
+            }
+        }
+    }
+
+    if ((argc > 1) && (strcmp(argv[1], "-v") == 0)) verbose = true;
+
+    int rv = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return rv;
+}
@@ -0,0 +1,129 @@
+// unit tests for checking LAMMPS MPI communication options
+
+#define LAMMPS_LIB_MPI 1
+#include "atom.h"
+#include "comm.h"
+#include "comm_shm.h"
+#include "exceptions.h"
+#include "input.h"
+#include "lammps.h"
+#include "variable.h"
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+namespace LAMMPS_NS {
+
+class MPICommTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    // run a short LJ melt and return final potential energy and pressure
+
+    std::pair<double, double> run_melt(const std::string &options, const std::string &style = "")
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        command("clear");
+        if (!style.empty()) command("comm_style " + style);
+        if (!options.empty()) command("comm_modify " + options);
+        command("units           lj");
+        command("atom_style      atomic");
+        command("lattice         fcc 0.8442");
+        command("region          box block 0 6 0 6 0 6");
+        command("create_box      1 box");
+        command("create_atoms    1 box");
+        command("mass            1 1.0");
+        command("velocity        all create 1.44 87287 loop geom");
+        command("pair_style      lj/cut 2.5");
+        command("pair_coeff      1 1 1.0 1.0 2.5");
+        command("neighbor        0.3 bin");
+        command("neigh_modify    every 10 delay 0 check no");
+        command("fix             1 all nve");
+        if (style == "tiled") command("fix             2 all balance 5 1.0 rcb");
+        command("variable        e equal pe");
+        command("variable        p equal press");
+        command("run             40 post no");
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+        return {lmp->input->variable->compute_equal("v_e"),
+                lmp->input->variable->compute_equal("v_p")};
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+};
+
+TEST_F(MPICommTest, overlap)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ref = run_melt("");
+    auto val = run_melt("overlap yes");
+    EXPECT_NEAR(ref.first, val.first, 1.0e-10);
+    EXPECT_NEAR(ref.second, val.second, 1.0e-10);
+}
+
+TEST_F(MPICommTest, shmem)
+{
+    if (!CommShm::available()) GTEST_SKIP();
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ref = run_melt("");
+    auto val = run_melt("shmem yes");
+    ASSERT_EQ(lmp->comm->shmem, 1);
+    EXPECT_NEAR(ref.first, val.first, 1.0e-10);
+    EXPECT_NEAR(ref.second, val.second, 1.0e-10);
+
+    val = run_melt("shmem yes vel yes");
+    EXPECT_NEAR(ref.first, val.first, 1.0e-10);
+    EXPECT_NEAR(ref.second, val.second, 1.0e-10);
+
+    val = run_melt("shmem yes overlap yes");
+    EXPECT_NEAR(ref.first, val.first, 1.0e-10);
+    EXPECT_NEAR(ref.second, val.second, 1.0e-10);
+
+    // shared memory communication is only implemented for comm_style brick
+
+    std::string mesg;
+    try {
+        run_melt("shmem yes", "tiled");
+    } catch (LAMMPSException &e) {
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+        mesg = e.what();
+    }
+    EXPECT_THAT(mesg, ::testing::HasSubstr("shmem is only supported by comm_style brick"));
+}
+
+TEST_F(MPICommTest, irregular)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ref = run_melt("");
+
+    // repeated rebalancing migrates atoms with the same Irregular instance
+
+    auto val = run_melt("", "tiled");
+    ASSERT_EQ(lmp->atom->natoms, 864);
+    EXPECT_NEAR(ref.first, val.first, 1.0e-8);
+    EXPECT_NEAR(ref.second, val.second, 1.0e-8);
+}
+} // namespace LAMMPS_NS
@@ -0,0 +1,202 @@
+// unit tests for compute cluster/atom, fragment/atom and aggregate/atom on
+// several MPI ranks, compared to clusters found serially from all atoms
+
+#define LAMMPS_LIB_MPI 1
+#include "atom.h"
+#include "comm.h"
+#include "compute.h"
+#include "domain.h"
+#include "input.h"
+#include "lammps.h"
+#include "modify.h"
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+namespace LAMMPS_NS {
+
+class MPIComputeClusterTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+    int natoms;
+    std::vector<double> xall;
+    std::vector<int> typeall;
+
+    // random gas of two atom types, type 1 atoms closer than 1.3 are bonded
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+        command("units lj");
+        command("atom_style bond");
+        command("atom_modify map array");
+        command("region box block 0 8 0 8 0 8");
+        command("create_box 2 box bond/types 1 extra/bond/per/atom 20 "
+                "extra/special/per/atom 50");
+        command("create_atoms 1 random 300 7239 NULL");
+        command("set type 1 type/fraction 2 0.5 4598");
+        command("mass * 1.0");
+        command("pair_style zero 2.0");
+        command("pair_coeff * *");
+        command("bond_style zero");
+        command("bond_coeff 1");
+        command("special_bonds lj/coul 0.0 1.0 1.0");
+        command("group one type 1");
+        command("create_bonds many one one 1 0.0 1.3");
+
+        // keep bonded pairs in the neighbor lists used for clusters
+
+        command("special_bonds lj/coul 1.0 1.0 1.0");
+        command("compute cluster all cluster/atom 1.0");
+        command("compute fragment all fragment/atom");
+        command("compute single all fragment/atom single yes");
+        command("compute aggregate all aggregate/atom 1.0");
+        command("run 0 post no");
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+
+        // positions and types of all atoms, indexed by atom ID - 1
+
+        auto atom = lmp->atom;
+        natoms    = atom->natoms;
+        std::vector<double> x(3 * natoms, 0.0);
+        std::vector<int> type(natoms, 0);
+        for (int i = 0; i < atom->nlocal; ++i) {
+            for (int k = 0; k < 3; ++k)
+                x[3 * (atom->tag[i] - 1) + k] = atom->x[i][k];
+            type[atom->tag[i] - 1] = atom->type[i];
+        }
+        xall.resize(3 * natoms);
+        typeall.resize(natoms);
+        MPI_Allreduce(x.data(), xall.data(), 3 * natoms, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        MPI_Allreduce(type.data(), typeall.data(), natoms, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    // squared minimum image distance of atoms with index I and J
+
+    double distsq(int i, int j)
+    {
+        double rsq = 0.0;
+        for (int k = 0; k < 3; ++k) {
+            double del = xall[3 * i + k] - xall[3 * j + k];
+            del -= 8.0 * std::round(del / 8.0);
+            rsq += del * del;
+        }
+        return rsq;
+    }
+
+    // IDs of the compute for all atoms, indexed by atom ID - 1
+
+    std::vector<double> compute_ids(const std::string &id)
+    {
+        auto compute = lmp->modify->get_compute_by_id(id);
+        compute->compute_peratom();
+        auto atom = lmp->atom;
+        std::vector<double> mine(natoms, 0.0), all(natoms);
+        for (int i = 0; i < atom->nlocal; ++i)
+            mine[atom->tag[i] - 1] = compute->vector_atom[i];
+        MPI_Allreduce(mine.data(), all.data(), natoms, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        return all;
+    }
+
+    // lowest atom ID of each connected set of atoms
+
+    std::vector<double> reference_ids(const std::function<bool(int, int)> &connected)
+    {
+        std::vector<int> root(natoms);
+        std::iota(root.begin(), root.end(), 0);
+        std::function<int(int)> find = [&](int i) {
+            return (root[i] == i) ? i : (root[i] = find(root[i]));
+        };
+        for (int i = 0; i < natoms; ++i)
+            for (int j = i + 1; j < natoms; ++j)
+                if (connected(i, j)) {
+                    int ri = find(i), rj = find(j);
+                    if (ri < rj)
+                        root[rj] = ri;
+                    else
+                        root[ri] = rj;
+                }
+        std::vector<double> ids(natoms);
+        for (int i = 0; i < natoms; ++i)
+            ids[i] = find(i) + 1;
+        return ids;
+    }
+
+    bool bonded(int i, int j)
+    {
+        return (typeall[i] == 1) && (typeall[j] == 1) && (distsq(i, j) < 1.3 * 1.3);
+    }
+};
+
+TEST_F(MPIComputeClusterTest, cluster)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    ASSERT_EQ(natoms, 300);
+    auto ids = compute_ids("cluster");
+    auto ref = reference_ids([&](int i, int j) { return distsq(i, j) < 1.0; });
+    EXPECT_EQ(ids, ref);
+
+    // there must be clusters of several atoms that span subdomains
+
+    int nsingle = 0;
+    for (int i = 0; i < natoms; ++i)
+        if (ref[i] == i + 1) ++nsingle;
+    EXPECT_LT(nsingle, natoms / 2);
+}
+
+TEST_F(MPIComputeClusterTest, fragment)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ref = reference_ids([&](int i, int j) { return bonded(i, j); });
+    EXPECT_EQ(compute_ids("single"), ref);
+
+    // atoms without bonds have fragment ID 0 by default
+
+    auto ids = compute_ids("fragment");
+    int nbonded = 0;
+    for (int i = 0; i < natoms; ++i) {
+        bool isbonded = false;
+        for (int j = 0; j < natoms; ++j)
+            if ((j != i) && bonded(i, j)) isbonded = true;
+        if (isbonded) ++nbonded;
+        EXPECT_EQ(ids[i], isbonded ? ref[i] : 0.0) << "atom ID " << i + 1;
+    }
+    EXPECT_GT(nbonded, natoms / 4);
+}
+
+TEST_F(MPIComputeClusterTest, aggregate)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ids = compute_ids("aggregate");
+    auto ref =
+        reference_ids([&](int i, int j) { return bonded(i, j) || (distsq(i, j) < 1.0); });
+    EXPECT_EQ(ids, ref);
+
+    // bonds longer than the cutoff must join clusters
+
+    EXPECT_NE(ref, reference_ids([&](int i, int j) { return distsq(i, j) < 1.0; }));
+}
+} // namespace LAMMPS_NS
@@ -0,0 +1,290 @@
+// unit tests for parallel options of the PPPM kspace solver
+
+#define LAMMPS_LIB_MPI 1
+#include "atom.h"
+#include "comm.h"
+#include "exceptions.h"
+#include "input.h"
+#include "lammps.h"
+#include "variable.h"
+#include <cmath>
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+using ::testing::ContainsRegex;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+namespace LAMMPS_NS {
+
+class MPIKSpaceTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    // neutral, disordered ionic system with PPPM
+
+    void create_system(const std::string &kspace = "pppm 1.0e-5")
+    {
+        command("clear");
+        command("units           lj");
+        command("atom_style      charge");
+        command("lattice         fcc 0.8442");
+        command("region          box block 0 6 0 6 0 6");
+        command("create_box      2 box");
+        command("create_atoms    1 box");
+        command("set             group all type/ratio 2 0.5 4587");
+        command("set             type 1 charge 1.0");
+        command("set             type 2 charge -1.0");
+        command("displace_atoms  all random 0.05 0.05 0.05 7239 units box");
+        command("mass            * 1.0");
+        command("velocity        all create 1.0 87287 loop geom");
+        command("pair_style      lj/cut/coul/long 2.5");
+        command("pair_coeff      * * 1.0 1.0");
+        command("kspace_style    " + kspace);
+        command("neighbor        0.3 bin");
+        command("variable        e equal pe");
+        command("variable        p equal press");
+    }
+
+    // energy and pressure after N steps with the given kspace_modify options
+
+    std::pair<double, double> run_pppm(const std::string &options, int nsteps = 0)
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        create_system();
+        if (!options.empty()) command("kspace_modify " + options);
+        command("fix             1 all nve");
+        command(fmt::format("run {} post no", nsteps));
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+        return {lmp->input->variable->compute_equal("v_e"),
+                lmp->input->variable->compute_equal("v_p")};
+    }
+
+    // message of the error raised by a command
+
+    std::string error_message(const std::string &line)
+    {
+        std::string mesg;
+        try {
+            command(line);
+        } catch (LAMMPSException &e) {
+            mesg = e.what();
+        }
+        return mesg;
+    }
+};
+
+TEST_F(MPIKSpaceTest, fft_procs_pipeline)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ref = run_pppm("", 10);
+    ASSERT_NE(ref.first, 0.0);
+
+    // FFTs on a subset of procs and pipelined remaps only change rounding
+
+    for (const auto &options :
+         {"fft/pipeline yes", "fft/procs 2", "fft/procs 1", "fft/procs 2 fft/pipeline yes",
+          "fft/procs 3 fft/pipeline yes", "collective yes fft/procs 2"}) {
+        auto val = run_pppm(options, 10);
+        EXPECT_NEAR(ref.first, val.first, 1.0e-8 * fabs(ref.first)) << options;
+        EXPECT_NEAR(ref.second, val.second, 1.0e-8 * fabs(ref.second)) << options;
+    }
+}
+
+TEST_F(MPIKSpaceTest, fft_tune)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    auto ref = run_pppm("");
+
+    // tuning is done in the first run only and reported in the log
+
+    ::testing::internal::CaptureStdout();
+    create_system();
+    command("kspace_modify fft/tune yes");
+    command("run 0 post no");
+    command("run 0 post no");
+    auto output = ::testing::internal::GetCapturedStdout();
+    if (verbose) std::cout << output;
+    double energy = lmp->input->variable->compute_equal("v_e");
+    EXPECT_NEAR(ref.first, energy, 1.0e-10 * fabs(ref.first));
+
+    if (lmp->comm->me == 0) {
+        auto first = output.find("FFT tuning");
+        ASSERT_NE(first, std::string::npos);
+        EXPECT_EQ(output.find("FFT tuning", first + 1), std::string::npos);
+        EXPECT_THAT(output, ContainsRegex("FFT procs = [1-4], pipelined FFT remaps = (yes|no)"));
+    }
+
+    // a different grid is tuned again
+
+    ::testing::internal::CaptureStdout();
+    command("kspace_modify mesh 24 24 24");
+    command("run 0 post no");
+    output = ::testing::internal::GetCapturedStdout();
+    if (verbose) std::cout << output;
+    if (lmp->comm->me == 0) EXPECT_THAT(output, HasSubstr("FFT tuning"));
+}
+
+TEST_F(MPIKSpaceTest, fft_unsupported)
+{
+    for (const auto &style : {"pppm/disp", "pppm/dipole"}) {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        create_system(fmt::format("{} 1.0e-4", style));
+        command("kspace_modify fft/procs 2");
+        auto mesg = error_message("run 0 post no");
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+        EXPECT_THAT(mesg, ContainsRegex("Cannot \\(yet\\) use kspace_modify fft/procs, "
+                                        "fft/pipeline, or fft/tune with PPPMDi(sp|pole)"));
+    }
+}
+
+TEST_F(MPIKSpaceTest, split_run)
+{
+    // FFT plans and Green's function kept from the first run must give
+    // the same trajectory as a single run, up to the changed summation
+    // order from reneighboring during the setup of the second run
+
+    auto ref = run_pppm("", 20);
+
+    if (!verbose) ::testing::internal::CaptureStdout();
+    create_system();
+    command("fix             1 all nve");
+    command("run 10 post no");
+    command("run 10 post no");
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+    EXPECT_NEAR(ref.first, lmp->input->variable->compute_equal("v_e"), 1.0e-12 * fabs(ref.first));
+    EXPECT_NEAR(ref.second, lmp->input->variable->compute_equal("v_p"),
+                1.0e-12 * fabs(ref.second));
+}
+
+TEST_F(MPIKSpaceTest, change_box)
+{
+    // Green's function must be recomputed after the box was changed
+    // between runs, compare to a system created with the changed box
+
+    if (!verbose) ::testing::internal::CaptureStdout();
+    create_system();
+    command("change_box      all x scale 1.05 y scale 0.97 remap");
+    command("run 0 post no");
+    double ref = lmp->input->variable->compute_equal("v_e");
+
+    create_system();
+    command("run 0 post no");
+    double orig = lmp->input->variable->compute_equal("v_e");
+    command("change_box      all x scale 1.05 y scale 0.97 remap");
+    command("run 0 post no");
+    double val = lmp->input->variable->compute_equal("v_e");
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+
+    EXPECT_GT(fabs(orig - ref), 1.0e-4 * fabs(ref));
+    EXPECT_NEAR(ref, val, 1.0e-12 * fabs(ref));
+}
+
+TEST_F(MPIKSpaceTest, change_box_triclinic)
+{
+    // Green's function of a triclinic box must not be reused after
+    // switching back to an orthogonal box with the same dimensions.
+    // PPPM requires to redefine the kspace style after either change.
+
+    if (!verbose) ::testing::internal::CaptureStdout();
+    create_system();
+    command("run 0 post no");
+    double ref = lmp->input->variable->compute_equal("v_e");
+    command("change_box      all triclinic xy final 1.5 remap");
+    command("kspace_style    pppm 1.0e-5");
+    command("run 0 post no");
+    double tilt = lmp->input->variable->compute_equal("v_e");
+    command("change_box      all xy final 0.0 remap ortho");
+    command("kspace_style    pppm 1.0e-5");
+    command("run 0 post no");
+    double val = lmp->input->variable->compute_equal("v_e");
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+
+    EXPECT_GT(fabs(tilt - ref), 1.0e-4 * fabs(ref));
+    EXPECT_NEAR(ref, val, 1.0e-10 * fabs(ref));
+}
+
+TEST_F(MPIKSpaceTest, mts_one)
+{
+    // kspace_modify mts 1 is the same as a plain run
+
+    auto ref = run_pppm("", 20);
+    auto val = run_pppm("mts 1", 20);
+    EXPECT_DOUBLE_EQ(ref.first, val.first);
+    EXPECT_DOUBLE_EQ(ref.second, val.second);
+}
+
+TEST_F(MPIKSpaceTest, mts_impulse)
+{
+    // impulse multiple time stepping conserves the total energy like a
+    // plain run, thermo output on multiples of N does not trigger a warning
+
+    double drift[2];
+    for (int i = 0; i < 2; ++i) {
+        ::testing::internal::CaptureStdout();
+        create_system();
+        if (i) command("kspace_modify mts 2");
+        command("fix             1 all nve");
+        command("timestep        0.002");
+        command("thermo          10");
+        command("variable        et equal etotal");
+        command("run 0 post no");
+        double e0 = lmp->input->variable->compute_equal("v_et");
+        command("run 100 post no");
+        double e1 = lmp->input->variable->compute_equal("v_et");
+        auto output = ::testing::internal::GetCapturedStdout();
+        if (verbose) std::cout << output;
+        drift[i] = fabs(e1 - e0) / fabs(e0);
+        EXPECT_THAT(output, Not(HasSubstr("WARNING: Kspace_modify mts")));
+    }
+    // the drift is dominated by the truncated LJ potential, not the splitting
+    EXPECT_LT(drift[0], 5.0e-3);
+    EXPECT_LT(drift[1], 1.2 * drift[0]);
+}
+
+TEST_F(MPIKSpaceTest, mts_warning)
+{
+    // energy needed on every step computes kspace on every step
+
+    ::testing::internal::CaptureStdout();
+    create_system();
+    command("kspace_modify mts 2");
+    command("fix             1 all nve");
+    command("thermo          1");
+    command("run 20 post no");
+    auto output = ::testing::internal::GetCapturedStdout();
+    if (verbose) std::cout << output;
+    if (lmp->comm->me == 0) {
+        auto first = output.find("WARNING: Kspace_modify mts 2 has no effect");
+        ASSERT_NE(first, std::string::npos);
+        EXPECT_EQ(output.find("WARNING: Kspace_modify mts", first + 1), std::string::npos);
+    }
+}
+} // namespace LAMMPS_NS
@@ -9,6 +9,8 @@
 #include "lammps.h"
 #include "neighbor.h"
 #include "timer.h"
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 #include "gmock/gmock.h"
@@ -191,6 +193,84 @@ TEST_F(MPILoadBalanceTest, rcb)
     ASSERT_GT(dz, lmp->neighbor->skin);
 }
 
+TEST_F(MPILoadBalanceTest, rcb_incremental)
+{
+    command("comm_style tiled");
+    command("create_atoms 1 random 4000 5782 NULL");
+    command("balance 1.0 rcb");
+    ASSERT_EQ(lmp->atom->nlocal, 1000);
+
+    // adding atoms in one corner creates a large imbalance
+
+    command("region corner block 0 8 0 8 0 8");
+    command("create_atoms 1 random 2000 9713 corner");
+
+    int nmax, nlast;
+    int nlocal = lmp->atom->nlocal;
+    MPI_Allreduce(&nlocal, &nlast, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+    // incremental rebalancing must reduce the imbalance in every step
+    // and move at most the atoms close to the cuts
+
+    for (int i = 0; i < 4; ++i) {
+        command("balance 1.0 rcb incremental 0.2");
+        nlocal = lmp->atom->nlocal;
+        MPI_Allreduce(&nlocal, &nmax, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        EXPECT_LT(nmax, nlast);
+        nlast = nmax;
+    }
+    EXPECT_LT(nmax, 1800);
+    ASSERT_EQ(lmp->atom->natoms, 6000);
+}
+
+TEST_F(MPILoadBalanceTest, rcb_weight_pair)
+{
+    // dense half with many neighbors per atom and sparse half with few
+
+    command("comm_style tiled");
+    command("lattice sc 1.0");
+    command("region dense block 0 9.5 0 19.5 0 19.5 units box");
+    command("create_atoms 1 region dense");
+    command("lattice sc 0.125");
+    command("region sparse block 10 19.5 0 19.5 0 19.5 units box");
+    command("create_atoms 1 region sparse");
+    ASSERT_EQ(lmp->atom->natoms, 4500);
+
+    // balance by atom count only, then by pair cost estimate
+
+    int nlocal = lmp->atom->nlocal;
+    int nmax[2], nmin[2];
+    double bounds[2][6];
+    for (int i = 0; i < 2; ++i) {
+        command(std::string("fix 2 all balance 10 1.0 rcb") + (i ? " weight pair 1.0" : ""));
+        command("run 20 post no");
+        command("unfix 2");
+
+        nlocal = lmp->atom->nlocal;
+        MPI_Allreduce(&nlocal, &nmax[i], 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        MPI_Allreduce(&nlocal, &nmin[i], 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        for (int k = 0; k < 3; ++k) {
+            bounds[i][k]     = lmp->domain->sublo[k];
+            bounds[i][k + 3] = lmp->domain->subhi[k];
+        }
+    }
+    ASSERT_EQ(lmp->atom->natoms, 4500);
+
+    // without weights all procs own about the same number of atoms,
+    // with pair weights the atom counts differ and the cuts have moved
+
+    EXPECT_LT(nmax[0] - nmin[0], 100);
+    EXPECT_GT(nmax[1] - nmin[1], 300);
+    EXPECT_GT(nmax[1], nmax[0]);
+
+    double shift = 0.0;
+    for (int k = 0; k < 6; ++k)
+        shift = std::max(shift, fabs(bounds[1][k] - bounds[0][k]));
+    double maxshift;
+    MPI_Allreduce(&shift, &maxshift, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    EXPECT_GT(maxshift, 0.25);
+}
+
 TEST_F(MPILoadBalanceTest, rcb_min_size)
 {
     GTEST_SKIP();
@@ -0,0 +1,117 @@
+// unit tests for the output of fix reaxff/species written directly
+// and from the background thread with async yes, on one and several MPI ranks
+
+#define LAMMPS_LIB_MPI 1
+#include "comm.h"
+#include "input.h"
+#include "lammps.h"
+#include "platform.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+namespace LAMMPS_NS {
+
+class ReaxFFSpeciesTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    // hot disordered H/C/O system, so that molecules form and break
+
+    void run_species(const std::string &prefix, const std::string &options)
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        command("clear");
+        command("atom_modify map array");
+        command("units real");
+        command("atom_style charge");
+        command("lattice diamond 3.77");
+        command("region box block 0 2 0 2 0 2");
+        command("create_box 3 box");
+        command("create_atoms 1 box");
+        command("displace_atoms all random 0.1 0.1 0.1 623426");
+        command("mass 1 1.0");
+        command("mass 2 12.0");
+        command("mass 3 16.0");
+        command("set type 1 type/fraction 2 0.5 998877");
+        command("set type 2 type/fraction 3 0.5 887766");
+        command("set type 1 charge 0.00");
+        command("set type 2 charge 0.01");
+        command("set type 3 charge -0.01");
+        command("velocity all create 2000 4534624 loop geom");
+        command("pair_style reaxff NULL");
+        command("pair_coeff * * ffield.reax.mattsson H C O");
+        command("fix qeq all qeq/reaxff 1 0.0 8.0 1.0e-8 reaxff");
+        command("fix nve all nve");
+        command("timestep 0.2");
+        command(fmt::format("fix species all reaxff/species 1 2 10 {0}.species position 10 "
+                            "{0}.pos.* {1}",
+                            prefix, options));
+        command("run 40 post no");
+        command("unfix species");
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    std::string file_contents(const std::string &file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+};
+
+TEST_F(ReaxFFSpeciesTest, async_identical)
+{
+    // file names depend on the number of procs, so serial and MPI tests may run concurrently
+
+    auto sync  = fmt::format("species_sync{}", lmp->comm->nprocs);
+    auto async = fmt::format("species_async{}", lmp->comm->nprocs);
+    run_species(sync, "");
+    run_species(async, "async yes");
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    if (lmp->comm->me == 0) {
+        auto species = file_contents(sync + ".species");
+        ASSERT_THAT(species, ::testing::HasSubstr("No_Moles"));
+        EXPECT_EQ(species, file_contents(async + ".species"));
+        platform::unlink(sync + ".species");
+        platform::unlink(async + ".species");
+
+        for (int step = 10; step <= 40; step += 10) {
+            auto syncpos  = fmt::format("{}.pos.{}", sync, step);
+            auto asyncpos = fmt::format("{}.pos.{}", async, step);
+            auto pos      = file_contents(syncpos);
+            ASSERT_FALSE(pos.empty()) << syncpos;
+            EXPECT_EQ(pos, file_contents(asyncpos)) << asyncpos;
+            platform::unlink(syncpos);
+            platform::unlink(asyncpos);
+        }
+    }
+}
+} // namespace LAMMPS_NS
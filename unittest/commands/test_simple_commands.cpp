@@ -19,6 +19,7 @@
 #include "info.h"
 #include "input.h"
 #include "output.h"
+#include "timer.h"
 #include "update.h"
 #include "utils.h"
 #include "variable.h"
@@ -33,6 +34,7 @@
 #include <fstream>
 #include <iostream>
 #include <mpi.h>
+#include <vector>
 
 // whether to print verbose output (i.e. not capturing LAMMPS screen output).
 bool verbose = false;
@@ -49,6 +51,62 @@ TEST_F(SimpleCommandsTest, UnknownCommand)
     TEST_FAILURE(".*ERROR: Unknown command.*", command("XXX one two"););
 }
 
+TEST_F(SimpleCommandsTest, CommOverlap)
+{
+    ASSERT_EQ(lmp->comm->overlap, 0);
+
+    BEGIN_HIDE_OUTPUT();
+    command("comm_modify overlap yes");
+    END_HIDE_OUTPUT();
+    ASSERT_EQ(lmp->comm->overlap, 1);
+
+    // run the same trajectory with and without overlap
+    // periodic images are exchanged with self swaps, owned atoms are sent first
+
+    std::vector<double> energy;
+    for (const auto &flag : {"yes", "no"}) {
+        BEGIN_HIDE_OUTPUT();
+        command("clear");
+        command(std::string("comm_modify overlap ") + flag);
+        command("lattice fcc 0.8442");
+        command("region box block 0 4 0 4 0 4");
+        command("create_box 1 box");
+        command("create_atoms 1 box");
+        command("mass 1 1.0");
+        command("velocity all create 1.44 87287 loop geom");
+        command("pair_style lj/cut 2.5");
+        command("pair_coeff 1 1 1.0 1.0 2.5");
+        command("neighbor 0.3 bin");
+        command("neigh_modify every 20 delay 0 check no");
+        command("fix 1 all nve");
+        command("variable e equal pe");
+        command("variable p equal press");
+        command("run 50 post no");
+        END_HIDE_OUTPUT();
+        energy.push_back(lmp->input->variable->compute_equal("v_e"));
+        energy.push_back(lmp->input->variable->compute_equal("v_p"));
+    }
+    EXPECT_NEAR(energy[0], energy[2], 1.0e-10);
+    EXPECT_NEAR(energy[1], energy[3], 1.0e-10);
+
+    // overlap is not available for pair styles without interior/boundary split
+
+    BEGIN_HIDE_OUTPUT();
+    command("comm_modify overlap yes");
+    command("pair_style zero 2.5");
+    command("pair_coeff * *");
+    END_HIDE_OUTPUT();
+    BEGIN_CAPTURE_OUTPUT();
+    command("run 0 post no");
+    auto text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, ContainsRegex(".*WARNING: Comm overlap is not supported.*"));
+
+    TEST_FAILURE(".*ERROR: Illegal comm_modify overlap command: missing argument.*",
+                 command("comm_modify overlap"););
+    TEST_FAILURE(".*ERROR: Expected boolean parameter instead of 'xxx'.*",
+                 command("comm_modify overlap xxx"););
+}
+
 TEST_F(SimpleCommandsTest, Echo)
 {
     ASSERT_EQ(lmp->input->echo_screen, 1);
@@ -352,6 +410,64 @@ TEST_F(SimpleCommandsTest, Thermo)
     TEST_FAILURE(".*ERROR: Expected integer.*", command("thermo xxx"););
 }
 
+TEST_F(SimpleCommandsTest, Timer)
+{
+    ASSERT_FALSE(lmp->timer->has_detail());
+
+    BEGIN_CAPTURE_OUTPUT();
+    command("timer detail json test_timer.json");
+    auto text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, ContainsRegex(".*New timer settings: .* detail=yes.*"));
+    ASSERT_TRUE(lmp->timer->has_detail());
+
+    BEGIN_HIDE_OUTPUT();
+    command("region box block 0 4 0 4 0 4");
+    command("create_box 1 box");
+    command("create_atoms 1 single 1.0 1.0 1.0");
+    command("create_atoms 1 single 2.0 2.0 2.0");
+    command("mass 1 1.0");
+    command("pair_style hybrid/overlay zero 2.0 zero 2.0");
+    command("pair_coeff 1 1 zero 1");
+    command("pair_coeff 1 1 zero 2");
+    command("fix nve all nve");
+    command("fix freeze all setforce 0.0 0.0 0.0");
+    command("compute count all property/atom id");
+    command("compute max all reduce max c_count");
+    command("thermo_style custom step c_max");
+    command("thermo 5");
+    command("dump xyz all xyz 5 test_timer.xyz");
+    END_HIDE_OUTPUT();
+
+    BEGIN_CAPTURE_OUTPUT();
+    command("run 10 post yes");
+    text = END_CAPTURE_OUTPUT();
+    ASSERT_THAT(text, ContainsRegex(".*Detailed timing breakdown:.*"));
+    ASSERT_THAT(text, ContainsRegex(".*fix +\\| nve \\(nve\\) +\\| +20 \\|.*"));
+    ASSERT_THAT(text, ContainsRegex(".*fix +\\| freeze \\(setforce\\) +\\| +10 \\|.*"));
+    ASSERT_THAT(text, ContainsRegex(".*pair +\\| zero:2 \\(zero\\) +\\| +[0-9]+ \\|.*"));
+    ASSERT_THAT(text, ContainsRegex(".*compute +\\| max \\(reduce\\) +\\| +[0-9]+ \\|.*"));
+    ASSERT_THAT(text, ContainsRegex(".*dump +\\| xyz \\(xyz\\) +\\| +[0-9]+ \\|.*"));
+
+    auto lines = read_lines("test_timer.json");
+    std::string json;
+    for (const auto &line : lines) json += line;
+    ASSERT_THAT(json, ContainsRegex(".*\"nsteps\": 10,.*"));
+    ASSERT_THAT(json, ContainsRegex(".*\"category\": \"fix\", \"id\": \"nve\", \"style\": \"nve\", "
+                                    "\"calls\": 20,.*"));
+    ASSERT_THAT(json, ContainsRegex(".*\"category\": \"dump\", \"id\": \"xyz\", \"style\": "
+                                    "\"xyz\", \"calls\": [0-9]+,.*"));
+    platform::unlink("test_timer.json");
+    platform::unlink("test_timer.xyz");
+
+    BEGIN_HIDE_OUTPUT();
+    command("timer nodetail json none");
+    END_HIDE_OUTPUT();
+    ASSERT_FALSE(lmp->timer->has_detail());
+
+    TEST_FAILURE(".*ERROR: Illegal timer command.*", command("timer json"););
+    TEST_FAILURE(".*ERROR: Illegal timer command.*", command("timer xxx"););
+}
+
 TEST_F(SimpleCommandsTest, TimeStep)
 {
     BEGIN_HIDE_OUTPUT();
@@ -296,6 +296,81 @@ TEST_F(VariableTest, AtomicSystem)
                  variable->compute_equal("max(v_sum2)"););
 }
 
+TEST_F(VariableTest, AtomExpressions)
+{
+    molecular_system();
+
+    BEGIN_HIDE_OUTPUT();
+    command("group right region right");
+    command("variable a1 atom x*y+z/2.0-mass*q^2");
+    command("variable a2 atom sqrt(abs(x))+exp(-y*y)*cos(z)-atan2(y,x)+floor(id/3)+ceil(x)+round(z)");
+    command("variable a3 atom ((x>0)&&(y<0))||!(z==0.125)");
+    command("variable a4 atom 1.0/(x-0.125)");
+    command("variable a5 atom gmask(right)*x+rmask(top)");
+    END_HIDE_OUTPUT();
+
+    auto atom   = lmp->atom;
+    int nlocal  = atom->nlocal;
+    double **x  = atom->x;
+    double *q   = atom->q;
+    double *m   = atom->rmass;
+    tagint *tag = atom->tag;
+    int right   = group->find("right");
+    auto top    = domain->get_region_by_id("top");
+    std::vector<double> result(2 * nlocal);
+
+    variable->compute_atom(variable->find("a1"), 0, result.data(), 1, 0);
+    for (int i = 0; i < nlocal; ++i)
+        EXPECT_DOUBLE_EQ(result[i], x[i][0] * x[i][1] + x[i][2] / 2.0 - m[i] * pow(q[i], 2.0));
+
+    variable->compute_atom(variable->find("a2"), 0, result.data(), 1, 0);
+    for (int i = 0; i < nlocal; ++i) {
+        double z   = x[i][2];
+        double ref = sqrt(fabs(x[i][0])) + exp(-x[i][1] * x[i][1]) * cos(z) -
+            atan2(x[i][1], x[i][0]) + floor(tag[i] / 3.0) + ceil(x[i][0]) +
+            (((z - floor(z)) >= 0.5) ? ceil(z) : floor(z));
+        EXPECT_DOUBLE_EQ(result[i], ref);
+    }
+
+    variable->compute_atom(variable->find("a3"), 0, result.data(), 1, 0);
+    for (int i = 0; i < nlocal; ++i) {
+        bool ref = ((x[i][0] > 0.0) && (x[i][1] < 0.0)) || (x[i][2] != 0.125);
+        EXPECT_DOUBLE_EQ(result[i], ref ? 1.0 : 0.0);
+    }
+
+    // atoms outside the group must not trigger errors and are zeroed
+    // or left unchanged when summing with stride
+
+    for (auto &r : result) r = -1.0;
+    variable->compute_atom(variable->find("a4"), right, result.data(), 2, 0);
+    for (int i = 0; i < nlocal; ++i) {
+        if (x[i][0] > 0.5)
+            EXPECT_DOUBLE_EQ(result[2 * i], 1.0 / (x[i][0] - 0.125));
+        else
+            EXPECT_DOUBLE_EQ(result[2 * i], 0.0);
+        EXPECT_DOUBLE_EQ(result[2 * i + 1], -1.0);
+    }
+    variable->compute_atom(variable->find("a4"), right, result.data(), 2, 1);
+    for (int i = 0; i < nlocal; ++i) {
+        if (x[i][0] > 0.5)
+            EXPECT_DOUBLE_EQ(result[2 * i], 2.0 / (x[i][0] - 0.125));
+        else
+            EXPECT_DOUBLE_EQ(result[2 * i], 0.0);
+    }
+
+    // formula with functions not supported by bytecode
+
+    variable->compute_atom(variable->find("a5"), 0, result.data(), 1, 0);
+    for (int i = 0; i < nlocal; ++i) {
+        double ref = (x[i][0] > 0.5) ? x[i][0] : 0.0;
+        if (top->match(x[i][0], x[i][1], x[i][2])) ref += 1.0;
+        EXPECT_DOUBLE_EQ(result[i], ref);
+    }
+
+    TEST_FAILURE(".*ERROR on proc 0: Divide by 0 in variable formula.*",
+                 variable->compute_atom(variable->find("a4"), 0, result.data(), 1, 0););
+}
+
 TEST_F(VariableTest, Expressions)
 {
     atomic_system();
@@ -0,0 +1,125 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS Development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "library.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#define STRINGIFY(val) XSTR(val)
+#define XSTR(val) #val
+
+const char tasystem[] = "units           metal\n"
+                        "atom_style      atomic\n"
+                        "atom_modify     map array\n"
+                        "lattice         bcc 3.316\n"
+                        "region          box block 0 3 0 3 0 3\n"
+                        "create_box      1 box\n"
+                        "create_atoms    1 box\n"
+                        "displace_atoms  all random 0.1 0.1 0.1 623426\n"
+                        "mass            1 180.88\n";
+
+const char descriptor[] = " descriptor sna Ta06A.mliap.descriptor";
+
+namespace LAMMPS_NS {
+
+// per-atom energy and force of one LAMMPS instance, indexed by atom ID - 1
+
+struct PerAtom {
+    std::vector<double> e, f;
+};
+
+static PerAtom run_mliap(void *lmp, const std::string &models, bool variance = false)
+{
+    lammps_commands_string(lmp, tasystem);
+    lammps_command(lmp, ("pair_style mliap " + models + descriptor).c_str());
+    lammps_command(lmp, "pair_coeff * * Ta");
+    lammps_command(lmp, "compute pe all pe/atom");
+    if (variance) lammps_command(lmp, "fix uq all pair 1 mliap variance 1");
+    lammps_command(lmp, "run 0 post no");
+
+    const int natoms = (int)lammps_get_natoms(lmp);
+    auto id          = (int *)lammps_extract_atom(lmp, "id");
+    auto f           = (double **)lammps_extract_atom(lmp, "f");
+    auto pe = (double *)lammps_extract_compute(lmp, "pe", LMP_STYLE_ATOM, LMP_TYPE_VECTOR);
+    PerAtom data;
+    data.e.resize(natoms);
+    data.f.resize(3 * natoms);
+    for (int i = 0; i < natoms; ++i) {
+        data.e[id[i] - 1] = pe[i];
+        for (int k = 0; k < 3; ++k)
+            data.f[3 * (id[i] - 1) + k] = f[i][k];
+    }
+    return data;
+}
+
+TEST(MliapCommittee, Variance)
+{
+    if (!lammps_config_has_package("ML-IAP") || !lammps_config_has_package("ML-SNAP"))
+        GTEST_SKIP();
+
+    const char *lmpargv[] = {"committee", "-log", "none", "-nocite", "-screen", "none"};
+    int lmpargc           = sizeof(lmpargv) / sizeof(const char *);
+
+    const std::string first  = "linear Ta06A.mliap.model";
+    const std::string second =
+        "linear " STRINGIFY(TEST_INPUT_FOLDER) "/Ta06A.committee.mliap.model";
+
+    void *lmp = lammps_open_no_mpi(lmpargc, (char **)lmpargv, nullptr);
+    auto ref1 = run_mliap(lmp, "model " + first);
+    lammps_close(lmp);
+    lmp       = lammps_open_no_mpi(lmpargc, (char **)lmpargv, nullptr);
+    auto ref2 = run_mliap(lmp, "model " + second);
+    lammps_close(lmp);
+
+    lmp      = lammps_open_no_mpi(lmpargc, (char **)lmpargv, nullptr);
+    auto val = run_mliap(lmp, "model " + first + " committee 1 " + second, true);
+    auto variance =
+        (double **)lammps_extract_fix(lmp, "uq", LMP_STYLE_ATOM, LMP_TYPE_ARRAY, 0, 0);
+    ASSERT_NE(variance, nullptr);
+
+    // mean of the two models and the variance of two values (a-b)^2/4
+
+    const int natoms = val.e.size();
+    auto id          = (int *)lammps_extract_atom(lmp, "id");
+    double maxevar = 0.0, maxfvar = 0.0;
+    for (int i = 0; i < natoms; ++i) {
+        const int n = id[i] - 1;
+        EXPECT_NEAR(val.e[n], 0.5 * (ref1.e[n] + ref2.e[n]), 1.0e-10);
+        const double de   = ref1.e[n] - ref2.e[n];
+        const double evar = 0.25 * de * de;
+        double fvar       = 0.0;
+        for (int k = 0; k < 3; ++k) {
+            const int m = 3 * n + k;
+            EXPECT_NEAR(val.f[m], 0.5 * (ref1.f[m] + ref2.f[m]), 1.0e-10);
+            const double df = ref1.f[m] - ref2.f[m];
+            fvar += 0.25 * df * df;
+        }
+        EXPECT_NEAR(variance[i][0], evar, 1.0e-10 * (1.0 + evar)) << "atom ID " << n + 1;
+        EXPECT_NEAR(variance[i][1], fvar, 1.0e-10 * (1.0 + fvar)) << "atom ID " << n + 1;
+        maxevar = std::max(maxevar, evar);
+        maxfvar = std::max(maxfvar, fvar);
+    }
+
+    // the models must differ for the test to be meaningful
+
+    EXPECT_GT(maxevar, 1.0e-4);
+    EXPECT_GT(maxfvar, 1.0e-4);
+    lammps_close(lmp);
+}
+} // namespace LAMMPS_NS
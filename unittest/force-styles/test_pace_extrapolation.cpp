@@ -0,0 +1,235 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS Development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "library.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define STRINGIFY(val) XSTR(val)
+#define XSTR(val) #val
+
+const char cusystem[] = "units           metal\n"
+                        "atom_style      atomic\n"
+                        "atom_modify     map array\n"
+                        "lattice         fcc 3.6\n"
+                        "region          box block 0 2 0 2 0 2\n"
+                        "create_box      1 box\n"
+                        "create_atoms    1 box\n"
+                        "displace_atoms  all random 0.1 0.1 0.1 623426\n"
+                        "mass            1 63.546\n";
+
+// cutoff of the potential in Cu-uncertain.yaml
+
+static constexpr double CUTOFF = 4.0;
+
+namespace LAMMPS_NS {
+
+// one environment of an uncertain atom as written by pair style pace/extrapolation
+
+struct Environment {
+    long timestep;
+    int id;
+    double gamma;
+    std::vector<int> z;
+    std::vector<double> x;
+};
+
+static void run_pace(void *lmp, const std::string &file)
+{
+    lammps_commands_string(lmp, cusystem);
+    lammps_command(lmp, ("pair_style pace/extrapolation uncertain 0.0 1.0e10 " + file).c_str());
+    lammps_command(lmp, "pair_coeff * * " STRINGIFY(TEST_INPUT_FOLDER) "/Cu-uncertain.yaml "
+                        STRINGIFY(TEST_INPUT_FOLDER) "/Cu-uncertain.asi Cu");
+    lammps_command(lmp, "fix pace_gamma all pair 1 pace/extrapolation gamma 1");
+    lammps_command(lmp, "run 0 post no");
+}
+
+static std::vector<Environment> read_extxyz(const std::string &file)
+{
+    std::vector<Environment> envs;
+    std::ifstream in(file);
+    std::string line;
+    while (std::getline(in, line)) {
+        Environment env;
+        const int n = std::stoi(line);
+        std::getline(in, line);
+        EXPECT_EQ(sscanf(line.c_str(), "Properties=species:S:1:pos:R:3 timestep=%ld id=%d gamma=%lg",
+                         &env.timestep, &env.id, &env.gamma),
+                  3)
+            << line;
+        for (int k = 0; k < n; ++k) {
+            std::getline(in, line);
+            std::istringstream words(line);
+            std::string element;
+            double x, y, z;
+            words >> element >> x >> y >> z;
+            EXPECT_EQ(element, "Cu");
+            env.z.push_back(29);
+            env.x.push_back(x);
+            env.x.push_back(y);
+            env.x.push_back(z);
+        }
+        envs.push_back(env);
+    }
+    return envs;
+}
+
+static std::vector<Environment> read_binary(const std::string &file)
+{
+    std::vector<Environment> envs;
+    FILE *fp = fopen(file.c_str(), "rb");
+    if (!fp) return envs;
+    double head[4], atom[4];
+    while (fread(head, sizeof(double), 4, fp) == 4) {
+        Environment env;
+        env.timestep = (long)head[0];
+        env.id       = (int)head[1];
+        env.gamma    = head[2];
+        const int n  = (int)head[3];
+        for (int k = 0; k < n; ++k) {
+            EXPECT_EQ(fread(atom, sizeof(double), 4, fp), 4U);
+            env.z.push_back((int)atom[0]);
+            for (int m = 1; m < 4; ++m)
+                env.x.push_back(atom[m]);
+        }
+        envs.push_back(env);
+    }
+    fclose(fp);
+    return envs;
+}
+
+// check each environment against the atoms of the periodic system:
+// the uncertain atom is first and at the origin, and all other entries
+// are exactly the periodic images of atoms within the cutoff
+
+static void check_environments(void *lmp, const std::vector<Environment> &envs, double epsilon)
+{
+    const int natoms = (int)lammps_get_natoms(lmp);
+    ASSERT_EQ((int)envs.size(), natoms);
+
+    auto boxlo = (double *)lammps_extract_global(lmp, "boxlo");
+    auto boxhi = (double *)lammps_extract_global(lmp, "boxhi");
+    auto x     = (double **)lammps_extract_atom(lmp, "x");
+    auto id    = (int *)lammps_extract_atom(lmp, "id");
+    const double prd[3] = {boxhi[0] - boxlo[0], boxhi[1] - boxlo[1], boxhi[2] - boxlo[2]};
+    const int nimage[3] = {(int)ceil(CUTOFF / prd[0]), (int)ceil(CUTOFF / prd[1]),
+                           (int)ceil(CUTOFF / prd[2])};
+
+    std::vector<bool> seen(natoms + 1, false);
+    for (const auto &env : envs) {
+        EXPECT_EQ(env.timestep, 0);
+        ASSERT_GT(env.id, 0);
+        ASSERT_LE(env.id, natoms);
+        EXPECT_FALSE(seen[env.id]) << "atom ID " << env.id;
+        seen[env.id] = true;
+        EXPECT_GE(env.gamma, 0.0);
+        int i = 0;
+        while ((i < natoms) && (id[i] != env.id)) ++i;
+        ASSERT_LT(i, natoms);
+
+        const int n = env.z.size();
+        ASSERT_GE(n, 1);
+        EXPECT_EQ(env.z[0], 29);
+        for (int m = 0; m < 3; ++m)
+            EXPECT_EQ(env.x[m], 0.0);
+
+        // reference list of all neighbors within the cutoff including periodic images
+
+        std::vector<std::vector<double>> ref;
+        for (int j = 0; j < natoms; ++j) {
+            for (int a = -nimage[0]; a <= nimage[0]; ++a) {
+                for (int b = -nimage[1]; b <= nimage[1]; ++b) {
+                    for (int c = -nimage[2]; c <= nimage[2]; ++c) {
+                        const double del[3] = {x[j][0] + a * prd[0] - x[i][0],
+                                               x[j][1] + b * prd[1] - x[i][1],
+                                               x[j][2] + c * prd[2] - x[i][2]};
+                        const double rsq = del[0] * del[0] + del[1] * del[1] + del[2] * del[2];
+                        if ((rsq > 0.0) && (rsq < CUTOFF * CUTOFF))
+                            ref.push_back({del[0], del[1], del[2]});
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(n - 1, (int)ref.size()) << "atom ID " << env.id;
+
+        // each written neighbor must match exactly one reference neighbor
+
+        std::vector<bool> used(ref.size(), false);
+        for (int k = 1; k < n; ++k) {
+            EXPECT_EQ(env.z[k], 29);
+            int match = -1;
+            for (int r = 0; r < (int)ref.size(); ++r) {
+                if (used[r]) continue;
+                if ((fabs(env.x[3 * k] - ref[r][0]) < epsilon) &&
+                    (fabs(env.x[3 * k + 1] - ref[r][1]) < epsilon) &&
+                    (fabs(env.x[3 * k + 2] - ref[r][2]) < epsilon)) {
+                    match = r;
+                    break;
+                }
+            }
+            EXPECT_GE(match, 0) << "atom ID " << env.id << " neighbor " << k;
+            if (match >= 0) used[match] = true;
+        }
+    }
+}
+
+TEST(PaceExtrapolation, Uncertain)
+{
+    if (!lammps_config_has_package("ML-PACE")) GTEST_SKIP();
+
+    const char *lmpargv[] = {"uncertain", "-log", "none", "-nocite", "-screen", "none"};
+    int lmpargc           = sizeof(lmpargv) / sizeof(const char *);
+
+    const std::string xyzfile = "test_pace_uncertain.extxyz";
+    const std::string binfile = "test_pace_uncertain.bin";
+
+    // every atom is uncertain with these thresholds, so every environment is written.
+    // the file is closed when the pair style is replaced.
+
+    void *lmp = lammps_open_no_mpi(lmpargc, (char **)lmpargv, nullptr);
+    run_pace(lmp, xyzfile);
+    lammps_command(lmp, "pair_style zero 1.0");
+    auto xyz = read_extxyz(xyzfile);
+    check_environments(lmp, xyz, 2.0e-8);
+    lammps_close(lmp);
+
+    lmp = lammps_open_no_mpi(lmpargc, (char **)lmpargv, nullptr);
+    run_pace(lmp, binfile);
+    lammps_command(lmp, "pair_style zero 1.0");
+    auto bin = read_binary(binfile);
+    check_environments(lmp, bin, 1.0e-10);
+    lammps_close(lmp);
+
+    // both formats contain the same environments in the same order
+
+    ASSERT_EQ(xyz.size(), bin.size());
+    for (int m = 0; m < (int)xyz.size(); ++m) {
+        EXPECT_EQ(xyz[m].id, bin[m].id);
+        EXPECT_NEAR(xyz[m].gamma, bin[m].gamma, 1.0e-7 * (1.0 + bin[m].gamma));
+        ASSERT_EQ(xyz[m].x.size(), bin[m].x.size());
+        for (int k = 0; k < (int)xyz[m].x.size(); ++k)
+            EXPECT_NEAR(xyz[m].x[k], bin[m].x[k], 1.0e-8);
+    }
+
+    remove(xyzfile.c_str());
+    remove(binfile.c_str());
+}
+} // namespace LAMMPS_NS
@@ -618,6 +618,77 @@ TEST_F(DumpAtomTest, per_processor_multi_file_run1)
     delete_file(run1_p0_1);
 }
 
+TEST_F(DumpAtomTest, async_run1)
+{
+    auto ref_file   = dump_filename("sync_run1");
+    auto async_file = dump_filename("async_run1");
+    generate_dump(ref_file, "", 1);
+    close_dump();
+    BEGIN_HIDE_OUTPUT();
+    command("reset_timestep 0");
+    END_HIDE_OUTPUT();
+    generate_dump(async_file, "async yes", 1);
+
+    // file must be complete at the end of the run
+    ASSERT_FILE_EXISTS(async_file);
+    ASSERT_EQ(count_lines(async_file), 82);
+    ASSERT_THAT(read_lines(async_file), Eq(read_lines(ref_file)));
+
+    continue_dump(1);
+    ASSERT_EQ(count_lines(async_file), 123);
+    close_dump();
+    delete_file(ref_file);
+    delete_file(async_file);
+}
+
+TEST_F(DumpAtomTest, async_toggle_run3)
+{
+    auto ref_file   = dump_filename("sync_run3");
+    auto async_file = dump_filename("async_toggle_run3");
+    generate_dump(ref_file, "", 3);
+    close_dump();
+    BEGIN_HIDE_OUTPUT();
+    command("reset_timestep 0");
+    command(fmt::format("dump id all atom 1 {}", async_file));
+    command("dump_modify id async yes async/queue 4");
+    command("run 3 post no every 1 \"dump_modify id async no\" \"dump_modify id async yes\"");
+    END_HIDE_OUTPUT();
+
+    // snapshots must stay in order when switching between async and sync output
+    ASSERT_FILE_EXISTS(async_file);
+    ASSERT_THAT(read_lines(async_file), Eq(read_lines(ref_file)));
+    close_dump();
+    delete_file(ref_file);
+    delete_file(async_file);
+}
+
+TEST_F(DumpAtomTest, async_no_buffer_multi_file_run1)
+{
+    auto dump_file = dump_filename("async_run1_*");
+    generate_dump(dump_file, "buffer no async yes async/queue 1", 1);
+
+    auto run1_0 = dump_filename("async_run1_0");
+    auto run1_1 = dump_filename("async_run1_1");
+    ASSERT_FILE_EXISTS(run1_0);
+    ASSERT_FILE_EXISTS(run1_1);
+    ASSERT_EQ(count_lines(run1_0), 41);
+    ASSERT_EQ(count_lines(run1_1), 41);
+    delete_file(run1_0);
+    delete_file(run1_1);
+}
+
+TEST_F(DumpAtomTest, dump_modify_async_invalid)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("dump id all atom 1 dump.txt");
+    END_HIDE_OUTPUT();
+
+    TEST_FAILURE(".*Expected boolean parameter instead of 'xxx'.*",
+                 command("dump_modify id async xxx"););
+    TEST_FAILURE(".*Invalid dump_modify async/queue argument: 0.*",
+                 command("dump_modify id async/queue 0"););
+}
+
 TEST_F(DumpAtomTest, dump_modify_scale_invalid)
 {
     BEGIN_HIDE_OUTPUT();
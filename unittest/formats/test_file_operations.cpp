@@ -16,9 +16,11 @@
 #include "atom.h"
 #include "domain.h"
 #include "error.h"
+#include "group.h"
 #include "info.h"
 #include "input.h"
 #include "lammps.h"
+#include "output.h"
 #include "update.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -26,6 +28,7 @@
 #include <cstdio>
 #include <mpi.h>
 #include <string>
+#include <vector>
 
 using namespace LAMMPS_NS;
 
@@ -404,6 +407,101 @@ TEST_F(FileOperationsTest, write_restart)
     if (Info::has_package("MPIIO")) delete_file("test.restart.mpiio");
 }
 
+TEST_F(FileOperationsTest, write_restart_incremental)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("atom_modify map array");
+    command("lattice fcc 0.8442");
+    command("region box block 0 4 0 4 0 4");
+    command("create_box 2 box");
+    command("create_atoms 1 box");
+    command("mass * 1.0");
+    command("pair_style lj/cut 2.5");
+    command("pair_coeff * * 1.0 1.0");
+    command("velocity all create 1.0 87287 loop geom");
+    command("fix 1 all nve");
+    command("run 20 post no");
+    command("write_restart base.restart incremental 2 precision 1.0e-8");
+    command("run 20 post no");
+    command("set atom 1 type 2");
+    command("write_restart delta.restart incremental 2 precision 1.0e-8");
+    END_HIDE_OUTPUT();
+    ASSERT_THAT(lmp->output->restart_base, StrEq("base.restart"));
+    ASSERT_EQ(lmp->output->restart_ndelta, 1);
+
+    // delta file must be smaller than the base file
+
+    ASSERT_FILE_EXISTS("base.restart");
+    ASSERT_FILE_EXISTS("delta.restart");
+    std::ifstream in("base.restart", std::ios::binary | std::ios::ate);
+    auto basesize = in.tellg();
+    in.close();
+    in.open("delta.restart", std::ios::binary | std::ios::ate);
+    auto deltasize = in.tellg();
+    in.close();
+    ASSERT_LT(deltasize, basesize);
+
+    // record per-atom state by atom ID
+
+    auto atom      = lmp->atom;
+    const int nall = atom->natoms;
+    std::vector<double> xold(3 * nall), vold(3 * nall);
+    std::vector<int> typeold(nall);
+    for (int i = 0; i < atom->nlocal; ++i) {
+        const int j = atom->tag[i] - 1;
+        for (int k = 0; k < 3; ++k) {
+            xold[3 * j + k] = atom->x[i][k];
+            vold[3 * j + k] = atom->v[i][k];
+        }
+        typeold[j] = atom->type[i];
+    }
+
+    // after Nd delta files a new base file is written
+
+    BEGIN_HIDE_OUTPUT();
+    command("write_restart delta2.restart incremental 2 precision 1.0e-8");
+    command("write_restart base2.restart incremental 2 precision 1.0e-8");
+    END_HIDE_OUTPUT();
+    ASSERT_THAT(lmp->output->restart_base, StrEq("base2.restart"));
+    ASSERT_EQ(lmp->output->restart_ndelta, 0);
+
+    TEST_FAILURE(".*ERROR: Write_restart incremental cannot be used with multi-proc or MPI-IO.*",
+                 command("write_restart multi-%.restart incremental 2"););
+    TEST_FAILURE(".*ERROR: Invalid write_restart precision value 0.*",
+                 command("write_restart test.restart incremental 2 precision 0.0"););
+
+    // reconstruct state from delta and base file
+
+    BEGIN_HIDE_OUTPUT();
+    command("clear");
+    command("read_restart delta.restart");
+    END_HIDE_OUTPUT();
+    atom = lmp->atom;
+    ASSERT_EQ(atom->natoms, nall);
+    ASSERT_EQ(lmp->update->ntimestep, 40);
+    for (int i = 0; i < atom->nlocal; ++i) {
+        const int j = atom->tag[i] - 1;
+        for (int k = 0; k < 3; ++k) {
+            EXPECT_NEAR(atom->x[i][k], xold[3 * j + k], 1.0e-8);
+            EXPECT_DOUBLE_EQ(atom->v[i][k], vold[3 * j + k]);
+        }
+        EXPECT_EQ(atom->type[i], typeold[j]);
+    }
+
+    // delta file cannot be read without its base file
+
+    delete_file("base.restart");
+    BEGIN_HIDE_OUTPUT();
+    command("clear");
+    END_HIDE_OUTPUT();
+    TEST_FAILURE(".*ERROR on proc 0: Cannot open base file base.restart of incremental restart.*",
+                 command("read_restart delta.restart"););
+
+    delete_file("delta.restart");
+    delete_file("delta2.restart");
+    delete_file("base2.restart");
+}
+
 TEST_F(FileOperationsTest, write_data)
 {
     BEGIN_HIDE_OUTPUT();
@@ -504,6 +602,63 @@ TEST_F(FileOperationsTest, write_data)
 }
 
 #define GETIDX(i) lmp->atom->map(i)
+TEST_F(FileOperationsTest, read_data_readers)
+{
+    BEGIN_HIDE_OUTPUT();
+    command("echo none");
+    command("atom_modify map array");
+    command("region box block -2 2 -2 2 -2 2");
+    command("create_box 2 box");
+    command("create_atoms 1 random 20 4958 NULL");
+    command("create_atoms 2 random 20 2386 NULL");
+    command("mass * 1.0");
+    command("velocity all create 1.0 87287 loop geom");
+    command("write_data test_readers.data nocoeff");
+    END_HIDE_OUTPUT();
+
+    const int natoms = 40;
+    std::vector<double> xref(3 * natoms), vref(3 * natoms);
+    std::vector<int> tref(natoms);
+    for (int i = 1; i <= natoms; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            xref[3 * (i - 1) + j] = lmp->atom->x[GETIDX(i)][j];
+            vref[3 * (i - 1) + j] = lmp->atom->v[GETIDX(i)][j];
+        }
+        tref[i - 1] = lmp->atom->type[GETIDX(i)];
+    }
+
+    for (const auto &readers : {"1", "all"}) {
+        BEGIN_HIDE_OUTPUT();
+        command("clear");
+        command("atom_modify map array");
+        command(fmt::format("read_data test_readers.data readers {}", readers));
+        END_HIDE_OUTPUT();
+
+        ASSERT_EQ(lmp->atom->natoms, natoms);
+        for (int i = 1; i <= natoms; ++i) {
+            ASSERT_GE(GETIDX(i), 0);
+            EXPECT_EQ(lmp->atom->type[GETIDX(i)], tref[i - 1]);
+            for (int j = 0; j < 3; ++j) {
+                EXPECT_DOUBLE_EQ(lmp->atom->x[GETIDX(i)][j], xref[3 * (i - 1) + j]);
+                EXPECT_DOUBLE_EQ(lmp->atom->v[GETIDX(i)][j], vref[3 * (i - 1) + j]);
+            }
+        }
+    }
+
+    // added atoms are appended after the existing ones
+
+    BEGIN_HIDE_OUTPUT();
+    command("read_data test_readers.data add append readers all group added");
+    END_HIDE_OUTPUT();
+    ASSERT_EQ(lmp->atom->natoms, 2 * natoms);
+    ASSERT_EQ(lmp->group->count(lmp->group->find("added")), natoms);
+    EXPECT_DOUBLE_EQ(lmp->atom->x[GETIDX(natoms + 1)][0], xref[0]);
+
+    TEST_FAILURE(".*ERROR: Illegal read_data readers value -1.*",
+                 command("read_data test_readers.data add append readers -1"););
+    delete_file("test_readers.data");
+}
+
 TEST_F(FileOperationsTest, read_data_fix)
 {
     ASSERT_EQ(lmp->restart_ver, -1);
@@ -0,0 +1,223 @@
+// unit tests for reading data files in parallel with the read_data readers keyword
+
+#define LAMMPS_LIB_MPI 1
+#include "atom.h"
+#include "comm.h"
+#include "exceptions.h"
+#include "group.h"
+#include "input.h"
+#include "lammps.h"
+#include "platform.h"
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+namespace LAMMPS_NS {
+
+class MPIReadDataTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    // positions and types of my local atoms indexed by atom ID
+
+    std::map<tagint, std::array<double, 4>> local_atoms()
+    {
+        std::map<tagint, std::array<double, 4>> data;
+        for (int i = 0; i < lmp->atom->nlocal; ++i)
+            data[lmp->atom->tag[i]] = {lmp->atom->x[i][0], lmp->atom->x[i][1], lmp->atom->x[i][2],
+                                       (double)lmp->atom->type[i]};
+        return data;
+    }
+
+    void write_box(const std::string &file, int nx, int ny, int nz)
+    {
+        command("clear");
+        command("lattice sc 1.0");
+        command(fmt::format("region box block 0 {} 0 {} 0 {}", nx, ny, nz));
+        command("create_box 2 box");
+        command("create_atoms 1 box");
+        command("set type 1 type/fraction 2 0.5 3498");
+        command("displace_atoms all random 0.1 0.1 0.1 8923 units box");
+        command("mass * 1.0");
+        command(fmt::format("write_data {} nocoeff", file));
+    }
+
+    // message of the error raised by a command
+
+    std::string error_message(const std::string &line)
+    {
+        std::string mesg;
+        try {
+            command(line);
+        } catch (LAMMPSException &e) {
+            mesg = e.what();
+        }
+        return mesg;
+    }
+};
+
+// add atoms from a data file with a larger box to an existing system
+
+TEST_F(MPIReadDataTest, add_larger_box)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    if (!verbose) ::testing::internal::CaptureStdout();
+    write_box("mpi_small.data", 4, 4, 4);
+    write_box("mpi_large.data", 6, 6, 3);
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+
+    std::map<tagint, std::array<double, 4>> ref;
+    for (const auto &readers : {"", "readers 2", "readers all"}) {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        command("clear");
+        command("atom_modify map array");
+        command("read_data mpi_small.data");
+        command("group old type 1 2");
+        command(fmt::format("read_data mpi_large.data add append group new {}", readers));
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+
+        ASSERT_EQ(lmp->atom->natoms, 64 + 108);
+        EXPECT_EQ(lmp->group->count(lmp->group->find("old")), 64);
+        EXPECT_EQ(lmp->group->count(lmp->group->find("new")), 108);
+
+        // new atoms must have IDs after the existing ones and nothing else
+
+        int newbit = lmp->group->bitmask[lmp->group->find("new")];
+        int oldbit = lmp->group->bitmask[lmp->group->find("old")];
+        for (int i = 0; i < lmp->atom->nlocal; ++i) {
+            bool isnew = lmp->atom->mask[i] & newbit;
+            bool isold = lmp->atom->mask[i] & oldbit;
+            EXPECT_NE(isnew, isold);
+            EXPECT_EQ(isnew, lmp->atom->tag[i] > 64);
+        }
+
+        // compare with serial reading for the same domain decomposition
+
+        auto data = local_atoms();
+        if (ref.empty())
+            ref = data;
+        else
+            EXPECT_EQ(data, ref);
+    }
+    platform::unlink("mpi_small.data");
+    platform::unlink("mpi_large.data");
+}
+
+// Atoms section larger than the 16 MB block of a reader, so that lines are
+// split between readers and a single reader needs more than one round
+
+TEST_F(MPIReadDataTest, multiple_blocks)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    if (!verbose) ::testing::internal::CaptureStdout();
+    write_box("mpi_blocks.data", 64, 64, 64);
+    if (!verbose) ::testing::internal::GetCapturedStdout();
+
+    // size of the Atoms section in bytes
+
+    std::ifstream in("mpi_blocks.data");
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto atoms = text.find("\nAtoms");
+    auto velocities = text.find("\nVelocities");
+    ASSERT_NE(atoms, std::string::npos);
+    ASSERT_NE(velocities, std::string::npos);
+    ASSERT_GT(velocities - atoms, 16 * 1024 * 1024);
+
+    std::map<tagint, std::array<double, 4>> ref;
+    for (const auto &readers : {"", "readers 1", "readers 2"}) {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        command("clear");
+        command("atom_modify map array");
+        command(fmt::format("read_data mpi_blocks.data {}", readers));
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+
+        ASSERT_EQ(lmp->atom->natoms, 262144);
+        auto data = local_atoms();
+        if (ref.empty())
+            ref = data;
+        else
+            EXPECT_EQ(data, ref);
+    }
+    platform::unlink("mpi_blocks.data");
+}
+
+// atoms outside a non-periodic boundary are not assigned to any proc when
+// reading serially, so they must not be kept by the readers either
+
+TEST_F(MPIReadDataTest, outside_nonperiodic_box)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    FILE *fp = fopen("mpi_outside.data", "w");
+    fputs("LAMMPS data file\n\n8 atoms\n1 atom types\n\n"
+          "0.0 4.0 xlo xhi\n0.0 4.0 ylo yhi\n0.0 4.0 zlo zhi\n\n"
+          "Masses\n\n1 1.0\n\nAtoms # atomic\n\n",
+          fp);
+    for (int i = 0; i < 7; ++i)
+        fprintf(fp, "%d 1 %g %g %g\n", i + 1, 0.5 + 0.5 * i, 3.5 - 0.5 * i, 0.5 + 0.4 * i);
+    fputs("8 1 2.0 2.0 4.5\n", fp);
+    fclose(fp);
+
+    // the last atom is outside the box in z only
+
+    for (const auto &boundary : {"f f f", "p p f", "p p s"}) {
+        for (const auto &readers : {"", "readers 2", "readers all"}) {
+            if (!verbose) ::testing::internal::CaptureStdout();
+            command("clear");
+            command(fmt::format("boundary {}", boundary));
+            auto mesg = error_message(fmt::format("read_data mpi_outside.data {}", readers));
+            if (!verbose) ::testing::internal::GetCapturedStdout();
+            EXPECT_THAT(mesg, ::testing::HasSubstr("Did not assign all atoms correctly"))
+                << "boundary " << boundary << " " << readers;
+        }
+    }
+
+    // with a periodic z boundary the atom is remapped into the box
+
+    std::map<tagint, std::array<double, 4>> ref;
+    for (const auto &readers : {"", "readers 2", "readers all"}) {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        command("clear");
+        command("boundary f f p");
+        command(fmt::format("read_data mpi_outside.data {}", readers));
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+
+        ASSERT_EQ(lmp->atom->natoms, 8);
+        auto data = local_atoms();
+        if (ref.empty())
+            ref = data;
+        else
+            EXPECT_EQ(data, ref);
+    }
+    platform::unlink("mpi_outside.data");
+}
+} // namespace LAMMPS_NS
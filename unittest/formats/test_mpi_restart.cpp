@@ -0,0 +1,141 @@
+// unit tests for incremental restart files written and read on several MPI ranks
+
+#define LAMMPS_LIB_MPI 1
+#include "atom.h"
+#include "comm.h"
+#include "input.h"
+#include "lammps.h"
+#include "platform.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "../testing/test_mpi_main.h"
+
+namespace LAMMPS_NS {
+
+class MPIRestartTest : public ::testing::Test {
+public:
+    void command(const std::string &line) { lmp->input->one(line); }
+
+protected:
+    const char *testbinary = "LAMMPSTest";
+    LAMMPS *lmp;
+
+    void SetUp() override
+    {
+        const char *args[] = {testbinary, "-log", "none", "-echo", "screen", "-nocite"};
+        char **argv        = (char **)args;
+        int argc           = sizeof(args) / sizeof(char *);
+        if (!verbose) ::testing::internal::CaptureStdout();
+        lmp = new LAMMPS(argc, argv, MPI_COMM_WORLD);
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    void TearDown() override
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        delete lmp;
+        lmp = nullptr;
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+    }
+
+    void create_system()
+    {
+        command("clear");
+        command("atom_modify map array");
+        command("lattice fcc 0.8442");
+        command("region box block 0 6 0 6 0 6");
+        command("create_box 2 box");
+        command("create_atoms 1 box");
+        command("mass * 1.0");
+        command("pair_style lj/cut 2.5");
+        command("pair_coeff * * 1.0 1.0");
+        command("velocity all create 1.0 87287 loop geom");
+        command("fix 1 all nve");
+    }
+
+    // coords, velocities and types of all atoms indexed by atom ID
+
+    std::vector<double> all_atoms()
+    {
+        auto atom = lmp->atom;
+        std::vector<double> mine(7 * atom->natoms, 0.0), all(7 * atom->natoms);
+        for (int i = 0; i < atom->nlocal; ++i) {
+            double *rec = &mine[7 * (atom->tag[i] - 1)];
+            for (int k = 0; k < 3; ++k) {
+                rec[k]     = atom->x[i][k];
+                rec[3 + k] = atom->v[i][k];
+            }
+            rec[6] = atom->type[i];
+        }
+        MPI_Allreduce(mine.data(), all.data(), mine.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        return all;
+    }
+
+    // write base and delta file with atoms that migrated in between and
+    // compare the state read back from the delta file
+
+    void check_incremental(const std::string &dir, const std::string &readdir,
+                           const std::string &options)
+    {
+        if (!verbose) ::testing::internal::CaptureStdout();
+        create_system();
+        command("run 10 post no");
+        command(fmt::format("write_restart {}/base.restart incremental 2 {}", dir, options));
+        command("run 10 post no");
+        command("displace_atoms all move 2.1 1.3 0.7 units box");
+        command("set atom 5*20 type 2");
+        command(fmt::format("write_restart {}/delta.restart incremental 2 {}", dir, options));
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+        auto ref = all_atoms();
+
+        if (dir != readdir) {
+            MPI_Barrier(MPI_COMM_WORLD);
+            if (lmp->comm->me == 0) std::rename(dir.c_str(), readdir.c_str());
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+
+        if (!verbose) ::testing::internal::CaptureStdout();
+        command("clear");
+        command("atom_modify map array");
+        command(fmt::format("read_restart {}/delta.restart", readdir));
+        if (!verbose) ::testing::internal::GetCapturedStdout();
+        ASSERT_EQ(lmp->atom->natoms, 864);
+        auto val = all_atoms();
+        for (std::size_t i = 0; i < ref.size(); ++i)
+            EXPECT_NEAR(val[i], ref[i], 1.0e-7) << options << " index " << i;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        if (lmp->comm->me == 0) {
+            platform::unlink(readdir + "/base.restart");
+            platform::unlink(readdir + "/delta.restart");
+            platform::rmdir(readdir);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+};
+
+TEST_F(MPIRestartTest, incremental)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    for (const auto &options : {"precision 1.0e-8 compress no", "precision 1.0e-8"}) {
+        if (lmp->comm->me == 0) platform::mkdir("mpi_restart");
+        MPI_Barrier(MPI_COMM_WORLD);
+        check_incremental("mpi_restart", "mpi_restart", options);
+    }
+}
+
+// base and delta file moved together to a different directory
+
+TEST_F(MPIRestartTest, incremental_moved)
+{
+    ASSERT_EQ(lmp->comm->nprocs, 4);
+    if (lmp->comm->me == 0) platform::mkdir("mpi_restart_orig");
+    MPI_Barrier(MPI_COMM_WORLD);
+    check_incremental("mpi_restart_orig", "mpi_restart_moved", "precision 1.0e-8");
+}
+} // namespace LAMMPS_NS
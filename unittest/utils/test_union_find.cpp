@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------
+   LAMMPS - Large-scale Atomic/Molecular Massively Parallel Simulator
+   https://www.lammps.org/, Sandia National Laboratories
+   LAMMPS Development team: developers@lammps.org
+
+   Copyright (2003) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level LAMMPS directory.
+------------------------------------------------------------------------- */
+
+#include "union_find.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace LAMMPS_NS;
+
+TEST(UnionFind, singletons)
+{
+    UnionFind uf;
+    uf.reset(5);
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ(uf.find(i), i);
+
+    std::vector<double> value = {4.0, 3.0, 2.0, 1.0, 0.0};
+    ASSERT_EQ(uf.assign_min(value.data(), 5), 0);
+    ASSERT_THAT(value, ::testing::ElementsAre(4.0, 3.0, 2.0, 1.0, 0.0));
+}
+
+TEST(UnionFind, unite)
+{
+    UnionFind uf;
+    uf.reset(8);
+
+    // sets {0,3,5,7}, {1,2}, {4}, {6}, root is lowest index
+
+    uf.unite(7, 5);
+    uf.unite(5, 3);
+    uf.unite(3, 0);
+    uf.unite(2, 1);
+    uf.unite(1, 2);
+    uf.unite(4, 4);
+    for (int i : {0, 3, 5, 7})
+        ASSERT_EQ(uf.find(i), 0);
+    ASSERT_EQ(uf.find(1), 1);
+    ASSERT_EQ(uf.find(2), 1);
+    ASSERT_EQ(uf.find(4), 4);
+    ASSERT_EQ(uf.find(6), 6);
+
+    // merging two sets keeps the lower root
+
+    uf.unite(2, 7);
+    for (int i : {0, 1, 2, 3, 5, 7})
+        ASSERT_EQ(uf.find(i), 0);
+
+    // reset makes all sets singletons again
+
+    uf.reset(3);
+    for (int i = 0; i < 3; ++i)
+        ASSERT_EQ(uf.find(i), i);
+}
+
+TEST(UnionFind, chain)
+{
+    // long chain united from the end must find the same root everywhere
+
+    const int n = 100000;
+    UnionFind uf;
+    uf.reset(n);
+    for (int i = n - 1; i > 0; --i)
+        uf.unite(i, i - 1);
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQ(uf.find(i), 0);
+    ASSERT_GE(uf.memory_usage(), n * sizeof(int));
+}
+
+TEST(UnionFind, assign_min)
+{
+    UnionFind uf;
+    uf.reset(6);
+    uf.unite(0, 4);
+    uf.unite(1, 5);
+    uf.unite(5, 2);
+
+    // the minimum of each set is assigned to all its members, only
+    // changes of the first nfirst values are reported
+
+    std::vector<double> value = {7.0, 9.0, 8.0, 3.0, 5.0, 2.0};
+    ASSERT_EQ(uf.assign_min(value.data(), 3), 1);
+    ASSERT_THAT(value, ::testing::ElementsAre(5.0, 2.0, 2.0, 3.0, 5.0, 2.0));
+    ASSERT_EQ(uf.assign_min(value.data(), 6), 0);
+
+    value = {1.0, 2.0, 3.0, 4.0, 5.0, 0.5};
+    ASSERT_EQ(uf.assign_min(value.data(), 1), 0);
+    ASSERT_THAT(value, ::testing::ElementsAre(1.0, 0.5, 0.5, 4.0, 1.0, 0.5));
+}